@@ -0,0 +1,359 @@
+#include <benchmark/benchmark.h>
+#include "core/Board.h"
+#include "core/Game.h"
+#include "core/Notation.h"
+#include "core/PositionBatch.h"
+#include "core/TimerWheel.h"
+#include "ui/Display.h"
+#include "utils/Utils.h"
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+// Run with --benchmark_format=json (or --benchmark_out=FILE) to get output
+// that can be compared between commits, e.g. with Google Benchmark's
+// tools/compare.py.
+
+namespace {
+
+struct BenchPosition {
+    const char* name;
+    const char* fen;
+};
+
+// Arg(i) indexes into this table, so keep the order stable
+const BenchPosition POSITIONS[] = {
+    {"opening", "r1bqkbnr/pppp1ppp/2n5/4p3/4P3/5N2/PPPP1PPP/RNBQKB1R w KQkq - 2 3"},
+    {"middlegame", "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1"},
+    {"endgame", "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1"},
+};
+
+void loadPosition(benchmark::State& state, Game& game) {
+    const BenchPosition& position = POSITIONS[state.range(0)];
+    state.SetLabel(position.name);
+    if (!game.loadFEN(position.fen)) state.SkipWithError("bad FEN");
+}
+
+std::vector<std::pair<Position, Position>> legalMoves(const Board& board, PieceColor color) {
+    std::vector<std::pair<Position, Position>> moves;
+    for (const auto& from : board.getAllPiecesPositions(color)) {
+        for (const auto& to : board.getPiece(from)->getPossibleMoves(from, board)) {
+            if (!board.wouldBeInCheck(from, to, color)) moves.emplace_back(from, to);
+        }
+    }
+    return moves;
+}
+
+void positionArgs(benchmark::internal::Benchmark* bench) {
+    for (int i = 0; i < static_cast<int>(std::size(POSITIONS)); ++i) bench->Arg(i);
+}
+
+// 4096 positions from seeded random games, for the bulk benchmarks
+const std::vector<PositionSnapshot>& corpus() {
+    static const std::vector<PositionSnapshot> positions = [] {
+        std::vector<PositionSnapshot> sampled;
+        std::mt19937 rng(1);
+        while (sampled.size() < 4096) {
+            Game game;
+            for (int ply = 0; ply < 120 && !game.isGameOver() && sampled.size() < 4096; ++ply) {
+                auto moves = legalMoves(game.getBoard(), game.getCurrentPlayer());
+                const auto& [from, to] = moves[rng() % moves.size()];
+                game.makeMove(from, to);
+                sampled.push_back(game.snapshot());
+            }
+        }
+        return sampled;
+    }();
+    return positions;
+}
+
+// Arg 0 runs the scalar kernels, 1 the AVX2 ones
+bool loadBatch(benchmark::State& state, PositionBatch& batch) {
+    for (const auto& position : corpus()) batch.add(position);
+    bool avx2 = state.range(0) != 0;
+    state.SetLabel(avx2 ? "avx2" : "scalar");
+    if (!batch.setKernel(avx2 ? PositionBatch::Kernel::AVX2 : PositionBatch::Kernel::SCALAR)) {
+        state.SkipWithError("no AVX2 on this CPU");
+        return false;
+    }
+    return true;
+}
+
+}
+
+static void BM_BoardCopy(benchmark::State& state) {
+    Game game;
+    loadPosition(state, game);
+    for (auto _ : state) {
+        Board copy(game.getBoard());
+        benchmark::DoNotOptimize(copy);
+    }
+}
+BENCHMARK(BM_BoardCopy)->Apply(positionArgs);
+
+static void BM_GetAllValidMoves(benchmark::State& state) {
+    Game game;
+    loadPosition(state, game);
+    const Board& board = game.getBoard();
+    for (auto _ : state) {
+        auto moves = board.getAllValidMoves(game.getCurrentPlayer());
+        benchmark::DoNotOptimize(moves.data());
+    }
+}
+BENCHMARK(BM_GetAllValidMoves)->Apply(positionArgs);
+
+// A UI hovering every own piece once per ply; the first query builds the
+// per-ply legal move table and the rest are lookups
+static void BM_GameValidMoves(benchmark::State& state) {
+    Game game;
+    loadPosition(state, game);
+    auto pieces = game.getBoard().getAllPiecesPositions(game.getCurrentPlayer());
+    for (auto _ : state) {
+        game.updateGameStatus();
+        for (const auto& from : pieces) {
+            auto moves = game.getValidMoves(from);
+            benchmark::DoNotOptimize(moves.data());
+        }
+    }
+}
+BENCHMARK(BM_GameValidMoves)->Apply(positionArgs);
+
+static void BM_IsInCheck(benchmark::State& state) {
+    Game game;
+    loadPosition(state, game);
+    const Board& board = game.getBoard();
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(board.isInCheck(PieceColor::WHITE));
+        benchmark::DoNotOptimize(board.isInCheck(PieceColor::BLACK));
+    }
+}
+BENCHMARK(BM_IsInCheck)->Apply(positionArgs);
+
+static void BM_WouldBeInCheck(benchmark::State& state) {
+    Game game;
+    loadPosition(state, game);
+    const Board& board = game.getBoard();
+    PieceColor color = game.getCurrentPlayer();
+    auto moves = legalMoves(board, color);
+    for (auto _ : state) {
+        for (const auto& move : moves) {
+            benchmark::DoNotOptimize(board.wouldBeInCheck(move.first, move.second, color));
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(moves.size()));
+}
+BENCHMARK(BM_WouldBeInCheck)->Apply(positionArgs);
+
+static void BM_MakeUndo(benchmark::State& state) {
+    Game game;
+    loadPosition(state, game);
+    auto moves = legalMoves(game.getBoard(), game.getCurrentPlayer());
+    size_t i = 0;
+    for (auto _ : state) {
+        const auto& move = moves[i++ % moves.size()];
+        if (!game.makeMove(move.first, move.second)) state.SkipWithError("move rejected");
+        game.undoLastMove();
+    }
+}
+BENCHMARK(BM_MakeUndo)->Apply(positionArgs);
+
+// The two halves of BM_MakeUndo timed separately; PauseTiming adds a fixed
+// overhead, so compare these across commits rather than against each other
+static void BM_MakeMove(benchmark::State& state) {
+    Game game;
+    loadPosition(state, game);
+    auto moves = legalMoves(game.getBoard(), game.getCurrentPlayer());
+    size_t i = 0;
+    for (auto _ : state) {
+        const auto& move = moves[i++ % moves.size()];
+        if (!game.makeMove(move.first, move.second)) state.SkipWithError("move rejected");
+        state.PauseTiming();
+        game.undoLastMove();
+        state.ResumeTiming();
+    }
+}
+BENCHMARK(BM_MakeMove)->Apply(positionArgs);
+
+static void BM_UndoLastMove(benchmark::State& state) {
+    Game game;
+    loadPosition(state, game);
+    auto moves = legalMoves(game.getBoard(), game.getCurrentPlayer());
+    size_t i = 0;
+    for (auto _ : state) {
+        const auto& move = moves[i++ % moves.size()];
+        state.PauseTiming();
+        game.makeMove(move.first, move.second);
+        state.ResumeTiming();
+        game.undoLastMove();
+    }
+}
+BENCHMARK(BM_UndoLastMove)->Apply(positionArgs);
+
+// Jumps between both ends of a line of range(0) plies
+static void BM_SeekToPly(benchmark::State& state) {
+    Game game;
+    for (int ply = 0; ply < state.range(0); ++ply) {
+        auto moves = legalMoves(game.getBoard(), game.getCurrentPlayer());
+        if (moves.empty() || !game.makeMove(moves[ply % moves.size()].first, moves[ply % moves.size()].second)) {
+            state.SkipWithError("line ended early");
+            return;
+        }
+    }
+    size_t last = game.getLastPly();
+    bool toStart = true;
+    for (auto _ : state) {
+        game.seekToPly(toStart ? 0 : last);
+        toStart = !toStart;
+    }
+}
+BENCHMARK(BM_SeekToPly)->Arg(8)->Arg(64);
+
+static void BM_UpdateGameStatus(benchmark::State& state) {
+    Game game;
+    loadPosition(state, game);
+    for (auto _ : state) {
+        game.updateGameStatus();
+        benchmark::DoNotOptimize(game.getGameStatus());
+    }
+}
+BENCHMARK(BM_UpdateGameStatus)->Apply(positionArgs);
+
+static void BM_MoveNotation(benchmark::State& state) {
+    Game game;
+    loadPosition(state, game);
+    const Board& board = game.getBoard();
+    auto moves = legalMoves(board, game.getCurrentPlayer());
+    for (auto _ : state) {
+        for (const auto& move : moves) {
+            std::string san = Move(move.first, move.second).toAlgebraicNotation(board);
+            benchmark::DoNotOptimize(san.data());
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(moves.size()));
+}
+BENCHMARK(BM_MoveNotation)->Apply(positionArgs);
+
+static void BM_SanDecode(benchmark::State& state) {
+    Game game;
+    loadPosition(state, game);
+    const Board& board = game.getBoard();
+    std::vector<std::string> sans;
+    for (const auto& move : legalMoves(board, game.getCurrentPlayer())) {
+        sans.push_back(Notation::toSAN(board, move.first, move.second));
+    }
+    for (auto _ : state) {
+        for (const auto& san : sans) {
+            benchmark::DoNotOptimize(Notation::fromSAN(board, game.getCurrentPlayer(), san));
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(sans.size()));
+}
+BENCHMARK(BM_SanDecode)->Apply(positionArgs);
+
+static void BM_SquareNotation(benchmark::State& state) {
+    for (auto _ : state) {
+        for (int sq = 0; sq < 64; ++sq) {
+            std::string square = Utils::positionToSquare(Position(sq / 8, sq % 8));
+            benchmark::DoNotOptimize(Utils::squareToPosition(square));
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * 64);
+}
+BENCHMARK(BM_SquareNotation);
+
+// Alternates between two boards one quiet move apart, as a terminal sees
+// during play; Arg(0) forces a full repaint every frame for comparison
+static void BM_RenderBoard(benchmark::State& state) {
+    Game game;
+    Board before(game.getBoard());
+    game.makeMove(Position(7, 6), Position(5, 5));  // Ng1-f3
+    Board after(game.getBoard());
+    
+    Display display;
+    size_t bytes = 0;
+    bool flip = false;
+    for (auto _ : state) {
+        if (state.range(0) == 0) display.invalidate();
+        const std::string& frame = display.renderBoard(flip ? after : before);
+        bytes += frame.size();
+        flip = !flip;
+    }
+    state.SetLabel(state.range(0) ? "diff" : "full");
+    state.counters["bytes_per_frame"] = benchmark::Counter(static_cast<double>(bytes), benchmark::Counter::kAvgIterations);
+}
+BENCHMARK(BM_RenderBoard)->Arg(0)->Arg(1);
+
+// Re-arms one timer per move among range(0) live games, as the server does
+// with flag-fall deadlines, while the wheel turns 1 ms per iteration
+static void BM_TimerWheelRearm(benchmark::State& state) {
+    auto start = TimerWheel::Clock::now();
+    TimerWheel wheel(start);
+    std::vector<TimerWheel::Handle> handles(static_cast<size_t>(state.range(0)));
+    for (size_t i = 0; i < handles.size(); ++i) {
+        handles[i] = wheel.arm(i, start + std::chrono::seconds(60 + i % 240));
+    }
+    
+    std::vector<uint64_t> fired;
+    size_t i = 0;
+    auto now = start;
+    for (auto _ : state) {
+        size_t game = (i++ * 7919) % handles.size();
+        now += std::chrono::milliseconds(1);
+        wheel.cancel(handles[game]);
+        handles[game] = wheel.arm(game, now + std::chrono::seconds(30 + game % 270));
+        wheel.advance(now, fired);
+    }
+    benchmark::DoNotOptimize(fired.size());
+}
+BENCHMARK(BM_TimerWheelRearm)->Arg(1000)->Arg(100000);
+
+// Legal move counts over the corpus one position at a time through Board,
+// against PositionBatch's kernels
+static void BM_BoardLegalMoveCounts(benchmark::State& state) {
+    const auto& positions = corpus();
+    Board board;
+    for (auto _ : state) {
+        for (const auto& position : positions) {
+            board.restore(position);
+            benchmark::DoNotOptimize(legalMoves(board, position.side()).size());
+        }
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * positions.size()));
+}
+BENCHMARK(BM_BoardLegalMoveCounts);
+
+static void BM_BatchLegalMoveCounts(benchmark::State& state) {
+    PositionBatch batch;
+    if (!loadBatch(state, batch)) return;
+    std::vector<uint16_t> counts;
+    for (auto _ : state) {
+        batch.legalMoveCounts(counts);
+        benchmark::DoNotOptimize(counts.data());
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * batch.size()));
+}
+BENCHMARK(BM_BatchLegalMoveCounts)->Arg(0)->Arg(1);
+
+static void BM_SnapshotInCheck(benchmark::State& state) {
+    const auto& positions = corpus();
+    for (auto _ : state) {
+        for (const auto& position : positions) benchmark::DoNotOptimize(position.isInCheck(position.side()));
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * positions.size()));
+}
+BENCHMARK(BM_SnapshotInCheck);
+
+static void BM_BatchInCheck(benchmark::State& state) {
+    PositionBatch batch;
+    if (!loadBatch(state, batch)) return;
+    std::vector<uint8_t> checks;
+    for (auto _ : state) {
+        batch.inCheck(checks);
+        benchmark::DoNotOptimize(checks.data());
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * batch.size()));
+}
+BENCHMARK(BM_BatchInCheck)->Arg(0)->Arg(1);
+
+BENCHMARK_MAIN();
\ No newline at end of file
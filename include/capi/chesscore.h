@@ -0,0 +1,131 @@
+#ifndef CHESSCORE_H
+#define CHESSCORE_H
+
+/*
+ * C interface to the rules core, built as the libchesscore shared library.
+ *
+ * A chess_position is an opaque handle to a game: a position plus the moves
+ * that led to it, so moves can be unmade and repetitions are detected.
+ * Functions that produce more than a scalar write into a buffer the caller
+ * owns and report how much they needed, so nothing returned ever has to be
+ * freed; only create and destroy manage memory on the caller's behalf.
+ * Queries work on a copy of the position and do not allocate; load_fen,
+ * make_move and unmake_move may, as the game keeps its move history.
+ *
+ * Squares are numbered from a1 = 0 to h8 = 63 (file + 8 * rank). A move packs
+ * the origin in bits 0-5, the destination in bits 6-11 and a promotion piece
+ * in bits 12-14.
+ *
+ * A handle may be used from one thread at a time; separate handles are
+ * independent.
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+
+#if defined(_WIN32)
+#  if defined(CHESSCORE_BUILD)
+#    define CHESSCORE_API __declspec(dllexport)
+#  else
+#    define CHESSCORE_API __declspec(dllimport)
+#  endif
+#else
+#  define CHESSCORE_API __attribute__((visibility("default")))
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Bumped whenever a signature or a constant below changes meaning */
+#define CHESSCORE_ABI_VERSION 1
+
+/* Enough for any legal position (the most known is 218) */
+#define CHESS_MAX_MOVES 256
+/* Longest FEN this library writes, including the terminating NUL */
+#define CHESS_MAX_FEN 96
+
+typedef struct chess_position chess_position;
+typedef uint16_t chess_move;
+
+typedef enum chess_status {
+    CHESS_OK = 0,
+    CHESS_INVALID_ARGUMENT,     /* Null handle or buffer, unknown promotion */
+    CHESS_INVALID_FEN,          /* The position is left unchanged */
+    CHESS_ILLEGAL_MOVE,         /* Includes any move once the game is over */
+    CHESS_NO_MOVE_TO_UNMAKE,
+    CHESS_BUFFER_TOO_SMALL,     /* As much as fits was written; see the count */
+    CHESS_OUT_OF_MEMORY,
+    CHESS_INTERNAL_ERROR
+} chess_status;
+
+typedef enum chess_promotion {
+    CHESS_PROMOTE_NONE = 0,
+    CHESS_PROMOTE_KNIGHT,
+    CHESS_PROMOTE_BISHOP,
+    CHESS_PROMOTE_ROOK,
+    CHESS_PROMOTE_QUEEN
+} chess_promotion;
+
+typedef enum chess_color {
+    CHESS_WHITE = 0,
+    CHESS_BLACK
+} chess_color;
+
+typedef enum chess_game_state {
+    CHESS_ONGOING = 0,
+    CHESS_CHECK,
+    CHESS_CHECKMATE,
+    CHESS_STALEMATE,
+    CHESS_DRAW_FIFTY_MOVES,
+    CHESS_DRAW_REPETITION,
+    CHESS_DRAW_INSUFFICIENT_MATERIAL
+} chess_game_state;
+
+static inline chess_move chess_make_move(int from, int to, chess_promotion promotion) {
+    return (chess_move)((from & 63) | ((to & 63) << 6) | (((int)promotion & 7) << 12));
+}
+static inline int chess_move_from(chess_move move) { return move & 63; }
+static inline int chess_move_to(chess_move move) { return (move >> 6) & 63; }
+static inline chess_promotion chess_move_promotion(chess_move move) { return (chess_promotion)((move >> 12) & 7); }
+
+/* CHESSCORE_ABI_VERSION of the library actually loaded */
+CHESSCORE_API uint32_t chess_abi_version(void);
+CHESSCORE_API const char* chess_status_string(chess_status status);
+
+/* The standard starting position; NULL if out of memory */
+CHESSCORE_API chess_position* chess_position_create(void);
+CHESSCORE_API void chess_position_destroy(chess_position* position);
+
+/* Replaces the game with the position in fen; clocks and castling fields are optional */
+CHESSCORE_API chess_status chess_position_load_fen(chess_position* position, const char* fen);
+/* Writes the current position as a NUL-terminated FEN. *length (optional)
+   receives the FEN's length without the NUL, also when the buffer is too
+   small. */
+CHESSCORE_API chess_status chess_position_fen(const chess_position* position, char* buffer, size_t size,
+                                              size_t* length);
+
+/* Promotions without a piece promote to a queen; a piece on any other move
+   is ignored */
+CHESSCORE_API chess_status chess_position_make_move(chess_position* position, chess_move move);
+CHESSCORE_API chess_status chess_position_unmake_move(chess_position* position);
+
+/* Writes the legal moves of the side to move, one entry per promotion
+   piece. *count receives the number of legal moves, which may exceed
+   capacity; a buffer of CHESS_MAX_MOVES always suffices. */
+CHESSCORE_API chess_status chess_position_legal_moves(const chess_position* position, chess_move* moves,
+                                                      size_t capacity, size_t* count);
+CHESSCORE_API int chess_position_is_legal(const chess_position* position, chess_move move);
+
+CHESSCORE_API chess_color chess_position_side_to_move(const chess_position* position);
+CHESSCORE_API chess_game_state chess_position_state(const chess_position* position);
+/* Moves made since the start or the last load_fen */
+CHESSCORE_API size_t chess_position_ply(const chess_position* position);
+/* Zobrist key of the position, side to move and castling rights included */
+CHESSCORE_API uint64_t chess_position_hash(const chess_position* position);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
\ No newline at end of file
@@ -0,0 +1,69 @@
+#pragma once
+
+#include "Position.h"
+#include "utils/MappedFile.h"
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+class Board;
+
+enum class BitbaseResult {
+    WIN,
+    DRAW,
+    LOSS
+};
+
+// One bit per position for a king plus up to two pieces against a lone king:
+// set when the stronger side wins. Positions are indexed as
+// (side to move, strong king, weak king, piece 1, piece 2) with the stronger
+// side normalised to White, so a probe is a handful of multiplies.
+class Bitbase {
+public:
+    static constexpr int MAX_PIECES = 2;
+    
+    Bitbase() = default;
+    Bitbase(const std::string& material, std::vector<unsigned char> bits);
+    
+    bool load(const std::string& path);
+    bool save(const std::string& path) const;
+    
+    const std::string& getMaterial() const { return material_; }
+    size_t size() const { return positions_; }
+    bool isWin(size_t index) const { return (bits_[index >> 3] >> (index & 7)) & 1; }
+    
+    // Canonical material name ("KNBK" -> "KBNK"), empty if unsupported
+    static std::string canonicalMaterial(const std::string& material);
+    static size_t positionCount(const std::string& material);
+    
+private:
+    std::string material_;
+    size_t positions_ = 0;
+    std::vector<unsigned char> owned_;
+    MappedFile file_;
+    const unsigned char* bits_ = nullptr;
+};
+
+class BitbaseStore {
+public:
+    BitbaseStore() = default;
+    
+    bool load(const std::string& path);
+    size_t loadDirectory(const std::string& directory);
+    bool saveAll(const std::string& directory) const;
+    
+    // Builds the table and any smaller tables it depends on (promotions,
+    // captures) by retrograde analysis across the given number of threads.
+    bool generate(const std::string& material, unsigned threads = 0);
+    
+    void add(Bitbase bitbase);
+    const Bitbase* find(const std::string& material) const;
+    size_t size() const { return tables_.size(); }
+    
+    std::optional<BitbaseResult> probe(const Board& board, PieceColor sideToMove) const;
+    
+private:
+    std::unordered_map<std::string, Bitbase> tables_;
+};
\ No newline at end of file
@@ -1,7 +1,9 @@
 #pragma once
 
+#include "Material.h"
 #include "Position.h"
 #include "Piece.h"
+#include "PositionSnapshot.h"
 #include <array>
 #include <memory>
 #include <vector>
@@ -34,12 +36,21 @@ public:
     std::vector<Position> getAllPiecesPositions(PieceColor color) const;
     std::vector<Position> getAllValidMoves(PieceColor color) const;
     
+    // Probes a scratch snapshot instead of copying the board
     bool wouldBeInCheck(const Position& from, const Position& to, PieceColor color) const;
     
+    // Pieces and en passant square as a value; the side to move is the
+    // caller's, and clocks are left for Game to fill in
+    PositionSnapshot snapshot(PieceColor sideToMove = PieceColor::WHITE) const;
+    void restore(const PositionSnapshot& snapshot);
+    
     void setEnPassantTarget(const Position& pos) { en_passant_target_ = pos; }
     Position getEnPassantTarget() const { return en_passant_target_; }
     void clearEnPassantTarget() { en_passant_target_ = Position(-1, -1); }
     
+    // Piece counts per colour and kind, kept up to date by every change
+    Material::Key getMaterialKey() const { return material_key_; }
+    
     bool canCastleKingside(PieceColor color) const;
     bool canCastleQueenside(PieceColor color) const;
     
@@ -48,6 +59,7 @@ public:
 private:
     std::array<std::array<std::unique_ptr<Piece>, 8>, 8> board_;
     Position en_passant_target_;
+    Material::Key material_key_ = 0;
     
     void copyBoard(const Board& other);
     bool isPositionAttacked(const Position& pos, PieceColor attackingColor) const;
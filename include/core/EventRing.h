@@ -0,0 +1,99 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <type_traits>
+
+// Single-producer, multi-consumer broadcast ring. The producer publishes
+// values under consecutive sequence numbers and never waits: once the ring
+// is full each publish overwrites the oldest slot. Consumers keep their own
+// cursor and read by sequence number without writing shared state, so any
+// number of them cost the producer nothing. A consumer that falls more than
+// a ring's length behind is told so (LAGGED) and has to resync from some
+// other source, such as a snapshot taken together with head().
+//
+// Each slot is a seqlock: a stamp that is odd while the slot is being
+// written, then 2 * (sequence + 1), around the value held as atomic words,
+// so a read racing an overwrite is detected rather than torn.
+template <typename T>
+class EventRing {
+    static_assert(std::is_trivially_copyable<T>::value, "events are copied word by word");
+
+public:
+    enum class Read {
+        OK,
+        EMPTY,      // Not published yet
+        LAGGED      // Already overwritten
+    };
+
+    // Rounded up to a power of two
+    explicit EventRing(size_t capacity = 256) {
+        size_t size = 1;
+        while (size < capacity) size <<= 1;
+        mask_ = size - 1;
+        slots_ = std::make_unique<Slot[]>(size);
+    }
+
+    EventRing(const EventRing&) = delete;
+    EventRing& operator=(const EventRing&) = delete;
+
+    size_t capacity() const { return mask_ + 1; }
+
+    // Producer only
+    uint64_t publish(const T& value) {
+        uint64_t sequence = head_.load(std::memory_order_relaxed);
+        Slot& slot = slots_[sequence & mask_];
+        slot.stamp.store(2 * sequence + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+
+        uint64_t words[WORDS] = {};
+        std::memcpy(words, &value, sizeof(T));
+        for (size_t i = 0; i < WORDS; ++i) slot.words[i].store(words[i], std::memory_order_relaxed);
+
+        slot.stamp.store(2 * sequence + 2, std::memory_order_release);
+        head_.store(sequence + 1, std::memory_order_release);
+        return sequence;
+    }
+
+    // Sequence number the next publish will use
+    uint64_t head() const { return head_.load(std::memory_order_acquire); }
+    // Oldest sequence number still held
+    uint64_t tail() const {
+        uint64_t head = this->head();
+        return head > capacity() ? head - capacity() : 0;
+    }
+
+    Read read(uint64_t sequence, T& out) const {
+        if (sequence >= head_.load(std::memory_order_acquire)) return Read::EMPTY;
+
+        // The stamp was at least this when head moved past sequence, and
+        // only grows, so any other value means a later lap took the slot
+        const Slot& slot = slots_[sequence & mask_];
+        uint64_t expected = 2 * sequence + 2;
+        if (slot.stamp.load(std::memory_order_acquire) != expected) return Read::LAGGED;
+
+        uint64_t words[WORDS];
+        for (size_t i = 0; i < WORDS; ++i) words[i] = slot.words[i].load(std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (slot.stamp.load(std::memory_order_relaxed) != expected) return Read::LAGGED;
+
+        std::memcpy(&out, words, sizeof(T));
+        return Read::OK;
+    }
+
+private:
+    static constexpr size_t WORDS = (sizeof(T) + 7) / 8;
+
+    // A cache line each, so readers of neighbouring slots do not slow the
+    // producer's writes
+    struct alignas(64) Slot {
+        std::atomic<uint64_t> stamp{0};
+        std::atomic<uint64_t> words[WORDS] = {};
+    };
+
+    std::unique_ptr<Slot[]> slots_;
+    size_t mask_ = 0;
+    alignas(64) std::atomic<uint64_t> head_{0};
+};
\ No newline at end of file
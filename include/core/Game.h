@@ -1,10 +1,15 @@
 #pragma once
 
 #include "Board.h"
+#include "GameClock.h"
+#include "GameState.h"
 #include "Move.h"
 #include "Player.h"
+#include <array>
+#include <cstdint>
 #include <vector>
 #include <memory>
+#include <optional>
 
 class Game {
 public:
@@ -15,20 +20,79 @@ public:
     bool makeMove(const Position& from, const Position& to);
     bool makeMove(const Move& move);
     
+    // Steps back one ply; the undone move stays available to seek forward to
     void undoLastMove();
     
+    // Random access over the line of play. Every position from the first
+    // ply on is kept as a snapshot, so seeking any distance is one restore
+    // plus moving the Move objects in between to or from the future list.
+    // Plies past the current one are kept until a different move is made
+    // there; making the same move again just steps forward.
+    bool seekToPly(size_t ply);
+    size_t getCurrentPly() const { return move_history_.size(); }
+    // Earliest reachable ply: 0, unless restored from a state that has a
+    // move list but no start position
+    size_t getFirstPly() const { return first_ply_; }
+    size_t getLastPly() const { return first_ply_ + plies_.size() - 1; }
+    // Position at getFirstPly(), which moves before it lead to
+    const PositionSnapshot& getFirstPosition() const { return plies_.front().position; }
+    // Zobrist key of the current position, kept per ply for repetitions
+    uint64_t getPositionKey() const { return plies_[getCurrentPly() - first_ply_].key; }
+    
     PieceColor getCurrentPlayer() const { return current_player_; }
     GameStatus getGameStatus() const { return game_status_; }
+    DrawReason getDrawReason() const { return draw_reason_; }
     const Board& getBoard() const { return board_; }
     
     const std::vector<Move>& getMoveHistory() const { return move_history_; }
     const Move& getLastMove() const;
     
+    // Legality queries read a per-ply table of the side to move's legal
+    // destinations, built on first use and dropped whenever the position
+    // changes, so after one generation each query is a bit test
     bool isValidMove(const Position& from, const Position& to) const;
     std::vector<Position> getValidMoves(const Position& from) const;
+    // Destinations of the piece on from as bits (row * 8 + col); 0 for
+    // empty squares and the opponent's pieces
+    uint64_t getLegalTargets(const Position& from) const;
+    bool hasLegalMoves() const;
     
     bool isGameOver() const;
     std::string getGameStatusString() const;
+    std::string toFEN() const;
+    // Writes the FEN into buffer like snprintf: truncated to size - 1
+    // characters plus a NUL, returning the full length. Does not allocate.
+    size_t writeFEN(char* buffer, size_t size) const;
+    bool loadFEN(const std::string& fen);
+    // FEN the game was loaded from, empty for the standard start position
+    const std::string& getStartFEN() const { return start_fen_; }
+    
+    // Recomputes check, mate and draw status for the side to move
+    void updateGameStatus();
+    
+    GameState saveState() const;
+    bool restoreState(const GameState& state);
+    
+    // The current position as a 72-byte value. restoreSnapshot starts a new
+    // game from one (no move history), with the snapshot as its start FEN.
+    PositionSnapshot snapshot() const;
+    bool restoreSnapshot(const PositionSnapshot& position);
+    
+    // Chess clock, off unless a time control is set. makeMove stamps each
+    // move with GameClock::Clock::now(): a move made after the mover's flag
+    // fell is refused and ends the game on time instead. Takebacks hand the
+    // turn back without crediting the time spent.
+    void setTimeControl(const TimeControl& control);
+    void startClock(GameClock::Clock::time_point now = GameClock::Clock::now());
+    // Sets a stopped clock's time left, e.g. for a game coming back from a log
+    void setRemainingTime(PieceColor side, GameClock::Clock::duration left);
+    const GameClock* getClock() const { return clock_ ? &*clock_ : nullptr; }
+    // Ends the game if the side to move has run out of time by now; a flag
+    // against a bare king is a draw
+    bool checkFlag(GameClock::Clock::time_point now = GameClock::Clock::now());
+    // The outcome checkFlag gives once the side to move's flag has fallen,
+    // for replaying a flag fall without the clock
+    void forfeitOnTime();
     
     void setPlayer(PieceColor color, std::unique_ptr<Player> player);
     Player* getPlayer(PieceColor color) const;
@@ -48,15 +112,39 @@ private:
     int halfmove_clock_;
     int fullmove_number_;
     bool draw_offered_;
+    std::string start_fen_;
+    DrawReason draw_reason_ = DrawReason::NONE;
+    std::optional<GameClock> clock_;
+    
+    // Position and Zobrist key at every ply from first_ply_ to the end of
+    // the line, including plies past the current one; the keys feed
+    // repetition detection
+    struct PlyRecord {
+        PositionSnapshot position;
+        uint64_t key;
+    };
+    std::vector<PlyRecord> plies_;
+    // Moves after the current ply, the next one last
+    std::vector<Move> future_moves_;
+    size_t first_ply_ = 0;
+    
+    mutable std::array<uint64_t, 64> legal_targets_{};
+    mutable bool legal_targets_valid_ = false;
+    
+    const std::array<uint64_t, 64>& legalTargets() const;
     
     void switchPlayer();
-    void updateGameStatus();
+    // Starts a new line at the current position and move history
+    void resetLine();
+    // Records the position after the move just pushed onto move_history_
+    void recordPly();
+    bool replayState(const GameState& state);
     bool isThreefoldRepetition() const;
     bool isFiftyMoveRule() const;
     bool isInsufficientMaterial() const;
     
     Move createMove(const Position& from, const Position& to);
     bool executeCastling(const Move& move);
-    bool executeEnPassant(const Move& move);
+    bool executeEnPassant(Move& move);
     bool executePromotion(const Move& move);
 };
\ No newline at end of file
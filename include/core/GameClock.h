@@ -0,0 +1,55 @@
+#pragma once
+
+#include "Position.h"
+#include <chrono>
+
+// Base time per side plus either a Fischer increment (added after each
+// move) or a simple delay (the first delay of every turn is free)
+struct TimeControl {
+    std::chrono::milliseconds base{0};
+    std::chrono::milliseconds increment{0};
+    std::chrono::milliseconds delay{0};
+};
+
+// Two-sided chess clock. Every call takes the time it happens at instead of
+// reading the clock itself, so a caller stamps an event once and all the
+// accounting for it agrees; remaining time is kept at steady_clock
+// resolution and only rounded for display.
+class GameClock {
+public:
+    using Clock = std::chrono::steady_clock;
+    
+    explicit GameClock(const TimeControl& control);
+    
+    const TimeControl& getTimeControl() const { return control_; }
+    bool isRunning() const { return running_; }
+    PieceColor getRunningSide() const { return side_; }
+    
+    // Starts side's turn; does nothing if the clock is already running
+    void start(PieceColor side, Clock::time_point now);
+    // Charges the running side for its turn so far and stops
+    void stop(Clock::time_point now);
+    // Ends the running side's turn: charges its time, adds the increment and
+    // starts the other side. Returns false, changing nothing, if its flag had
+    // already fallen at now.
+    bool press(Clock::time_point now);
+    // Hands the turn to side without an increment, e.g. after a takeback
+    void switchTo(PieceColor side, Clock::time_point now);
+    // Only while stopped; a running side's time is charged from its turn start
+    void setRemaining(PieceColor side, Clock::duration left);
+    
+    Clock::duration remaining(PieceColor side, Clock::time_point now) const;
+    bool hasFlagged(Clock::time_point now) const;
+    // When the running side's flag falls; time_point::max() when stopped
+    Clock::time_point flagTime() const;
+    
+private:
+    TimeControl control_;
+    Clock::duration remaining_[2];
+    bool running_ = false;
+    PieceColor side_ = PieceColor::WHITE;
+    Clock::time_point turn_start_{};
+    
+    Clock::duration charged(Clock::time_point now) const;
+    static int index(PieceColor side) { return side == PieceColor::WHITE ? 0 : 1; }
+};
\ No newline at end of file
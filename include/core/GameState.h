@@ -0,0 +1,51 @@
+#pragma once
+
+#include "Position.h"
+#include "PositionSnapshot.h"
+#include <array>
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+// One move in 4 bytes: squares are row * 8 + col, the kind byte holds the
+// MoveType (low nibble) and promotion PieceType (high nibble), and captured
+// is the packed code of the piece taken, if any.
+struct PackedMove {
+    uint8_t from;
+    uint8_t to;
+    uint8_t kind;
+    uint8_t captured;
+};
+
+// Value-type copy of everything a Game needs to resume play: piece codes,
+// side to move, en passant square, clocks, the move list and the position
+// it starts from. Roughly 100 bytes plus 4 per move (70 more when the game
+// did not begin from the standard position), against kilobytes and dozens of allocations for a
+// live Game, so idle sessions can be parked or shipped between threads.
+struct GameState {
+    static constexpr uint8_t NO_SQUARE = 64;
+    
+    // Piece code: bits 0-2 PieceType + 1 (0 = empty), bit 3 black, bit 4 moved
+    std::array<uint8_t, 64> squares{};
+    uint8_t sideToMove = 0;
+    uint8_t status = 0;
+    uint8_t enPassant = NO_SQUARE;
+    uint8_t drawOffered = 0;
+    uint16_t halfmoveClock = 0;
+    uint16_t fullmoveNumber = 1;
+    std::vector<PackedMove> moves;
+    // Position before moves[0], so a restored game can seek back through the
+    // whole line; absent in version 1 data and in states built by hand
+    std::optional<PositionSnapshot> start;
+    
+    static uint8_t encodePiece(PieceType type, PieceColor color, bool moved);
+    static PieceType pieceType(uint8_t code) { return static_cast<PieceType>((code & 7) - 1); }
+    static PieceColor pieceColor(uint8_t code) { return (code & 8) ? PieceColor::BLACK : PieceColor::WHITE; }
+    static bool pieceMoved(uint8_t code) { return (code & 16) != 0; }
+    
+    // The current position, without restoring a Game
+    PositionSnapshot position() const;
+    
+    std::vector<uint8_t> serialize() const;
+    static std::optional<GameState> deserialize(const uint8_t* data, size_t size);
+};
\ No newline at end of file
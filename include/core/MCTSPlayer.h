@@ -0,0 +1,64 @@
+#pragma once
+
+#include "Player.h"
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+
+class Game;
+
+struct MCTSConfig {
+    unsigned threads = 1;
+    std::chrono::milliseconds budget{1000};
+    // Arena size; when it fills up the tree stops growing but the search
+    // keeps refining the nodes it has
+    uint32_t maxNodes = 1 << 18;
+    // Random plies played past a new leaf before scoring it by material
+    int playoutDepth = 8;
+    double exploration = 1.4;
+    // Losses a thread adds to each node on its path while it is in flight
+    int virtualLoss = 3;
+};
+
+struct MCTSStats {
+    uint64_t iterations = 0;
+    uint32_t nodes = 0;
+    uint32_t bestVisits = 0;
+    double seconds = 0.0;
+};
+
+// Monte Carlo tree search with tree parallelism. Every thread walks one
+// shared tree, charging a virtual loss to each node on its path so that
+// concurrent walks spread out, then plays a short random playout through
+// Game and scores the result by material. Nodes come from an arena sized
+// once at construction and are claimed with a single atomic increment, so
+// the tree is built without locks.
+class MCTSPlayer : public ComputerPlayer {
+public:
+    MCTSPlayer(const std::string& name, PieceColor color, const MCTSConfig& config = MCTSConfig(),
+               unsigned seed = std::random_device{}());
+    ~MCTSPlayer() override;
+    
+    const MCTSConfig& getConfig() const { return config_; }
+    MCTSStats getLastSearchStats() const;
+    
+protected:
+    // Searches until the budget, the request deadline or a cancellation,
+    // whichever comes first, and plays the most visited root move
+    Move chooseMove(const Board& board, const MoveRequest& request) override;
+    
+private:
+    struct Node;
+    struct Search;
+    
+    MCTSConfig config_;
+    std::unique_ptr<Node[]> nodes_;
+    
+    mutable std::mutex stats_mutex_;
+    MCTSStats last_stats_;
+    
+    void runSearch(Search& search, unsigned threadIndex);
+    bool expand(Search& search, Node& node, const Game& game);
+};
\ No newline at end of file
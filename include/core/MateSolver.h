@@ -0,0 +1,80 @@
+#pragma once
+
+#include "Game.h"
+#include "Move.h"
+#include "PositionSnapshot.h"
+#include <cstdint>
+#include <vector>
+
+struct MateSolverConfig {
+    // Transposition table size; the solver allocates it once and never more
+    size_t tableBytes = size_t{64} << 20;
+    // Node expansions per solve before giving up with UNKNOWN
+    uint64_t maxNodes = 2'000'000;
+};
+
+enum class MateResult {
+    MATE,       // Forced mate found; line holds it
+    NO_MATE,    // Proved that no mate exists within the bound
+    UNKNOWN     // Node budget ran out first
+};
+
+struct MateSolution {
+    MateResult result = MateResult::UNKNOWN;
+    int mateIn = 0;             // Moves by the mating side, for MATE
+    std::vector<Move> line;     // Both sides' moves, ending in mate
+    uint64_t nodes = 0;
+};
+
+// Depth-bounded depth-first proof-number search (df-pn) for forced mates.
+// Positions where the mating side is to move are OR nodes, the defender's
+// are AND nodes, and every node carries the plies left, so a transposition
+// table entry proved with d plies also proves the position for any bound
+// of d or more (and a disproof holds for any smaller bound). The table is
+// a fixed array of 4-entry buckets that evicts the entry with the smallest
+// subtree, so a small memory cap costs re-search rather than failures.
+// Draws by repetition or the fifty-move rule count as not mating, as Game
+// reports them along the current line.
+class MateSolver {
+public:
+    explicit MateSolver(const MateSolverConfig& config = MateSolverConfig());
+    
+    // Looks for the shortest forced mate by the side to move in at most
+    // maxMoves of its own moves. The table carries over between calls, so
+    // solving consecutive positions of one game reuses earlier work.
+    MateSolution solve(const PositionSnapshot& position, int maxMoves);
+    void clear();
+    
+    size_t tableEntries() const { return table_.size(); }
+    
+private:
+    struct Entry {
+        uint64_t key = 0;
+        uint32_t pn = 0;
+        uint32_t dn = 0;
+        uint32_t work = 0;      // Nodes spent below this entry; 0 = empty
+        uint16_t plies = 0;
+    };
+    struct Numbers {
+        uint32_t pn;
+        uint32_t dn;
+    };
+    struct Child;
+    
+    MateSolverConfig config_;
+    std::vector<Entry> table_;
+    Game game_;
+    PieceColor attacker_ = PieceColor::WHITE;
+    uint64_t nodes_ = 0;
+    uint64_t limit_ = 0;
+    
+    bool lookup(uint64_t key, int plies, Numbers& out) const;
+    void store(uint64_t key, int plies, Numbers numbers, uint64_t work);
+    
+    std::vector<Child> expand(int plies);
+    Numbers search(int plies, uint32_t thpn, uint32_t thdn);
+    // Proves or disproves the current position with plies left
+    bool isProven(int plies);
+    bool play(const Child& child);
+    void extractLine(int plies, std::vector<Move>& line);
+};
\ No newline at end of file
@@ -0,0 +1,78 @@
+#pragma once
+
+#include "Position.h"
+#include <cstdint>
+
+class Board;
+
+// Material signatures: a 4-bit piece count per colour and kind packed into
+// one word, White in the low half. Bishops are counted by square colour so
+// that bishop endings can be judged from the key alone. Board keeps the key
+// up to date as pieces come and go, and classify() maps it to what the
+// material alone decides.
+namespace Material {
+    using Key = uint64_t;
+
+    enum Slot {
+        PAWN,
+        KNIGHT,
+        LIGHT_BISHOP,
+        DARK_BISHOP,
+        ROOK,
+        QUEEN,
+        KING
+    };
+
+    enum class Outcome {
+        UNKNOWN,
+        DEAD_DRAW,      // Neither side can ever mate
+        DRAWN,          // Drawn with correct play
+        WHITE_WINS,     // Won with correct play, barring an immediate
+        BLACK_WINS      // capture or stalemate
+    };
+
+    constexpr int shift(Slot slot, PieceColor color) {
+        return 4 * (slot + (color == PieceColor::BLACK ? 8 : 0));
+    }
+
+    constexpr Key unit(Slot slot, PieceColor color) {
+        return Key{1} << shift(slot, color);
+    }
+
+    constexpr int count(Key key, Slot slot, PieceColor color) {
+        return static_cast<int>((key >> shift(slot, color)) & 0xF);
+    }
+
+    constexpr bool isBareKing(Key key, PieceColor color) {
+        Key side = (color == PieceColor::BLACK) ? (key >> 32) : (key & 0xFFFFFFFFULL);
+        return side == unit(KING, PieceColor::WHITE);
+    }
+
+    // Conventional values in pawns; the king counts for nothing
+    constexpr int pieceValue(PieceType type) {
+        switch (type) {
+            case PieceType::PAWN: return 1;
+            case PieceType::KNIGHT:
+            case PieceType::BISHOP: return 3;
+            case PieceType::ROOK: return 5;
+            case PieceType::QUEEN: return 9;
+            default: return 0;
+        }
+    }
+    
+    // White's material minus Black's, in pawns
+    int balance(Key key);
+    
+    Slot slotOf(PieceType type, const Position& pos);
+
+    inline Key unit(PieceType type, PieceColor color, const Position& pos) {
+        return unit(slotOf(type, pos), color);
+    }
+
+    // Key computed from scratch, to check the incremental one
+    Key key(const Board& board);
+
+    // One masked compare for the bishop-only families, then a probe of a
+    // small open-addressed table for the rest
+    Outcome classify(Key key);
+}
\ No newline at end of file
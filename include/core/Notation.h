@@ -0,0 +1,40 @@
+#pragma once
+
+#include "Move.h"
+#include "Position.h"
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+class Board;
+class Game;
+
+// Standard Algebraic Notation resolved against the legal moves of a
+// position: file/rank disambiguation, x for captures, =Q for promotions and
+// + or # when the move gives check or mate.
+namespace Notation {
+    // Appends the SAN of a legal move to out and returns the number of
+    // characters written, so callers can reuse one buffer for many moves.
+    size_t appendSAN(std::string& out, const Board& board, const Position& from, const Position& to,
+                     PieceType promotion = PieceType::QUEEN);
+    std::string toSAN(const Board& board, const Position& from, const Position& to,
+                      PieceType promotion = PieceType::QUEEN);
+    
+    // Accepts optional check/annotation suffixes, 0-0 for O-O and promotions
+    // with or without '='. Returns nothing unless exactly one legal move
+    // matches.
+    std::optional<Move> fromSAN(const Board& board, PieceColor side, std::string_view san);
+    
+    // Bulk conversion: replays the history from the game's first ply (moves
+    // before it are taken back from there) and returns one SAN string per move
+    std::vector<std::string> historyToSAN(const Game& game);
+    
+    // Returns the next move token of PGN-style move text starting at pos,
+    // skipping move numbers and {comments}; empty at the end or a result
+    std::string_view nextMoveToken(std::string_view text, size_t& pos);
+    
+    // Plays whitespace-separated SAN moves from nextMoveToken. Stops at the
+    // first move that does not resolve and returns the number played.
+    size_t playSAN(Game& game, std::string_view text);
+}
\ No newline at end of file
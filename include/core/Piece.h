@@ -11,6 +11,8 @@ public:
     Piece(PieceColor color, PieceType type);
     virtual ~Piece() = default;
     
+    static std::unique_ptr<Piece> create(PieceType type, PieceColor color);
+    
     PieceColor getColor() const { return color_; }
     PieceType getType() const { return type_; }
     bool hasMoved() const { return has_moved_; }
@@ -1,10 +1,52 @@
 #pragma once
 
+#include "Board.h"
 #include "Position.h"
 #include "Move.h"
+#include "PolyglotBook.h"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <random>
 #include <string>
 
-class Board;
+// Handle to a move being chosen in the background. The driver waits on it,
+// polls it or cancels it; the player fulfils it. It resolves empty when it
+// is cancelled or its deadline passes before a move arrives.
+class MoveRequest {
+public:
+    using Clock = std::chrono::steady_clock;
+    
+    explicit MoveRequest(Clock::time_point deadline = Clock::time_point::max());
+    
+    Clock::time_point deadline() const { return deadline_; }
+    
+    // True once cancel() was called or the deadline has passed
+    bool isCancelled() const;
+    void cancel();
+    
+    // True once a move arrived or the request was given up
+    bool isDone() const;
+    
+    // Blocks until done; empty if cancelled or out of time. Like a future,
+    // the move is handed over once.
+    std::optional<Move> wait();
+    std::optional<Move> waitUntil(Clock::time_point until);
+    
+    // First caller wins; returns false if the request was already done
+    bool fulfil(Move move);
+    
+private:
+    Clock::time_point deadline_;
+    std::atomic<bool> cancelled_;
+    mutable std::mutex mutex_;
+    std::condition_variable done_cv_;
+    bool done_;
+    std::optional<Move> move_;
+};
 
 class Player {
 public:
@@ -14,18 +56,74 @@ public:
     const std::string& getName() const { return name_; }
     PieceColor getColor() const { return color_; }
     
-    virtual Move getMove(const Board& board) = 0;
+    // Starts choosing a move on a shared worker thread and returns
+    // immediately. A new request cancels the previous one; the position is
+    // taken as a snapshot, so the caller may keep playing on its own.
+    std::shared_ptr<MoveRequest> requestMove(const Board& board,
+                                             MoveRequest::Clock::time_point deadline = MoveRequest::Clock::time_point::max());
+    
+    // Blocking form of requestMove; an invalid move if none was produced
+    Move getMove(const Board& board);
+    
     virtual bool isHuman() const = 0;
     
 protected:
+    // Chooses the move on the worker thread. Long-running implementations
+    // should poll request.isCancelled() and give up when it turns true.
+    virtual Move searchMove(const Board& board, const MoveRequest& request) = 0;
+    
+    // Cancels the outstanding request and waits for its search to return.
+    // Every concrete player calls this from its destructor, before
+    // searchMove's state goes.
+    void stopWorker();
+    
     std::string name_;
     PieceColor color_;
+    
+private:
+    std::shared_ptr<MoveRequest> pending_;
+    // Restored from each request's snapshot on the worker; reuses its
+    // pieces, so a game's requests allocate next to nothing
+    Board scratch_;
+    std::mutex search_mutex_;
+    std::condition_variable search_done_;
+    bool searching_ = false;
 };
 
 class HumanPlayer : public Player {
 public:
     HumanPlayer(const std::string& name, PieceColor color);
+    ~HumanPlayer() override;
     
-    Move getMove(const Board& board) override;
     bool isHuman() const override { return true; }
+    
+protected:
+    Move searchMove(const Board& board, const MoveRequest& request) override;
+};
+
+class ComputerPlayer : public Player {
+public:
+    ComputerPlayer(const std::string& name, PieceColor color, unsigned seed = std::random_device{}());
+    ~ComputerPlayer() override;
+    
+    bool isHuman() const override { return false; }
+    
+    void setOpeningBook(std::shared_ptr<const PolyglotBook> book, BookSelection selection = BookSelection::WEIGHTED);
+    const PolyglotBook* getOpeningBook() const { return book_.get(); }
+    
+protected:
+    Move searchMove(const Board& board, const MoveRequest& request) override;
+    
+    // Called when the book has no move for the position; picks a random legal move
+    virtual Move chooseMove(const Board& board, const MoveRequest& request);
+    
+    std::vector<std::pair<Position, Position>> legalMoves(const Board& board) const;
+    
+    std::mt19937 rng_;
+    
+private:
+    std::shared_ptr<const PolyglotBook> book_;
+    BookSelection book_selection_;
+    
+    bool isLegal(const Board& board, const Position& from, const Position& to) const;
 };
\ No newline at end of file
@@ -0,0 +1,66 @@
+#pragma once
+
+#include "Position.h"
+#include "Move.h"
+#include "utils/MappedFile.h"
+#include <cstdint>
+#include <optional>
+#include <random>
+#include <string>
+#include <vector>
+
+class Board;
+
+enum class BookSelection {
+    BEST,
+    WEIGHTED,
+    RANDOM
+};
+
+struct BookEntry {
+    uint64_t key;
+    uint16_t move;
+    uint16_t weight;
+    uint32_t learn;
+};
+
+struct BookMove {
+    Position from;
+    Position to;
+    PieceType promotion;
+    bool isPromotion;
+    uint16_t weight;
+    
+    Move toMove() const;
+};
+
+// Read-only view over a Polyglot .bin book. The file is memory-mapped and
+// searched in place, so opening a large book costs no reads up front.
+class PolyglotBook {
+public:
+    static constexpr size_t ENTRY_SIZE = 16;
+    
+    PolyglotBook() = default;
+    explicit PolyglotBook(const std::string& path);
+    
+    bool open(const std::string& path);
+    void close();
+    bool isOpen() const { return file_.isOpen(); }
+    size_t size() const { return file_.size() / ENTRY_SIZE; }
+    
+    BookEntry entryAt(size_t index) const;
+    std::vector<BookEntry> findEntries(uint64_t key) const;
+    
+    std::vector<BookMove> lookup(const Board& board, PieceColor sideToMove) const;
+    std::optional<BookMove> pickMove(const Board& board, PieceColor sideToMove,
+                                     BookSelection selection, std::mt19937& rng) const;
+    
+    static BookMove decodeMove(uint16_t move, uint16_t weight, const Board& board);
+    static uint16_t encodeMove(const Position& from, const Position& to, std::optional<PieceType> promotion);
+    static void writeEntry(unsigned char* out, const BookEntry& entry);
+    
+private:
+    MappedFile file_;
+    
+    uint64_t keyAt(size_t index) const;
+};
\ No newline at end of file
@@ -39,5 +39,15 @@ enum class GameStatus {
     CHECK,
     CHECKMATE,
     STALEMATE,
-    DRAW
+    DRAW,
+    TIME_FORFEIT    // The side to move ran out of time
+};
+
+enum class DrawReason {
+    NONE,
+    FIFTY_MOVE_RULE,
+    THREEFOLD_REPETITION,
+    INSUFFICIENT_MATERIAL,
+    AGREEMENT,
+    TIMEOUT_VS_INSUFFICIENT_MATERIAL    // Flag fell against a bare king
 };
\ No newline at end of file
@@ -0,0 +1,63 @@
+#pragma once
+
+#include "PositionSnapshot.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Operations the batch kernels implement (src/core/BatchKernels.h)
+enum class BatchOp;
+
+// Many positions packed as structure-of-arrays bitboards: one array per
+// colour and piece type, indexed by position and padded to whole groups of
+// four. The kernels run the same bitboard code over four positions at once
+// with AVX2 when the CPU has it, or one at a time otherwise, and answer
+// exactly as PositionSnapshot and Game do for each position on its own.
+class PositionBatch {
+public:
+    static constexpr size_t GROUP = 4;
+
+    enum class Kernel {
+        SCALAR,
+        AVX2
+    };
+
+    PositionBatch();
+
+    void reserve(size_t positions);
+    void clear();
+    void add(const PositionSnapshot& position);
+    size_t size() const { return size_; }
+
+    static bool hasAvx2();
+    Kernel getKernel() const { return kernel_; }
+    // False, keeping the current kernel, when the CPU lacks AVX2
+    bool setKernel(Kernel kernel);
+
+    // Each kernel writes one value per position, in the order added
+
+    // Squares attacked by a colour, as PositionSnapshot::isAttacked
+    void attackMaps(PieceColor by, std::vector<uint64_t>& out) const;
+    // 1 when the side to move is in check
+    void inCheck(std::vector<uint8_t>& out) const;
+    // Legal moves for the side to move, counted as Game::getValidMoves
+    // returns them (a promotion is one move)
+    void legalMoveCounts(std::vector<uint16_t>& out) const;
+    // White's material minus Black's, pawn 1, knight and bishop 3, rook 5,
+    // queen 9
+    void materialBalance(std::vector<int16_t>& out) const;
+
+private:
+    size_t size_ = 0;
+    Kernel kernel_ = Kernel::SCALAR;
+    // [colour][PieceType]
+    std::vector<uint64_t> pieces_[2][6];
+    // Pieces still on their first move: double pawn pushes and castling
+    std::vector<uint64_t> unmoved_;
+    std::vector<uint64_t> en_passant_;
+    // All ones when Black is to move
+    std::vector<uint64_t> black_to_move_;
+
+    // Runs the selected kernel over every group into a padded result array
+    std::vector<uint64_t> run(BatchOp op, PieceColor by = PieceColor::WHITE) const;
+};
\ No newline at end of file
@@ -0,0 +1,64 @@
+#pragma once
+
+#include "Position.h"
+#include "utils/MappedFile.h"
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+class Board;
+
+// One position reached in one game: ply 0 is the start position, ply n the
+// position after the nth move
+struct PositionRecord {
+    uint64_t key;
+    uint32_t gameId;
+    uint32_t ply;
+};
+
+// Sorted, memory-mapped (Zobrist key -> game, ply) index over a game
+// database. A 64K-entry fan-out table on the top key bits narrows each
+// lookup to a few records before the binary search, so a probe touches one
+// or two pages of a multi-gigabyte file.
+//
+// File layout (native byte order): "RCPI", version, game count, record
+// count, the fan-out table, then the records ordered by key, game and ply.
+class PositionIndex {
+public:
+    static constexpr int FANOUT_BITS = 16;
+    static constexpr size_t FANOUT_SIZE = size_t(1) << FANOUT_BITS;
+    
+    PositionIndex() = default;
+    explicit PositionIndex(const std::string& path);
+    
+    bool open(const std::string& path);
+    void close();
+    bool isOpen() const { return file_.isOpen(); }
+    
+    uint64_t gameCount() const { return game_count_; }
+    size_t size() const { return record_count_; }
+    
+    // All records for key as [first, last), ordered by game then ply
+    std::pair<const PositionRecord*, const PositionRecord*> find(uint64_t key) const;
+    std::vector<PositionRecord> lookup(const Board& board, PieceColor sideToMove) const;
+    
+    // Replays one game given as SAN move text and appends a record per ply.
+    // Returns false if a move did not resolve; the plies before it are kept.
+    static bool recordGame(std::string_view moveText, uint32_t gameId, std::vector<PositionRecord>& out);
+    
+    // Replays the games across the given number of threads and writes an
+    // index of them to outPath. With a base index the result also holds
+    // all of its records and the new games are numbered from
+    // base->gameCount(), so a database can be indexed incrementally.
+    // outPath may name the base file itself; it is replaced atomically.
+    static bool build(const std::vector<std::string>& games, const PositionIndex* base,
+                      const std::string& outPath, unsigned threads = 0, size_t* failedGames = nullptr);
+                      
+private:
+    MappedFile file_;
+    const uint64_t* fanout_ = nullptr;
+    const PositionRecord* records_ = nullptr;
+    uint64_t game_count_ = 0;
+    size_t record_count_ = 0;
+};
\ No newline at end of file
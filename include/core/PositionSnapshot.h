@@ -0,0 +1,70 @@
+#pragma once
+
+#include "Position.h"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+// A position as a 72-byte value: piece codes in the GameState layout (bits
+// 0-2 PieceType + 1, bit 3 black, bit 4 moved), side to move, en passant
+// square and clocks. Castling rights are the moved bits of kings and rooks,
+// as on Board. Copying one is a memcpy, so analysis code can fork and keep
+// thousands of branch points; Board and Game take and restore them.
+struct PositionSnapshot {
+    static constexpr uint8_t NO_SQUARE = 64;
+    static constexpr uint8_t BLACK_BIT = 8;
+    static constexpr uint8_t MOVED_BIT = 16;
+    
+    // Castling rights bits, in FEN order
+    static constexpr uint8_t WHITE_KINGSIDE = 1;
+    static constexpr uint8_t WHITE_QUEENSIDE = 2;
+    static constexpr uint8_t BLACK_KINGSIDE = 4;
+    static constexpr uint8_t BLACK_QUEENSIDE = 8;
+    
+    std::array<uint8_t, 64> squares;
+    uint8_t sideToMove;
+    uint8_t enPassant;
+    uint16_t halfmoveClock;
+    uint16_t fullmoveNumber;
+    uint8_t reserved[2];
+    
+    static uint8_t encode(PieceType type, PieceColor color, bool moved) {
+        return static_cast<uint8_t>((static_cast<int>(type) + 1) | (color == PieceColor::BLACK ? BLACK_BIT : 0) |
+                                    (moved ? MOVED_BIT : 0));
+    }
+    static bool isType(uint8_t code, PieceType type) { return (code & 7) == static_cast<int>(type) + 1; }
+    static bool isColor(uint8_t code, PieceColor color) {
+        return code && ((code & BLACK_BIT) != 0) == (color == PieceColor::BLACK);
+    }
+    
+    // The standard starting position, white to move
+    static PositionSnapshot initial();
+    
+    PieceColor side() const { return sideToMove ? PieceColor::BLACK : PieceColor::WHITE; }
+    
+    bool operator==(const PositionSnapshot& other) const;
+    bool operator!=(const PositionSnapshot& other) const { return !(*this == other); }
+    
+    // Square of color's king, or -1
+    int kingSquare(PieceColor color) const;
+    
+    // Whether a piece of color attacks square, by the same rules as Board
+    bool isAttacked(int square, PieceColor by) const;
+    bool isInCheck(PieceColor color) const;
+    
+    // Squares the piece on square may move to, exactly as Game's legal
+    // targets for it, quirks of Board's rules included; whose turn it is
+    // does not matter. Probes copies of this snapshot, so nothing allocates.
+    uint64_t legalTargets(int square) const;
+    bool hasLegalMove(PieceColor color) const;
+    
+    uint8_t castlingRights() const;
+    
+    // Writes the FEN into buffer like snprintf: truncated to size - 1
+    // characters plus a NUL, returning the full length
+    size_t writeFEN(char* buffer, size_t size) const;
+};
+
+static_assert(std::is_trivially_copyable<PositionSnapshot>::value, "snapshots are copied with memcpy");
+static_assert(sizeof(PositionSnapshot) == 72, "snapshot layout changed");
\ No newline at end of file
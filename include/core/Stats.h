@@ -0,0 +1,187 @@
+#pragma once
+
+#include "Trace.h"
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <ostream>
+
+// Hot-path counters and latency histograms for the move generator. Each
+// thread bumps its own block without synchronisation and snapshot() sums
+// the live blocks plus those of threads that have exited. Unless the build
+// sets CHESS_STATS (cmake -DCHESS_STATS=ON), the CHESS_STAT and
+// CHESS_LATENCY macros expand to nothing and every snapshot reads zero.
+namespace Stats {
+#ifdef CHESS_STATS
+    constexpr bool ENABLED = true;
+#else
+    constexpr bool ENABLED = false;
+#endif
+
+    enum class Counter {
+        BOARD_COPIES,
+        PIECE_CLONES,
+        POSSIBLE_MOVES_CALLS,
+        CHECK_PROBES,
+        LEGAL_MOVES_GENERATED,
+        STATUS_UPDATES,
+        STATUS_UPDATE_NANOS,
+        COUNT
+    };
+    
+    constexpr int COUNTER_COUNT = static_cast<int>(Counter::COUNT);
+    
+    struct Snapshot {
+        uint64_t values[COUNTER_COUNT] = {};
+        
+        uint64_t operator[](Counter counter) const { return values[static_cast<int>(counter)]; }
+        Snapshot operator-(const Snapshot& earlier) const;
+    };
+    
+    enum class Operation {
+        MAKE_MOVE,
+        UPDATE_STATUS,
+        VALID_MOVES,
+        GET_MOVE,
+        COUNT
+    };
+    
+    constexpr int OPERATION_COUNT = static_cast<int>(Operation::COUNT);
+    
+    // HDR-style log-bucketed histogram of nanosecond latencies: exact below
+    // 16 ns, then 16 linear buckets per power of two, so a percentile is
+    // reported within 1/16 of the true value over the whole 64-bit range
+    class Histogram {
+    public:
+        static constexpr int SUB_BUCKET_BITS = 4;
+        static constexpr int SUB_BUCKETS = 1 << SUB_BUCKET_BITS;
+        static constexpr int BUCKET_COUNT = (64 - SUB_BUCKET_BITS + 1) * SUB_BUCKETS;
+        
+        static int bucketIndex(uint64_t nanos) {
+            if (nanos < SUB_BUCKETS) return static_cast<int>(nanos);
+            int exponent = 63 - __builtin_clzll(nanos);
+            int shift = exponent - SUB_BUCKET_BITS;
+            return (shift + 1) * SUB_BUCKETS + static_cast<int>((nanos >> shift) & (SUB_BUCKETS - 1));
+        }
+        
+        // Largest latency that lands in the bucket
+        static uint64_t bucketUpperBound(int index);
+        
+        void record(uint64_t nanos);
+        void merge(const Histogram& other);
+        
+        // Folds in a per-thread block of bucket counts
+        void merge(const std::atomic<uint64_t>* counts, uint64_t sum, uint64_t max);
+        
+        uint64_t count() const { return count_; }
+        uint64_t max() const { return max_; }
+        double mean() const { return count_ ? static_cast<double>(sum_) / count_ : 0.0; }
+        
+        // Upper bound of the bucket holding the p-th fraction, capped at max()
+        uint64_t percentile(double p) const;
+        
+        uint64_t buckets[BUCKET_COUNT] = {};
+        
+    private:
+        uint64_t count_ = 0;
+        uint64_t sum_ = 0;
+        uint64_t max_ = 0;
+    };
+    
+    const char* counterName(Counter counter);
+    const char* operationName(Operation operation);
+    
+    Snapshot snapshot();
+    Histogram latency(Operation operation);
+    
+    // Zeroes every counter; call while no other thread is counting
+    void reset();
+    
+    // One line per counter, the average status update time and, for each
+    // timed operation, p50/p99/p99.9 and max in microseconds
+    void print(std::ostream& out, const Snapshot& stats);
+    
+    namespace detail {
+        struct ThreadCounters {
+            // Written only by the owning thread; atomic so snapshot() may read
+            std::atomic<uint64_t> values[COUNTER_COUNT];
+            std::atomic<uint64_t> latency[OPERATION_COUNT][Histogram::BUCKET_COUNT];
+            std::atomic<uint64_t> latencySum[OPERATION_COUNT];
+            std::atomic<uint64_t> latencyMax[OPERATION_COUNT];
+            
+            ThreadCounters();
+            ~ThreadCounters();
+        };
+        
+        inline ThreadCounters& local() {
+            thread_local ThreadCounters counters;
+            return counters;
+        }
+    }
+    
+    inline void add(Counter counter, uint64_t amount = 1) {
+        auto& value = detail::local().values[static_cast<int>(counter)];
+        value.store(value.load(std::memory_order_relaxed) + amount, std::memory_order_relaxed);
+    }
+    
+    inline void recordLatency(Operation operation, uint64_t nanos) {
+        auto& counters = detail::local();
+        int op = static_cast<int>(operation);
+        auto& bucket = counters.latency[op][Histogram::bucketIndex(nanos)];
+        bucket.store(bucket.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        auto& sum = counters.latencySum[op];
+        sum.store(sum.load(std::memory_order_relaxed) + nanos, std::memory_order_relaxed);
+        if (nanos > counters.latencyMax[op].load(std::memory_order_relaxed)) {
+            counters.latencyMax[op].store(nanos, std::memory_order_relaxed);
+        }
+    }
+    
+    // Records its lifetime in the operation's histogram; the traced span
+    // comes from CHESS_TRACE_SPAN next to it
+    class ScopedLatency {
+    public:
+        explicit ScopedLatency(Operation operation)
+            : operation_(operation), start_(Trace::Clock::now()) {}
+        ~ScopedLatency() {
+            auto elapsed = Trace::Clock::now() - start_;
+            recordLatency(operation_, static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count()));
+        }
+        
+        ScopedLatency(const ScopedLatency&) = delete;
+        ScopedLatency& operator=(const ScopedLatency&) = delete;
+        
+    private:
+        Operation operation_;
+        Trace::Clock::time_point start_;
+    };
+    
+    // Adds its lifetime in nanoseconds to a counter
+    class ScopedTimer {
+    public:
+        explicit ScopedTimer(Counter counter)
+            : counter_(counter), start_(std::chrono::steady_clock::now()) {}
+        ~ScopedTimer() {
+            auto elapsed = std::chrono::steady_clock::now() - start_;
+            add(counter_, static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count()));
+        }
+        
+        ScopedTimer(const ScopedTimer&) = delete;
+        ScopedTimer& operator=(const ScopedTimer&) = delete;
+        
+    private:
+        Counter counter_;
+        std::chrono::steady_clock::time_point start_;
+    };
+}
+
+#ifdef CHESS_STATS
+#define CHESS_STAT(counter) ::Stats::add(::Stats::Counter::counter)
+#define CHESS_STAT_ADD(counter, amount) ::Stats::add(::Stats::Counter::counter, (amount))
+#define CHESS_STAT_TIMER(counter) ::Stats::ScopedTimer chessStatTimer_##counter(::Stats::Counter::counter)
+#define CHESS_LATENCY(operation) ::Stats::ScopedLatency chessLatency_##operation(::Stats::Operation::operation)
+#else
+#define CHESS_STAT(counter) ((void)0)
+#define CHESS_STAT_ADD(counter, amount) ((void)0)
+#define CHESS_STAT_TIMER(counter) ((void)0)
+#define CHESS_LATENCY(operation) ((void)0)
+#endif
\ No newline at end of file
@@ -0,0 +1,76 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+// Hashed hierarchical timer wheel: four levels of 64 slots over a fixed
+// tick (1 ms by default, so the top level spans about 4.6 hours; later
+// deadlines wait there and are re-filed as it turns). Arm and cancel are
+// O(1); advancing visits one level-0 slot per tick and, every 64 ticks,
+// spreads one higher slot over the levels below. Timers fire no earlier
+// than their deadline and at most one tick after it, in batches returned
+// from advance(). Not thread-safe: callers serialise access.
+class TimerWheel {
+public:
+    using Clock = std::chrono::steady_clock;
+    // Names one armed timer; goes stale once it fires or is cancelled
+    using Handle = uint64_t;
+    static constexpr Handle NO_TIMER = 0;
+    
+    explicit TimerWheel(Clock::time_point start = Clock::now(),
+                        Clock::duration tick = std::chrono::milliseconds(1));
+    
+    // Arms a timer that reports tag once deadline has passed; deadlines
+    // already in the past fire on the next advance
+    Handle arm(uint64_t tag, Clock::time_point deadline);
+    // False if the timer already fired or was cancelled
+    bool cancel(Handle handle);
+    
+    // Moves the wheel forward to now, appending the tag of every timer due by
+    // then to fired; returns how many were appended
+    size_t advance(Clock::time_point now, std::vector<uint64_t>& fired);
+    
+    // Latest time a caller may sleep until without firing anything late: the
+    // first occupied level-0 slot or the next cascade, whichever is sooner.
+    // Empty when no timers are armed.
+    std::optional<Clock::time_point> nextWakeup() const;
+    
+    size_t size() const { return armed_; }
+    
+private:
+    static constexpr int LEVELS = 4;
+    static constexpr int SLOT_BITS = 6;
+    static constexpr uint32_t SLOTS = 1u << SLOT_BITS;
+    static constexpr uint32_t SLOT_MASK = SLOTS - 1;
+    static constexpr uint32_t HEADS = LEVELS * SLOTS;
+    static constexpr uint64_t SPAN = uint64_t{1} << (SLOT_BITS * LEVELS);
+    
+    // nodes_[0, HEADS) are the circular list heads of the slots; timers are
+    // pooled after them and recycled through free_
+    struct Node {
+        uint64_t tag = 0;
+        uint64_t expiry = 0;
+        uint32_t prev = 0;
+        uint32_t next = 0;
+        uint32_t generation = 1;
+        bool armed = false;
+    };
+    
+    Clock::time_point start_;
+    Clock::duration tick_;
+    uint64_t now_tick_ = 0;
+    size_t armed_ = 0;
+    std::vector<Node> nodes_;
+    std::vector<uint32_t> free_;
+    
+    static uint32_t head(int level, uint32_t slot) { return static_cast<uint32_t>(level) * SLOTS + slot; }
+    bool isEmpty(uint32_t list) const { return nodes_[list].next == list; }
+    Clock::time_point tickTime(uint64_t tick) const { return start_ + tick_ * static_cast<int64_t>(tick); }
+    
+    void insert(uint32_t node, uint64_t earliest);
+    void unlink(uint32_t node);
+    void release(uint32_t node);
+    void cascade(int level, uint32_t slot);
+};
\ No newline at end of file
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+// Scoped-span tracer writing Chrome trace-event JSON, which chrome://tracing
+// and Perfetto open directly. While no trace is running a span costs one
+// atomic load, so CHESS_TRACE_SPAN stays compiled in whether or not the
+// build counts Stats. Spans are buffered per thread, up to
+// MAX_SPANS_PER_THREAD.
+namespace Trace {
+    using Clock = std::chrono::steady_clock;
+    
+    constexpr size_t MAX_SPANS_PER_THREAD = 1 << 20;
+    
+    namespace detail {
+        extern std::atomic<bool> active;
+    }
+    
+    inline bool isActive() {
+        return detail::active.load(std::memory_order_acquire);
+    }
+    
+    // Discards earlier spans and starts recording
+    void start();
+    
+    // Stops recording and writes the spans to path; false if it cannot be
+    // written. Spans past the per-thread cap are counted, not kept.
+    bool stop(const std::string& path, uint64_t* droppedSpans = nullptr);
+    
+    // name must outlive the trace; string literals and operation names do
+    void record(const char* name, Clock::time_point start, Clock::duration duration);
+    
+    class Span {
+    public:
+        explicit Span(const char* name)
+            : name_(isActive() ? name : nullptr) {
+            if (name_) start_ = Clock::now();
+        }
+        ~Span() {
+            if (name_) record(name_, start_, Clock::now() - start_);
+        }
+        
+        Span(const Span&) = delete;
+        Span& operator=(const Span&) = delete;
+        
+    private:
+        const char* name_;
+        Clock::time_point start_;
+    };
+}
+
+#define CHESS_TRACE_SPAN(name) ::Trace::Span chessTraceSpan(name)
\ No newline at end of file
@@ -0,0 +1,103 @@
+#pragma once
+
+#include "PositionSnapshot.h"
+#include "utils/MappedFile.h"
+#include <atomic>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
+
+// A labelled position in 32 bytes: the occupancy bitboard, one 4-bit piece
+// code per occupied square in square order (PositionSnapshot's low bits:
+// PieceType + 1, 8 for black), the side to move, castling rights, en passant
+// square, clocks and how the game it came from ended.
+struct PackedPosition {
+    static constexpr uint8_t BLACK_TO_MOVE = 1;
+    
+    uint64_t occupancy;
+    uint8_t pieces[16];
+    uint8_t flags;              // BLACK_TO_MOVE, castling rights << 1
+    uint8_t enPassant;          // Square, or PositionSnapshot::NO_SQUARE
+    uint8_t halfmoveClock;      // Capped at 255
+    int8_t result;              // 1 White won, 0 drawn, -1 Black won
+    uint16_t fullmoveNumber;
+    uint16_t pliesToEnd;        // Capped at 65535
+    
+    // Empty for more than 32 pieces, which no game reaches
+    static std::optional<PackedPosition> pack(const PositionSnapshot& position, int result = 0, int pliesToEnd = 0);
+    // Moved flags are rebuilt as Game::loadFEN sets them: pawns off their
+    // home rank, and kings and rooks without castling rights
+    PositionSnapshot unpack() const;
+};
+
+static_assert(sizeof(PackedPosition) == 32, "training record layout changed");
+
+// Appends records to one file from many threads without a lock. Each thread
+// fills its own Buffer and flushes it with one pwrite at an offset reserved
+// by a single atomic add, so writers never wait on each other.
+//
+// File layout (native byte order): "RCTD", version, record size, reserved,
+// then the records.
+class TrainingDataWriter {
+public:
+    static constexpr size_t HEADER_SIZE = 16;
+    
+    class Buffer {
+    public:
+        // 1 MiB of records per write by default
+        explicit Buffer(TrainingDataWriter& writer, size_t records = 32768);
+        ~Buffer();
+        
+        Buffer(const Buffer&) = delete;
+        Buffer& operator=(const Buffer&) = delete;
+        
+        void add(const PackedPosition& position);
+        bool flush();
+        
+    private:
+        TrainingDataWriter& writer_;
+        std::vector<PackedPosition> records_;
+        size_t capacity_;
+    };
+    
+    TrainingDataWriter() = default;
+    ~TrainingDataWriter();
+    
+    TrainingDataWriter(const TrainingDataWriter&) = delete;
+    TrainingDataWriter& operator=(const TrainingDataWriter&) = delete;
+    
+    // Creates or truncates the file and writes the header
+    bool open(const std::string& path);
+    // False if any write failed; call once every Buffer has flushed
+    bool close();
+    
+    uint64_t size() const { return (end_.load() - HEADER_SIZE) / sizeof(PackedPosition); }
+    
+private:
+    int fd_ = -1;
+    std::atomic<uint64_t> end_{HEADER_SIZE};
+    std::atomic<bool> failed_{false};
+    
+    bool append(const void* data, size_t bytes);
+};
+
+// Memory-maps a file written by TrainingDataWriter
+class TrainingDataReader {
+public:
+    TrainingDataReader() = default;
+    explicit TrainingDataReader(const std::string& path);
+    
+    bool open(const std::string& path);
+    bool isOpen() const { return file_.isOpen(); }
+    
+    size_t size() const { return count_; }
+    const PackedPosition& operator[](size_t index) const { return records_[index]; }
+    const PackedPosition* begin() const { return records_; }
+    const PackedPosition* end() const { return records_ + count_; }
+    
+private:
+    MappedFile file_;
+    const PackedPosition* records_ = nullptr;
+    size_t count_ = 0;
+};
\ No newline at end of file
@@ -0,0 +1,26 @@
+#pragma once
+
+#include "Position.h"
+#include <cstdint>
+#include <string>
+
+class Board;
+
+// Position keys laid out as in the Polyglot book format: 768 piece-square
+// entries, 4 castling rights, 8 en passant files and the side to move.
+// The built-in values are Polyglot's Random64 constants, so keys match
+// third-party books as they are.
+namespace Zobrist {
+    constexpr int RANDOM_COUNT = 781;
+    
+    uint64_t hash(const Board& board, PieceColor sideToMove);
+    
+    uint64_t pieceKey(PieceType type, PieceColor color, const Position& pos);
+    uint64_t castleKey(int index);
+    uint64_t enPassantKey(int file);
+    uint64_t turnKey();
+    
+    // Replaces the built-in table with one read from a file of 781
+    // big-endian 64-bit words. Safe while other threads hash.
+    bool loadRandomTable(const std::string& path);
+}
\ No newline at end of file
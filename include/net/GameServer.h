@@ -0,0 +1,137 @@
+#pragma once
+
+#include "core/TimerWheel.h"
+#include "net/MoveLog.h"
+#include "net/Session.h"
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+struct ServerConfig {
+    std::string host = "0.0.0.0";
+    int port = 7878;
+    std::string unixPath;   // listens on a Unix socket instead of TCP when set
+    unsigned threads = 0;   // 0 = one worker per hardware thread
+    unsigned parkAfterSeconds = 0;  // park sessions idle this long, 0 = never
+    std::string logDirectory;       // write-ahead move log, off when empty
+    unsigned commitMicros = 2000;   // group commit window of the log
+    size_t checkpointRecords = 100000;
+    // Hold each MOVE reply and its notification until the log has synced
+    // the move; false answers at once and a crash may lose the last window
+    bool durableReplies = true;
+};
+
+// Hosts many Sessions over the line protocol in net/Protocol.h. A fixed set
+// of worker threads each run their own epoll loop; all of them wait on the
+// listening socket (EPOLLEXCLUSIVE) and own the connections they accept.
+// Flag-fall timers of timed games live in one TimerWheel per session shard,
+// advanced by the worker that also sweeps that shard for parking.
+// Spectators are served by a fan-out thread of their own, off the player
+// workers: every few milliseconds it reads new events from each watched
+// session's ring once, formats them once, and hands each spectator the lines
+// past its cursor.
+// With a log directory every session change goes through a MoveLog: start()
+// restores the sessions it recovers and checkpoints them, and a background
+// thread checkpoints again whenever enough records have piled up. A MOVE
+// reply is held on its connection, with everything after it, until the
+// flusher reports its record synced; the worker goes on serving meanwhile.
+// Should the log fail, connections with held replies are dropped instead.
+class GameServer {
+public:
+    explicit GameServer(const ServerConfig& config);
+    ~GameServer();
+    
+    GameServer(const GameServer&) = delete;
+    GameServer& operator=(const GameServer&) = delete;
+    
+    bool start();
+    void stop();
+    void wait();
+    
+    int getPort() const { return port_; }
+    size_t sessionCount() const;
+    size_t connectionCount() const { return connection_count_.load(); }
+    
+private:
+    struct Connection;
+    struct Worker;
+    struct WatchGroup;
+    
+    template <typename T>
+    struct Shard {
+        mutable std::mutex mutex;
+        std::unordered_map<uint64_t, std::shared_ptr<T>> items;
+    };
+    static constexpr size_t SHARD_COUNT = 64;
+    
+    struct ClockShard {
+        std::mutex mutex;
+        TimerWheel wheel;
+        std::unordered_map<uint32_t, TimerWheel::Handle> timers;
+    };
+    
+    ServerConfig config_;
+    int listen_fd_;
+    int port_;
+    std::atomic<bool> running_;
+    std::atomic<uint32_t> next_session_id_;
+    std::atomic<uint64_t> next_connection_id_;
+    std::atomic<size_t> connection_count_;
+    std::vector<std::unique_ptr<Worker>> workers_;
+    std::unique_ptr<MoveLog> log_;
+    Shard<Session> sessions_[SHARD_COUNT];
+    Shard<Connection> connections_[SHARD_COUNT];
+    ClockShard clocks_[SHARD_COUNT];
+    std::mutex watch_mutex_;
+    std::condition_variable watch_cv_;
+    std::unordered_map<uint32_t, std::shared_ptr<WatchGroup>> watching_;
+    std::thread spectator_thread_;
+    std::mutex checkpoint_mutex_;
+    std::condition_variable checkpoint_cv_;
+    std::thread checkpoint_thread_;
+    std::mutex holding_mutex_;
+    std::vector<std::weak_ptr<Connection>> holding_;   // Connections with held output
+    
+    bool openListener();
+    bool openLog();
+    void checkpoint();
+    void checkpointLoop();
+    void workerLoop(Worker& worker);
+    void acceptConnections(Worker& worker);
+    void handleReadable(Worker& worker, const std::shared_ptr<Connection>& connection);
+    void handleWritable(Connection& connection);
+    void closeConnection(Worker& worker, int fd);
+    void parkIdleSessions(const Worker& worker);
+    // Re-arms the session's flag timer from its clock and wakes the worker
+    // that advances its wheel
+    void syncClockTimer(const Session& session);
+    void fireClockTimers(const Worker& worker);
+    int clockTimeout(const Worker& worker);
+    std::string watch(Connection& connection, const std::shared_ptr<Session>& session);
+    std::string unwatch(Connection& connection, uint32_t id);
+    void spectatorLoop();
+    // False once the group is finished with: its session closed or its
+    // spectators all left
+    bool fanOut(uint32_t id, WatchGroup& group);
+    size_t pendingOutput(Connection& connection);
+    
+    // Sets lsn when the reply has to wait for that record to be durable
+    std::string handleLine(Connection& connection, const std::string& line, uint64_t& lsn);
+    void deliver(Connection& connection, const std::string& data, uint64_t lsn = MoveLog::NO_LSN);
+    void notify(uint64_t connectionId, const std::string& line, uint64_t lsn = MoveLog::NO_LSN);
+    // Both need the connection's output_mutex held
+    void send(Connection& connection, const std::string& data);
+    // Once the log has failed, drops a connection still holding a reply
+    void release(Connection& connection, uint64_t durable, bool failed);
+    // Flusher callback: sends whatever the sync made durable
+    void releaseHeld(uint64_t durable);
+    
+    std::shared_ptr<Session> findSession(uint32_t id);
+    void eraseSession(uint32_t id);
+};
\ No newline at end of file
@@ -0,0 +1,157 @@
+#pragma once
+
+#include "core/GameClock.h"
+#include "core/GameState.h"
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+
+// One session change in 16 bytes. Records are numbered by their position in
+// the log (the LSN), which is not stored: each segment file records the LSN
+// of its first record.
+struct MoveRecord {
+    enum Type : uint8_t {
+        NEW,        // detail: 1 for a solo session, 2 for a delay clock; a timed
+                    // session's extra seconds are from + 256 * to
+        MOVE,       // detail: promotion PieceType + 1, or 0 when none was given
+        UNDO,
+        RESIGN,     // detail: PieceColor that resigned
+        FLAG,       // detail: PieceColor whose flag fell (the side to move)
+        CLOSE
+    };
+    
+    uint32_t session;
+    Type type;
+    uint8_t from;       // row * 8 + col
+    uint8_t to;
+    uint8_t detail;
+    // NEW: base seconds of a timed session. MOVE and UNDO: milliseconds left
+    // on the clock that was just charged, the mover's or the undoer's
+    // opponent's
+    uint32_t clock;
+    uint32_t checksum;  // CRC-32 of the first 12 bytes
+};
+
+static_assert(sizeof(MoveRecord) == 16, "move record layout changed");
+
+struct MoveLogConfig {
+    std::string directory;
+    // Group commit window: appends within it share one write and one
+    // fdatasync. Zero syncs each batch as soon as the flusher wakes.
+    std::chrono::microseconds commitInterval{2000};
+    // Records after which checkpointDue() turns true
+    size_t checkpointRecords = 100000;
+    // Called on the flusher, without the log's lock, after each sync with
+    // the new durableLsn(), and with UINT64_MAX once the log has failed
+    std::function<void(uint64_t)> onDurable;
+};
+
+// A timed session's clock as the log keeps it: the time each side had left
+// when it last pressed; the turn in progress at a crash is not charged
+struct LoggedClock {
+    TimeControl control;
+    std::chrono::milliseconds remaining[2];     // White, black
+};
+
+// A session as rebuilt by recovery, in the form Session parks games
+struct RecoveredSession {
+    uint32_t id;
+    bool solo;
+    GameState state;
+    std::optional<LoggedClock> clock{};
+};
+
+// Session state that a checkpoint stores: the game and the LSN of the
+// session's last record, so replay skips what the state already includes
+struct CheckpointEntry {
+    uint32_t id;
+    bool solo;
+    uint64_t lastLsn;           // UINT64_MAX when the session has no record yet
+    std::vector<uint8_t> state; // GameState::serialize()
+    std::optional<LoggedClock> clock{};
+};
+
+// Write-ahead log of session changes with group commit. append() only
+// copies the record into a buffer under a short lock and returns its LSN;
+// a flusher thread writes the buffer out and fdatasyncs it once per commit
+// window, so any number of moves in a window cost one sync. A record is
+// durable once durableLsn() has passed it.
+//
+// Layout of the directory: segments wal-<n>.log ("RCWL", version, segment,
+// first LSN, then records) and a checkpoint file ("RCCP", version, first
+// segment to replay and its first LSN, session count, then per session id,
+// solo, last LSN, a timed flag followed by base, increment, delay and both
+// sides' time left in milliseconds when set, state size and state, and a
+// CRC-32 of it all). A checkpoint rotates to a fresh segment first, so every older segment is
+// covered by it and is deleted afterwards; recovery reads the checkpoint and
+// replays only the segments from there on.
+class MoveLog {
+public:
+    static constexpr uint64_t NO_LSN = UINT64_MAX;
+    
+    explicit MoveLog(const MoveLogConfig& config);
+    ~MoveLog();
+    
+    MoveLog(const MoveLog&) = delete;
+    MoveLog& operator=(const MoveLog&) = delete;
+    
+    // Rebuilds every open session from the checkpoint and the segments after
+    // it by replaying the records through Game, then starts a new segment
+    // and the flusher. A torn or corrupt record ends its segment.
+    bool open(std::vector<RecoveredSession>& recovered);
+    // Flushes what is buffered and stops the flusher
+    void close();
+    
+    uint64_t append(const MoveRecord& record);
+    uint64_t durableLsn() const;
+    // Blocks until the record with this LSN is on disk; false if the log
+    // failed or closed first
+    bool waitDurable(uint64_t lsn);
+    bool failed() const;
+    
+    bool checkpointDue() const;
+    // Starts a new segment and returns once the flusher has switched to it;
+    // states collected after this cover every record in older segments
+    bool beginCheckpoint();
+    // Writes the checkpoint atomically and deletes the segments it covers
+    bool writeCheckpoint(const std::vector<CheckpointEntry>& sessions);
+    
+    static MoveRecord makeRecord(uint32_t session, MoveRecord::Type type, uint8_t from = 0, uint8_t to = 0,
+                                 uint8_t detail = 0, uint32_t clock = 0);
+    static MoveRecord makeNewRecord(uint32_t session, bool solo, const std::optional<TimeControl>& control);
+    // Milliseconds as MOVE and UNDO records carry them
+    static uint32_t clockMillis(std::chrono::steady_clock::duration left);
+    
+private:
+    MoveLogConfig config_;
+    mutable std::mutex mutex_;
+    std::condition_variable work_;
+    std::condition_variable durable_;
+    std::vector<MoveRecord> pending_;
+    std::thread flusher_;
+    int fd_ = -1;
+    uint32_t segment_ = 0;
+    uint32_t checkpoint_segment_ = 0;   // First segment the next recovery replays
+    uint64_t checkpoint_lsn_ = 0;       // and the LSN it starts at
+    uint64_t next_lsn_ = 0;
+    uint64_t durable_lsn_ = 0;          // Records below this are on disk
+    size_t since_checkpoint_ = 0;
+    bool rotate_ = false;
+    bool stopping_ = false;
+    bool failed_ = false;
+    bool open_ = false;
+    bool exited_ = false;               // The flusher has stopped
+    
+    std::string segmentPath(uint32_t segment) const;
+    std::string checkpointPath() const;
+    int createSegment(uint32_t segment, uint64_t firstLsn);
+    bool syncDirectory() const;
+    void flushLoop();
+    bool recover(std::vector<RecoveredSession>& recovered);
+};
\ No newline at end of file
@@ -0,0 +1,68 @@
+#pragma once
+
+#include "core/GameClock.h"
+#include "core/Position.h"
+#include <cstdint>
+#include <optional>
+#include <string>
+
+// Line-based wire protocol. Each request and reply is one '\n'-terminated
+// line of space-separated tokens:
+//
+//   NEW [solo] [clock]   -> GAME <id> <white|both>
+//   JOIN <id>            -> JOINED <id> black
+//   MOVE <id> <e2e4[q]>  -> OK <id> <ply> <status>   | ERR <id> <reason>
+//   STATE <id>           -> STATE <id> <state> <status> <fen>
+//   UNDO <id>            -> OK <id> <ply> <status>   (solo games only)
+//   RESIGN <id>          -> OK <id> <ply> <status>
+//   CLOCK <id>           -> CLOCK <id> <white ms> <black ms> <white|black|none>
+//   CLOSE <id>           -> CLOSED <id>
+//   WATCH <id>           -> WATCHING <id> <seq> <state> <status> <fen>
+//   UNWATCH <id>         -> UNWATCHED <id>
+//   PING                 -> PONG
+//
+// The opponent's connection receives "MOVED <id> <move> <status>" pushes,
+// and "ABANDONED <id>" when a player disconnects mid-game and forfeits.
+// A clock is "<base>+<increment>" or "<base>d<delay>" in seconds (e.g.
+// 300+2); timed games start white's clock once both players are in and push
+// "FLAG <id> <white|black> <status>" to both players when a flag falls.
+//
+// Spectators receive "EVENT <id> <seq> <kind> [move|color] <ply> <status>"
+// for JOIN, MOVE, UNDO, RESIGN and FLAG, numbered from the <seq> of their
+// WATCHING line, and a final "EVENT <id> <seq> CLOSED". One that falls too
+// far behind gets "SYNC <id> <seq> <state> <status> <fen>" in place of the
+// events it missed and continues from there.
+namespace Protocol {
+    enum class CommandType {
+        NEW,
+        JOIN,
+        MOVE,
+        STATE,
+        UNDO,
+        RESIGN,
+        CLOSE,
+        CLOCK,
+        WATCH,
+        UNWATCH,
+        PING,
+        UNKNOWN
+    };
+    
+    struct Command {
+        CommandType type = CommandType::UNKNOWN;
+        uint32_t gameId = 0;
+        std::string argument;
+    };
+    
+    struct MoveText {
+        Position from;
+        Position to;
+        std::optional<PieceType> promotion;
+    };
+    
+    Command parseCommand(const std::string& line);
+    std::optional<MoveText> parseMove(const std::string& text);
+    std::optional<TimeControl> parseTimeControl(const std::string& text);
+    std::string formatMove(const Position& from, const Position& to, std::optional<PieceType> promotion);
+    const char* statusToken(GameStatus status);
+}
\ No newline at end of file
@@ -0,0 +1,161 @@
+#pragma once
+
+#include "core/EventRing.h"
+#include "core/Game.h"
+#include "core/GameState.h"
+#include "net/MoveLog.h"
+#include "net/Protocol.h"
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <vector>
+
+enum class SessionState {
+    WAITING,
+    PLAYING,
+    FINISHED
+};
+
+// What spectators see of a session, 8 bytes so the ring copies one word
+struct SpectatorEvent {
+    enum Kind : uint8_t {
+        JOIN,       // Black joined; the game starts
+        MOVE,
+        UNDO,
+        RESIGN,     // color resigned
+        FLAG,       // color's flag fell
+        CLOSED      // The session is gone; no further events
+    };
+    
+    Kind kind;
+    uint8_t from;           // row * 8 + col, MOVE only
+    uint8_t to;
+    uint8_t promotion;      // PieceType + 1, or 0
+    uint8_t status;         // GameStatus after the event
+    uint8_t color;          // PieceColor, RESIGN and FLAG only
+    uint16_t ply;
+};
+
+static_assert(sizeof(SpectatorEvent) == 8, "spectator event layout changed");
+
+// Where a spectator starts: the next event it should apply and the
+// position that event applies to
+struct SpectatorSnapshot {
+    uint64_t sequence;
+    std::string text;       // "<state> <status> <fen>"
+};
+
+struct SessionReply {
+    std::string text;
+    uint64_t notifyConnection = 0;
+    std::string notification{};
+    // The joiner took over a recovered session and now owns it
+    bool claimed = false;
+    // LSN of the record a MOVE reply reports, so the server can hold it
+    // until the log has synced it
+    uint64_t lsn = MoveLog::NO_LSN;
+    // Every player has left; the server can drop the session
+    bool vacated = false;
+};
+
+// One hosted game. A session starts WAITING for a second player (or PLAYING
+// straight away in solo mode, where one connection moves both sides) and
+// becomes FINISHED once the game ends or a player resigns. Idle sessions can
+// be parked as a compact GameState and are restored on their next request.
+// Timed sessions keep their Game live while the clock runs and never park.
+//
+// Every change is also published to a lock-free ring of SpectatorEvents,
+// under the session lock that already orders them, so the move path only
+// pays for a few stores however many spectators read the ring. Readers that
+// fall a ring's length behind resync from spectate().
+//
+// With a MoveLog every change is also appended to it under the same lock,
+// so a session's records are in the order its game saw them. Sessions the
+// log recovers come back without players: the first to join takes white
+// (both sides in solo mode) and ownership, the next one black. A timed one
+// comes back live with the time each side had left and restarts its clock
+// once both sides are in.
+class Session {
+public:
+    using Clock = std::chrono::steady_clock;
+    
+    Session(uint32_t id, uint64_t creator, bool solo, std::optional<TimeControl> control = std::nullopt,
+            MoveLog* log = nullptr);
+    // A session rebuilt by MoveLog recovery, parked until someone joins
+    Session(const RecoveredSession& recovered, MoveLog* log);
+    
+    uint32_t getId() const { return id_; }
+    SessionState getState() const;
+    bool isParticipant(uint64_t connection) const;
+    
+    SessionReply join(uint64_t connection);
+    SessionReply move(uint64_t connection, const Protocol::MoveText& move);
+    SessionReply undo(uint64_t connection);
+    SessionReply resign(uint64_t connection);
+    // A player's connection is gone: a game still in progress is forfeited to
+    // the opponent, who is told "ABANDONED <id>"
+    SessionReply leave(uint64_t connection);
+    SessionReply state();
+    SessionReply clock();
+    
+    bool isTimed() const { return timed_; }
+    // When the side to move's flag falls, if a clock is running
+    std::optional<Clock::time_point> flagTime() const;
+    // Ends the game if a flag has fallen by now and returns the FLAG line
+    // for both players
+    std::optional<std::string> checkFlag(Clock::time_point now);
+    std::vector<uint64_t> participants() const;
+    
+    // Consistent with events(): the snapshot already reflects every event
+    // before its sequence number
+    SpectatorSnapshot spectate() const;
+    const EventRing<SpectatorEvent>& events() const { return events_; }
+    static std::string formatEvent(uint32_t id, uint64_t sequence, const SpectatorEvent& event);
+    // Publishes CLOSED; the server calls it when it drops the session
+    void close();
+    bool isClosed() const { return closed_.load(std::memory_order_acquire); }
+    
+    bool park(Clock::time_point idleSince);
+    bool isParked() const;
+    std::vector<uint8_t> snapshot() const;
+    // State and last LSN for a checkpoint, taken under the session lock
+    CheckpointEntry checkpoint() const;
+    
+private:
+    uint32_t id_;
+    uint64_t white_;
+    uint64_t black_;
+    SessionState state_;
+    bool timed_;
+    bool solo_;
+    bool white_left_ = false;
+    bool black_left_ = false;
+    std::unique_ptr<Game> game_;
+    GameState parked_;
+    Clock::time_point last_active_;
+    EventRing<SpectatorEvent> events_;
+    std::atomic<bool> closed_{false};
+    MoveLog* log_;
+    uint64_t last_lsn_ = MoveLog::NO_LSN;
+    mutable std::mutex mutex_;
+    
+    Game& game();
+    std::string ok() const;
+    std::string error(const char* reason) const;
+    std::string flagLine() const;
+    uint64_t ownerOf(PieceColor color) const;
+    uint64_t opponentOf(uint64_t connection) const;
+    void publish(SpectatorEvent::Kind kind, PieceColor color = PieceColor::WHITE);
+    void publishMove(const Protocol::MoveText& move);
+    uint64_t record(MoveRecord::Type type, uint8_t from = 0, uint8_t to = 0, uint8_t detail = 0,
+                    uint32_t clock = 0);
+    uint64_t append(const MoveRecord& record);
+    // Milliseconds left on side's clock for a record, 0 when untimed
+    uint32_t clockMillis(PieceColor side) const;
+};
+
+const char* sessionStateToken(SessionState state);
\ No newline at end of file
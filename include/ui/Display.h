@@ -2,14 +2,21 @@
 
 #include "core/Board.h"
 #include "core/Game.h"
+#include <array>
 #include <string>
 
+// The board is drawn diff-based: the first frame repaints the screen, later
+// frames only rewrite the squares that changed (via cursor positioning) and
+// clear the text below the board. Each frame is built in one reused buffer
+// and written with a single flush.
 class Display {
 public:
     Display();
     ~Display() = default;
     
     void showBoard(const Board& board) const;
+    const std::string& renderBoard(const Board& board) const;
+    void invalidate() const { frame_valid_ = false; }
     void showGameStatus(const Game& game) const;
     void showMoveHistory(const Game& game) const;
     void showValidMoves(const std::vector<Position>& moves) const;
@@ -24,9 +31,18 @@ public:
     void displayPrompt(const std::string& prompt) const;
     
 private:
+    // Screen line of rank 8 and column of the a-file, both 1-based
+    static constexpr int BOARD_TOP_LINE = 4;
+    static constexpr int BOARD_LEFT_COLUMN = 5;
+    static constexpr int BOARD_BOTTOM_LINE = 15;
+    
+    mutable std::string frame_;
+    mutable std::array<char, 64> shown_{};
+    mutable bool frame_valid_ = false;
+    
+    void appendSquare(std::string& out, const Piece* piece, int row, int col) const;
+    
     std::string positionToString(const Position& pos) const;
     std::string pieceToUnicode(const Piece* piece) const;
-    std::string getSquareColor(int row, int col) const;
-    void printBoardHeader() const;
-    void printBoardFooter() const;
+    const char* getSquareColor(int row, int col) const;
 };
\ No newline at end of file
@@ -3,29 +3,54 @@
 #include "core/Position.h"
 #include "core/Move.h"
 #include <string>
+#include <string_view>
 #include <optional>
 
+enum class InputCommand {
+    EMPTY,
+    MOVE,
+    QUIT,
+    HELP,
+    UNDO,
+    DRAW,
+    RESIGN,
+    INVALID
+};
+
+// Result of classifying one input line; from, to and promotion are only
+// meaningful for MOVE
+struct ParsedInput {
+    InputCommand command = InputCommand::EMPTY;
+    Position from;
+    Position to;
+    std::optional<PieceType> promotion;
+};
+
 class InputParser {
 public:
     InputParser() = default;
     ~InputParser() = default;
     
-    std::optional<std::pair<Position, Position>> parseMove(const std::string& input) const;
-    std::optional<Position> parsePosition(const std::string& input) const;
-    std::optional<PieceType> parsePromotionPiece(const std::string& input) const;
+    // Single pass over the line without allocating: trims, matches commands
+    // case-insensitively and parses moves such as e2e4, e2-e4 or e7e8q
+    ParsedInput classify(std::string_view input) const;
+    
+    std::optional<std::pair<Position, Position>> parseMove(std::string_view input) const;
+    std::optional<Position> parsePosition(std::string_view input) const;
+    std::optional<PieceType> parsePromotionPiece(std::string_view input) const;
     
-    bool isQuitCommand(const std::string& input) const;
-    bool isHelpCommand(const std::string& input) const;
-    bool isUndoCommand(const std::string& input) const;
-    bool isDrawCommand(const std::string& input) const;
-    bool isResignCommand(const std::string& input) const;
+    bool isQuitCommand(std::string_view input) const;
+    bool isHelpCommand(std::string_view input) const;
+    bool isUndoCommand(std::string_view input) const;
+    bool isDrawCommand(std::string_view input) const;
+    bool isResignCommand(std::string_view input) const;
     
     std::string getUserInput() const;
     std::string getPlayerName(PieceColor color) const;
     
 private:
-    bool isValidSquare(const std::string& square) const;
-    Position squareToPosition(const std::string& square) const;
-    std::string trim(const std::string& str) const;
-    std::string toLower(const std::string& str) const;
+    bool isValidSquare(std::string_view square) const;
+    Position squareToPosition(std::string_view square) const;
+    std::string_view trim(std::string_view str) const;
+    bool equalsIgnoreCase(std::string_view str, std::string_view lower) const;
 };
\ No newline at end of file
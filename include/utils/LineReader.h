@@ -0,0 +1,48 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Reads a file or pipe line by line with large read(2) calls instead of
+// per-line stream extraction. Lines are returned as views into the internal
+// buffer without the trailing newline (or \r\n) and stay valid until the
+// next call to nextLine.
+class LineReader {
+public:
+    static constexpr size_t BUFFER_SIZE = 64 * 1024;
+    
+    LineReader() = default;
+    ~LineReader();
+    
+    LineReader(const LineReader&) = delete;
+    LineReader& operator=(const LineReader&) = delete;
+    
+    // Shared reader over standard input. All console input goes through it,
+    // so no stdio buffer can hold lines that poll(2) on the fd cannot see.
+    static LineReader& console();
+    
+    // "-" reads standard input
+    bool open(const std::string& path);
+    void close();
+    
+    bool isOpen() const { return fd_ >= 0; }
+    bool nextLine(std::string_view& line);
+    
+    // True when a whole line, or the end of input, is already buffered, so
+    // nextLine will return without reading
+    bool hasLine() const;
+    size_t lineNumber() const { return line_number_; }
+    
+private:
+    std::vector<char> buffer_;
+    size_t begin_ = 0;
+    size_t end_ = 0;
+    size_t line_number_ = 0;
+    int fd_ = -1;
+    bool owns_fd_ = false;
+    bool eof_ = false;
+    
+    bool fill();
+};
\ No newline at end of file
@@ -0,0 +1,28 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+class MappedFile {
+public:
+    MappedFile() = default;
+    explicit MappedFile(const std::string& path);
+    ~MappedFile();
+    
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+    MappedFile(MappedFile&& other) noexcept;
+    MappedFile& operator=(MappedFile&& other) noexcept;
+    
+    bool open(const std::string& path);
+    void close();
+    
+    bool isOpen() const { return fd_ >= 0; }
+    const unsigned char* data() const { return data_; }
+    size_t size() const { return size_; }
+    
+private:
+    const unsigned char* data_ = nullptr;
+    size_t size_ = 0;
+    int fd_ = -1;
+};
\ No newline at end of file
@@ -0,0 +1,192 @@
+#include "capi/chesscore.h"
+#include "core/Game.h"
+#include <new>
+
+// The handle is the Game itself; every entry point is a thin translation
+// of squares and moves, and no C++ exception crosses the boundary
+struct chess_position {
+    Game game;
+};
+
+namespace {
+
+// a1 = 0 outside, row 0 = rank 8 inside; flipping the rank bits converts
+// board indices
+Position toPosition(int square) {
+    return Position(7 - square / 8, square % 8);
+}
+
+int toSquare(int index) {
+    return index ^ 56;
+}
+
+const PieceType PROMOTION_PIECES[] = {PieceType::QUEEN, PieceType::KNIGHT, PieceType::BISHOP, PieceType::ROOK,
+                                      PieceType::QUEEN};
+const chess_promotion PROMOTION_ORDER[] = {CHESS_PROMOTE_QUEEN, CHESS_PROMOTE_ROOK, CHESS_PROMOTE_BISHOP,
+                                           CHESS_PROMOTE_KNIGHT};
+
+bool isPromotion(const Game& game, const Position& from, const Position& to) {
+    const Piece* piece = game.getBoard().getPiece(from);
+    return piece && piece->getType() == PieceType::PAWN && (to.row == 0 || to.row == 7);
+}
+
+bool isLive(const Game& game) {
+    return game.getGameStatus() == GameStatus::ONGOING || game.getGameStatus() == GameStatus::CHECK;
+}
+
+template <typename F>
+chess_status guarded(F&& body) {
+    try {
+        return body();
+    } catch (const std::bad_alloc&) {
+        return CHESS_OUT_OF_MEMORY;
+    } catch (...) {
+        return CHESS_INTERNAL_ERROR;
+    }
+}
+
+}
+
+extern "C" {
+
+uint32_t chess_abi_version(void) {
+    return CHESSCORE_ABI_VERSION;
+}
+
+const char* chess_status_string(chess_status status) {
+    switch (status) {
+        case CHESS_OK: return "ok";
+        case CHESS_INVALID_ARGUMENT: return "invalid argument";
+        case CHESS_INVALID_FEN: return "invalid FEN";
+        case CHESS_ILLEGAL_MOVE: return "illegal move";
+        case CHESS_NO_MOVE_TO_UNMAKE: return "no move to unmake";
+        case CHESS_BUFFER_TOO_SMALL: return "buffer too small";
+        case CHESS_OUT_OF_MEMORY: return "out of memory";
+        case CHESS_INTERNAL_ERROR: return "internal error";
+    }
+    return "unknown status";
+}
+
+chess_position* chess_position_create(void) {
+    try {
+        return new chess_position();
+    } catch (...) {
+        return nullptr;
+    }
+}
+
+void chess_position_destroy(chess_position* position) {
+    delete position;
+}
+
+chess_status chess_position_load_fen(chess_position* position, const char* fen) {
+    if (!position || !fen) return CHESS_INVALID_ARGUMENT;
+    return guarded([&] { return position->game.loadFEN(fen) ? CHESS_OK : CHESS_INVALID_FEN; });
+}
+
+chess_status chess_position_fen(const chess_position* position, char* buffer, size_t size, size_t* length) {
+    if (!position || (!buffer && size)) return CHESS_INVALID_ARGUMENT;
+    size_t written = position->game.writeFEN(buffer, size);
+    if (length) *length = written;
+    return written < size ? CHESS_OK : CHESS_BUFFER_TOO_SMALL;
+}
+
+chess_status chess_position_make_move(chess_position* position, chess_move move) {
+    if (!position) return CHESS_INVALID_ARGUMENT;
+    Position from = toPosition(chess_move_from(move));
+    Position to = toPosition(chess_move_to(move));
+    chess_promotion promotion = chess_move_promotion(move);
+    if (promotion > CHESS_PROMOTE_QUEEN) return CHESS_INVALID_ARGUMENT;
+    return guarded([&] {
+        Game& game = position->game;
+        bool made = isPromotion(game, from, to) ? game.makeMove(Move(from, to, PROMOTION_PIECES[promotion]))
+                                                : game.makeMove(from, to);
+        return made ? CHESS_OK : CHESS_ILLEGAL_MOVE;
+    });
+}
+
+chess_status chess_position_unmake_move(chess_position* position) {
+    if (!position) return CHESS_INVALID_ARGUMENT;
+    Game& game = position->game;
+    if (game.getCurrentPly() <= game.getFirstPly()) return CHESS_NO_MOVE_TO_UNMAKE;
+    return guarded([&] {
+        game.undoLastMove();
+        return CHESS_OK;
+    });
+}
+
+chess_status chess_position_legal_moves(const chess_position* position, chess_move* moves, size_t capacity,
+                                        size_t* count) {
+    if (!position || !count || (!moves && capacity)) return CHESS_INVALID_ARGUMENT;
+    const Game& game = position->game;
+    size_t found = 0;
+    auto emit = [&](int from, int to, chess_promotion promotion) {
+        if (found < capacity) moves[found] = chess_make_move(from, to, promotion);
+        ++found;
+    };
+    
+    if (isLive(game)) {
+        PositionSnapshot snapshot = game.snapshot();
+        for (int index = 0; index < 64; ++index) {
+            uint8_t code = snapshot.squares[index];
+            if (!PositionSnapshot::isColor(code, snapshot.side())) continue;
+            bool pawn = PositionSnapshot::isType(code, PieceType::PAWN);
+            for (uint64_t targets = snapshot.legalTargets(index); targets; targets &= targets - 1) {
+                int target = __builtin_ctzll(targets);
+                if (pawn && (target < 8 || target >= 56)) {
+                    for (chess_promotion promotion : PROMOTION_ORDER) {
+                        emit(toSquare(index), toSquare(target), promotion);
+                    }
+                } else {
+                    emit(toSquare(index), toSquare(target), CHESS_PROMOTE_NONE);
+                }
+            }
+        }
+    }
+    *count = found;
+    return found <= capacity ? CHESS_OK : CHESS_BUFFER_TOO_SMALL;
+}
+
+int chess_position_is_legal(const chess_position* position, chess_move move) {
+    if (!position) return 0;
+    const Game& game = position->game;
+    if (!isLive(game) || chess_move_promotion(move) > CHESS_PROMOTE_QUEEN) return 0;
+    PositionSnapshot snapshot = game.snapshot();
+    int from = toSquare(chess_move_from(move));
+    if (!PositionSnapshot::isColor(snapshot.squares[from], snapshot.side())) return 0;
+    return static_cast<int>((snapshot.legalTargets(from) >> toSquare(chess_move_to(move))) & 1);
+}
+
+chess_color chess_position_side_to_move(const chess_position* position) {
+    if (!position) return CHESS_WHITE;
+    return position->game.getCurrentPlayer() == PieceColor::WHITE ? CHESS_WHITE : CHESS_BLACK;
+}
+
+chess_game_state chess_position_state(const chess_position* position) {
+    if (!position) return CHESS_ONGOING;
+    const Game& game = position->game;
+    switch (game.getGameStatus()) {
+        case GameStatus::CHECK: return CHESS_CHECK;
+        case GameStatus::CHECKMATE: return CHESS_CHECKMATE;
+        case GameStatus::STALEMATE: return CHESS_STALEMATE;
+        case GameStatus::DRAW:
+            switch (game.getDrawReason()) {
+                case DrawReason::FIFTY_MOVE_RULE: return CHESS_DRAW_FIFTY_MOVES;
+                case DrawReason::THREEFOLD_REPETITION: return CHESS_DRAW_REPETITION;
+                default: return CHESS_DRAW_INSUFFICIENT_MATERIAL;
+            }
+        default: return CHESS_ONGOING;
+    }
+}
+
+size_t chess_position_ply(const chess_position* position) {
+    if (!position) return 0;
+    return position->game.getCurrentPly() - position->game.getFirstPly();
+}
+
+uint64_t chess_position_hash(const chess_position* position) {
+    if (!position) return 0;
+    return position->game.getPositionKey();
+}
+
+}
\ No newline at end of file
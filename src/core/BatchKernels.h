@@ -0,0 +1,322 @@
+#pragma once
+
+#include "core/PositionBatch.h"
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+enum class BatchOp {
+    ATTACK_MAPS,
+    IN_CHECK,
+    LEGAL_MOVE_COUNTS,
+    MATERIAL_BALANCE
+};
+
+// Bitboard kernels shared by the scalar and AVX2 builds of PositionBatch. V
+// holds the bitboards of one position (Lane1, PositionBatch.cpp) or of four
+// (Lane4, PositionBatchAvx2.cpp). Both offer the same few operations, so the
+// chess below is written once and compiled for each. Only templates live
+// here: an inline function compiled into both files could be linked from
+// the AVX2 one and run on a CPU without it.
+namespace BatchKernels {
+
+struct Lanes {
+    const uint64_t* pieces[2][6];
+    const uint64_t* unmoved;
+    const uint64_t* enPassant;
+    const uint64_t* blackToMove;
+    size_t count;    // A multiple of PositionBatch::GROUP
+};
+
+using Kernel = void (*)(BatchOp op, const Lanes& lanes, bool black, uint64_t* out);
+
+Kernel scalarKernel();
+// Null when PositionBatchAvx2.cpp was built without AVX2
+Kernel avx2Kernel();
+
+constexpr uint64_t ALL = ~0ULL;
+constexpr uint64_t NOT_FILE_A = ~0x0101010101010101ULL;
+constexpr uint64_t NOT_FILE_H = ~0x8080808080808080ULL;
+constexpr uint64_t NOT_FILE_AB = ~0x0303030303030303ULL;
+constexpr uint64_t NOT_FILE_GH = ~0xC0C0C0C0C0C0C0C0ULL;
+
+constexpr int PAWN = static_cast<int>(PieceType::PAWN);
+constexpr int ROOK = static_cast<int>(PieceType::ROOK);
+constexpr int KNIGHT = static_cast<int>(PieceType::KNIGHT);
+constexpr int BISHOP = static_cast<int>(PieceType::BISHOP);
+constexpr int QUEEN = static_cast<int>(PieceType::QUEEN);
+constexpr int KING = static_cast<int>(PieceType::KING);
+
+// Bit row * 8 + col with row 0 the eighth rank, so White advances by
+// shifting right
+template <int S, class V>
+V shift(V x) {
+    if constexpr (S > 0) {
+        return x.template shl<S>();
+    } else {
+        return x.template shr<-S>();
+    }
+}
+
+template <class V>
+V nonZero(V x) {
+    return ~isZero(x);
+}
+
+template <class V>
+V select(V mask, V yes, V no) {
+    return (mask & yes) | (~mask & no);
+}
+
+// Rook directions (north, south, east, west), then the diagonals
+constexpr int SHIFTS[8] = {-8, 8, 1, -1, 9, 7, -7, -9};
+constexpr uint64_t MASKS[8] = {ALL, ALL, NOT_FILE_A, NOT_FILE_H, NOT_FILE_A, NOT_FILE_H, NOT_FILE_A, NOT_FILE_H};
+
+// Squares sliders reach in direction D, up to and including the first
+// occupied one (Kogge-Stone occluded fill)
+template <int D, class V>
+V slide(V from, V empty) {
+    constexpr int S = SHIFTS[D];
+    const V mask = V::splat(MASKS[D]);
+    V pro = empty & mask;
+    V gen = from;
+    gen |= pro & shift<S>(gen);
+    pro &= shift<S>(pro);
+    gen |= pro & shift<2 * S>(gen);
+    pro &= shift<2 * S>(pro);
+    gen |= pro & shift<4 * S>(gen);
+    return shift<S>(gen) & mask;
+}
+
+template <class V>
+V rookAttacks(V rooks, V empty) {
+    return slide<0>(rooks, empty) | slide<1>(rooks, empty) | slide<2>(rooks, empty) | slide<3>(rooks, empty);
+}
+
+template <class V>
+V bishopAttacks(V bishops, V empty) {
+    return slide<4>(bishops, empty) | slide<5>(bishops, empty) | slide<6>(bishops, empty) | slide<7>(bishops, empty);
+}
+
+template <class V>
+V knightAttacks(V knights) {
+    const V a = V::splat(NOT_FILE_A), h = V::splat(NOT_FILE_H);
+    const V ab = V::splat(NOT_FILE_AB), gh = V::splat(NOT_FILE_GH);
+    return (shift<17>(knights) & a) | (shift<15>(knights) & h) | (shift<10>(knights) & ab) |
+           (shift<6>(knights) & gh) | (shift<-6>(knights) & ab) | (shift<-10>(knights) & gh) |
+           (shift<-15>(knights) & a) | (shift<-17>(knights) & h);
+}
+
+template <class V>
+V kingAttacks(V kings) {
+    V sideways = (shift<1>(kings) & V::splat(NOT_FILE_A)) | (shift<-1>(kings) & V::splat(NOT_FILE_H));
+    V row = kings | sideways;
+    return sideways | shift<8>(row) | shift<-8>(row);
+}
+
+template <class V>
+V pawnAttacks(V pawns, V black) {
+    const V a = V::splat(NOT_FILE_A), h = V::splat(NOT_FILE_H);
+    V white = (shift<-7>(pawns) & a) | (shift<-9>(pawns) & h);
+    V dark = (shift<9>(pawns) & a) | (shift<7>(pawns) & h);
+    return select(black, dark, white);
+}
+
+template <class V>
+V pawnAdvance(V pawns, V black) {
+    return select(black, shift<8>(pawns), shift<-8>(pawns));
+}
+
+template <class V>
+V times(V x, int weight) {
+    // No 64-bit multiply in AVX2; the weights are 1, 3, 5 and 9
+    switch (weight) {
+        case 3: return shift<1>(x) + x;
+        case 5: return shift<2>(x) + x;
+        case 9: return shift<3>(x) + x;
+        default: return x;
+    }
+}
+
+template <class V>
+struct Group {
+    V pieces[2][6];
+    V unmoved;
+    V enPassant;
+    V black;
+    
+    Group(const Lanes& lanes, size_t index) {
+        for (int color = 0; color < 2; ++color) {
+            for (int type = 0; type < 6; ++type) pieces[color][type] = V::load(lanes.pieces[color][type] + index);
+        }
+        unmoved = V::load(lanes.unmoved + index);
+        enPassant = V::load(lanes.enPassant + index);
+        black = V::load(lanes.blackToMove + index);
+    }
+};
+
+// One side's pieces, picked per lane by colour
+template <class V>
+struct Side {
+    V pieces[6];
+    V all;
+    V black;
+    
+    Side(const Group<V>& group, V isBlack) : all(V::splat(0)), black(isBlack) {
+        for (int type = 0; type < 6; ++type) {
+            pieces[type] = select(isBlack, group.pieces[1][type], group.pieces[0][type]);
+            all |= pieces[type];
+        }
+    }
+};
+
+template <class V>
+V allPieces(const Group<V>& group) {
+    V all = V::splat(0);
+    for (const auto& side : group.pieces) {
+        for (const V& pieces : side) all |= pieces;
+    }
+    return all;
+}
+
+template <class V>
+V attacks(const Side<V>& side, V empty) {
+    return pawnAttacks(side.pieces[PAWN], side.black) | knightAttacks(side.pieces[KNIGHT]) |
+           kingAttacks(side.pieces[KING]) | rookAttacks(side.pieces[ROOK] | side.pieces[QUEEN], empty) |
+           bishopAttacks(side.pieces[BISHOP] | side.pieces[QUEEN], empty);
+}
+
+template <class V>
+V inCheck(const Group<V>& group) {
+    Side<V> us(group, group.black), them(group, ~group.black);
+    V empty = ~(us.all | them.all);
+    return nonZero(attacks(them, empty) & us.pieces[KING]) & V::splat(1);
+}
+
+// Game keeps a move when it does not leave the king attacked, probing with
+// the piece moved and anything on the target removed. Here that becomes a
+// mask of evasions when in check and a ray for each pinned piece. Two quirks
+// of that probe are kept: an en passant capture leaves the captured pawn in
+// place, and castling is allowed by Board's rules, where enemy pawns cover
+// the squares they could advance to but not those they attack, with only the
+// king's destination probed for real.
+template <class V>
+V legalMoveCount(const Group<V>& group) {
+    const V zero = V::splat(0), all = V::splat(ALL);
+    Side<V> us(group, group.black), them(group, ~group.black);
+    V occupied = us.all | them.all;
+    V empty = ~occupied;
+    V king = us.pieces[KING];
+    V theirRooks = them.pieces[ROOK] | them.pieces[QUEEN];
+    V theirBishops = them.pieces[BISHOP] | them.pieces[QUEEN];
+    
+    // With the king lifted, sliders see through the square it leaves
+    V guarded = attacks(them, empty | king);
+    
+    V checkers = (pawnAttacks(king, us.black) & them.pieces[PAWN]) | (knightAttacks(king) & them.pieces[KNIGHT]) |
+                 (kingAttacks(king) & them.pieces[KING]);
+    V evasions = checkers;
+    V pinRays[8];
+    V pinned = zero;
+    auto ray = [&](auto direction) {
+        constexpr int D = decltype(direction)::value;
+        V sliders = (D < 4) ? theirRooks : theirBishops;
+        V toBlocker = slide<D>(king, empty);
+        V hit = nonZero(toBlocker & sliders);
+        checkers |= toBlocker & sliders;
+        evasions |= toBlocker & hit;
+        V blocker = toBlocker & us.all;
+        V beyond = slide<D>(blocker, empty);
+        V pins = nonZero(beyond & sliders);
+        pinRays[D] = (toBlocker | beyond) & pins;
+        pinned |= blocker & pins;
+    };
+    ray(std::integral_constant<int, 0>{});
+    ray(std::integral_constant<int, 1>{});
+    ray(std::integral_constant<int, 2>{});
+    ray(std::integral_constant<int, 3>{});
+    ray(std::integral_constant<int, 4>{});
+    ray(std::integral_constant<int, 5>{});
+    ray(std::integral_constant<int, 6>{});
+    ray(std::integral_constant<int, 7>{});
+    
+    V notChecked = isZero(checkers);
+    V singleCheck = isZero(checkers & (checkers - V::splat(1)));
+    V targets = ~us.all & select(notChecked, all, evasions) & singleCheck;
+    
+    V count = popcount(kingAttacks(king) & ~us.all & ~guarded);
+    
+    // Lanes walk their pieces in step, lowest square first; a lane with
+    // fewer pieces just adds zeros
+    auto eachPiece = [&](V pieces, auto moves) {
+        while (pieces.any()) {
+            V piece = pieces & (zero - pieces);
+            pieces ^= piece;
+            V limit = zero;
+            for (const V& pinRay : pinRays) limit |= pinRay & nonZero(pinRay & piece);
+            count = count + popcount(moves(piece) & targets & select(isZero(limit), all, limit));
+        }
+    };
+    eachPiece(us.pieces[KNIGHT] & ~pinned, [](V knight) { return knightAttacks(knight); });
+    eachPiece(us.pieces[BISHOP], [&](V bishop) { return bishopAttacks(bishop, empty); });
+    eachPiece(us.pieces[ROOK], [&](V rook) { return rookAttacks(rook, empty); });
+    eachPiece(us.pieces[QUEEN], [&](V queen) { return rookAttacks(queen, empty) | bishopAttacks(queen, empty); });
+    V pawnTargets = them.all | group.enPassant;
+    eachPiece(us.pieces[PAWN], [&](V pawn) {
+        V single = pawnAdvance(pawn, us.black) & empty;
+        V twice = pawnAdvance(single, us.black) & empty & nonZero(pawn & group.unmoved);
+        return single | twice | (pawnAttacks(pawn, us.black) & pawnTargets);
+    });
+    
+    V theirPawns = them.pieces[PAWN];
+    V advances = pawnAdvance(theirPawns, them.black) & empty;
+    advances |= pawnAdvance(pawnAdvance(theirPawns & group.unmoved, them.black) & empty, them.black) & empty;
+    Side<V> theirPieces = them;
+    theirPieces.pieces[PAWN] = zero;
+    V covered = attacks(theirPieces, empty) | advances;
+    
+    // Home-rank squares as White's bits, moved up for Black
+    auto home = [&](uint64_t squares) { return select(us.black, V::splat(squares >> 56), V::splat(squares)); };
+    constexpr uint64_t A1 = 1ULL << 56, B1 = 1ULL << 57, C1 = 1ULL << 58, D1 = 1ULL << 59;
+    constexpr uint64_t E1 = 1ULL << 60, F1 = 1ULL << 61, G1 = 1ULL << 62, H1 = 1ULL << 63;
+    // Board checks the corner for an unmoved rook of either colour
+    V rooks = (group.pieces[0][ROOK] | group.pieces[1][ROOK]) & group.unmoved;
+    V ready = nonZero(king & group.unmoved & home(E1)) & notChecked;
+    V kingside = ready & nonZero(rooks & home(H1)) & isZero((occupied | covered) & home(F1 | G1)) &
+                 isZero(guarded & home(G1));
+    V queenside = ready & nonZero(rooks & home(A1)) & isZero(occupied & home(B1 | C1 | D1)) &
+                  isZero(covered & home(C1 | D1)) & isZero(guarded & home(C1));
+    return count + (kingside & V::splat(1)) + (queenside & V::splat(1));
+}
+
+template <class V>
+V materialBalance(const Group<V>& group) {
+    static constexpr int WEIGHTS[6] = {1, 5, 3, 3, 9, 0};
+    V balance = V::splat(0);
+    for (int type = 0; type < KING; ++type) {
+        balance = balance + times(popcount(group.pieces[0][type]), WEIGHTS[type]);
+        balance = balance - times(popcount(group.pieces[1][type]), WEIGHTS[type]);
+    }
+    return balance;
+}
+
+template <class V>
+void run(BatchOp op, const Lanes& lanes, bool black, uint64_t* out) {
+    for (size_t index = 0; index < lanes.count; index += V::WIDTH) {
+        Group<V> group(lanes, index);
+        V result = V::splat(0);
+        switch (op) {
+            case BatchOp::ATTACK_MAPS: {
+                Side<V> side(group, V::splat(black ? ALL : 0));
+                result = attacks(side, ~allPieces(group));
+                break;
+            }
+            case BatchOp::IN_CHECK: result = inCheck(group); break;
+            case BatchOp::LEGAL_MOVE_COUNTS: result = legalMoveCount(group); break;
+            case BatchOp::MATERIAL_BALANCE: result = materialBalance(group); break;
+        }
+        result.store(out + index);
+    }
+}
+
+}
\ No newline at end of file
@@ -0,0 +1,617 @@
+#include "core/Bitbase.h"
+#include "core/Board.h"
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <thread>
+
+namespace {
+
+constexpr char MAGIC[4] = {'R', 'C', 'B', 'B'};
+constexpr uint32_t VERSION = 1;
+constexpr size_t HEADER_SIZE = 24;
+constexpr size_t MATERIAL_FIELD = 8;
+
+// Strong-side pieces in canonical order
+constexpr char PIECE_ORDER[] = "QRBNP";
+
+PieceType letterToType(char letter) {
+    switch (letter) {
+        case 'Q': return PieceType::QUEEN;
+        case 'R': return PieceType::ROOK;
+        case 'B': return PieceType::BISHOP;
+        case 'N': return PieceType::KNIGHT;
+        case 'P': return PieceType::PAWN;
+        default: return PieceType::KING;
+    }
+}
+
+char typeToLetter(PieceType type) {
+    switch (type) {
+        case PieceType::QUEEN: return 'Q';
+        case PieceType::ROOK: return 'R';
+        case PieceType::BISHOP: return 'B';
+        case PieceType::KNIGHT: return 'N';
+        case PieceType::PAWN: return 'P';
+        default: return 'K';
+    }
+}
+
+int letterRank(char letter) {
+    return static_cast<int>(std::strchr(PIECE_ORDER, letter) - PIECE_ORDER);
+}
+
+size_t sidePositions(size_t pieceCount) {
+    size_t count = 64 * 64;
+    for (size_t i = 0; i < pieceCount; ++i) count *= 64;
+    return count;
+}
+
+// Squares are row * 8 + col, matching Position (row 0 is rank 8).
+struct AttackTables {
+    uint64_t king[64];
+    uint64_t knight[64];
+};
+
+const AttackTables& attackTables() {
+    static const AttackTables tables = [] {
+        AttackTables t{};
+        const int kingSteps[8][2] = {{0, 1}, {0, -1}, {1, 0}, {-1, 0}, {1, 1}, {1, -1}, {-1, 1}, {-1, -1}};
+        const int knightSteps[8][2] = {{2, 1}, {2, -1}, {-2, 1}, {-2, -1}, {1, 2}, {1, -2}, {-1, 2}, {-1, -2}};
+        for (int sq = 0; sq < 64; ++sq) {
+            for (int i = 0; i < 8; ++i) {
+                Position k(sq / 8 + kingSteps[i][0], sq % 8 + kingSteps[i][1]);
+                if (k.isValid()) t.king[sq] |= 1ULL << (k.row * 8 + k.col);
+                Position n(sq / 8 + knightSteps[i][0], sq % 8 + knightSteps[i][1]);
+                if (n.isValid()) t.knight[sq] |= 1ULL << (n.row * 8 + n.col);
+            }
+        }
+        return t;
+    }();
+    return tables;
+}
+
+uint64_t slide(int sq, uint64_t occupied, const int (*dirs)[2]) {
+    uint64_t attacks = 0;
+    for (int d = 0; d < 4; ++d) {
+        int row = sq / 8 + dirs[d][0];
+        int col = sq % 8 + dirs[d][1];
+        while (row >= 0 && row < 8 && col >= 0 && col < 8) {
+            uint64_t b = 1ULL << (row * 8 + col);
+            attacks |= b;
+            if (occupied & b) break;
+            row += dirs[d][0];
+            col += dirs[d][1];
+        }
+    }
+    return attacks;
+}
+
+const int ROOK_DIRS[4][2] = {{0, 1}, {0, -1}, {1, 0}, {-1, 0}};
+const int BISHOP_DIRS[4][2] = {{1, 1}, {1, -1}, {-1, 1}, {-1, -1}};
+
+// The strong side is always White here, so pawns move towards row 0.
+uint64_t attacks(PieceType type, int sq, uint64_t occupied) {
+    switch (type) {
+        case PieceType::KNIGHT: return attackTables().knight[sq];
+        case PieceType::KING: return attackTables().king[sq];
+        case PieceType::BISHOP: return slide(sq, occupied, BISHOP_DIRS);
+        case PieceType::ROOK: return slide(sq, occupied, ROOK_DIRS);
+        case PieceType::QUEEN: return slide(sq, occupied, BISHOP_DIRS) | slide(sq, occupied, ROOK_DIRS);
+        case PieceType::PAWN: {
+            uint64_t result = 0;
+            int row = sq / 8 - 1;
+            int col = sq % 8;
+            if (row < 0) return 0;
+            if (col > 0) result |= 1ULL << (row * 8 + col - 1);
+            if (col < 7) result |= 1ULL << (row * 8 + col + 1);
+            return result;
+        }
+    }
+    return 0;
+}
+
+struct Placement {
+    int strongKing;
+    int weakKing;
+    int squares[Bitbase::MAX_PIECES];
+};
+
+size_t indexOf(int strongToMove, const Placement& p, size_t pieceCount) {
+    size_t index = strongToMove ? 0 : 1;
+    index = index * 64 + p.strongKing;
+    index = index * 64 + p.weakKing;
+    for (size_t i = 0; i < pieceCount; ++i) {
+        index = index * 64 + p.squares[i];
+    }
+    return index;
+}
+
+template <typename Fn>
+void parallelFor(size_t count, unsigned threads, Fn fn) {
+    std::vector<std::thread> workers;
+    size_t chunk = (count + threads - 1) / threads;
+    for (unsigned t = 0; t < threads; ++t) {
+        size_t begin = t * chunk;
+        size_t end = std::min(count, begin + chunk);
+        if (begin >= end) break;
+        workers.emplace_back([=, &fn] { fn(t, begin, end); });
+    }
+    for (auto& worker : workers) worker.join();
+}
+
+class Generator {
+public:
+    Generator(const std::string& material, unsigned threads, const BitbaseStore& store)
+        : material_(material), threads_(threads), store_(store) {
+        for (size_t i = 1; i + 1 < material.size(); ++i) {
+            types_.push_back(letterToType(material[i]));
+        }
+        side_size_ = sidePositions(types_.size());
+    }
+    
+    Bitbase run() {
+        for (auto& w : win_) w.reset(new std::atomic<uint8_t>[side_size_]);
+        count_.reset(new std::atomic<uint8_t>[side_size_]);
+        
+        std::vector<std::vector<size_t>> strongSeeds(threads_), weakSeeds(threads_);
+        parallelFor(side_size_, threads_, [&](unsigned t, size_t begin, size_t end) {
+            for (size_t local = begin; local < end; ++local) {
+                initStrong(local, strongSeeds[t]);
+                initWeak(local, weakSeeds[t]);
+            }
+        });
+        
+        std::vector<size_t> strongFrontier = merge(strongSeeds);
+        std::vector<size_t> weakFrontier = merge(weakSeeds);
+        
+        // Level-synchronous propagation: wins with the weak side to move make
+        // their strong-side predecessors wins; each new strong win removes one
+        // escape from every weak-side predecessor.
+        while (!strongFrontier.empty() || !weakFrontier.empty()) {
+            auto nextWeak = expand(strongFrontier, [this](size_t local, std::vector<size_t>& out) {
+                retractWeak(local, out);
+            });
+            auto nextStrong = expand(weakFrontier, [this](size_t local, std::vector<size_t>& out) {
+                retractStrong(local, out);
+            });
+            strongFrontier = std::move(nextStrong);
+            weakFrontier = std::move(nextWeak);
+        }
+        
+        std::vector<unsigned char> bits((2 * side_size_ + 7) / 8, 0);
+        for (int stm = 0; stm < 2; ++stm) {
+            for (size_t local = 0; local < side_size_; ++local) {
+                if (win_[stm][local].load(std::memory_order_relaxed)) {
+                    size_t index = stm * side_size_ + local;
+                    bits[index >> 3] |= static_cast<unsigned char>(1u << (index & 7));
+                }
+            }
+        }
+        return Bitbase(material_, std::move(bits));
+    }
+    
+private:
+    static constexpr uint8_t DRAWN = 0xFF;
+    
+    std::string material_;
+    unsigned threads_;
+    const BitbaseStore& store_;
+    std::vector<PieceType> types_;
+    size_t side_size_;
+    std::unique_ptr<std::atomic<uint8_t>[]> win_[2];  // [0] strong to move, [1] weak to move
+    std::unique_ptr<std::atomic<uint8_t>[]> count_;   // remaining non-losing replies, weak to move
+    
+    Placement decode(size_t local) const {
+        Placement p{};
+        for (size_t i = types_.size(); i-- > 0;) {
+            p.squares[i] = static_cast<int>(local & 63);
+            local >>= 6;
+        }
+        p.weakKing = static_cast<int>(local & 63);
+        p.strongKing = static_cast<int>((local >> 6) & 63);
+        return p;
+    }
+    
+    size_t encode(const Placement& p) const {
+        return indexOf(true, p, types_.size());
+    }
+    
+    uint64_t occupancy(const Placement& p) const {
+        uint64_t occupied = (1ULL << p.strongKing) | (1ULL << p.weakKing);
+        for (size_t i = 0; i < types_.size(); ++i) occupied |= 1ULL << p.squares[i];
+        return occupied;
+    }
+    
+    bool attackedByStrong(int sq, const Placement& p, uint64_t occupied, int skipPiece = -1) const {
+        if (attackTables().king[p.strongKing] & (1ULL << sq)) return true;
+        for (size_t i = 0; i < types_.size(); ++i) {
+            if (static_cast<int>(i) == skipPiece) continue;
+            if (attacks(types_[i], p.squares[i], occupied) & (1ULL << sq)) return true;
+        }
+        return false;
+    }
+    
+    bool isValid(const Placement& p, bool strongToMove) const {
+        uint64_t occupied = (1ULL << p.strongKing) | (1ULL << p.weakKing);
+        if (p.strongKing == p.weakKing) return false;
+        for (size_t i = 0; i < types_.size(); ++i) {
+            uint64_t b = 1ULL << p.squares[i];
+            if (occupied & b) return false;
+            occupied |= b;
+            int row = p.squares[i] / 8;
+            if (types_[i] == PieceType::PAWN && (row == 0 || row == 7)) return false;
+        }
+        if (attackTables().king[p.strongKing] & (1ULL << p.weakKing)) return false;
+        // The side that just moved cannot have left its king in check
+        return !strongToMove || !attackedByStrong(p.weakKing, p, occupied);
+    }
+    
+    // Result of leaving this material for a smaller table
+    bool subtableWins(std::vector<PieceType> types, const Placement& p, std::vector<int> squares,
+                      bool strongToMove) const {
+        if (types.empty()) return false;
+        
+        std::vector<size_t> order(types.size());
+        for (size_t i = 0; i < order.size(); ++i) order[i] = i;
+        std::sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+            return letterRank(typeToLetter(types[a])) < letterRank(typeToLetter(types[b]));
+        });
+        
+        std::string material = "K";
+        Placement sub{};
+        sub.strongKing = p.strongKing;
+        sub.weakKing = p.weakKing;
+        for (size_t i = 0; i < order.size(); ++i) {
+            material += typeToLetter(types[order[i]]);
+            sub.squares[i] = squares[order[i]];
+        }
+        material += "K";
+        
+        const Bitbase* table = store_.find(material);
+        return table && table->isWin(indexOf(strongToMove, sub, types.size()));
+    }
+    
+    void initStrong(size_t local, std::vector<size_t>& seeds) {
+        win_[0][local].store(0, std::memory_order_relaxed);
+        Placement p = decode(local);
+        if (!isValid(p, true)) return;
+        
+        uint64_t occupied = occupancy(p);
+        for (size_t i = 0; i < types_.size(); ++i) {
+            if (types_[i] != PieceType::PAWN || p.squares[i] / 8 != 1) continue;
+            int target = p.squares[i] - 8;
+            if (occupied & (1ULL << target)) continue;
+            
+            std::vector<int> squares(p.squares, p.squares + types_.size());
+            squares[i] = target;
+            for (PieceType promotion : {PieceType::QUEEN, PieceType::ROOK, PieceType::BISHOP, PieceType::KNIGHT}) {
+                std::vector<PieceType> types = types_;
+                types[i] = promotion;
+                if (subtableWins(types, p, squares, false)) {
+                    win_[0][local].store(1, std::memory_order_relaxed);
+                    seeds.push_back(local);
+                    return;
+                }
+            }
+        }
+    }
+    
+    void initWeak(size_t local, std::vector<size_t>& seeds) {
+        win_[1][local].store(0, std::memory_order_relaxed);
+        count_[local].store(0, std::memory_order_relaxed);
+        Placement p = decode(local);
+        if (!isValid(p, false)) return;
+        
+        uint64_t occupied = occupancy(p);
+        uint64_t withoutKing = occupied & ~(1ULL << p.weakKing);
+        uint64_t targets = attackTables().king[p.weakKing] & ~(1ULL << p.strongKing);
+        
+        int quiet = 0;
+        int legal = 0;
+        bool escapes = false;
+        while (targets) {
+            int to = __builtin_ctzll(targets);
+            targets &= targets - 1;
+            
+            int captured = -1;
+            for (size_t i = 0; i < types_.size(); ++i) {
+                if (p.squares[i] == to) captured = static_cast<int>(i);
+            }
+            if (attackedByStrong(to, p, withoutKing, captured)) continue;
+            ++legal;
+            
+            if (captured < 0) {
+                ++quiet;
+                continue;
+            }
+            
+            std::vector<PieceType> types = types_;
+            std::vector<int> squares(p.squares, p.squares + types_.size());
+            types.erase(types.begin() + captured);
+            squares.erase(squares.begin() + captured);
+            Placement after = p;
+            after.weakKing = to;
+            if (!subtableWins(types, after, squares, true)) escapes = true;
+        }
+        
+        if (legal == 0) {
+            if (attackedByStrong(p.weakKing, p, occupied)) {
+                win_[1][local].store(1, std::memory_order_relaxed);
+                seeds.push_back(local);
+            }
+            return;
+        }
+        if (escapes) {
+            count_[local].store(DRAWN, std::memory_order_relaxed);
+        } else if (quiet == 0) {
+            win_[1][local].store(1, std::memory_order_relaxed);
+            seeds.push_back(local);
+        } else {
+            count_[local].store(static_cast<uint8_t>(quiet), std::memory_order_relaxed);
+        }
+    }
+    
+    // Predecessors of a won strong-to-move position: weak king moves
+    void retractWeak(size_t local, std::vector<size_t>& out) {
+        Placement p = decode(local);
+        uint64_t empty = ~occupancy(p);
+        uint64_t sources = attackTables().king[p.weakKing] & empty;
+        while (sources) {
+            Placement prev = p;
+            prev.weakKing = __builtin_ctzll(sources);
+            sources &= sources - 1;
+            if (!isValid(prev, false)) continue;
+            
+            size_t index = encode(prev);
+            if (count_[index].load(std::memory_order_relaxed) == DRAWN) continue;
+            if (count_[index].fetch_sub(1, std::memory_order_relaxed) == 1 &&
+                !win_[1][index].exchange(1, std::memory_order_relaxed)) {
+                out.push_back(index);
+            }
+        }
+    }
+    
+    // Predecessors of a won weak-to-move position: any strong move
+    void retractStrong(size_t local, std::vector<size_t>& out) {
+        Placement p = decode(local);
+        uint64_t occupied = occupancy(p);
+        
+        auto visit = [&](const Placement& prev) {
+            if (!isValid(prev, true)) return;
+            size_t index = encode(prev);
+            if (!win_[0][index].exchange(1, std::memory_order_relaxed)) {
+                out.push_back(index);
+            }
+        };
+        
+        uint64_t kingSources = attackTables().king[p.strongKing] & ~occupied;
+        while (kingSources) {
+            Placement prev = p;
+            prev.strongKing = __builtin_ctzll(kingSources);
+            kingSources &= kingSources - 1;
+            visit(prev);
+        }
+        
+        for (size_t i = 0; i < types_.size(); ++i) {
+            int sq = p.squares[i];
+            if (types_[i] == PieceType::PAWN) {
+                int row = sq / 8;
+                if (row + 1 <= 6 && !(occupied & (1ULL << (sq + 8)))) {
+                    Placement prev = p;
+                    prev.squares[i] = sq + 8;
+                    visit(prev);
+                    if (row == 4 && !(occupied & (1ULL << (sq + 16)))) {
+                        prev.squares[i] = sq + 16;
+                        visit(prev);
+                    }
+                }
+                continue;
+            }
+            
+            uint64_t sources = attacks(types_[i], sq, occupied) & ~occupied;
+            while (sources) {
+                Placement prev = p;
+                prev.squares[i] = __builtin_ctzll(sources);
+                sources &= sources - 1;
+                visit(prev);
+            }
+        }
+    }
+    
+    template <typename Fn>
+    std::vector<size_t> expand(const std::vector<size_t>& frontier, Fn fn) {
+        std::vector<std::vector<size_t>> next(threads_);
+        parallelFor(frontier.size(), threads_, [&](unsigned t, size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i) fn(frontier[i], next[t]);
+        });
+        return merge(next);
+    }
+    
+    static std::vector<size_t> merge(std::vector<std::vector<size_t>>& parts) {
+        std::vector<size_t> merged;
+        for (auto& part : parts) merged.insert(merged.end(), part.begin(), part.end());
+        return merged;
+    }
+};
+
+}
+
+Bitbase::Bitbase(const std::string& material, std::vector<unsigned char> bits)
+    : material_(material), positions_(positionCount(material)), owned_(std::move(bits)) {
+    bits_ = owned_.data();
+}
+
+std::string Bitbase::canonicalMaterial(const std::string& material) {
+    if (material.size() < 2 || material.front() != 'K' || material.back() != 'K') return "";
+    
+    std::string pieces = material.substr(1, material.size() - 2);
+    if (pieces.size() > MAX_PIECES) return "";
+    for (char c : pieces) {
+        if (c == '\0' || !std::strchr(PIECE_ORDER, c)) return "";
+    }
+    std::sort(pieces.begin(), pieces.end(), [](char a, char b) { return letterRank(a) < letterRank(b); });
+    return "K" + pieces + "K";
+}
+
+size_t Bitbase::positionCount(const std::string& material) {
+    return 2 * sidePositions(material.size() - 2);
+}
+
+bool Bitbase::load(const std::string& path) {
+    MappedFile file;
+    if (!file.open(path) || file.size() < HEADER_SIZE) return false;
+    
+    const unsigned char* data = file.data();
+    uint32_t version;
+    uint64_t positions;
+    std::memcpy(&version, data + 4, sizeof(version));
+    std::memcpy(&positions, data + 16, sizeof(positions));
+    
+    char name[MATERIAL_FIELD + 1] = {};
+    std::memcpy(name, data + 8, MATERIAL_FIELD);
+    std::string material = canonicalMaterial(name);
+    
+    if (std::memcmp(data, MAGIC, sizeof(MAGIC)) != 0 || version != VERSION || material.empty() ||
+        positions != positionCount(material) || file.size() != HEADER_SIZE + (positions + 7) / 8) {
+        return false;
+    }
+    
+    material_ = material;
+    positions_ = positions;
+    owned_.clear();
+    file_ = std::move(file);
+    bits_ = file_.data() + HEADER_SIZE;
+    return true;
+}
+
+bool Bitbase::save(const std::string& path) const {
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    if (!out) return false;
+    
+    unsigned char header[HEADER_SIZE] = {};
+    uint64_t positions = positions_;
+    std::memcpy(header, MAGIC, sizeof(MAGIC));
+    std::memcpy(header + 4, &VERSION, sizeof(VERSION));
+    std::memcpy(header + 8, material_.data(), std::min(material_.size(), MATERIAL_FIELD));
+    std::memcpy(header + 16, &positions, sizeof(positions));
+    
+    out.write(reinterpret_cast<const char*>(header), sizeof(header));
+    out.write(reinterpret_cast<const char*>(bits_), static_cast<std::streamsize>((positions_ + 7) / 8));
+    return static_cast<bool>(out);
+}
+
+bool BitbaseStore::load(const std::string& path) {
+    Bitbase bitbase;
+    if (!bitbase.load(path)) return false;
+    add(std::move(bitbase));
+    return true;
+}
+
+size_t BitbaseStore::loadDirectory(const std::string& directory) {
+    size_t loaded = 0;
+    std::error_code ec;
+    for (const auto& entry : std::filesystem::directory_iterator(directory, ec)) {
+        if (entry.path().extension() == ".bb" && load(entry.path().string())) {
+            ++loaded;
+        }
+    }
+    return loaded;
+}
+
+bool BitbaseStore::saveAll(const std::string& directory) const {
+    for (const auto& [material, bitbase] : tables_) {
+        if (!bitbase.save((std::filesystem::path(directory) / (material + ".bb")).string())) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool BitbaseStore::generate(const std::string& requested, unsigned threads) {
+    std::string material = Bitbase::canonicalMaterial(requested);
+    if (material.empty()) return false;
+    if (find(material) || material == "KK") return true;
+    
+    // Tables reachable by promoting a pawn or losing a piece come first
+    std::string pieces = material.substr(1, material.size() - 2);
+    for (size_t i = 0; i < pieces.size(); ++i) {
+        std::string without = pieces;
+        without.erase(i, 1);
+        if (!generate("K" + without + "K", threads)) return false;
+        
+        if (pieces[i] == 'P') {
+            for (char promotion : {'Q', 'R', 'B', 'N'}) {
+                std::string promoted = pieces;
+                promoted[i] = promotion;
+                if (!generate("K" + promoted + "K", threads)) return false;
+            }
+        }
+    }
+    
+    if (threads == 0) threads = std::max(1u, std::thread::hardware_concurrency());
+    add(Generator(material, threads, *this).run());
+    return true;
+}
+
+void BitbaseStore::add(Bitbase bitbase) {
+    std::string material = bitbase.getMaterial();
+    tables_.insert_or_assign(material, std::move(bitbase));
+}
+
+const Bitbase* BitbaseStore::find(const std::string& material) const {
+    auto it = tables_.find(material);
+    return it == tables_.end() ? nullptr : &it->second;
+}
+
+std::optional<BitbaseResult> BitbaseStore::probe(const Board& board, PieceColor sideToMove) const {
+    struct Entry { PieceType type; Position pos; };
+    Entry pieces[2][Bitbase::MAX_PIECES + 1];
+    int counts[2] = {0, 0};
+    Position kings[2] = {Position(-1, -1), Position(-1, -1)};
+    
+    for (int row = 0; row < 8; ++row) {
+        for (int col = 0; col < 8; ++col) {
+            const Piece* piece = board.getPiece(Position(row, col));
+            if (!piece) continue;
+            int side = piece->getColor() == PieceColor::WHITE ? 0 : 1;
+            if (piece->getType() == PieceType::KING) {
+                kings[side] = Position(row, col);
+                continue;
+            }
+            if (counts[side] == Bitbase::MAX_PIECES || counts[1 - side] > 0) return std::nullopt;
+            pieces[side][counts[side]++] = {piece->getType(), Position(row, col)};
+        }
+    }
+    if (!kings[0].isValid() || !kings[1].isValid()) return std::nullopt;
+    if (counts[0] == 0 && counts[1] == 0) return BitbaseResult::DRAW;
+    
+    int strong = counts[0] > 0 ? 0 : 1;
+    int count = counts[strong];
+    std::sort(pieces[strong], pieces[strong] + count, [](const Entry& a, const Entry& b) {
+        return letterRank(typeToLetter(a.type)) < letterRank(typeToLetter(b.type));
+    });
+    
+    std::string material = "K";
+    for (int i = 0; i < count; ++i) material += typeToLetter(pieces[strong][i].type);
+    material += "K";
+    const Bitbase* table = find(material);
+    if (!table) return std::nullopt;
+    
+    // Tables are built with the strong side as White; mirror Black ranks
+    auto square = [strong](const Position& pos) {
+        int row = strong == 0 ? pos.row : 7 - pos.row;
+        return row * 8 + pos.col;
+    };
+    Placement p{};
+    p.strongKing = square(kings[strong]);
+    p.weakKing = square(kings[1 - strong]);
+    for (int i = 0; i < count; ++i) p.squares[i] = square(pieces[strong][i].pos);
+    
+    bool strongToMove = (sideToMove == PieceColor::WHITE) == (strong == 0);
+    if (!table->isWin(indexOf(strongToMove, p, count))) return BitbaseResult::DRAW;
+    return strongToMove ? BitbaseResult::WIN : BitbaseResult::LOSS;
+}
\ No newline at end of file
@@ -1,5 +1,6 @@
 #include "core/Board.h"
 #include "core/Piece.h"
+#include "core/Stats.h"
 #include <iostream>
 #include <algorithm>
 
@@ -7,13 +8,16 @@ Board::Board() : en_passant_target_(-1, -1) {
     initializeBoard();
 }
 
-Board::Board(const Board& other) : en_passant_target_(other.en_passant_target_) {
+Board::Board(const Board& other) : en_passant_target_(other.en_passant_target_), material_key_(other.material_key_) {
+    CHESS_STAT(BOARD_COPIES);
     copyBoard(other);
 }
 
 Board& Board::operator=(const Board& other) {
     if (this != &other) {
+        CHESS_STAT(BOARD_COPIES);
         en_passant_target_ = other.en_passant_target_;
+        material_key_ = other.material_key_;
         copyBoard(other);
     }
     return *this;
@@ -47,6 +51,8 @@ void Board::initializeBoard() {
     board_[7][5] = std::make_unique<Bishop>(PieceColor::WHITE);
     board_[7][6] = std::make_unique<Knight>(PieceColor::WHITE);
     board_[7][7] = std::make_unique<Rook>(PieceColor::WHITE);
+    
+    material_key_ = Material::key(*this);
 }
 
 void Board::clearBoard() {
@@ -56,6 +62,7 @@ void Board::clearBoard() {
         }
     }
     clearEnPassantTarget();
+    material_key_ = 0;
 }
 
 const Piece* Board::getPiece(const Position& pos) const {
@@ -70,13 +77,18 @@ Piece* Board::getPiece(const Position& pos) {
 
 bool Board::placePiece(std::unique_ptr<Piece> piece, const Position& pos) {
     if (!pos.isValid()) return false;
-    board_[pos.row][pos.col] = std::move(piece);
+    auto& square = board_[pos.row][pos.col];
+    if (square) material_key_ -= Material::unit(square->getType(), square->getColor(), pos);
+    if (piece) material_key_ += Material::unit(piece->getType(), piece->getColor(), pos);
+    square = std::move(piece);
     return true;
 }
 
 std::unique_ptr<Piece> Board::removePiece(const Position& pos) {
     if (!pos.isValid()) return nullptr;
-    return std::move(board_[pos.row][pos.col]);
+    auto& square = board_[pos.row][pos.col];
+    if (square) material_key_ -= Material::unit(square->getType(), square->getColor(), pos);
+    return std::move(square);
 }
 
 bool Board::movePiece(const Position& from, const Position& to) {
@@ -155,17 +167,59 @@ std::vector<Position> Board::getAllValidMoves(PieceColor color) const {
             }
         }
     }
+    CHESS_STAT_ADD(LEGAL_MOVES_GENERATED, allMoves.size());
     return allMoves;
 }
 
 bool Board::wouldBeInCheck(const Position& from, const Position& to, PieceColor color) const {
-    Board tempBoard(*this);
-    
-    auto piece = tempBoard.removePiece(from);
-    if (!piece) return true;
+    CHESS_STAT(CHECK_PROBES);
+    if (!getPiece(from) || !to.isValid()) return true;
     
-    tempBoard.placePiece(std::move(piece), to);
-    return tempBoard.isInCheck(color);
+    PositionSnapshot probe = snapshot(color);
+    probe.squares[to.row * 8 + to.col] = probe.squares[from.row * 8 + from.col];
+    probe.squares[from.row * 8 + from.col] = 0;
+    return probe.isInCheck(color);
+}
+
+PositionSnapshot Board::snapshot(PieceColor sideToMove) const {
+    PositionSnapshot position{};
+    for (int row = 0; row < 8; ++row) {
+        for (int col = 0; col < 8; ++col) {
+            const Piece* piece = board_[row][col].get();
+            if (piece) {
+                position.squares[row * 8 + col] = PositionSnapshot::encode(piece->getType(), piece->getColor(), piece->hasMoved());
+            }
+        }
+    }
+    position.sideToMove = (sideToMove == PieceColor::BLACK) ? 1 : 0;
+    position.enPassant = en_passant_target_.isValid()
+        ? static_cast<uint8_t>(en_passant_target_.row * 8 + en_passant_target_.col)
+        : PositionSnapshot::NO_SQUARE;
+    position.fullmoveNumber = 1;
+    return position;
+}
+
+void Board::restore(const PositionSnapshot& snapshot) {
+    material_key_ = 0;
+    for (int sq = 0; sq < 64; ++sq) {
+        uint8_t code = snapshot.squares[sq];
+        auto& square = board_[sq / 8][sq % 8];
+        if (!code) {
+            square.reset();
+            continue;
+        }
+        auto type = static_cast<PieceType>((code & 7) - 1);
+        auto color = (code & PositionSnapshot::BLACK_BIT) ? PieceColor::BLACK : PieceColor::WHITE;
+        // Keep the existing piece object when it already matches
+        if (!square || square->getType() != type || square->getColor() != color) {
+            square = Piece::create(type, color);
+        }
+        material_key_ += Material::unit(type, color, Position(sq / 8, sq % 8));
+        square->setMoved((code & PositionSnapshot::MOVED_BIT) != 0);
+    }
+    en_passant_target_ = (snapshot.enPassant < 64)
+        ? Position(snapshot.enPassant / 8, snapshot.enPassant % 8)
+        : Position(-1, -1);
 }
 
 bool Board::canCastleKingside(PieceColor color) const {
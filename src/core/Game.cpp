@@ -1,6 +1,10 @@
 #include "core/Game.h"
+#include "core/Stats.h"
+#include "core/Zobrist.h"
 #include "utils/Utils.h"
 #include <algorithm>
+#include <cctype>
+#include <sstream>
 
 Game::Game() 
     : current_player_(PieceColor::WHITE), 
@@ -19,6 +23,9 @@ void Game::startNewGame() {
     halfmove_clock_ = 0;
     fullmove_number_ = 1;
     draw_offered_ = false;
+    start_fen_.clear();
+    if (clock_) clock_.emplace(clock_->getTimeControl());
+    resetLine();
     updateGameStatus();
 }
 
@@ -28,10 +35,15 @@ bool Game::makeMove(const Position& from, const Position& to) {
 }
 
 bool Game::makeMove(const Move& move) {
+    CHESS_LATENCY(MAKE_MOVE);
+    CHESS_TRACE_SPAN("Game::makeMove");
     if (game_status_ != GameStatus::ONGOING && game_status_ != GameStatus::CHECK) {
         return false;
     }
     
+    auto now = GameClock::Clock::now();
+    if (checkFlag(now)) return false;
+    
     const Piece* piece = board_.getPiece(move.getFrom());
     if (!piece || piece->getColor() != current_player_) {
         return false;
@@ -41,11 +53,14 @@ bool Game::makeMove(const Move& move) {
         return false;
     }
     
-    // Create a new move for execution
-    Move executedMove(move.getFrom(), move.getTo(), move.getType());
-    if (move.isPromotion()) {
+    // Players and books only supply from/to (and a promotion choice), so the
+    // move kind is always derived from the board
+    PieceType movedType = piece->getType();
+    Move executedMove = createMove(move.getFrom(), move.getTo());
+    if (executedMove.isPromotion() && move.isPromotion()) {
         executedMove = Move(move.getFrom(), move.getTo(), move.getPromotionPiece());
     }
+    MoveType type = executedMove.getType();
     
     // Handle captures
     if (!board_.isSquareEmpty(move.getTo())) {
@@ -54,11 +69,11 @@ bool Game::makeMove(const Move& move) {
     }
     
     // Handle special moves
-    if (move.getType() == MoveType::CASTLING_KINGSIDE || move.getType() == MoveType::CASTLING_QUEENSIDE) {
+    if (type == MoveType::CASTLING_KINGSIDE || type == MoveType::CASTLING_QUEENSIDE) {
         if (!executeCastling(executedMove)) return false;
-    } else if (move.getType() == MoveType::EN_PASSANT) {
+    } else if (type == MoveType::EN_PASSANT) {
         if (!executeEnPassant(executedMove)) return false;
-    } else if (move.getType() == MoveType::PAWN_PROMOTION) {
+    } else if (type == MoveType::PAWN_PROMOTION) {
         if (!executePromotion(executedMove)) return false;
     } else {
         // Normal move
@@ -66,7 +81,7 @@ bool Game::makeMove(const Move& move) {
     }
     
     // Update move counters
-    if (piece->getType() == PieceType::PAWN || executedMove.isCapture()) {
+    if (movedType == PieceType::PAWN || executedMove.isCapture()) {
         halfmove_clock_ = 0;
     } else {
         halfmove_clock_++;
@@ -78,46 +93,75 @@ bool Game::makeMove(const Move& move) {
     
     // Set en passant target for pawn double moves
     board_.clearEnPassantTarget();
-    if (piece->getType() == PieceType::PAWN && Utils::abs(move.getTo().row - move.getFrom().row) == 2) {
+    if (movedType == PieceType::PAWN && Utils::abs(move.getTo().row - move.getFrom().row) == 2) {
         int enPassantRow = (move.getFrom().row + move.getTo().row) / 2;
         board_.setEnPassantTarget(Position(enPassantRow, move.getFrom().col));
     }
     
     move_history_.push_back(std::move(executedMove));
     switchPlayer();
+    recordPly();
     updateGameStatus();
     draw_offered_ = false;
+    if (clock_) {
+        clock_->press(now);
+        if (isGameOver()) clock_->stop(now);
+    }
     
     return true;
 }
 
 void Game::undoLastMove() {
-    if (move_history_.empty()) return;
-    
-    const Move& lastMove = move_history_.back();
-    
-    // Store move info before removing from history
-    Position from = lastMove.getFrom();
-    Position to = lastMove.getTo();
-    MoveType type = lastMove.getType();
-    
-    move_history_.pop_back();
-    
-    // Move piece back
-    board_.movePiece(to, from);
+    if (getCurrentPly() > first_ply_) seekToPly(getCurrentPly() - 1);
+}
+
+bool Game::seekToPly(size_t ply) {
+    if (ply < first_ply_ || ply > getLastPly()) return false;
     
-    // Handle special move undos
-    if (type == MoveType::CASTLING_KINGSIDE || type == MoveType::CASTLING_QUEENSIDE) {
-        int row = from.row;
-        if (type == MoveType::CASTLING_KINGSIDE) {
-            board_.movePiece(Position(row, 5), Position(row, 7));
-        } else {
-            board_.movePiece(Position(row, 3), Position(row, 0));
-        }
+    while (move_history_.size() > ply) {
+        future_moves_.push_back(std::move(move_history_.back()));
+        move_history_.pop_back();
+    }
+    while (move_history_.size() < ply) {
+        move_history_.push_back(std::move(future_moves_.back()));
+        future_moves_.pop_back();
     }
     
-    switchPlayer();
+    const PositionSnapshot& position = plies_[ply - first_ply_].position;
+    board_.restore(position);
+    current_player_ = position.side();
+    halfmove_clock_ = position.halfmoveClock;
+    fullmove_number_ = position.fullmoveNumber;
+    draw_offered_ = false;
     updateGameStatus();
+    if (clock_) clock_->switchTo(current_player_, GameClock::Clock::now());
+    return true;
+}
+
+void Game::resetLine() {
+    future_moves_.clear();
+    first_ply_ = move_history_.size();
+    plies_.assign(1, {snapshot(), Zobrist::hash(board_, current_player_)});
+}
+
+void Game::recordPly() {
+    size_t index = move_history_.size() - first_ply_;
+    PlyRecord record{snapshot(), Zobrist::hash(board_, current_player_)};
+    
+    // Replaying the next move of the line keeps the rest of it
+    const Move& made = move_history_.back();
+    if (!future_moves_.empty()) {
+        const Move& next = future_moves_.back();
+        if (next.getFrom() == made.getFrom() && next.getTo() == made.getTo() &&
+            next.getPromotionPiece() == made.getPromotionPiece()) {
+            future_moves_.pop_back();
+            plies_[index] = record;
+            return;
+        }
+    }
+    future_moves_.clear();
+    plies_.resize(index);
+    plies_.push_back(record);
 }
 
 const Move& Game::getLastMove() const {
@@ -129,40 +173,57 @@ const Move& Game::getLastMove() const {
 }
 
 bool Game::isValidMove(const Position& from, const Position& to) const {
-    const Piece* piece = board_.getPiece(from);
-    if (!piece || piece->getColor() != current_player_) {
-        return false;
-    }
-    
-    if (!piece->isValidMove(from, to, board_)) {
-        return false;
-    }
-    
-    return !board_.wouldBeInCheck(from, to, current_player_);
+    if (!to.isValid()) return false;
+    return (getLegalTargets(from) >> (to.row * 8 + to.col)) & 1;
 }
 
 std::vector<Position> Game::getValidMoves(const Position& from) const {
-    const Piece* piece = board_.getPiece(from);
-    if (!piece || piece->getColor() != current_player_) {
-        return {};
-    }
-    
-    auto possibleMoves = piece->getPossibleMoves(from, board_);
+    CHESS_LATENCY(VALID_MOVES);
+    CHESS_TRACE_SPAN("Game::getValidMoves");
     std::vector<Position> validMoves;
-    
-    for (const auto& move : possibleMoves) {
-        if (!board_.wouldBeInCheck(from, move, current_player_)) {
-            validMoves.push_back(move);
-        }
+    for (uint64_t targets = getLegalTargets(from); targets; targets &= targets - 1) {
+        int sq = __builtin_ctzll(targets);
+        validMoves.emplace_back(sq / 8, sq % 8);
     }
-    
     return validMoves;
 }
 
+uint64_t Game::getLegalTargets(const Position& from) const {
+    if (!from.isValid()) return 0;
+    return legalTargets()[from.row * 8 + from.col];
+}
+
+bool Game::hasLegalMoves() const {
+    for (uint64_t targets : legalTargets()) {
+        if (targets) return true;
+    }
+    return false;
+}
+
+const std::array<uint64_t, 64>& Game::legalTargets() const {
+    if (legal_targets_valid_) return legal_targets_;
+    
+    legal_targets_.fill(0);
+    for (const auto& from : board_.getAllPiecesPositions(current_player_)) {
+        const Piece* piece = board_.getPiece(from);
+        uint64_t targets = 0;
+        for (const auto& to : piece->getPossibleMoves(from, board_)) {
+            if (!board_.wouldBeInCheck(from, to, current_player_)) {
+                targets |= uint64_t{1} << (to.row * 8 + to.col);
+            }
+        }
+        CHESS_STAT_ADD(LEGAL_MOVES_GENERATED, __builtin_popcountll(targets));
+        legal_targets_[from.row * 8 + from.col] = targets;
+    }
+    legal_targets_valid_ = true;
+    return legal_targets_;
+}
+
 bool Game::isGameOver() const {
     return game_status_ == GameStatus::CHECKMATE || 
            game_status_ == GameStatus::STALEMATE || 
-           game_status_ == GameStatus::DRAW;
+           game_status_ == GameStatus::DRAW ||
+           game_status_ == GameStatus::TIME_FORFEIT;
 }
 
 std::string Game::getGameStatusString() const {
@@ -177,12 +238,258 @@ std::string Game::getGameStatusString() const {
         case GameStatus::STALEMATE:
             return "Stalemate - Draw";
         case GameStatus::DRAW:
-            return "Draw";
+            switch (draw_reason_) {
+                case DrawReason::FIFTY_MOVE_RULE: return "Draw by the fifty-move rule";
+                case DrawReason::THREEFOLD_REPETITION: return "Draw by threefold repetition";
+                case DrawReason::INSUFFICIENT_MATERIAL: return "Draw by insufficient material";
+                case DrawReason::AGREEMENT: return "Draw by agreement";
+                case DrawReason::TIMEOUT_VS_INSUFFICIENT_MATERIAL: return "Draw: time ran out against a bare king";
+                default: return "Draw";
+            }
+        case GameStatus::TIME_FORFEIT:
+            return Utils::colorToString(current_player_) + " lost on time. " +
+                   Utils::colorToString(current_player_ == PieceColor::WHITE ? PieceColor::BLACK : PieceColor::WHITE) + " wins!";
         default:
             return "Unknown game status";
     }
 }
 
+std::string Game::toFEN() const {
+    // At most 71 characters of pieces and 22 of fields
+    char buffer[96];
+    return std::string(buffer, writeFEN(buffer, sizeof(buffer)));
+}
+
+size_t Game::writeFEN(char* buffer, size_t size) const {
+    return snapshot().writeFEN(buffer, size);
+}
+
+bool Game::loadFEN(const std::string& fen) {
+    std::istringstream fields(fen);
+    std::string placement, side, castling = "-", enPassant = "-";
+    int halfmove = 0, fullmove = 1;
+    if (!(fields >> placement >> side)) return false;
+    fields >> castling >> enPassant >> halfmove >> fullmove;
+    if (side != "w" && side != "b") return false;
+    
+    GameState state;
+    int row = 0, col = 0;
+    for (char c : placement) {
+        if (c == '/') {
+            if (col != 8) return false;
+            ++row;
+            col = 0;
+        } else if (c >= '1' && c <= '8') {
+            col += c - '0';
+        } else {
+            static const std::string symbols = "prnbqk";  // PieceType order
+            size_t type = symbols.find(static_cast<char>(std::tolower(static_cast<unsigned char>(c))));
+            if (type == std::string::npos || row > 7 || col > 7) return false;
+            PieceColor color = std::isupper(static_cast<unsigned char>(c)) ? PieceColor::WHITE : PieceColor::BLACK;
+            // Pawns off their home rank and pieces without castling rights have moved
+            int homeRow = (color == PieceColor::WHITE) ? 6 : 1;
+            bool moved = (type == 0 && row != homeRow);
+            state.squares[row * 8 + col] = GameState::encodePiece(static_cast<PieceType>(type), color, moved);
+            ++col;
+        }
+        if (col > 8) return false;
+    }
+    if (row != 7 || col != 8) return false;
+    
+    auto markMoved = [&state](int sq, PieceType type) {
+        uint8_t& code = state.squares[sq];
+        if (code && GameState::pieceType(code) == type) code |= 16;
+    };
+    auto has = [&castling](char right) { return castling.find(right) != std::string::npos; };
+    if (!has('K') && !has('Q')) markMoved(60, PieceType::KING);
+    if (!has('k') && !has('q')) markMoved(4, PieceType::KING);
+    if (!has('K')) markMoved(63, PieceType::ROOK);
+    if (!has('Q')) markMoved(56, PieceType::ROOK);
+    if (!has('k')) markMoved(7, PieceType::ROOK);
+    if (!has('q')) markMoved(0, PieceType::ROOK);
+    
+    if (enPassant != "-") {
+        if (!Utils::isValidSquareNotation(enPassant)) return false;
+        Position target = Utils::squareToPosition(enPassant);
+        state.enPassant = static_cast<uint8_t>(target.row * 8 + target.col);
+    }
+    state.sideToMove = (side == "w") ? 0 : 1;
+    state.halfmoveClock = static_cast<uint16_t>(std::max(0, halfmove));
+    state.fullmoveNumber = static_cast<uint16_t>(std::max(1, fullmove));
+    
+    if (!restoreState(state)) return false;
+    updateGameStatus();
+    start_fen_ = fen;
+    return true;
+}
+
+GameState Game::saveState() const {
+    PositionSnapshot position = snapshot();
+    GameState state;
+    state.squares = position.squares;
+    state.sideToMove = position.sideToMove;
+    state.status = static_cast<uint8_t>(game_status_);
+    state.enPassant = position.enPassant;
+    state.drawOffered = draw_offered_ ? 1 : 0;
+    state.halfmoveClock = position.halfmoveClock;
+    state.fullmoveNumber = position.fullmoveNumber;
+    if (first_ply_ == 0) state.start = plies_.front().position;
+    
+    state.moves.reserve(move_history_.size());
+    for (const auto& move : move_history_) {
+        const Piece* captured = move.getCapturedPiece();
+        PackedMove packed;
+        packed.from = static_cast<uint8_t>(move.getFrom().row * 8 + move.getFrom().col);
+        packed.to = static_cast<uint8_t>(move.getTo().row * 8 + move.getTo().col);
+        packed.kind = static_cast<uint8_t>(static_cast<int>(move.getType()) | (static_cast<int>(move.getPromotionPiece()) << 4));
+        packed.captured = captured ? GameState::encodePiece(captured->getType(), captured->getColor(), captured->hasMoved()) : 0;
+        state.moves.push_back(packed);
+    }
+    return state;
+}
+
+PositionSnapshot Game::snapshot() const {
+    PositionSnapshot position = board_.snapshot(current_player_);
+    position.halfmoveClock = static_cast<uint16_t>(halfmove_clock_);
+    position.fullmoveNumber = static_cast<uint16_t>(fullmove_number_);
+    return position;
+}
+
+bool Game::restoreSnapshot(const PositionSnapshot& position) {
+    int whiteKing = position.kingSquare(PieceColor::WHITE);
+    int blackKing = position.kingSquare(PieceColor::BLACK);
+    int kings = 0;
+    for (uint8_t code : position.squares) {
+        if (!code) continue;
+        if ((code & 7) == 0 || (code & 7) > 6) return false;
+        if (PositionSnapshot::isType(code, PieceType::KING)) ++kings;
+    }
+    if (whiteKing < 0 || blackKing < 0 || kings != 2) return false;
+    
+    board_.restore(position);
+    current_player_ = position.side();
+    halfmove_clock_ = position.halfmoveClock;
+    fullmove_number_ = std::max<int>(position.fullmoveNumber, 1);
+    draw_offered_ = false;
+    move_history_.clear();
+    resetLine();
+    game_status_ = GameStatus::ONGOING;
+    updateGameStatus();
+    start_fen_ = toFEN();
+    return true;
+}
+
+bool Game::restoreState(const GameState& state) {
+    // With a start position the line is rebuilt by replaying the moves, so
+    // the restored game can still seek back to its first ply
+    if (state.start && replayState(state)) return true;
+    
+    int kings[2] = {0, 0};
+    for (uint8_t code : state.squares) {
+        if (!code) continue;
+        if ((code & 7) == 0 || (code & 7) > 6) return false;
+        if (GameState::pieceType(code) == PieceType::KING) ++kings[(code & 8) ? 1 : 0];
+    }
+    if (kings[0] != 1 || kings[1] != 1) return false;
+    
+    board_.clearBoard();
+    for (int sq = 0; sq < 64; ++sq) {
+        uint8_t code = state.squares[sq];
+        if (!code) continue;
+        auto piece = Piece::create(GameState::pieceType(code), GameState::pieceColor(code));
+        piece->setMoved(GameState::pieceMoved(code));
+        board_.placePiece(std::move(piece), Position(sq / 8, sq % 8));
+    }
+    if (state.enPassant != GameState::NO_SQUARE) {
+        board_.setEnPassantTarget(Position(state.enPassant / 8, state.enPassant % 8));
+    }
+    
+    current_player_ = state.sideToMove ? PieceColor::BLACK : PieceColor::WHITE;
+    game_status_ = static_cast<GameStatus>(state.status);
+    draw_offered_ = state.drawOffered != 0;
+    halfmove_clock_ = state.halfmoveClock;
+    fullmove_number_ = state.fullmoveNumber;
+    
+    start_fen_.clear();
+    draw_reason_ = DrawReason::NONE;
+    legal_targets_valid_ = false;
+    move_history_.clear();
+    move_history_.reserve(state.moves.size());
+    for (const auto& packed : state.moves) {
+        Position from(packed.from / 8, packed.from % 8);
+        Position to(packed.to / 8, packed.to % 8);
+        MoveType type = static_cast<MoveType>(packed.kind & 0x0F);
+        
+        Move move = (type == MoveType::PAWN_PROMOTION)
+            ? Move(from, to, static_cast<PieceType>(packed.kind >> 4))
+            : Move(from, to, type);
+        if (packed.captured) {
+            auto captured = Piece::create(GameState::pieceType(packed.captured), GameState::pieceColor(packed.captured));
+            captured->setMoved(GameState::pieceMoved(packed.captured));
+            move.setCapturedPiece(std::move(captured));
+        }
+        move_history_.push_back(std::move(move));
+    }
+    resetLine();
+    return true;
+}
+
+bool Game::replayState(const GameState& state) {
+    if (!restoreSnapshot(*state.start)) return false;
+    if (*state.start == PositionSnapshot::initial()) start_fen_.clear();
+    
+    for (const auto& packed : state.moves) {
+        Position from(packed.from / 8, packed.from % 8);
+        Position to(packed.to / 8, packed.to % 8);
+        bool promotion = static_cast<MoveType>(packed.kind & 0x0F) == MoveType::PAWN_PROMOTION;
+        if (!makeMove(promotion ? Move(from, to, static_cast<PieceType>(packed.kind >> 4)) : Move(from, to))) {
+            return false;
+        }
+    }
+    PositionSnapshot position = board_.snapshot(current_player_);
+    if (position.squares != state.squares || position.enPassant != state.enPassant) return false;
+    
+    // Status and side to move come from the state, which may record a
+    // resignation or an accepted draw the moves alone do not show
+    current_player_ = state.sideToMove ? PieceColor::BLACK : PieceColor::WHITE;
+    game_status_ = static_cast<GameStatus>(state.status);
+    draw_offered_ = state.drawOffered != 0;
+    halfmove_clock_ = state.halfmoveClock;
+    fullmove_number_ = state.fullmoveNumber;
+    legal_targets_valid_ = false;
+    return true;
+}
+
+void Game::setTimeControl(const TimeControl& control) {
+    clock_.emplace(control);
+}
+
+void Game::startClock(GameClock::Clock::time_point now) {
+    if (clock_ && !isGameOver()) clock_->start(current_player_, now);
+}
+
+void Game::setRemainingTime(PieceColor side, GameClock::Clock::duration left) {
+    if (clock_) clock_->setRemaining(side, left);
+}
+
+bool Game::checkFlag(GameClock::Clock::time_point now) {
+    if (!clock_ || !clock_->hasFlagged(now)) return false;
+    
+    clock_->stop(now);
+    forfeitOnTime();
+    return true;
+}
+
+void Game::forfeitOnTime() {
+    PieceColor opponent = (current_player_ == PieceColor::WHITE) ? PieceColor::BLACK : PieceColor::WHITE;
+    if (Material::isBareKing(board_.getMaterialKey(), opponent)) {
+        game_status_ = GameStatus::DRAW;
+        draw_reason_ = DrawReason::TIMEOUT_VS_INSUFFICIENT_MATERIAL;
+    } else {
+        game_status_ = GameStatus::TIME_FORFEIT;
+    }
+}
+
 void Game::setPlayer(PieceColor color, std::unique_ptr<Player> player) {
     if (color == PieceColor::WHITE) {
         white_player_ = std::move(player);
@@ -203,6 +510,8 @@ bool Game::offerDraw() {
 bool Game::acceptDraw() {
     if (draw_offered_) {
         game_status_ = GameStatus::DRAW;
+        draw_reason_ = DrawReason::AGREEMENT;
+        if (clock_) clock_->stop(GameClock::Clock::now());
         return true;
     }
     return false;
@@ -211,6 +520,7 @@ bool Game::acceptDraw() {
 void Game::resignGame(PieceColor color) {
     game_status_ = GameStatus::CHECKMATE;
     current_player_ = color;
+    if (clock_) clock_->stop(GameClock::Clock::now());
 }
 
 void Game::switchPlayer() {
@@ -218,13 +528,28 @@ void Game::switchPlayer() {
 }
 
 void Game::updateGameStatus() {
-    if (board_.isInCheckmate(current_player_)) {
+    CHESS_STAT(STATUS_UPDATES);
+    CHESS_STAT_TIMER(STATUS_UPDATE_NANOS);
+    CHESS_LATENCY(UPDATE_STATUS);
+    CHESS_TRACE_SPAN("Game::updateGameStatus");
+    draw_reason_ = DrawReason::NONE;
+    legal_targets_valid_ = false;
+    bool inCheck = board_.isInCheck(current_player_);
+    bool canMove = hasLegalMoves();
+    if (inCheck && !canMove) {
         game_status_ = GameStatus::CHECKMATE;
-    } else if (board_.isInStalemate(current_player_)) {
+    } else if (!canMove) {
         game_status_ = GameStatus::STALEMATE;
-    } else if (isFiftyMoveRule() || isThreefoldRepetition() || isInsufficientMaterial()) {
+    } else if (isFiftyMoveRule()) {
+        game_status_ = GameStatus::DRAW;
+        draw_reason_ = DrawReason::FIFTY_MOVE_RULE;
+    } else if (isThreefoldRepetition()) {
         game_status_ = GameStatus::DRAW;
-    } else if (board_.isInCheck(current_player_)) {
+        draw_reason_ = DrawReason::THREEFOLD_REPETITION;
+    } else if (isInsufficientMaterial()) {
+        game_status_ = GameStatus::DRAW;
+        draw_reason_ = DrawReason::INSUFFICIENT_MATERIAL;
+    } else if (inCheck) {
         game_status_ = GameStatus::CHECK;
     } else {
         game_status_ = GameStatus::ONGOING;
@@ -232,6 +557,14 @@ void Game::updateGameStatus() {
 }
 
 bool Game::isThreefoldRepetition() const {
+    // Only positions since the last capture or pawn move can repeat, and only
+    // every other ply has the same side to move
+    size_t last = getCurrentPly() - first_ply_;
+    size_t window = std::min(last, static_cast<size_t>(halfmove_clock_));
+    int seen = 1;
+    for (size_t back = 2; back <= window; back += 2) {
+        if (plies_[last - back].key == plies_[last].key && ++seen == 3) return true;
+    }
     return false;
 }
 
@@ -240,25 +573,7 @@ bool Game::isFiftyMoveRule() const {
 }
 
 bool Game::isInsufficientMaterial() const {
-    auto whitePieces = board_.getAllPiecesPositions(PieceColor::WHITE);
-    auto blackPieces = board_.getAllPiecesPositions(PieceColor::BLACK);
-    
-    if (whitePieces.size() <= 2 && blackPieces.size() <= 2) {
-        bool whiteHasOnlyKing = whitePieces.size() == 1;
-        bool blackHasOnlyKing = blackPieces.size() == 1;
-        
-        if (whiteHasOnlyKing && blackHasOnlyKing) {
-            return true;
-        }
-        
-        // King vs King + Knight/Bishop
-        if ((whiteHasOnlyKing && blackPieces.size() == 2) || 
-            (blackHasOnlyKing && whitePieces.size() == 2)) {
-            return true;
-        }
-    }
-    
-    return false;
+    return Material::classify(board_.getMaterialKey()) == Material::Outcome::DEAD_DRAW;
 }
 
 Move Game::createMove(const Position& from, const Position& to) {
@@ -311,14 +626,14 @@ bool Game::executeCastling(const Move& move) {
     return true;
 }
 
-bool Game::executeEnPassant(const Move& move) {
+bool Game::executeEnPassant(Move& move) {
     // Move the pawn
     board_.movePiece(move.getFrom(), move.getTo());
     
     // Remove the captured pawn
     int capturedPawnRow = move.getFrom().row;
     Position capturedPawnPos(capturedPawnRow, move.getTo().col);
-    board_.removePiece(capturedPawnPos);
+    move.setCapturedPiece(board_.removePiece(capturedPawnPos));
     
     return true;
 }
@@ -0,0 +1,59 @@
+#include "core/GameClock.h"
+#include <algorithm>
+
+GameClock::GameClock(const TimeControl& control)
+    : control_(control),
+      remaining_{control.base, control.base} {}
+
+void GameClock::start(PieceColor side, Clock::time_point now) {
+    if (running_) return;
+    running_ = true;
+    side_ = side;
+    turn_start_ = now;
+}
+
+void GameClock::stop(Clock::time_point now) {
+    if (!running_) return;
+    remaining_[index(side_)] = remaining(side_, now);
+    running_ = false;
+}
+
+bool GameClock::press(Clock::time_point now) {
+    if (!running_) return true;
+    if (hasFlagged(now)) return false;
+    
+    remaining_[index(side_)] = remaining(side_, now) + control_.increment;
+    side_ = (side_ == PieceColor::WHITE) ? PieceColor::BLACK : PieceColor::WHITE;
+    turn_start_ = now;
+    return true;
+}
+
+void GameClock::switchTo(PieceColor side, Clock::time_point now) {
+    if (!running_) return;
+    remaining_[index(side_)] = remaining(side_, now);
+    side_ = side;
+    turn_start_ = now;
+}
+
+void GameClock::setRemaining(PieceColor side, Clock::duration left) {
+    if (!running_) remaining_[index(side)] = left;
+}
+
+GameClock::Clock::duration GameClock::remaining(PieceColor side, Clock::time_point now) const {
+    Clock::duration left = remaining_[index(side)];
+    if (running_ && side == side_) left -= charged(now);
+    return std::max(left, Clock::duration::zero());
+}
+
+bool GameClock::hasFlagged(Clock::time_point now) const {
+    return running_ && now >= flagTime();
+}
+
+GameClock::Clock::time_point GameClock::flagTime() const {
+    if (!running_) return Clock::time_point::max();
+    return turn_start_ + control_.delay + remaining_[index(side_)];
+}
+
+GameClock::Clock::duration GameClock::charged(Clock::time_point now) const {
+    return std::max(now - turn_start_ - control_.delay, Clock::duration::zero());
+}
\ No newline at end of file
@@ -0,0 +1,136 @@
+#include "core/GameState.h"
+#include <algorithm>
+
+namespace {
+
+constexpr uint8_t MAGIC[4] = {'R', 'C', 'G', 'S'};
+constexpr uint8_t VERSION = 2;
+constexpr size_t HEADER_SIZE = 4 + 1 + 64 + 4 + 2 + 2 + 4;
+
+// Version 2 follows the header with a start kind byte, and for START_CUSTOM
+// the squares, side, en passant square and clocks of the start position
+constexpr uint8_t START_NONE = 0;
+constexpr uint8_t START_INITIAL = 1;
+constexpr uint8_t START_CUSTOM = 2;
+constexpr size_t START_SIZE = 64 + 1 + 1 + 2 + 2;
+
+void put16(std::vector<uint8_t>& out, uint16_t value) {
+    out.push_back(static_cast<uint8_t>(value & 0xFF));
+    out.push_back(static_cast<uint8_t>(value >> 8));
+}
+
+uint16_t get16(const uint8_t* p) {
+    return static_cast<uint16_t>(p[0] | (p[1] << 8));
+}
+
+}
+
+uint8_t GameState::encodePiece(PieceType type, PieceColor color, bool moved) {
+    return static_cast<uint8_t>((static_cast<int>(type) + 1) |
+                                (color == PieceColor::BLACK ? 8 : 0) |
+                                (moved ? 16 : 0));
+}
+
+PositionSnapshot GameState::position() const {
+    PositionSnapshot position{};
+    position.squares = squares;
+    position.sideToMove = sideToMove;
+    position.enPassant = enPassant;
+    position.halfmoveClock = halfmoveClock;
+    position.fullmoveNumber = fullmoveNumber;
+    return position;
+}
+
+std::vector<uint8_t> GameState::serialize() const {
+    std::vector<uint8_t> out;
+    out.reserve(HEADER_SIZE + 1 + START_SIZE + moves.size() * sizeof(PackedMove));
+    
+    out.insert(out.end(), MAGIC, MAGIC + 4);
+    out.push_back(VERSION);
+    out.insert(out.end(), squares.begin(), squares.end());
+    out.push_back(sideToMove);
+    out.push_back(status);
+    out.push_back(enPassant);
+    out.push_back(drawOffered);
+    put16(out, halfmoveClock);
+    put16(out, fullmoveNumber);
+    put16(out, static_cast<uint16_t>(moves.size() & 0xFFFF));
+    put16(out, static_cast<uint16_t>(moves.size() >> 16));
+    
+    if (!start) {
+        out.push_back(START_NONE);
+    } else if (*start == PositionSnapshot::initial()) {
+        out.push_back(START_INITIAL);
+    } else {
+        out.push_back(START_CUSTOM);
+        out.insert(out.end(), start->squares.begin(), start->squares.end());
+        out.push_back(start->sideToMove);
+        out.push_back(start->enPassant);
+        put16(out, start->halfmoveClock);
+        put16(out, start->fullmoveNumber);
+    }
+    
+    for (const auto& move : moves) {
+        out.push_back(move.from);
+        out.push_back(move.to);
+        out.push_back(move.kind);
+        out.push_back(move.captured);
+    }
+    return out;
+}
+
+std::optional<GameState> GameState::deserialize(const uint8_t* data, size_t size) {
+    if (size < HEADER_SIZE || !std::equal(MAGIC, MAGIC + 4, data) || data[4] < 1 || data[4] > VERSION) {
+        return std::nullopt;
+    }
+    const uint8_t* end = data + size;
+    
+    GameState state;
+    const uint8_t* p = data + 5;
+    std::copy(p, p + 64, state.squares.begin());
+    p += 64;
+    state.sideToMove = p[0];
+    state.status = p[1];
+    state.enPassant = p[2];
+    state.drawOffered = p[3];
+    state.halfmoveClock = get16(p + 4);
+    state.fullmoveNumber = get16(p + 6);
+    size_t moveCount = get16(p + 8) | (static_cast<size_t>(get16(p + 10)) << 16);
+    p += 12;
+    
+    if (data[4] >= 2) {
+        if (p == end || p[0] > START_CUSTOM) return std::nullopt;
+        uint8_t kind = *p++;
+        if (kind == START_INITIAL) {
+            state.start = PositionSnapshot::initial();
+        } else if (kind == START_CUSTOM) {
+            if (static_cast<size_t>(end - p) < START_SIZE) return std::nullopt;
+            PositionSnapshot position{};
+            std::copy(p, p + 64, position.squares.begin());
+            position.sideToMove = p[64];
+            position.enPassant = p[65];
+            position.halfmoveClock = get16(p + 66);
+            position.fullmoveNumber = get16(p + 68);
+            p += START_SIZE;
+            if (position.sideToMove > 1 || position.enPassant > NO_SQUARE) return std::nullopt;
+            state.start = position;
+        }
+    }
+    
+    if (static_cast<size_t>(end - p) != moveCount * 4) return std::nullopt;
+    for (uint8_t code : state.squares) {
+        if (code != 0 && ((code & 7) == 0 || (code & 7) > 6)) return std::nullopt;
+    }
+    if (state.sideToMove > 1 || state.status > static_cast<uint8_t>(GameStatus::TIME_FORFEIT) ||
+        state.enPassant > NO_SQUARE) {
+        return std::nullopt;
+    }
+    
+    state.moves.resize(moveCount);
+    for (auto& move : state.moves) {
+        move = {p[0], p[1], p[2], p[3]};
+        if (move.from >= 64 || move.to >= 64) return std::nullopt;
+        p += 4;
+    }
+    return state;
+}
\ No newline at end of file
@@ -0,0 +1,288 @@
+#include "core/MCTSPlayer.h"
+#include "core/Board.h"
+#include "core/Game.h"
+#include <algorithm>
+#include <cmath>
+#include <thread>
+#include <vector>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+// Scores are summed as fixed point so nodes can use integer atomics
+constexpr int64_t SCORE_UNIT = 1 << 20;
+// Room left before a request deadline for the last ply to finish and the
+// helpers to join
+constexpr auto DEADLINE_MARGIN = std::chrono::milliseconds(10);
+
+enum NodeState : uint8_t {
+    UNEXPANDED,
+    EXPANDING,
+    EXPANDED,
+    TERMINAL
+};
+
+// Root position for the per-thread games; restoreState leaves the legal
+// move table to be built on demand, unlike restoreSnapshot
+GameState rootState(const Board& board, PieceColor sideToMove) {
+    PositionSnapshot position = board.snapshot(sideToMove);
+    GameState state;
+    state.squares = position.squares;
+    state.enPassant = position.enPassant;
+    state.sideToMove = position.sideToMove;
+    return state;
+}
+
+// Endings the material key already decides need no further playout
+bool isKnownResult(const Game& game) {
+    return Material::classify(game.getBoard().getMaterialKey()) != Material::Outcome::UNKNOWN;
+}
+
+// Chance that side wins from here: 0 or 1 when decided by the rules or the
+// material, else a logistic curve over the material balance
+double evaluate(const Game& game, PieceColor side) {
+    GameStatus status = game.getGameStatus();
+    if (status == GameStatus::CHECKMATE) {
+        return game.getCurrentPlayer() == side ? 0.0 : 1.0;
+    }
+    if (status == GameStatus::STALEMATE || status == GameStatus::DRAW) {
+        return 0.5;
+    }
+    Material::Key key = game.getBoard().getMaterialKey();
+    switch (Material::classify(key)) {
+        case Material::Outcome::DEAD_DRAW:
+        case Material::Outcome::DRAWN: return 0.5;
+        case Material::Outcome::WHITE_WINS: return side == PieceColor::WHITE ? 1.0 : 0.0;
+        case Material::Outcome::BLACK_WINS: return side == PieceColor::BLACK ? 1.0 : 0.0;
+        case Material::Outcome::UNKNOWN: break;
+    }
+    
+    int balance = Material::balance(key);
+    if (side == PieceColor::BLACK) balance = -balance;
+    return 1.0 / (1.0 + std::exp(-0.4 * balance));
+}
+
+}
+
+struct MCTSPlayer::Node {
+    // Visits include virtual losses still in flight
+    std::atomic<int32_t> visits;
+    // Results for the side that played the move into this node
+    std::atomic<int64_t> score;
+    std::atomic<uint8_t> state;
+    uint8_t from;
+    uint8_t to;
+    uint16_t childCount;
+    uint32_t firstChild;
+    
+    void reset(uint8_t moveFrom, uint8_t moveTo) {
+        visits.store(0, std::memory_order_relaxed);
+        score.store(0, std::memory_order_relaxed);
+        state.store(UNEXPANDED, std::memory_order_relaxed);
+        from = moveFrom;
+        to = moveTo;
+        childCount = 0;
+        firstChild = 0;
+    }
+};
+
+struct MCTSPlayer::Search {
+    GameState root;
+    PieceColor side;
+    Clock::time_point stopAt;
+    const MoveRequest* request;
+    std::atomic<uint32_t> nodeCount{1};
+    std::atomic<bool> arenaFull{false};
+    std::atomic<uint64_t> iterations{0};
+    unsigned seed;
+};
+
+MCTSPlayer::MCTSPlayer(const std::string& name, PieceColor color, const MCTSConfig& config, unsigned seed)
+    : ComputerPlayer(name, color, seed), config_(config), nodes_(new Node[std::max<uint32_t>(config.maxNodes, 1)]) {
+    config_.threads = std::max(1u, config_.threads);
+    config_.maxNodes = std::max<uint32_t>(config_.maxNodes, 1);
+}
+
+MCTSPlayer::~MCTSPlayer() {
+    stopWorker();
+}
+
+MCTSStats MCTSPlayer::getLastSearchStats() const {
+    std::lock_guard<std::mutex> lock(stats_mutex_);
+    return last_stats_;
+}
+
+Move MCTSPlayer::chooseMove(const Board& board, const MoveRequest& request) {
+    auto start = Clock::now();
+    Search search;
+    search.root = rootState(board, color_);
+    search.side = color_;
+    search.stopAt = start + config_.budget;
+    if (request.deadline() != Clock::time_point::max()) {
+        search.stopAt = std::min(search.stopAt, request.deadline() - DEADLINE_MARGIN);
+    }
+    search.request = &request;
+    search.seed = static_cast<unsigned>(rng_());
+    nodes_[0].reset(0, 0);
+    
+    std::vector<std::thread> helpers;
+    for (unsigned t = 1; t < config_.threads; ++t) {
+        helpers.emplace_back([this, &search, t]() { runSearch(search, t); });
+    }
+    runSearch(search, 0);
+    for (auto& helper : helpers) helper.join();
+    
+    const Node& root = nodes_[0];
+    const Node* best = nullptr;
+    if (root.state.load(std::memory_order_acquire) == EXPANDED) {
+        for (uint32_t i = 0; i < root.childCount; ++i) {
+            const Node& child = nodes_[root.firstChild + i];
+            if (!best || child.visits.load(std::memory_order_relaxed) > best->visits.load(std::memory_order_relaxed)) {
+                best = &child;
+            }
+        }
+    }
+    
+    {
+        std::lock_guard<std::mutex> lock(stats_mutex_);
+        last_stats_.iterations = search.iterations.load();
+        last_stats_.nodes = std::min(search.nodeCount.load(), config_.maxNodes);
+        last_stats_.bestVisits = best ? static_cast<uint32_t>(best->visits.load()) : 0;
+        last_stats_.seconds = std::chrono::duration<double>(Clock::now() - start).count();
+    }
+    
+    if (!best) {
+        return ComputerPlayer::chooseMove(board, request);
+    }
+    return Move(Position(best->from / 8, best->from % 8), Position(best->to / 8, best->to % 8));
+}
+
+bool MCTSPlayer::expand(Search& search, Node& node, const Game& game) {
+    uint8_t expected = UNEXPANDED;
+    if (search.arenaFull.load(std::memory_order_relaxed) ||
+        !node.state.compare_exchange_strong(expected, EXPANDING, std::memory_order_acquire)) {
+        return false;
+    }
+    
+    uint64_t targets[64];
+    uint32_t count = 0;
+    for (int sq = 0; sq < 64; ++sq) {
+        targets[sq] = game.getLegalTargets(Position(sq / 8, sq % 8));
+        count += static_cast<uint32_t>(__builtin_popcountll(targets[sq]));
+    }
+    
+    uint32_t first = search.nodeCount.fetch_add(count, std::memory_order_relaxed);
+    if (count == 0 || first + count > config_.maxNodes) {
+        if (count != 0) search.arenaFull.store(true, std::memory_order_relaxed);
+        node.state.store(count == 0 ? TERMINAL : UNEXPANDED, std::memory_order_release);
+        return false;
+    }
+    
+    uint32_t next = first;
+    for (int sq = 0; sq < 64; ++sq) {
+        for (uint64_t bits = targets[sq]; bits; bits &= bits - 1) {
+            nodes_[next++].reset(static_cast<uint8_t>(sq), static_cast<uint8_t>(__builtin_ctzll(bits)));
+        }
+    }
+    node.firstChild = first;
+    node.childCount = static_cast<uint16_t>(count);
+    node.state.store(EXPANDED, std::memory_order_release);
+    return true;
+}
+
+void MCTSPlayer::runSearch(Search& search, unsigned threadIndex) {
+    std::mt19937 rng(search.seed + threadIndex * 7919u);
+    Game game;
+    std::vector<uint32_t> path;
+    std::vector<std::pair<int, uint64_t>> movable;
+    const int32_t virtualLoss = config_.virtualLoss;
+    
+    while (Clock::now() < search.stopAt && !search.request->isCancelled()) {
+        if (!game.restoreState(search.root)) return;
+        path.assign(1, 0);
+        Node* node = &nodes_[0];
+        node->visits.fetch_add(1, std::memory_order_relaxed);
+        
+        // Selection: descend by UCT through expanded nodes
+        while (node->state.load(std::memory_order_acquire) == EXPANDED && !game.isGameOver()) {
+            double logParent = std::log(std::max(1, node->visits.load(std::memory_order_relaxed)));
+            Node* best = nullptr;
+            double bestScore = -1.0;
+            for (uint32_t i = 0; i < node->childCount; ++i) {
+                Node& child = nodes_[node->firstChild + i];
+                int32_t visits = child.visits.load(std::memory_order_relaxed);
+                double uct = visits == 0
+                    ? 1e9 + static_cast<double>(rng() & 0xFFFF)
+                    : static_cast<double>(child.score.load(std::memory_order_relaxed)) / SCORE_UNIT / visits +
+                      config_.exploration * std::sqrt(logParent / visits);
+                if (uct > bestScore) {
+                    bestScore = uct;
+                    best = &child;
+                }
+            }
+            best->visits.fetch_add(virtualLoss, std::memory_order_relaxed);
+            game.makeMove(Position(best->from / 8, best->from % 8), Position(best->to / 8, best->to % 8));
+            path.push_back(static_cast<uint32_t>(best - nodes_.get()));
+            node = best;
+        }
+        
+        // Expansion: one new child of the leaf, chosen at random
+        if (!game.isGameOver() && expand(search, *node, game)) {
+            Node& child = nodes_[node->firstChild + rng() % node->childCount];
+            child.visits.fetch_add(virtualLoss, std::memory_order_relaxed);
+            game.makeMove(Position(child.from / 8, child.from % 8), Position(child.to / 8, child.to % 8));
+            path.push_back(static_cast<uint32_t>(&child - nodes_.get()));
+        }
+        
+        // Playout: uniformly random legal moves through the real rules. Out of
+        // time midway, the iteration is dropped and its virtual losses undone.
+        bool outOfTime = false;
+        for (int ply = 0; ply < config_.playoutDepth && !game.isGameOver() && !isKnownResult(game); ++ply) {
+            if (Clock::now() >= search.stopAt) {
+                outOfTime = true;
+                break;
+            }
+            movable.clear();
+            int total = 0;
+            for (int sq = 0; sq < 64; ++sq) {
+                uint64_t targets = game.getLegalTargets(Position(sq / 8, sq % 8));
+                if (targets) {
+                    movable.emplace_back(sq, targets);
+                    total += __builtin_popcountll(targets);
+                }
+            }
+            int pick = static_cast<int>(rng() % static_cast<unsigned>(total));
+            for (const auto& [from, targets] : movable) {
+                int count = __builtin_popcountll(targets);
+                if (pick >= count) {
+                    pick -= count;
+                    continue;
+                }
+                uint64_t bits = targets;
+                while (pick-- > 0) bits &= bits - 1;
+                int to = __builtin_ctzll(bits);
+                game.makeMove(Position(from / 8, from % 8), Position(to / 8, to % 8));
+                break;
+            }
+        }
+        
+        if (outOfTime) {
+            for (size_t depth = 1; depth < path.size(); ++depth) {
+                nodes_[path[depth]].visits.fetch_sub(virtualLoss, std::memory_order_relaxed);
+            }
+            nodes_[0].visits.fetch_sub(1, std::memory_order_relaxed);
+            break;
+        }
+        
+        // Backpropagation: a node at odd depth was entered by the root side
+        double value = evaluate(game, search.side);
+        for (size_t depth = 1; depth < path.size(); ++depth) {
+            Node& visited = nodes_[path[depth]];
+            double result = (depth % 2 == 1) ? value : 1.0 - value;
+            visited.score.fetch_add(static_cast<int64_t>(result * SCORE_UNIT), std::memory_order_relaxed);
+            visited.visits.fetch_add(1 - virtualLoss, std::memory_order_relaxed);
+        }
+        search.iterations.fetch_add(1, std::memory_order_relaxed);
+    }
+}
\ No newline at end of file
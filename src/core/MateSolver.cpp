@@ -0,0 +1,258 @@
+#include "core/MateSolver.h"
+#include <algorithm>
+
+namespace {
+
+constexpr uint32_t INF = 1u << 30;
+constexpr size_t BUCKET = 4;
+
+uint32_t saturatingAdd(uint32_t a, uint32_t b) {
+    return std::min<uint64_t>(uint64_t{a} + b, INF - 1);
+}
+
+}
+
+// One legal move out of the node being searched, with the key of the
+// position it leads to and its proof numbers; terminal children (mate,
+// draw or out of plies) keep theirs fixed
+struct MateSolver::Child {
+    Position from;
+    Position to;
+    PieceType promotion;
+    bool isPromotion;
+    bool terminal;
+    uint64_t key;
+    Numbers numbers;
+};
+
+MateSolver::MateSolver(const MateSolverConfig& config)
+    : config_(config) {
+    size_t entries = BUCKET;
+    while (entries * 2 * sizeof(Entry) <= config_.tableBytes) entries *= 2;
+    table_.resize(entries);
+}
+
+void MateSolver::clear() {
+    std::fill(table_.begin(), table_.end(), Entry());
+}
+
+MateSolution MateSolver::solve(const PositionSnapshot& position, int maxMoves) {
+    MateSolution solution;
+    if (maxMoves < 1 || !game_.restoreSnapshot(position)) return solution;
+    attacker_ = game_.getCurrentPlayer();
+    if (game_.isGameOver()) {
+        solution.result = MateResult::NO_MATE;
+        return solution;
+    }
+    
+    nodes_ = 0;
+    limit_ = config_.maxNodes;
+    // Shortest first: a mate in n is usually far cheaper to find than a
+    // proof that nothing shorter exists at the full bound
+    for (int moves = 1; moves <= maxMoves; ++moves) {
+        Numbers root = search(2 * moves - 1, INF, INF);
+        if (root.pn == 0) {
+            solution.result = MateResult::MATE;
+            solution.mateIn = moves;
+            limit_ = nodes_ + config_.maxNodes;
+            extractLine(2 * moves - 1, solution.line);
+            break;
+        }
+        if (root.dn != 0) break;    // Out of budget
+        if (moves == maxMoves) solution.result = MateResult::NO_MATE;
+    }
+    solution.nodes = nodes_;
+    return solution;
+}
+
+bool MateSolver::lookup(uint64_t key, int plies, Numbers& out) const {
+    size_t index = key & (table_.size() - 1) & ~(BUCKET - 1);
+    bool found = false;
+    for (size_t i = index; i < index + BUCKET; ++i) {
+        const Entry& entry = table_[i];
+        if (entry.work == 0 || entry.key != key) continue;
+        if (entry.pn == 0 && entry.plies <= plies) {
+            out = {0, INF};
+            return true;
+        }
+        if (entry.dn == 0 && entry.plies >= plies) {
+            out = {INF, 0};
+            return true;
+        }
+        if (entry.plies == plies) {
+            out = {entry.pn, entry.dn};
+            found = true;
+        }
+    }
+    return found;
+}
+
+void MateSolver::store(uint64_t key, int plies, Numbers numbers, uint64_t work) {
+    size_t index = key & (table_.size() - 1) & ~(BUCKET - 1);
+    Entry* victim = &table_[index];
+    for (size_t i = index; i < index + BUCKET; ++i) {
+        Entry& entry = table_[i];
+        if (entry.work != 0 && entry.key == key && entry.plies == plies) {
+            victim = &entry;
+            break;
+        }
+        if (entry.work < victim->work) victim = &entry;
+    }
+    victim->key = key;
+    victim->pn = numbers.pn;
+    victim->dn = numbers.dn;
+    victim->work = static_cast<uint32_t>(std::clamp<uint64_t>(work, 1, UINT32_MAX));
+    victim->plies = static_cast<uint16_t>(plies);
+}
+
+std::vector<MateSolver::Child> MateSolver::expand(int plies) {
+    bool orNode = game_.getCurrentPlayer() == attacker_;
+    const Board& board = game_.getBoard();
+    std::vector<Child> children;
+    
+    for (const auto& from : board.getAllPiecesPositions(game_.getCurrentPlayer())) {
+        uint64_t targets = game_.getLegalTargets(from);
+        bool pawn = board.getPiece(from)->getType() == PieceType::PAWN;
+        while (targets) {
+            int square = __builtin_ctzll(targets);
+            targets &= targets - 1;
+            Position to(square / 8, square % 8);
+            
+            bool promotes = pawn && (to.row == 0 || to.row == 7);
+            for (PieceType promotion : {PieceType::QUEEN, PieceType::KNIGHT, PieceType::ROOK, PieceType::BISHOP}) {
+                children.push_back({from, to, promotion, promotes, false, 0, {1, 1}});
+                if (!promotes) break;
+            }
+        }
+    }
+    
+    for (auto& child : children) {
+        if (!play(child)) continue;
+        GameStatus status = game_.getGameStatus();
+        if (status == GameStatus::CHECKMATE) {
+            // Only the mating side's moves can mate here: the defender's
+            // checkmating the attacker is a refutation
+            child.terminal = true;
+            child.numbers = orNode ? Numbers{0, INF} : Numbers{INF, 0};
+        } else if (game_.isGameOver() || plies == 1) {
+            child.terminal = true;
+            child.numbers = {INF, 0};
+        } else {
+            child.key = game_.getPositionKey();
+            // An AND child starts with one proof to find per defence, which
+            // steers the search toward checks and other forcing moves
+            if (orNode) {
+                uint32_t replies = 0;
+                for (const auto& square : game_.getBoard().getAllPiecesPositions(game_.getCurrentPlayer())) {
+                    replies += static_cast<uint32_t>(__builtin_popcountll(game_.getLegalTargets(square)));
+                }
+                child.numbers = {replies, 1};
+            }
+            lookup(child.key, plies - 1, child.numbers);
+        }
+        game_.undoLastMove();
+    }
+    return children;
+}
+
+MateSolver::Numbers MateSolver::search(int plies, uint32_t thpn, uint32_t thdn) {
+    bool orNode = game_.getCurrentPlayer() == attacker_;
+    uint64_t key = game_.getPositionKey();
+    uint64_t start = nodes_++;
+    
+    std::vector<Child> children = expand(plies);
+    Numbers numbers{INF, 0};
+    while (true) {
+        // OR: pn is the easiest child proof, dn the sum of disproofs; an
+        // AND node is the mirror image
+        size_t best = 0;
+        uint32_t second = INF;
+        uint32_t minimum = INF;
+        uint32_t sum = 0;
+        for (size_t i = 0; i < children.size(); ++i) {
+            Child& child = children[i];
+            if (!child.terminal) lookup(child.key, plies - 1, child.numbers);
+            uint32_t own = orNode ? child.numbers.pn : child.numbers.dn;
+            uint32_t other = orNode ? child.numbers.dn : child.numbers.pn;
+            if (own < minimum) {
+                second = minimum;
+                minimum = own;
+                best = i;
+            } else if (own < second) {
+                second = own;
+            }
+            sum = saturatingAdd(sum, other);
+        }
+        if (minimum == 0) sum = INF;
+        numbers = orNode ? Numbers{minimum, sum} : Numbers{sum, minimum};
+        
+        if (numbers.pn >= thpn || numbers.dn >= thdn || nodes_ >= limit_ || children.empty()) break;
+        
+        Child& child = children[best];
+        uint64_t ownThreshold = orNode ? thpn : thdn;
+        uint64_t otherThreshold = orNode ? thdn : thpn;
+        uint32_t childOwn = static_cast<uint32_t>(std::min<uint64_t>(ownThreshold, uint64_t{second} + 1));
+        uint32_t childOther = static_cast<uint32_t>(std::min<uint64_t>(
+            otherThreshold - sum + (orNode ? child.numbers.dn : child.numbers.pn), INF));
+        
+        play(child);
+        child.numbers = orNode ? search(plies - 1, childOwn, childOther) : search(plies - 1, childOther, childOwn);
+        game_.undoLastMove();
+    }
+    
+    store(key, plies, numbers, nodes_ - start);
+    return numbers;
+}
+
+bool MateSolver::isProven(int plies) {
+    if (game_.isGameOver()) {
+        return game_.getGameStatus() == GameStatus::CHECKMATE && game_.getCurrentPlayer() != attacker_;
+    }
+    if (plies <= 0) return false;
+    Numbers numbers;
+    if (lookup(game_.getPositionKey(), plies, numbers) && (numbers.pn == 0 || numbers.dn == 0)) {
+        return numbers.pn == 0;
+    }
+    return search(plies, INF, INF).pn == 0;
+}
+
+bool MateSolver::play(const Child& child) {
+    return child.isPromotion ? game_.makeMove(Move(child.from, child.to, child.promotion))
+                             : game_.makeMove(Move(child.from, child.to));
+}
+
+void MateSolver::extractLine(int plies, std::vector<Move>& line) {
+    // The mating side takes its fastest mate and the defender its longest
+    // resistance, each found by proving children at increasing bounds
+    size_t start = game_.getCurrentPly();
+    while (plies > 0 && !game_.isGameOver() && nodes_ < limit_) {
+        bool orNode = game_.getCurrentPlayer() == attacker_;
+        std::vector<Child> children = expand(plies);
+        const Child* chosen = nullptr;
+        int chosenPlies = orNode ? plies : -1;
+        
+        for (const auto& child : children) {
+            play(child);
+            int need = -1;
+            for (int bound = (orNode ? 0 : 1); bound < plies; bound += 2) {
+                if (isProven(bound)) {
+                    need = bound;
+                    break;
+                }
+            }
+            game_.undoLastMove();
+            if (need < 0) continue;
+            if (orNode ? need < chosenPlies : need > chosenPlies) {
+                chosen = &child;
+                chosenPlies = need;
+            }
+        }
+        if (!chosen) break;
+        
+        play(*chosen);
+        line.push_back(chosen->isPromotion ? Move(chosen->from, chosen->to, chosen->promotion)
+                                           : Move(chosen->from, chosen->to));
+        plies = chosenPlies;
+    }
+    game_.seekToPly(start);
+}
\ No newline at end of file
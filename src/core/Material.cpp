@@ -0,0 +1,145 @@
+#include "core/Material.h"
+#include "core/Board.h"
+#include <array>
+#include <initializer_list>
+
+namespace {
+
+using Material::Key;
+using Material::Outcome;
+using Material::Slot;
+
+constexpr Key KINGS = Material::unit(Material::KING, PieceColor::WHITE) | Material::unit(Material::KING, PieceColor::BLACK);
+
+constexpr Key bothSides(Slot slot) {
+    return (Key{0xF} << Material::shift(slot, PieceColor::WHITE)) | (Key{0xF} << Material::shift(slot, PieceColor::BLACK));
+}
+
+constexpr Key LIGHT_BISHOPS = bothSides(Material::LIGHT_BISHOP);
+constexpr Key DARK_BISHOPS = bothSides(Material::DARK_BISHOP);
+
+// Power of two, comfortably above the number of entries so probes stay short
+constexpr size_t TABLE_SIZE = 256;
+
+struct Entry {
+    Key key = 0;
+    Outcome outcome = Outcome::UNKNOWN;
+};
+
+size_t slotFor(Key key) {
+    return static_cast<size_t>((key * 0x9E3779B97F4A7C15ULL) >> 56) & (TABLE_SIZE - 1);
+}
+
+class RecognizerTable {
+public:
+    RecognizerTable() {
+        const std::initializer_list<Slot> minors = {Material::KNIGHT, Material::LIGHT_BISHOP, Material::DARK_BISHOP};
+        for (PieceColor strong : {PieceColor::WHITE, PieceColor::BLACK}) {
+            PieceColor weak = (strong == PieceColor::WHITE) ? PieceColor::BLACK : PieceColor::WHITE;
+            Outcome wins = (strong == PieceColor::WHITE) ? Outcome::WHITE_WINS : Outcome::BLACK_WINS;
+            auto add = [&](std::initializer_list<Slot> own, std::initializer_list<Slot> theirs, Outcome outcome) {
+                Key key = KINGS;
+                for (Slot slot : own) key += Material::unit(slot, strong);
+                for (Slot slot : theirs) key += Material::unit(slot, weak);
+                insert(key, outcome);
+            };
+            
+            // A lone knight cannot mate even with help
+            add({Material::KNIGHT}, {}, Outcome::DEAD_DRAW);
+            add({Material::KNIGHT, Material::KNIGHT}, {}, Outcome::DRAWN);
+            
+            add({Material::QUEEN}, {}, wins);
+            add({Material::ROOK}, {}, wins);
+            add({Material::LIGHT_BISHOP, Material::DARK_BISHOP}, {}, wins);
+            add({Material::LIGHT_BISHOP, Material::KNIGHT}, {}, wins);
+            add({Material::DARK_BISHOP, Material::KNIGHT}, {}, wins);
+            add({Material::QUEEN}, {Material::ROOK}, wins);
+            add({Material::QUEEN, Material::QUEEN}, {Material::QUEEN}, wins);
+            for (Slot minor : minors) {
+                add({Material::QUEEN}, {minor}, wins);
+                add({Material::ROOK}, {minor}, Outcome::DRAWN);
+                for (Slot other : minors) add({minor}, {other}, Outcome::DRAWN);
+            }
+            add({Material::ROOK}, {Material::ROOK}, Outcome::DRAWN);
+            add({Material::QUEEN}, {Material::QUEEN}, Outcome::DRAWN);
+        }
+    }
+    
+    Outcome find(Key key) const {
+        for (size_t i = slotFor(key);; i = (i + 1) & (TABLE_SIZE - 1)) {
+            if (entries_[i].key == key) return entries_[i].outcome;
+            if (entries_[i].key == 0) return Outcome::UNKNOWN;
+        }
+    }
+    
+private:
+    std::array<Entry, TABLE_SIZE> entries_{};
+    
+    void insert(Key key, Outcome outcome) {
+        size_t i = slotFor(key);
+        while (entries_[i].key != 0 && entries_[i].key != key) i = (i + 1) & (TABLE_SIZE - 1);
+        // Symmetric signatures such as KRKR come up once per side
+        if (entries_[i].key == 0) entries_[i] = Entry{key, outcome};
+    }
+};
+
+const RecognizerTable& table() {
+    static const RecognizerTable recognizers;
+    return recognizers;
+}
+
+}
+
+namespace Material {
+
+Slot slotOf(PieceType type, const Position& pos) {
+    switch (type) {
+        case PieceType::PAWN: return PAWN;
+        case PieceType::KNIGHT: return KNIGHT;
+        // Row 0 is the eighth rank, so a8 (0, 0) is a light square
+        case PieceType::BISHOP: return ((pos.row + pos.col) % 2 == 0) ? LIGHT_BISHOP : DARK_BISHOP;
+        case PieceType::ROOK: return ROOK;
+        case PieceType::QUEEN: return QUEEN;
+        case PieceType::KING: return KING;
+    }
+    return PAWN;
+}
+
+int balance(Key key) {
+    int total = 0;
+    for (PieceColor color : {PieceColor::WHITE, PieceColor::BLACK}) {
+        int side = count(key, PAWN, color) * pieceValue(PieceType::PAWN) +
+                   count(key, KNIGHT, color) * pieceValue(PieceType::KNIGHT) +
+                   (count(key, LIGHT_BISHOP, color) + count(key, DARK_BISHOP, color)) * pieceValue(PieceType::BISHOP) +
+                   count(key, ROOK, color) * pieceValue(PieceType::ROOK) +
+                   count(key, QUEEN, color) * pieceValue(PieceType::QUEEN);
+        total += (color == PieceColor::WHITE) ? side : -side;
+    }
+    return total;
+}
+
+Key key(const Board& board) {
+    Key total = 0;
+    for (int row = 0; row < 8; ++row) {
+        for (int col = 0; col < 8; ++col) {
+            Position pos(row, col);
+            const Piece* piece = board.getPiece(pos);
+            if (piece) total += unit(piece->getType(), piece->getColor(), pos);
+        }
+    }
+    return total;
+}
+
+Outcome classify(Key key) {
+    if ((key & bothSides(Material::KING)) != KINGS) return Outcome::UNKNOWN;
+    
+    // Bare kings, or bishops that all stand on one square colour: no
+    // sequence of legal moves can reach a mate
+    Key rest = key & ~KINGS;
+    if ((rest & ~LIGHT_BISHOPS) == 0 || (rest & ~DARK_BISHOPS) == 0) {
+        return Outcome::DEAD_DRAW;
+    }
+    return table().find(key);
+}
+
+}
\ No newline at end of file
@@ -0,0 +1,346 @@
+#include "core/Notation.h"
+#include "core/Board.h"
+#include "core/Game.h"
+
+namespace {
+
+// Indexed by PieceType
+constexpr char PIECE_LETTERS[] = "PRNBQK";
+
+PieceColor opponent(PieceColor color) {
+    return (color == PieceColor::WHITE) ? PieceColor::BLACK : PieceColor::WHITE;
+}
+
+void appendSquare(std::string& out, const Position& pos) {
+    out += static_cast<char>('a' + pos.col);
+    out += static_cast<char>('8' - pos.row);
+}
+
+std::optional<PieceType> pieceFromLetter(char letter) {
+    switch (letter) {
+        case 'N': return PieceType::KNIGHT;
+        case 'B': return PieceType::BISHOP;
+        case 'R': return PieceType::ROOK;
+        case 'Q': return PieceType::QUEEN;
+        case 'K': return PieceType::KING;
+        default: return std::nullopt;
+    }
+}
+
+bool isLegal(const Board& board, const Piece* piece, const Position& from, const Position& to) {
+    return piece->isValidMove(from, to, board) && !board.wouldBeInCheck(from, to, piece->getColor());
+}
+
+bool isEnPassant(const Board& board, const Piece* piece, const Position& from, const Position& to) {
+    return piece->getType() == PieceType::PAWN && from.col != to.col &&
+           board.getEnPassantTarget() == to && board.isSquareEmpty(to);
+}
+
+// Plays the move on a snapshot, including the rook hop of castling, the
+// pawn taken en passant and promotion, so check and mate can be tested
+// without copying the board
+void applyMove(PositionSnapshot& position, const Position& from, const Position& to, PieceType promotion) {
+    int source = from.row * 8 + from.col;
+    int target = to.row * 8 + to.col;
+    uint8_t code = position.squares[source] | PositionSnapshot::MOVED_BIT;
+    bool pawn = PositionSnapshot::isType(code, PieceType::PAWN);
+    
+    if (PositionSnapshot::isType(code, PieceType::KING) && (to.col - from.col == 2 || from.col - to.col == 2)) {
+        bool kingside = to.col > from.col;
+        int rook = from.row * 8 + (kingside ? 7 : 0);
+        position.squares[from.row * 8 + (kingside ? 5 : 3)] = position.squares[rook] | PositionSnapshot::MOVED_BIT;
+        position.squares[rook] = 0;
+    }
+    if (pawn && from.col != to.col && target == position.enPassant && !position.squares[target]) {
+        position.squares[from.row * 8 + to.col] = 0;
+    }
+    
+    position.squares[target] = code;
+    position.squares[source] = 0;
+    position.enPassant = PositionSnapshot::NO_SQUARE;
+    
+    if (pawn) {
+        PieceColor color = (code & PositionSnapshot::BLACK_BIT) ? PieceColor::BLACK : PieceColor::WHITE;
+        if (to.row == 0 || to.row == 7) {
+            position.squares[target] = PositionSnapshot::encode(promotion, color, true);
+        } else if (to.row - from.row == 2 || from.row - to.row == 2) {
+            position.enPassant = static_cast<uint8_t>((from.row + to.row) / 2 * 8 + from.col);
+        }
+    }
+}
+
+// Takes a move back on a snapshot, the inverse of applyMove, putting back
+// the piece it captured. Whether the mover had moved before is not recorded,
+// so it keeps its moved bit unless it castled.
+void unapplyMove(PositionSnapshot& position, const Move& move) {
+    Position from = move.getFrom();
+    Position to = move.getTo();
+    int source = from.row * 8 + from.col;
+    int target = to.row * 8 + to.col;
+    uint8_t code = position.squares[target];
+    PieceColor color = (code & PositionSnapshot::BLACK_BIT) ? PieceColor::BLACK : PieceColor::WHITE;
+    
+    if (move.isPromotion()) code = PositionSnapshot::encode(PieceType::PAWN, color, true);
+    if (move.isCastling()) {
+        bool kingside = to.col > from.col;
+        int hop = from.row * 8 + (kingside ? 5 : 3);
+        position.squares[from.row * 8 + (kingside ? 7 : 0)] = position.squares[hop] & ~PositionSnapshot::MOVED_BIT;
+        position.squares[hop] = 0;
+        code &= ~PositionSnapshot::MOVED_BIT;
+    }
+    position.squares[source] = code;
+    position.squares[target] = 0;
+    
+    bool enPassant = move.getType() == MoveType::EN_PASSANT;
+    if (const Piece* captured = move.getCapturedPiece()) {
+        position.squares[enPassant ? from.row * 8 + to.col : target] =
+            PositionSnapshot::encode(captured->getType(), captured->getColor(), captured->hasMoved());
+    }
+    position.sideToMove = (color == PieceColor::BLACK) ? 1 : 0;
+    position.enPassant = enPassant ? static_cast<uint8_t>(target) : PositionSnapshot::NO_SQUARE;
+}
+
+bool isResultToken(std::string_view token) {
+    return token == "1-0" || token == "0-1" || token == "1/2-1/2" || token == "*";
+}
+
+}
+
+namespace Notation {
+
+size_t appendSAN(std::string& out, const Board& board, const Position& from, const Position& to,
+                 PieceType promotion) {
+    const Piece* piece = board.getPiece(from);
+    if (!piece) return 0;
+    
+    size_t start = out.size();
+    PieceType type = piece->getType();
+    PieceColor color = piece->getColor();
+    
+    if (type == PieceType::KING && (to.col - from.col == 2 || from.col - to.col == 2)) {
+        out += (to.col > from.col) ? "O-O" : "O-O-O";
+    } else {
+        bool capture = !board.isSquareEmpty(to) || isEnPassant(board, piece, from, to);
+        
+        if (type != PieceType::PAWN) {
+            out += PIECE_LETTERS[static_cast<int>(type)];
+            
+            // Another piece of the same kind that can reach the square forces
+            // the file, else the rank, else both
+            bool ambiguous = false, sharesFile = false, sharesRank = false;
+            for (int row = 0; row < 8; ++row) {
+                for (int col = 0; col < 8; ++col) {
+                    Position pos(row, col);
+                    const Piece* other = board.getPiece(pos);
+                    if (!other || other == piece || other->getType() != type || other->getColor() != color) continue;
+                    if (!isLegal(board, other, pos, to)) continue;
+                    ambiguous = true;
+                    sharesFile |= (col == from.col);
+                    sharesRank |= (row == from.row);
+                }
+            }
+            if (ambiguous) {
+                if (!sharesFile) {
+                    out += static_cast<char>('a' + from.col);
+                } else if (!sharesRank) {
+                    out += static_cast<char>('8' - from.row);
+                } else {
+                    appendSquare(out, from);
+                }
+            }
+        } else if (capture) {
+            out += static_cast<char>('a' + from.col);
+        }
+        
+        if (capture) out += 'x';
+        appendSquare(out, to);
+        
+        if (type == PieceType::PAWN && (to.row == 0 || to.row == 7)) {
+            out += '=';
+            out += PIECE_LETTERS[static_cast<int>(promotion)];
+        }
+    }
+    
+    PieceColor enemy = opponent(color);
+    PositionSnapshot after = board.snapshot(enemy);
+    applyMove(after, from, to, promotion);
+    if (after.isInCheck(enemy)) {
+        out += after.hasLegalMove(enemy) ? '+' : '#';
+    }
+    return out.size() - start;
+}
+
+std::string toSAN(const Board& board, const Position& from, const Position& to, PieceType promotion) {
+    std::string san;
+    san.reserve(8);
+    appendSAN(san, board, from, to, promotion);
+    return san;
+}
+
+std::optional<Move> fromSAN(const Board& board, PieceColor side, std::string_view san) {
+    while (!san.empty() && (san.back() == '+' || san.back() == '#' || san.back() == '!' || san.back() == '?')) {
+        san.remove_suffix(1);
+    }
+    
+    int homeRow = (side == PieceColor::WHITE) ? 7 : 0;
+    if (san == "O-O" || san == "0-0" || san == "O-O-O" || san == "0-0-0") {
+        Position from(homeRow, 4);
+        Position to(homeRow, san.size() == 3 ? 6 : 2);
+        const Piece* king = board.getPiece(from);
+        if (!king || king->getType() != PieceType::KING || king->getColor() != side) return std::nullopt;
+        if (!isLegal(board, king, from, to)) return std::nullopt;
+        return Move(from, to);
+    }
+    
+    PieceType type = PieceType::PAWN;
+    if (!san.empty()) {
+        if (auto letter = pieceFromLetter(san.front())) {
+            type = *letter;
+            san.remove_prefix(1);
+        }
+    }
+    
+    std::optional<PieceType> promotion;
+    if (type == PieceType::PAWN && san.size() >= 3) {
+        char last = san.back();
+        char upper = (last >= 'a' && last <= 'z') ? static_cast<char>(last - 'a' + 'A') : last;
+        char before = san[san.size() - 2];
+        if (before == '=' || (before >= '1' && before <= '8')) {
+            promotion = pieceFromLetter(upper);
+            if (promotion) {
+                if (*promotion == PieceType::KING) return std::nullopt;
+                san.remove_suffix(before == '=' ? 2 : 1);
+            }
+        }
+    }
+    
+    if (san.size() < 2) return std::nullopt;
+    char toFile = san[san.size() - 2];
+    char toRank = san[san.size() - 1];
+    if (toFile < 'a' || toFile > 'h' || toRank < '1' || toRank > '8') return std::nullopt;
+    Position to('8' - toRank, toFile - 'a');
+    san.remove_suffix(2);
+    
+    bool captureMarked = false;
+    if (!san.empty() && (san.back() == 'x' || san.back() == ':')) {
+        captureMarked = true;
+        san.remove_suffix(1);
+    }
+    
+    int fromFile = -1, fromRow = -1;
+    for (char c : san) {
+        if (c >= 'a' && c <= 'h' && fromFile < 0) {
+            fromFile = c - 'a';
+        } else if (c >= '1' && c <= '8' && fromRow < 0) {
+            fromRow = '8' - c;
+        } else {
+            return std::nullopt;
+        }
+    }
+    
+    std::optional<Position> found;
+    for (int row = 0; row < 8; ++row) {
+        if (fromRow >= 0 && row != fromRow) continue;
+        for (int col = 0; col < 8; ++col) {
+            if (fromFile >= 0 && col != fromFile) continue;
+            Position pos(row, col);
+            const Piece* piece = board.getPiece(pos);
+            if (!piece || piece->getType() != type || piece->getColor() != side) continue;
+            if (!isLegal(board, piece, pos, to)) continue;
+            if (found) return std::nullopt;  // ambiguous
+            found = pos;
+        }
+    }
+    if (!found) return std::nullopt;
+    
+    const Piece* piece = board.getPiece(*found);
+    bool capture = !board.isSquareEmpty(to) || isEnPassant(board, piece, *found, to);
+    if (captureMarked && !capture) return std::nullopt;
+    
+    bool promotes = (type == PieceType::PAWN && (to.row == 0 || to.row == 7));
+    if (promotes != promotion.has_value()) return std::nullopt;
+    if (promotes) return Move(*found, to, *promotion);
+    return Move(*found, to);
+}
+
+std::vector<std::string> historyToSAN(const Game& game) {
+    const auto& history = game.getMoveHistory();
+    size_t first = game.getFirstPly();
+    std::vector<std::string> result;
+    result.reserve(history.size());
+    result.resize(first);
+    
+    // A game restored without its start position only keeps positions from
+    // its first ply on; the moves before it are taken back from there
+    PositionSnapshot position = game.getFirstPosition();
+    Board board;
+    for (size_t ply = first; ply-- > 0;) {
+        const Move& move = history[ply];
+        unapplyMove(position, move);
+        board.restore(position);
+        appendSAN(result[ply], board, move.getFrom(), move.getTo(), move.getPromotionPiece());
+    }
+    
+    Game replay;
+    replay.restoreSnapshot(game.getFirstPosition());
+    std::string buffer;
+    for (size_t ply = first; ply < history.size(); ++ply) {
+        const Move& move = history[ply];
+        buffer.clear();
+        appendSAN(buffer, replay.getBoard(), move.getFrom(), move.getTo(), move.getPromotionPiece());
+        result.push_back(buffer);
+        
+        bool played = move.isPromotion() ? replay.makeMove(Move(move.getFrom(), move.getTo(), move.getPromotionPiece()))
+                                         : replay.makeMove(move.getFrom(), move.getTo());
+        if (!played) break;
+    }
+    return result;
+}
+
+std::string_view nextMoveToken(std::string_view text, size_t& pos) {
+    while (pos < text.size()) {
+        char c = text[pos];
+        if (c == ' ' || c == '\t' || c == '\n' || c == '\r') {
+            ++pos;
+            continue;
+        }
+        if (c == '{') {
+            size_t close = text.find('}', pos);
+            pos = (close == std::string_view::npos) ? text.size() : close + 1;
+            continue;
+        }
+        
+        size_t end = text.find_first_of(" \t\n\r{", pos);
+        if (end == std::string_view::npos) end = text.size();
+        std::string_view token = text.substr(pos, end - pos);
+        pos = end;
+        
+        if (isResultToken(token)) {
+            pos = text.size();
+            return {};
+        }
+        
+        // Move numbers: "12." and "12..." alone or glued to the move
+        size_t digits = 0;
+        while (digits < token.size() && token[digits] >= '0' && token[digits] <= '9') ++digits;
+        if (digits > 0 && digits < token.size() && token[digits] == '.') {
+            token.remove_prefix(digits);
+            while (!token.empty() && token.front() == '.') token.remove_prefix(1);
+        }
+        if (!token.empty()) return token;
+    }
+    return {};
+}
+
+size_t playSAN(Game& game, std::string_view text) {
+    size_t played = 0;
+    size_t pos = 0;
+    for (auto token = nextMoveToken(text, pos); !token.empty(); token = nextMoveToken(text, pos)) {
+        auto move = fromSAN(game.getBoard(), game.getCurrentPlayer(), token);
+        if (!move || !game.makeMove(*move)) break;
+        ++played;
+    }
+    return played;
+}
+
+}
\ No newline at end of file
@@ -1,5 +1,6 @@
 #include "core/Piece.h"
 #include "core/Board.h"
+#include "core/Stats.h"
 #include "utils/Utils.h"
 #include <algorithm>
 #include <cmath>
@@ -8,6 +9,18 @@
 Piece::Piece(PieceColor color, PieceType type) 
     : color_(color), type_(type), has_moved_(false) {}
 
+std::unique_ptr<Piece> Piece::create(PieceType type, PieceColor color) {
+    switch (type) {
+        case PieceType::PAWN: return std::make_unique<Pawn>(color);
+        case PieceType::ROOK: return std::make_unique<Rook>(color);
+        case PieceType::KNIGHT: return std::make_unique<Knight>(color);
+        case PieceType::BISHOP: return std::make_unique<Bishop>(color);
+        case PieceType::QUEEN: return std::make_unique<Queen>(color);
+        case PieceType::KING: return std::make_unique<King>(color);
+    }
+    return nullptr;
+}
+
 bool Piece::isPathClear(const Position& from, const Position& to, const Board& board) const {
     int deltaRow = to.row - from.row;
     int deltaCol = to.col - from.col;
@@ -41,6 +54,7 @@ bool Piece::isEmptySquare(const Position& pos, const Board& board) const {
 Pawn::Pawn(PieceColor color) : Piece(color, PieceType::PAWN) {}
 
 std::vector<Position> Pawn::getPossibleMoves(const Position& from, const Board& board) const {
+    CHESS_STAT(POSSIBLE_MOVES_CALLS);
     std::vector<Position> moves;
     int direction = (color_ == PieceColor::WHITE) ? -1 : 1;
     
@@ -87,6 +101,7 @@ bool Pawn::isValidMove(const Position& from, const Position& to, const Board& bo
 }
 
 std::unique_ptr<Piece> Pawn::clone() const {
+    CHESS_STAT(PIECE_CLONES);
     auto newPawn = std::make_unique<Pawn>(color_);
     newPawn->has_moved_ = has_moved_;
     return newPawn;
@@ -100,6 +115,7 @@ char Pawn::getSymbol() const {
 Rook::Rook(PieceColor color) : Piece(color, PieceType::ROOK) {}
 
 std::vector<Position> Rook::getPossibleMoves(const Position& from, const Board& board) const {
+    CHESS_STAT(POSSIBLE_MOVES_CALLS);
     std::vector<Position> moves;
     
     // Horizontal and vertical directions
@@ -134,6 +150,7 @@ bool Rook::isValidMove(const Position& from, const Position& to, const Board& bo
 }
 
 std::unique_ptr<Piece> Rook::clone() const {
+    CHESS_STAT(PIECE_CLONES);
     auto newRook = std::make_unique<Rook>(color_);
     newRook->has_moved_ = has_moved_;
     return newRook;
@@ -147,6 +164,7 @@ char Rook::getSymbol() const {
 Knight::Knight(PieceColor color) : Piece(color, PieceType::KNIGHT) {}
 
 std::vector<Position> Knight::getPossibleMoves(const Position& from, const Board& board) const {
+    CHESS_STAT(POSSIBLE_MOVES_CALLS);
     std::vector<Position> moves;
     
     // Knight move patterns
@@ -178,6 +196,7 @@ bool Knight::isValidMove(const Position& from, const Position& to, const Board&
 }
 
 std::unique_ptr<Piece> Knight::clone() const {
+    CHESS_STAT(PIECE_CLONES);
     auto newKnight = std::make_unique<Knight>(color_);
     newKnight->has_moved_ = has_moved_;
     return newKnight;
@@ -191,6 +210,7 @@ char Knight::getSymbol() const {
 Bishop::Bishop(PieceColor color) : Piece(color, PieceType::BISHOP) {}
 
 std::vector<Position> Bishop::getPossibleMoves(const Position& from, const Board& board) const {
+    CHESS_STAT(POSSIBLE_MOVES_CALLS);
     std::vector<Position> moves;
     
     // Diagonal directions
@@ -225,6 +245,7 @@ bool Bishop::isValidMove(const Position& from, const Position& to, const Board&
 }
 
 std::unique_ptr<Piece> Bishop::clone() const {
+    CHESS_STAT(PIECE_CLONES);
     auto newBishop = std::make_unique<Bishop>(color_);
     newBishop->has_moved_ = has_moved_;
     return newBishop;
@@ -238,6 +259,7 @@ char Bishop::getSymbol() const {
 Queen::Queen(PieceColor color) : Piece(color, PieceType::QUEEN) {}
 
 std::vector<Position> Queen::getPossibleMoves(const Position& from, const Board& board) const {
+    CHESS_STAT(POSSIBLE_MOVES_CALLS);
     std::vector<Position> moves;
     
     // All 8 directions (rook + bishop)
@@ -278,6 +300,7 @@ bool Queen::isValidMove(const Position& from, const Position& to, const Board& b
 }
 
 std::unique_ptr<Piece> Queen::clone() const {
+    CHESS_STAT(PIECE_CLONES);
     auto newQueen = std::make_unique<Queen>(color_);
     newQueen->has_moved_ = has_moved_;
     return newQueen;
@@ -291,6 +314,7 @@ char Queen::getSymbol() const {
 King::King(PieceColor color) : Piece(color, PieceType::KING) {}
 
 std::vector<Position> King::getPossibleMoves(const Position& from, const Board& board) const {
+    CHESS_STAT(POSSIBLE_MOVES_CALLS);
     std::vector<Position> moves;
     
     // All 8 directions, one step each
@@ -342,6 +366,7 @@ bool King::isValidMove(const Position& from, const Position& to, const Board& bo
 }
 
 std::unique_ptr<Piece> King::clone() const {
+    CHESS_STAT(PIECE_CLONES);
     auto newKing = std::make_unique<King>(color_);
     newKing->has_moved_ = has_moved_;
     return newKing;
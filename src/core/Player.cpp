@@ -1,37 +1,221 @@
 #include "core/Player.h"
 #include "core/Board.h"
+#include "core/Stats.h"
 #include "ui/InputParser.h"
 #include "ui/Display.h"
+#include "utils/LineReader.h"
 #include "utils/Utils.h"
-#include <iostream>
+#include <poll.h>
+#include <unistd.h>
+#include <deque>
+#include <functional>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace {
+
+constexpr int INPUT_POLL_MS = 50;
+
+Move noMove() {
+    return Move(Position(-1, -1), Position(-1, -1));
+}
+
+// Waits for console input in short slices so a cancelled request does not
+// leave the worker stuck in a read; empty on cancellation or end of input.
+// Lines already buffered by the console reader are taken without polling.
+std::optional<std::string> readInput(const MoveRequest& request) {
+    LineReader& console = LineReader::console();
+    while (!console.hasLine()) {
+        if (request.isCancelled()) return std::nullopt;
+        pollfd input{STDIN_FILENO, POLLIN, 0};
+        if (::poll(&input, 1, INPUT_POLL_MS) > 0) break;
+    }
+    std::string_view line;
+    if (!console.nextLine(line)) return std::nullopt;
+    return std::string(line);
+}
+
+// Threads shared by every player's requests. An idle thread takes the next
+// job; one is added only when all are busy, since a human's request may sit
+// on input for as long as it likes while an engine thinks.
+class RequestPool {
+public:
+    static RequestPool& instance() {
+        static RequestPool pool;
+        return pool;
+    }
+    
+    void submit(std::function<void()> job) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        jobs_.push_back(std::move(job));
+        if (idle_ < jobs_.size()) {
+            threads_.emplace_back([this]() { run(); });
+        } else {
+            work_cv_.notify_one();
+        }
+    }
+    
+private:
+    RequestPool() = default;
+    
+    ~RequestPool() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stopping_ = true;
+        }
+        work_cv_.notify_all();
+        for (auto& thread : threads_) {
+            thread.join();
+        }
+    }
+    
+    void run() {
+        std::unique_lock<std::mutex> lock(mutex_);
+        while (true) {
+            ++idle_;
+            work_cv_.wait(lock, [this]() { return stopping_ || !jobs_.empty(); });
+            --idle_;
+            if (jobs_.empty()) return;
+            auto job = std::move(jobs_.front());
+            jobs_.pop_front();
+            lock.unlock();
+            job();
+            lock.lock();
+        }
+    }
+    
+    std::mutex mutex_;
+    std::condition_variable work_cv_;
+    std::deque<std::function<void()>> jobs_;
+    std::vector<std::thread> threads_;
+    size_t idle_ = 0;
+    bool stopping_ = false;
+};
+
+}
+
+MoveRequest::MoveRequest(Clock::time_point deadline)
+    : deadline_(deadline), cancelled_(false), done_(false) {}
+
+bool MoveRequest::isCancelled() const {
+    return cancelled_.load(std::memory_order_relaxed) ||
+           (deadline_ != Clock::time_point::max() && Clock::now() >= deadline_);
+}
+
+void MoveRequest::cancel() {
+    cancelled_.store(true, std::memory_order_relaxed);
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        done_ = true;
+    }
+    done_cv_.notify_all();
+}
+
+bool MoveRequest::isDone() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return done_ || isCancelled();
+}
+
+std::optional<Move> MoveRequest::wait() {
+    return waitUntil(deadline_);
+}
+
+std::optional<Move> MoveRequest::waitUntil(Clock::time_point until) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    if (until == Clock::time_point::max()) {
+        done_cv_.wait(lock, [this]() { return done_; });
+    } else {
+        done_cv_.wait_until(lock, std::min(until, deadline_), [this]() { return done_; });
+    }
+    // Out of time counts as given up, so a late answer is discarded
+    if (!done_ && Clock::now() >= deadline_) {
+        done_ = true;
+        cancelled_.store(true, std::memory_order_relaxed);
+    }
+    return std::exchange(move_, std::nullopt);
+}
+
+bool MoveRequest::fulfil(Move move) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (done_ || isCancelled()) return false;
+        move_ = std::move(move);
+        done_ = true;
+    }
+    done_cv_.notify_all();
+    return true;
+}
 
 Player::Player(const std::string& name, PieceColor color)
     : name_(name), color_(color) {}
 
+std::shared_ptr<MoveRequest> Player::requestMove(const Board& board, MoveRequest::Clock::time_point deadline) {
+    stopWorker();
+    
+    auto request = std::make_shared<MoveRequest>(deadline);
+    pending_ = request;
+    searching_ = true;
+    RequestPool::instance().submit([this, request, snapshot = board.snapshot()]() {
+        {
+            CHESS_LATENCY(GET_MOVE);
+            CHESS_TRACE_SPAN("Player::getMove");
+            scratch_.restore(snapshot);
+            request->fulfil(searchMove(scratch_, *request));
+        }
+        // Notify under the lock: once it is released, stopWorker may return
+        // and the player may be gone
+        std::lock_guard<std::mutex> lock(search_mutex_);
+        searching_ = false;
+        search_done_.notify_all();
+    });
+    return request;
+}
+
+Move Player::getMove(const Board& board) {
+    return requestMove(board)->wait().value_or(noMove());
+}
+
+void Player::stopWorker() {
+    if (pending_) {
+        pending_->cancel();
+        pending_.reset();
+    }
+    std::unique_lock<std::mutex> lock(search_mutex_);
+    search_done_.wait(lock, [this]() { return !searching_; });
+}
+
 HumanPlayer::HumanPlayer(const std::string& name, PieceColor color)
     : Player(name, color) {}
 
-Move HumanPlayer::getMove(const Board& board) {
+HumanPlayer::~HumanPlayer() {
+    stopWorker();
+}
+
+Move HumanPlayer::searchMove(const Board& board, const MoveRequest& request) {
     InputParser parser;
     Display display;
     
     while (true) {
         display.displayPrompt(name_ + "'s turn (" + Utils::colorToString(color_) + "): ");
-        std::string input = parser.getUserInput();
+        auto input = readInput(request);
+        if (!input) {
+            return noMove();
+        }
+        ParsedInput parsed = parser.classify(*input);
         
-        if (parser.isQuitCommand(input)) {
-            return Move(Position(-1, -1), Position(-1, -1));
+        if (parsed.command == InputCommand::QUIT) {
+            return noMove();
         }
         
-        if (parser.isHelpCommand(input)) {
+        if (parsed.command == InputCommand::HELP) {
             display.showHelpMessage();
             continue;
         }
         
-        auto movePositions = parser.parseMove(input);
-        if (movePositions) {
-            Position from = movePositions->first;
-            Position to = movePositions->second;
+        if (parsed.command == InputCommand::MOVE) {
+            Position from = parsed.from;
+            Position to = parsed.to;
             
             const Piece* piece = board.getPiece(from);
             if (!piece) {
@@ -53,9 +237,15 @@ Move HumanPlayer::getMove(const Board& board) {
             if (piece->getType() == PieceType::PAWN) {
                 int promotionRow = (color_ == PieceColor::WHITE) ? 0 : 7;
                 if (to.row == promotionRow) {
+                    if (parsed.promotion) {
+                        return Move(from, to, *parsed.promotion);
+                    }
                     display.displayPrompt("Promote to (Q/R/B/N): ");
-                    std::string promotionInput = parser.getUserInput();
-                    auto promotionPiece = parser.parsePromotionPiece(promotionInput);
+                    auto promotionInput = readInput(request);
+                    if (!promotionInput) {
+                        return noMove();
+                    }
+                    auto promotionPiece = parser.parsePromotionPiece(*promotionInput);
                     if (promotionPiece) {
                         return Move(from, to, *promotionPiece);
                     } else {
@@ -69,4 +259,58 @@ Move HumanPlayer::getMove(const Board& board) {
             display.displayError("Invalid input! Use format like 'e2e4' or type 'help'");
         }
     }
+}
+
+ComputerPlayer::ComputerPlayer(const std::string& name, PieceColor color, unsigned seed)
+    : Player(name, color), rng_(seed), book_selection_(BookSelection::WEIGHTED) {}
+
+ComputerPlayer::~ComputerPlayer() {
+    stopWorker();
+}
+
+void ComputerPlayer::setOpeningBook(std::shared_ptr<const PolyglotBook> book, BookSelection selection) {
+    book_ = std::move(book);
+    book_selection_ = selection;
+}
+
+Move ComputerPlayer::searchMove(const Board& board, const MoveRequest& request) {
+    if (book_ && book_->isOpen()) {
+        auto bookMove = book_->pickMove(board, color_, book_selection_, rng_);
+        // Guard against key collisions and books built for other variants
+        if (bookMove && isLegal(board, bookMove->from, bookMove->to)) {
+            return bookMove->toMove();
+        }
+    }
+    return chooseMove(board, request);
+}
+
+Move ComputerPlayer::chooseMove(const Board& board, const MoveRequest&) {
+    auto moves = legalMoves(board);
+    if (moves.empty()) {
+        return noMove();
+    }
+    
+    auto choice = moves[std::uniform_int_distribution<size_t>(0, moves.size() - 1)(rng_)];
+    return Move(choice.first, choice.second);
+}
+
+std::vector<std::pair<Position, Position>> ComputerPlayer::legalMoves(const Board& board) const {
+    std::vector<std::pair<Position, Position>> moves;
+    for (const auto& from : board.getAllPiecesPositions(color_)) {
+        const Piece* piece = board.getPiece(from);
+        for (const auto& to : piece->getPossibleMoves(from, board)) {
+            if (!board.wouldBeInCheck(from, to, color_)) {
+                moves.emplace_back(from, to);
+            }
+        }
+    }
+    CHESS_STAT_ADD(LEGAL_MOVES_GENERATED, moves.size());
+    return moves;
+}
+
+bool ComputerPlayer::isLegal(const Board& board, const Position& from, const Position& to) const {
+    const Piece* piece = board.getPiece(from);
+    if (!piece || piece->getColor() != color_) return false;
+    if (!piece->isValidMove(from, to, board)) return false;
+    return !board.wouldBeInCheck(from, to, color_);
 }
\ No newline at end of file
@@ -0,0 +1,178 @@
+#include "core/PolyglotBook.h"
+#include "core/Board.h"
+#include "core/Zobrist.h"
+
+namespace {
+
+uint64_t readBigEndian(const unsigned char* p, int bytes) {
+    uint64_t value = 0;
+    for (int i = 0; i < bytes; ++i) {
+        value = (value << 8) | p[i];
+    }
+    return value;
+}
+
+void writeBigEndian(unsigned char* p, uint64_t value, int bytes) {
+    for (int i = bytes - 1; i >= 0; --i) {
+        p[i] = static_cast<unsigned char>(value & 0xFF);
+        value >>= 8;
+    }
+}
+
+// Polyglot squares are numbered a1 = 0 .. h8 = 63.
+Position fromPolyglotSquare(int file, int rank) {
+    return Position(7 - rank, file);
+}
+
+}
+
+Move BookMove::toMove() const {
+    if (isPromotion) {
+        return Move(from, to, promotion);
+    }
+    return Move(from, to);
+}
+
+PolyglotBook::PolyglotBook(const std::string& path) {
+    open(path);
+}
+
+bool PolyglotBook::open(const std::string& path) {
+    if (!file_.open(path)) return false;
+    if (file_.size() % ENTRY_SIZE != 0) {
+        file_.close();
+        return false;
+    }
+    return true;
+}
+
+void PolyglotBook::close() {
+    file_.close();
+}
+
+uint64_t PolyglotBook::keyAt(size_t index) const {
+    return readBigEndian(file_.data() + index * ENTRY_SIZE, 8);
+}
+
+BookEntry PolyglotBook::entryAt(size_t index) const {
+    const unsigned char* p = file_.data() + index * ENTRY_SIZE;
+    BookEntry entry;
+    entry.key = readBigEndian(p, 8);
+    entry.move = static_cast<uint16_t>(readBigEndian(p + 8, 2));
+    entry.weight = static_cast<uint16_t>(readBigEndian(p + 10, 2));
+    entry.learn = static_cast<uint32_t>(readBigEndian(p + 12, 4));
+    return entry;
+}
+
+std::vector<BookEntry> PolyglotBook::findEntries(uint64_t key) const {
+    std::vector<BookEntry> entries;
+    
+    // Lower bound over the sorted keys
+    size_t low = 0;
+    size_t high = size();
+    while (low < high) {
+        size_t mid = low + (high - low) / 2;
+        if (keyAt(mid) < key) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+    
+    for (size_t i = low; i < size() && keyAt(i) == key; ++i) {
+        entries.push_back(entryAt(i));
+    }
+    return entries;
+}
+
+std::vector<BookMove> PolyglotBook::lookup(const Board& board, PieceColor sideToMove) const {
+    std::vector<BookMove> moves;
+    if (!isOpen()) return moves;
+    
+    for (const auto& entry : findEntries(Zobrist::hash(board, sideToMove))) {
+        moves.push_back(decodeMove(entry.move, entry.weight, board));
+    }
+    return moves;
+}
+
+std::optional<BookMove> PolyglotBook::pickMove(const Board& board, PieceColor sideToMove,
+                                               BookSelection selection, std::mt19937& rng) const {
+    auto moves = lookup(board, sideToMove);
+    if (moves.empty()) return std::nullopt;
+    
+    switch (selection) {
+        case BookSelection::BEST: {
+            size_t best = 0;
+            for (size_t i = 1; i < moves.size(); ++i) {
+                if (moves[i].weight > moves[best].weight) best = i;
+            }
+            return moves[best];
+        }
+        case BookSelection::WEIGHTED: {
+            uint32_t total = 0;
+            for (const auto& move : moves) total += move.weight;
+            if (total == 0) break;
+            
+            uint32_t pick = std::uniform_int_distribution<uint32_t>(0, total - 1)(rng);
+            for (const auto& move : moves) {
+                if (pick < move.weight) return move;
+                pick -= move.weight;
+            }
+            break;
+        }
+        case BookSelection::RANDOM:
+            break;
+    }
+    
+    return moves[std::uniform_int_distribution<size_t>(0, moves.size() - 1)(rng)];
+}
+
+BookMove PolyglotBook::decodeMove(uint16_t move, uint16_t weight, const Board& board) {
+    BookMove result;
+    result.to = fromPolyglotSquare(move & 7, (move >> 3) & 7);
+    result.from = fromPolyglotSquare((move >> 6) & 7, (move >> 9) & 7);
+    result.weight = weight;
+    result.isPromotion = false;
+    result.promotion = PieceType::QUEEN;
+    
+    static const PieceType promotions[] = {PieceType::KNIGHT, PieceType::BISHOP, PieceType::ROOK, PieceType::QUEEN};
+    int promotion = (move >> 12) & 7;
+    if (promotion >= 1 && promotion <= 4) {
+        result.isPromotion = true;
+        result.promotion = promotions[promotion - 1];
+    }
+    
+    // Castling is stored as the king capturing its own rook
+    const Piece* piece = board.getPiece(result.from);
+    if (piece && piece->getType() == PieceType::KING && result.from.col == 4 && result.from.row == result.to.row) {
+        if (result.to.col == 7) {
+            result.to.col = 6;
+        } else if (result.to.col == 0) {
+            result.to.col = 2;
+        }
+    }
+    
+    return result;
+}
+
+uint16_t PolyglotBook::encodeMove(const Position& from, const Position& to, std::optional<PieceType> promotion) {
+    int promotionCode = 0;
+    if (promotion) {
+        switch (*promotion) {
+            case PieceType::KNIGHT: promotionCode = 1; break;
+            case PieceType::BISHOP: promotionCode = 2; break;
+            case PieceType::ROOK: promotionCode = 3; break;
+            case PieceType::QUEEN: promotionCode = 4; break;
+            default: break;
+        }
+    }
+    return static_cast<uint16_t>(to.col | ((7 - to.row) << 3) | (from.col << 6) |
+                                 ((7 - from.row) << 9) | (promotionCode << 12));
+}
+
+void PolyglotBook::writeEntry(unsigned char* out, const BookEntry& entry) {
+    writeBigEndian(out, entry.key, 8);
+    writeBigEndian(out + 8, entry.move, 2);
+    writeBigEndian(out + 10, entry.weight, 2);
+    writeBigEndian(out + 12, entry.learn, 4);
+}
\ No newline at end of file
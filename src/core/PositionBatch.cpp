@@ -0,0 +1,145 @@
+#include "core/PositionBatch.h"
+#include "BatchKernels.h"
+
+namespace BatchKernels {
+namespace {
+
+// One position per lane: plain 64-bit bitboards
+struct Lane1 {
+    static constexpr size_t WIDTH = 1;
+    uint64_t bits;
+    
+    static Lane1 splat(uint64_t value) { return {value}; }
+    static Lane1 load(const uint64_t* source) { return {*source}; }
+    void store(uint64_t* target) const { *target = bits; }
+    
+    template <int N> Lane1 shl() const { return {bits << N}; }
+    template <int N> Lane1 shr() const { return {bits >> N}; }
+    bool any() const { return bits != 0; }
+    
+    Lane1 operator&(Lane1 other) const { return {bits & other.bits}; }
+    Lane1 operator|(Lane1 other) const { return {bits | other.bits}; }
+    Lane1 operator^(Lane1 other) const { return {bits ^ other.bits}; }
+    Lane1 operator+(Lane1 other) const { return {bits + other.bits}; }
+    Lane1 operator-(Lane1 other) const { return {bits - other.bits}; }
+    Lane1 operator~() const { return {~bits}; }
+    Lane1& operator&=(Lane1 other) { bits &= other.bits; return *this; }
+    Lane1& operator|=(Lane1 other) { bits |= other.bits; return *this; }
+    Lane1& operator^=(Lane1 other) { bits ^= other.bits; return *this; }
+};
+
+Lane1 isZero(Lane1 x) {
+    return {x.bits ? 0 : ALL};
+}
+
+Lane1 popcount(Lane1 x) {
+    return {static_cast<uint64_t>(__builtin_popcountll(x.bits))};
+}
+
+}
+
+Kernel scalarKernel() {
+    return &run<Lane1>;
+}
+
+}
+
+PositionBatch::PositionBatch() {
+    kernel_ = hasAvx2() ? Kernel::AVX2 : Kernel::SCALAR;
+}
+
+bool PositionBatch::hasAvx2() {
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+    return BatchKernels::avx2Kernel() != nullptr && __builtin_cpu_supports("avx2");
+#else
+    return false;
+#endif
+}
+
+bool PositionBatch::setKernel(Kernel kernel) {
+    if (kernel == Kernel::AVX2 && !hasAvx2()) return false;
+    kernel_ = kernel;
+    return true;
+}
+
+void PositionBatch::reserve(size_t positions) {
+    size_t padded = (positions + GROUP - 1) / GROUP * GROUP;
+    for (auto& side : pieces_) {
+        for (auto& lane : side) lane.reserve(padded);
+    }
+    unmoved_.reserve(padded);
+    en_passant_.reserve(padded);
+    black_to_move_.reserve(padded);
+}
+
+void PositionBatch::clear() {
+    size_ = 0;
+    for (auto& side : pieces_) {
+        for (auto& lane : side) lane.clear();
+    }
+    unmoved_.clear();
+    en_passant_.clear();
+    black_to_move_.clear();
+}
+
+void PositionBatch::add(const PositionSnapshot& position) {
+    // Arrays grow a whole group at a time so kernels never read past them;
+    // the zero padding is an empty board
+    if (size_ % GROUP == 0) {
+        size_t padded = size_ + GROUP;
+        for (auto& side : pieces_) {
+            for (auto& lane : side) lane.resize(padded);
+        }
+        unmoved_.resize(padded);
+        en_passant_.resize(padded);
+        black_to_move_.resize(padded);
+    }
+    
+    for (int sq = 0; sq < 64; ++sq) {
+        uint8_t code = position.squares[sq];
+        if (!code) continue;
+        uint64_t bit = uint64_t{1} << sq;
+        pieces_[(code & PositionSnapshot::BLACK_BIT) ? 1 : 0][(code & 7) - 1][size_] |= bit;
+        if (!(code & PositionSnapshot::MOVED_BIT)) unmoved_[size_] |= bit;
+    }
+    if (position.enPassant < 64) en_passant_[size_] = uint64_t{1} << position.enPassant;
+    black_to_move_[size_] = position.sideToMove ? BatchKernels::ALL : 0;
+    ++size_;
+}
+
+std::vector<uint64_t> PositionBatch::run(BatchOp op, PieceColor by) const {
+    BatchKernels::Lanes lanes{};
+    for (int color = 0; color < 2; ++color) {
+        for (int type = 0; type < 6; ++type) lanes.pieces[color][type] = pieces_[color][type].data();
+    }
+    lanes.unmoved = unmoved_.data();
+    lanes.enPassant = en_passant_.data();
+    lanes.blackToMove = black_to_move_.data();
+    lanes.count = unmoved_.size();
+    
+    std::vector<uint64_t> results(lanes.count);
+    auto kernel = (kernel_ == Kernel::AVX2) ? BatchKernels::avx2Kernel() : BatchKernels::scalarKernel();
+    kernel(op, lanes, by == PieceColor::BLACK, results.data());
+    results.resize(size_);
+    return results;
+}
+
+void PositionBatch::attackMaps(PieceColor by, std::vector<uint64_t>& out) const {
+    out = run(BatchOp::ATTACK_MAPS, by);
+}
+
+void PositionBatch::inCheck(std::vector<uint8_t>& out) const {
+    std::vector<uint64_t> results = run(BatchOp::IN_CHECK);
+    out.assign(results.begin(), results.end());
+}
+
+void PositionBatch::legalMoveCounts(std::vector<uint16_t>& out) const {
+    std::vector<uint64_t> results = run(BatchOp::LEGAL_MOVE_COUNTS);
+    out.assign(results.begin(), results.end());
+}
+
+void PositionBatch::materialBalance(std::vector<int16_t>& out) const {
+    std::vector<uint64_t> results = run(BatchOp::MATERIAL_BALANCE);
+    out.resize(results.size());
+    for (size_t i = 0; i < results.size(); ++i) out[i] = static_cast<int16_t>(static_cast<int64_t>(results[i]));
+}
\ No newline at end of file
@@ -0,0 +1,67 @@
+#include "BatchKernels.h"
+
+// Built with -mavx2 (see CMakeLists.txt); PositionBatch only calls in here
+// after checking the CPU
+
+#ifdef __AVX2__
+
+#include <immintrin.h>
+
+namespace BatchKernels {
+namespace {
+
+// Four positions per lane group, one per 64-bit element
+struct Lane4 {
+    static constexpr size_t WIDTH = 4;
+    __m256i bits;
+    
+    static Lane4 splat(uint64_t value) { return {_mm256_set1_epi64x(static_cast<long long>(value))}; }
+    static Lane4 load(const uint64_t* source) { return {_mm256_loadu_si256(reinterpret_cast<const __m256i*>(source))}; }
+    void store(uint64_t* target) const { _mm256_storeu_si256(reinterpret_cast<__m256i*>(target), bits); }
+    
+    template <int N> Lane4 shl() const { return {_mm256_slli_epi64(bits, N)}; }
+    template <int N> Lane4 shr() const { return {_mm256_srli_epi64(bits, N)}; }
+    bool any() const { return !_mm256_testz_si256(bits, bits); }
+    
+    Lane4 operator&(Lane4 other) const { return {_mm256_and_si256(bits, other.bits)}; }
+    Lane4 operator|(Lane4 other) const { return {_mm256_or_si256(bits, other.bits)}; }
+    Lane4 operator^(Lane4 other) const { return {_mm256_xor_si256(bits, other.bits)}; }
+    Lane4 operator+(Lane4 other) const { return {_mm256_add_epi64(bits, other.bits)}; }
+    Lane4 operator-(Lane4 other) const { return {_mm256_sub_epi64(bits, other.bits)}; }
+    Lane4 operator~() const { return {_mm256_xor_si256(bits, _mm256_set1_epi64x(-1))}; }
+    Lane4& operator&=(Lane4 other) { bits = _mm256_and_si256(bits, other.bits); return *this; }
+    Lane4& operator|=(Lane4 other) { bits = _mm256_or_si256(bits, other.bits); return *this; }
+    Lane4& operator^=(Lane4 other) { bits = _mm256_xor_si256(bits, other.bits); return *this; }
+};
+
+Lane4 isZero(Lane4 x) {
+    return {_mm256_cmpeq_epi64(x.bits, _mm256_setzero_si256())};
+}
+
+// AVX2 has no 64-bit popcount: count nibbles with a shuffle table and sum
+// the bytes of each element
+Lane4 popcount(Lane4 x) {
+    const __m256i table = _mm256_setr_epi8(0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4,
+                                           0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4);
+    const __m256i nibble = _mm256_set1_epi8(0x0F);
+    __m256i low = _mm256_and_si256(x.bits, nibble);
+    __m256i high = _mm256_and_si256(_mm256_srli_epi16(x.bits, 4), nibble);
+    __m256i counts = _mm256_add_epi8(_mm256_shuffle_epi8(table, low), _mm256_shuffle_epi8(table, high));
+    return {_mm256_sad_epu8(counts, _mm256_setzero_si256())};
+}
+
+}
+
+Kernel avx2Kernel() {
+    return &run<Lane4>;
+}
+
+}
+
+#else
+
+BatchKernels::Kernel BatchKernels::avx2Kernel() {
+    return nullptr;
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,221 @@
+#include "core/PositionIndex.h"
+#include "core/Game.h"
+#include "core/Notation.h"
+#include "core/Zobrist.h"
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <queue>
+#include <thread>
+
+namespace {
+
+constexpr char MAGIC[4] = {'R', 'C', 'P', 'I'};
+constexpr uint32_t VERSION = 1;
+constexpr size_t HEADER_SIZE = 32;
+constexpr size_t FANOUT_BYTES = (PositionIndex::FANOUT_SIZE + 1) * sizeof(uint64_t);
+constexpr size_t GAMES_PER_CLAIM = 64;
+constexpr size_t WRITE_BATCH = 4096;
+
+static_assert(sizeof(PositionRecord) == 16, "records are stored as raw structs");
+static_assert((HEADER_SIZE + FANOUT_BYTES) % alignof(PositionRecord) == 0, "records must stay aligned");
+
+bool recordLess(const PositionRecord& a, const PositionRecord& b) {
+    if (a.key != b.key) return a.key < b.key;
+    if (a.gameId != b.gameId) return a.gameId < b.gameId;
+    return a.ply < b.ply;
+}
+
+size_t bucketOf(uint64_t key) {
+    return static_cast<size_t>(key >> (64 - PositionIndex::FANOUT_BITS));
+}
+
+// Streams records to disk in key order, counting the fan-out as it goes and
+// writing the header and table once everything is in
+class IndexWriter {
+public:
+    explicit IndexWriter(const std::string& path)
+        : out_(path, std::ios::binary | std::ios::trunc), counts_(PositionIndex::FANOUT_SIZE, 0) {
+        std::vector<char> zeros(HEADER_SIZE + FANOUT_BYTES, 0);
+        out_.write(zeros.data(), static_cast<std::streamsize>(zeros.size()));
+        buffer_.reserve(WRITE_BATCH);
+    }
+    
+    void add(const PositionRecord& record) {
+        buffer_.push_back(record);
+        ++counts_[bucketOf(record.key)];
+        if (buffer_.size() == WRITE_BATCH) flush();
+    }
+    
+    bool finish(uint64_t games) {
+        flush();
+        
+        std::vector<uint64_t> fanout(PositionIndex::FANOUT_SIZE + 1, 0);
+        for (size_t b = 0; b < PositionIndex::FANOUT_SIZE; ++b) {
+            fanout[b + 1] = fanout[b] + counts_[b];
+        }
+        
+        unsigned char header[HEADER_SIZE] = {};
+        std::memcpy(header, MAGIC, sizeof(MAGIC));
+        std::memcpy(header + 4, &VERSION, sizeof(VERSION));
+        std::memcpy(header + 8, &games, sizeof(games));
+        std::memcpy(header + 16, &written_, sizeof(written_));
+        
+        out_.seekp(0);
+        out_.write(reinterpret_cast<const char*>(header), sizeof(header));
+        out_.write(reinterpret_cast<const char*>(fanout.data()), static_cast<std::streamsize>(FANOUT_BYTES));
+        out_.close();
+        return !out_.fail();
+    }
+    
+    bool ok() const { return static_cast<bool>(out_); }
+    
+private:
+    std::ofstream out_;
+    std::vector<uint64_t> counts_;
+    std::vector<PositionRecord> buffer_;
+    uint64_t written_ = 0;
+    
+    void flush() {
+        out_.write(reinterpret_cast<const char*>(buffer_.data()),
+                   static_cast<std::streamsize>(buffer_.size() * sizeof(PositionRecord)));
+        written_ += buffer_.size();
+        buffer_.clear();
+    }
+};
+
+struct Run {
+    const PositionRecord* next;
+    const PositionRecord* end;
+};
+
+}
+
+PositionIndex::PositionIndex(const std::string& path) {
+    open(path);
+}
+
+bool PositionIndex::open(const std::string& path) {
+    close();
+    
+    MappedFile file;
+    if (!file.open(path) || file.size() < HEADER_SIZE + FANOUT_BYTES) return false;
+    
+    const unsigned char* data = file.data();
+    uint32_t version;
+    uint64_t games, records;
+    std::memcpy(&version, data + 4, sizeof(version));
+    std::memcpy(&games, data + 8, sizeof(games));
+    std::memcpy(&records, data + 16, sizeof(records));
+    
+    if (std::memcmp(data, MAGIC, sizeof(MAGIC)) != 0 || version != VERSION ||
+        file.size() != HEADER_SIZE + FANOUT_BYTES + records * sizeof(PositionRecord)) {
+        return false;
+    }
+    
+    file_ = std::move(file);
+    fanout_ = reinterpret_cast<const uint64_t*>(file_.data() + HEADER_SIZE);
+    records_ = reinterpret_cast<const PositionRecord*>(file_.data() + HEADER_SIZE + FANOUT_BYTES);
+    game_count_ = games;
+    record_count_ = records;
+    return fanout_[FANOUT_SIZE] == records;
+}
+
+void PositionIndex::close() {
+    file_.close();
+    fanout_ = nullptr;
+    records_ = nullptr;
+    game_count_ = 0;
+    record_count_ = 0;
+}
+
+std::pair<const PositionRecord*, const PositionRecord*> PositionIndex::find(uint64_t key) const {
+    if (!isOpen()) return {nullptr, nullptr};
+    
+    size_t bucket = bucketOf(key);
+    const PositionRecord* first = records_ + fanout_[bucket];
+    const PositionRecord* last = records_ + fanout_[bucket + 1];
+    first = std::lower_bound(first, last, key, [](const PositionRecord& r, uint64_t k) { return r.key < k; });
+    last = std::upper_bound(first, last, key, [](uint64_t k, const PositionRecord& r) { return k < r.key; });
+    return {first, last};
+}
+
+std::vector<PositionRecord> PositionIndex::lookup(const Board& board, PieceColor sideToMove) const {
+    auto range = find(Zobrist::hash(board, sideToMove));
+    return std::vector<PositionRecord>(range.first, range.second);
+}
+
+bool PositionIndex::recordGame(std::string_view moveText, uint32_t gameId, std::vector<PositionRecord>& out) {
+    Game game;
+    uint32_t ply = 0;
+    out.push_back({Zobrist::hash(game.getBoard(), game.getCurrentPlayer()), gameId, ply});
+    
+    size_t pos = 0;
+    for (auto token = Notation::nextMoveToken(moveText, pos); !token.empty();
+         token = Notation::nextMoveToken(moveText, pos)) {
+        auto move = Notation::fromSAN(game.getBoard(), game.getCurrentPlayer(), token);
+        if (!move || !game.makeMove(*move)) return false;
+        out.push_back({Zobrist::hash(game.getBoard(), game.getCurrentPlayer()), gameId, ++ply});
+    }
+    return true;
+}
+
+bool PositionIndex::build(const std::vector<std::string>& games, const PositionIndex* base,
+                          const std::string& outPath, unsigned threads, size_t* failedGames) {
+    uint64_t firstId = (base && base->isOpen()) ? base->gameCount() : 0;
+    if (firstId + games.size() > UINT32_MAX) return false;
+    
+    if (threads == 0) threads = std::max(1u, std::thread::hardware_concurrency());
+    threads = static_cast<unsigned>(std::min<size_t>(threads, games.size() / GAMES_PER_CLAIM + 1));
+    
+    // Workers claim games in small blocks, then sort their own records
+    std::vector<std::vector<PositionRecord>> runs(threads);
+    std::atomic<size_t> nextGame{0};
+    std::atomic<size_t> failed{0};
+    auto work = [&](unsigned t) {
+        auto& records = runs[t];
+        while (true) {
+            size_t begin = nextGame.fetch_add(GAMES_PER_CLAIM);
+            if (begin >= games.size()) break;
+            size_t end = std::min(games.size(), begin + GAMES_PER_CLAIM);
+            for (size_t g = begin; g < end; ++g) {
+                if (!recordGame(games[g], static_cast<uint32_t>(firstId + g), records)) ++failed;
+            }
+        }
+        std::sort(records.begin(), records.end(), recordLess);
+    };
+    
+    std::vector<std::thread> workers;
+    for (unsigned t = 1; t < threads; ++t) workers.emplace_back(work, t);
+    work(0);
+    for (auto& worker : workers) worker.join();
+    if (failedGames) *failedGames = failed;
+    
+    // K-way merge of the sorted runs and the existing index into the new file
+    std::vector<Run> sources;
+    if (base && base->isOpen()) sources.push_back({base->records_, base->records_ + base->record_count_});
+    for (const auto& records : runs) {
+        if (!records.empty()) sources.push_back({records.data(), records.data() + records.size()});
+    }
+    auto later = [&sources](size_t a, size_t b) { return recordLess(*sources[b].next, *sources[a].next); };
+    std::priority_queue<size_t, std::vector<size_t>, decltype(later)> heap(later);
+    for (size_t s = 0; s < sources.size(); ++s) heap.push(s);
+    
+    std::string tempPath = outPath + ".tmp";
+    IndexWriter writer(tempPath);
+    if (!writer.ok()) return false;
+    while (!heap.empty()) {
+        size_t s = heap.top();
+        heap.pop();
+        writer.add(*sources[s].next);
+        if (++sources[s].next != sources[s].end) heap.push(s);
+    }
+    
+    if (!writer.finish(firstId + games.size()) || std::rename(tempPath.c_str(), outPath.c_str()) != 0) {
+        std::remove(tempPath.c_str());
+        return false;
+    }
+    return true;
+}
\ No newline at end of file
@@ -0,0 +1,287 @@
+#include "core/PositionSnapshot.h"
+#include <algorithm>
+#include <charconv>
+#include <cstring>
+#include <initializer_list>
+
+namespace {
+
+const int KNIGHT_STEPS[8][2] = {{-2, -1}, {-2, 1}, {-1, -2}, {-1, 2}, {1, -2}, {1, 2}, {2, -1}, {2, 1}};
+const int KING_STEPS[8][2] = {{-1, -1}, {-1, 0}, {-1, 1}, {0, -1}, {0, 1}, {1, -1}, {1, 0}, {1, 1}};
+const int ROOK_RAYS[4][2] = {{-1, 0}, {1, 0}, {0, -1}, {0, 1}};
+const int BISHOP_RAYS[4][2] = {{-1, -1}, {-1, 1}, {1, -1}, {1, 1}};
+
+bool onBoard(int row, int col) {
+    return row >= 0 && row < 8 && col >= 0 && col < 8;
+}
+
+// Pawn captures are left out on request, for Board's castling rule below
+bool attackedBy(const PositionSnapshot& position, int square, PieceColor by, bool pawnCaptures) {
+    int row = square / 8;
+    int col = square % 8;
+    auto holds = [&](int r, int c, PieceType type) {
+        uint8_t code = position.squares[r * 8 + c];
+        return PositionSnapshot::isType(code, type) && PositionSnapshot::isColor(code, by);
+    };
+    
+    // White pawns move toward row 0, so they attack from the row below
+    int pawnRow = (by == PieceColor::WHITE) ? row + 1 : row - 1;
+    for (int dc : {-1, 1}) {
+        if (pawnCaptures && onBoard(pawnRow, col + dc) && holds(pawnRow, col + dc, PieceType::PAWN)) return true;
+    }
+    for (const auto& step : KNIGHT_STEPS) {
+        int r = row + step[0];
+        int c = col + step[1];
+        if (onBoard(r, c) && holds(r, c, PieceType::KNIGHT)) return true;
+    }
+    for (const auto& step : KING_STEPS) {
+        int r = row + step[0];
+        int c = col + step[1];
+        if (onBoard(r, c) && holds(r, c, PieceType::KING)) return true;
+    }
+    
+    auto slides = [&](const int (&rays)[4][2], PieceType slider) {
+        for (const auto& ray : rays) {
+            for (int r = row + ray[0], c = col + ray[1]; onBoard(r, c); r += ray[0], c += ray[1]) {
+                uint8_t code = position.squares[r * 8 + c];
+                if (!code) continue;
+                if (PositionSnapshot::isColor(code, by) &&
+                    (PositionSnapshot::isType(code, slider) || PositionSnapshot::isType(code, PieceType::QUEEN))) {
+                    return true;
+                }
+                break;
+            }
+        }
+        return false;
+    };
+    return slides(ROOK_RAYS, PieceType::ROOK) || slides(BISHOP_RAYS, PieceType::BISHOP);
+}
+
+// Board::isPositionAttacked on an empty square: any piece of by that could
+// move there, so pawns cover the squares they advance to, not their attacks
+bool covered(const PositionSnapshot& position, int square, PieceColor by) {
+    if (attackedBy(position, square, by, false)) return true;
+    int row = square / 8;
+    int col = square % 8;
+    int back = (by == PieceColor::WHITE) ? 1 : -1;
+    auto pawn = [&](int r, int c, bool unmoved) {
+        if (!onBoard(r, c)) return false;
+        uint8_t code = position.squares[r * 8 + c];
+        return PositionSnapshot::isType(code, PieceType::PAWN) && PositionSnapshot::isColor(code, by) &&
+               (!unmoved || !(code & PositionSnapshot::MOVED_BIT));
+    };
+    if (pawn(row + back, col, false)) return true;
+    if (onBoard(row + back, col) && !position.squares[(row + back) * 8 + col] && pawn(row + 2 * back, col, true)) {
+        return true;
+    }
+    return square == position.enPassant && (pawn(row + back, col - 1, false) || pawn(row + back, col + 1, false));
+}
+
+}
+
+PositionSnapshot PositionSnapshot::initial() {
+    static const PieceType BACK_RANK[8] = {PieceType::ROOK, PieceType::KNIGHT, PieceType::BISHOP, PieceType::QUEEN,
+                                           PieceType::KING, PieceType::BISHOP, PieceType::KNIGHT, PieceType::ROOK};
+    PositionSnapshot position{};
+    for (int col = 0; col < 8; ++col) {
+        position.squares[col] = encode(BACK_RANK[col], PieceColor::BLACK, false);
+        position.squares[8 + col] = encode(PieceType::PAWN, PieceColor::BLACK, false);
+        position.squares[48 + col] = encode(PieceType::PAWN, PieceColor::WHITE, false);
+        position.squares[56 + col] = encode(BACK_RANK[col], PieceColor::WHITE, false);
+    }
+    position.enPassant = NO_SQUARE;
+    position.fullmoveNumber = 1;
+    return position;
+}
+
+bool PositionSnapshot::operator==(const PositionSnapshot& other) const {
+    return std::memcmp(this, &other, sizeof(PositionSnapshot)) == 0;
+}
+
+int PositionSnapshot::kingSquare(PieceColor color) const {
+    for (int sq = 0; sq < 64; ++sq) {
+        if (isType(squares[sq], PieceType::KING) && isColor(squares[sq], color)) return sq;
+    }
+    return -1;
+}
+
+bool PositionSnapshot::isAttacked(int square, PieceColor by) const {
+    return attackedBy(*this, square, by, true);
+}
+
+bool PositionSnapshot::isInCheck(PieceColor color) const {
+    int king = kingSquare(color);
+    if (king < 0) return false;
+    return isAttacked(king, color == PieceColor::WHITE ? PieceColor::BLACK : PieceColor::WHITE);
+}
+
+uint64_t PositionSnapshot::legalTargets(int square) const {
+    uint8_t code = squares[square];
+    if (!code) return 0;
+    PieceColor color = (code & BLACK_BIT) ? PieceColor::BLACK : PieceColor::WHITE;
+    int row = square / 8;
+    int col = square % 8;
+    uint64_t targets = 0;
+    
+    // Kept when the king is safe with the piece moved and the target
+    // cleared, as Board::wouldBeInCheck probes
+    auto add = [&](int r, int c) {
+        if (!onBoard(r, c)) return;
+        PositionSnapshot probe = *this;
+        probe.squares[r * 8 + c] = code;
+        probe.squares[square] = 0;
+        if (!probe.isInCheck(color)) targets |= uint64_t{1} << (r * 8 + c);
+    };
+    auto open = [&](int r, int c) { return onBoard(r, c) && !isColor(squares[r * 8 + c], color); };
+    auto slide = [&](const int (&rays)[4][2]) {
+        for (const auto& ray : rays) {
+            for (int r = row + ray[0], c = col + ray[1]; open(r, c); r += ray[0], c += ray[1]) {
+                add(r, c);
+                if (squares[r * 8 + c]) break;
+            }
+        }
+    };
+    
+    switch (static_cast<PieceType>((code & 7) - 1)) {
+        case PieceType::PAWN: {
+            int ahead = row + ((color == PieceColor::WHITE) ? -1 : 1);
+            if (!onBoard(ahead, col)) break;
+            if (!squares[ahead * 8 + col]) {
+                add(ahead, col);
+                int twice = 2 * ahead - row;
+                if (!(code & MOVED_BIT) && onBoard(twice, col) && !squares[twice * 8 + col]) add(twice, col);
+            }
+            for (int c : {col - 1, col + 1}) {
+                if (!onBoard(ahead, c)) continue;
+                uint8_t target = squares[ahead * 8 + c];
+                if ((target && !isColor(target, color)) || ahead * 8 + c == enPassant) add(ahead, c);
+            }
+            break;
+        }
+        case PieceType::KNIGHT:
+            for (const auto& step : KNIGHT_STEPS) {
+                if (open(row + step[0], col + step[1])) add(row + step[0], col + step[1]);
+            }
+            break;
+        case PieceType::BISHOP:
+            slide(BISHOP_RAYS);
+            break;
+        case PieceType::ROOK:
+            slide(ROOK_RAYS);
+            break;
+        case PieceType::QUEEN:
+            slide(ROOK_RAYS);
+            slide(BISHOP_RAYS);
+            break;
+        case PieceType::KING: {
+            for (const auto& step : KING_STEPS) {
+                if (open(row + step[0], col + step[1])) add(row + step[0], col + step[1]);
+            }
+            if (code & MOVED_BIT) break;
+            // Board::canCastle*: the home squares must hold an unmoved king
+            // and rook of any colour, and only the king's destination is
+            // probed for real
+            int home = (color == PieceColor::WHITE) ? 7 : 0;
+            PieceColor enemy = (color == PieceColor::WHITE) ? PieceColor::BLACK : PieceColor::WHITE;
+            auto unmoved = [&](int c, PieceType type) {
+                return isType(squares[home * 8 + c], type) && !(squares[home * 8 + c] & MOVED_BIT);
+            };
+            auto empty = [&](std::initializer_list<int> cols) {
+                for (int c : cols) {
+                    if (squares[home * 8 + c]) return false;
+                }
+                return true;
+            };
+            auto safe = [&](std::initializer_list<int> cols) {
+                for (int c : cols) {
+                    if (covered(*this, home * 8 + c, enemy)) return false;
+                }
+                return true;
+            };
+            if (!unmoved(4, PieceType::KING) || isInCheck(color)) break;
+            if (unmoved(7, PieceType::ROOK) && empty({5, 6}) && safe({5, 6})) add(row, col + 2);
+            if (unmoved(0, PieceType::ROOK) && empty({1, 2, 3}) && safe({2, 3})) add(row, col - 2);
+            break;
+        }
+    }
+    return targets;
+}
+
+bool PositionSnapshot::hasLegalMove(PieceColor color) const {
+    for (int sq = 0; sq < 64; ++sq) {
+        if (isColor(squares[sq], color) && legalTargets(sq)) return true;
+    }
+    return false;
+}
+
+uint8_t PositionSnapshot::castlingRights() const {
+    auto unmoved = [&](int sq, PieceType type, PieceColor color) {
+        uint8_t code = squares[sq];
+        return isType(code, type) && isColor(code, color) && !(code & MOVED_BIT);
+    };
+    
+    uint8_t rights = 0;
+    if (unmoved(60, PieceType::KING, PieceColor::WHITE)) {
+        if (unmoved(63, PieceType::ROOK, PieceColor::WHITE)) rights |= WHITE_KINGSIDE;
+        if (unmoved(56, PieceType::ROOK, PieceColor::WHITE)) rights |= WHITE_QUEENSIDE;
+    }
+    if (unmoved(4, PieceType::KING, PieceColor::BLACK)) {
+        if (unmoved(7, PieceType::ROOK, PieceColor::BLACK)) rights |= BLACK_KINGSIDE;
+        if (unmoved(0, PieceType::ROOK, PieceColor::BLACK)) rights |= BLACK_QUEENSIDE;
+    }
+    return rights;
+}
+
+size_t PositionSnapshot::writeFEN(char* buffer, size_t size) const {
+    static const char LETTERS[] = "PRNBQK";
+    size_t length = 0;
+    auto put = [&](char c) {
+        if (length + 1 < size) buffer[length] = c;
+        ++length;
+    };
+    auto putNumber = [&](unsigned value) {
+        char digits[8];
+        auto end = std::to_chars(digits, digits + sizeof(digits), value).ptr;
+        for (const char* digit = digits; digit != end; ++digit) put(*digit);
+    };
+    
+    for (int row = 0; row < 8; ++row) {
+        int empty = 0;
+        for (int col = 0; col < 8; ++col) {
+            uint8_t code = squares[row * 8 + col];
+            if (!code) {
+                ++empty;
+                continue;
+            }
+            if (empty > 0) put(static_cast<char>('0' + empty));
+            empty = 0;
+            char letter = LETTERS[(code & 7) - 1];
+            put((code & BLACK_BIT) ? static_cast<char>(letter - 'A' + 'a') : letter);
+        }
+        if (empty > 0) put(static_cast<char>('0' + empty));
+        if (row < 7) put('/');
+    }
+    
+    put(' ');
+    put(sideToMove ? 'b' : 'w');
+    put(' ');
+    uint8_t rights = castlingRights();
+    if (!rights) put('-');
+    for (int bit = 0; bit < 4; ++bit) {
+        if (rights & (1 << bit)) put("KQkq"[bit]);
+    }
+    put(' ');
+    if (enPassant < 64) {
+        put(static_cast<char>('a' + enPassant % 8));
+        put(static_cast<char>('8' - enPassant / 8));
+    } else {
+        put('-');
+    }
+    put(' ');
+    putNumber(halfmoveClock);
+    put(' ');
+    putNumber(fullmoveNumber);
+    
+    if (size > 0) buffer[std::min(length, size - 1)] = '\0';
+    return length;
+}
\ No newline at end of file
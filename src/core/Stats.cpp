@@ -0,0 +1,204 @@
+#include "core/Stats.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <mutex>
+#include <vector>
+
+namespace {
+
+const char* const COUNTER_NAMES[Stats::COUNTER_COUNT] = {
+    "board copies",
+    "piece clones",
+    "getPossibleMoves calls",
+    "wouldBeInCheck probes",
+    "legal moves generated",
+    "status updates",
+    "status update ns"
+};
+
+const char* const OPERATION_NAMES[Stats::OPERATION_COUNT] = {
+    "Game::makeMove",
+    "Game::updateGameStatus",
+    "Game::getValidMoves",
+    "Player::getMove"
+};
+
+struct Registry {
+    std::mutex mutex;
+    std::vector<Stats::detail::ThreadCounters*> live;
+    uint64_t retired[Stats::COUNTER_COUNT] = {};
+    Stats::Histogram retiredLatency[Stats::OPERATION_COUNT];
+};
+
+// Leaked so that threads exiting during static destruction can still retire
+Registry& registry() {
+    static Registry* instance = new Registry();
+    return *instance;
+}
+
+}
+
+namespace Stats {
+
+namespace detail {
+
+ThreadCounters::ThreadCounters() {
+    for (auto& value : values) value.store(0, std::memory_order_relaxed);
+    for (int op = 0; op < OPERATION_COUNT; ++op) {
+        for (auto& bucket : latency[op]) bucket.store(0, std::memory_order_relaxed);
+        latencySum[op].store(0, std::memory_order_relaxed);
+        latencyMax[op].store(0, std::memory_order_relaxed);
+    }
+    Registry& reg = registry();
+    std::lock_guard<std::mutex> lock(reg.mutex);
+    reg.live.push_back(this);
+}
+
+ThreadCounters::~ThreadCounters() {
+    Registry& reg = registry();
+    std::lock_guard<std::mutex> lock(reg.mutex);
+    for (int i = 0; i < COUNTER_COUNT; ++i) {
+        reg.retired[i] += values[i].load(std::memory_order_relaxed);
+    }
+    for (int op = 0; op < OPERATION_COUNT; ++op) {
+        reg.retiredLatency[op].merge(latency[op], latencySum[op].load(std::memory_order_relaxed),
+                                     latencyMax[op].load(std::memory_order_relaxed));
+    }
+    reg.live.erase(std::remove(reg.live.begin(), reg.live.end(), this), reg.live.end());
+}
+
+}
+
+Snapshot Snapshot::operator-(const Snapshot& earlier) const {
+    Snapshot difference;
+    for (int i = 0; i < COUNTER_COUNT; ++i) {
+        difference.values[i] = values[i] - earlier.values[i];
+    }
+    return difference;
+}
+
+uint64_t Histogram::bucketUpperBound(int index) {
+    if (index < SUB_BUCKETS) return static_cast<uint64_t>(index);
+    int shift = index / SUB_BUCKETS - 1;
+    uint64_t lower = static_cast<uint64_t>(SUB_BUCKETS + index % SUB_BUCKETS) << shift;
+    return lower + ((uint64_t{1} << shift) - 1);
+}
+
+void Histogram::record(uint64_t nanos) {
+    ++buckets[bucketIndex(nanos)];
+    ++count_;
+    sum_ += nanos;
+    max_ = std::max(max_, nanos);
+}
+
+void Histogram::merge(const Histogram& other) {
+    for (int i = 0; i < BUCKET_COUNT; ++i) {
+        buckets[i] += other.buckets[i];
+    }
+    count_ += other.count_;
+    sum_ += other.sum_;
+    max_ = std::max(max_, other.max_);
+}
+
+void Histogram::merge(const std::atomic<uint64_t>* counts, uint64_t sum, uint64_t max) {
+    for (int i = 0; i < BUCKET_COUNT; ++i) {
+        uint64_t count = counts[i].load(std::memory_order_relaxed);
+        buckets[i] += count;
+        count_ += count;
+    }
+    sum_ += sum;
+    max_ = std::max(max_, max);
+}
+
+uint64_t Histogram::percentile(double p) const {
+    if (count_ == 0) return 0;
+    uint64_t rank = static_cast<uint64_t>(std::ceil(p * static_cast<double>(count_)));
+    rank = std::max<uint64_t>(rank, 1);
+    uint64_t seen = 0;
+    for (int i = 0; i < BUCKET_COUNT; ++i) {
+        seen += buckets[i];
+        if (seen >= rank) return std::min(bucketUpperBound(i), max_);
+    }
+    return max_;
+}
+
+const char* counterName(Counter counter) {
+    return COUNTER_NAMES[static_cast<int>(counter)];
+}
+
+const char* operationName(Operation operation) {
+    return OPERATION_NAMES[static_cast<int>(operation)];
+}
+
+Snapshot snapshot() {
+    Snapshot total;
+    Registry& reg = registry();
+    std::lock_guard<std::mutex> lock(reg.mutex);
+    for (int i = 0; i < COUNTER_COUNT; ++i) {
+        total.values[i] = reg.retired[i];
+    }
+    for (const auto* counters : reg.live) {
+        for (int i = 0; i < COUNTER_COUNT; ++i) {
+            total.values[i] += counters->values[i].load(std::memory_order_relaxed);
+        }
+    }
+    return total;
+}
+
+Histogram latency(Operation operation) {
+    int op = static_cast<int>(operation);
+    Registry& reg = registry();
+    std::lock_guard<std::mutex> lock(reg.mutex);
+    Histogram total = reg.retiredLatency[op];
+    for (const auto* counters : reg.live) {
+        total.merge(counters->latency[op], counters->latencySum[op].load(std::memory_order_relaxed),
+                    counters->latencyMax[op].load(std::memory_order_relaxed));
+    }
+    return total;
+}
+
+void reset() {
+    Registry& reg = registry();
+    std::lock_guard<std::mutex> lock(reg.mutex);
+    std::fill(std::begin(reg.retired), std::end(reg.retired), 0);
+    std::fill(std::begin(reg.retiredLatency), std::end(reg.retiredLatency), Histogram());
+    for (auto* counters : reg.live) {
+        for (auto& value : counters->values) value.store(0, std::memory_order_relaxed);
+        for (int op = 0; op < OPERATION_COUNT; ++op) {
+            for (auto& bucket : counters->latency[op]) bucket.store(0, std::memory_order_relaxed);
+            counters->latencySum[op].store(0, std::memory_order_relaxed);
+            counters->latencyMax[op].store(0, std::memory_order_relaxed);
+        }
+    }
+}
+
+void print(std::ostream& out, const Snapshot& stats) {
+    if (!ENABLED) {
+        out << "Statistics are not compiled in; configure with -DCHESS_STATS=ON\n";
+        return;
+    }
+    
+    out << "Hot-path statistics:\n";
+    for (int i = 0; i < COUNTER_COUNT; ++i) {
+        out << "  " << COUNTER_NAMES[i] << ": " << stats.values[i] << "\n";
+    }
+    uint64_t updates = stats[Counter::STATUS_UPDATES];
+    if (updates > 0) {
+        out << "  mean status update: " << stats[Counter::STATUS_UPDATE_NANOS] / updates << " ns\n";
+    }
+    
+    out << "Latency (us):\n";
+    for (int op = 0; op < OPERATION_COUNT; ++op) {
+        Histogram histogram = latency(static_cast<Operation>(op));
+        if (histogram.count() == 0) continue;
+        char line[160];
+        std::snprintf(line, sizeof(line), "  %-24s n %-9llu p50 %9.1f  p99 %9.1f  p99.9 %9.1f  max %9.1f\n",
+                      OPERATION_NAMES[op], static_cast<unsigned long long>(histogram.count()),
+                      histogram.percentile(0.50) / 1000.0, histogram.percentile(0.99) / 1000.0,
+                      histogram.percentile(0.999) / 1000.0, histogram.max() / 1000.0);
+        out << line;
+    }
+}
+
+}
\ No newline at end of file
@@ -0,0 +1,132 @@
+#include "core/TimerWheel.h"
+#include <algorithm>
+
+TimerWheel::TimerWheel(Clock::time_point start, Clock::duration tick)
+    : start_(start),
+      tick_(tick),
+      nodes_(HEADS) {
+    for (uint32_t i = 0; i < HEADS; ++i) {
+        nodes_[i].prev = nodes_[i].next = i;
+    }
+}
+
+TimerWheel::Handle TimerWheel::arm(uint64_t tag, Clock::time_point deadline) {
+    uint32_t node;
+    if (!free_.empty()) {
+        node = free_.back();
+        free_.pop_back();
+    } else {
+        node = static_cast<uint32_t>(nodes_.size());
+        nodes_.emplace_back();
+    }
+    
+    // Round up so a timer never fires before its deadline
+    uint64_t expiry = 0;
+    if (deadline > start_) {
+        auto ticks = (deadline - start_ + tick_ - Clock::duration(1)) / tick_;
+        expiry = static_cast<uint64_t>(ticks);
+    }
+    nodes_[node].tag = tag;
+    nodes_[node].expiry = expiry;
+    nodes_[node].armed = true;
+    insert(node, now_tick_ + 1);
+    ++armed_;
+    return (static_cast<uint64_t>(nodes_[node].generation) << 32) | node;
+}
+
+bool TimerWheel::cancel(Handle handle) {
+    uint32_t node = static_cast<uint32_t>(handle);
+    uint32_t generation = static_cast<uint32_t>(handle >> 32);
+    if (node < HEADS || node >= nodes_.size()) return false;
+    if (!nodes_[node].armed || nodes_[node].generation != generation) return false;
+    
+    unlink(node);
+    release(node);
+    return true;
+}
+
+size_t TimerWheel::advance(Clock::time_point now, std::vector<uint64_t>& fired) {
+    if (now < start_) return 0;
+    uint64_t target = static_cast<uint64_t>((now - start_) / tick_);
+    size_t before = fired.size();
+    
+    while (now_tick_ < target) {
+        if (armed_ == 0) {
+            now_tick_ = target;
+            break;
+        }
+        uint64_t t = ++now_tick_;
+        
+        // Highest level first, so its timers can drop through the levels
+        // below in the same tick
+        if ((t & SLOT_MASK) == 0) {
+            int top = 1;
+            while (top < LEVELS - 1 && ((t >> (SLOT_BITS * top)) & SLOT_MASK) == 0) ++top;
+            for (int level = top; level >= 1; --level) {
+                cascade(level, static_cast<uint32_t>((t >> (SLOT_BITS * level)) & SLOT_MASK));
+            }
+        }
+        
+        uint32_t list = head(0, static_cast<uint32_t>(t & SLOT_MASK));
+        while (!isEmpty(list)) {
+            uint32_t node = nodes_[list].next;
+            fired.push_back(nodes_[node].tag);
+            unlink(node);
+            release(node);
+        }
+    }
+    return fired.size() - before;
+}
+
+std::optional<TimerWheel::Clock::time_point> TimerWheel::nextWakeup() const {
+    if (armed_ == 0) return std::nullopt;
+    for (uint64_t t = now_tick_ + 1;; ++t) {
+        if ((t & SLOT_MASK) == 0 || !isEmpty(head(0, static_cast<uint32_t>(t & SLOT_MASK)))) {
+            return tickTime(t);
+        }
+    }
+}
+
+void TimerWheel::insert(uint32_t node, uint64_t earliest) {
+    // The level is chosen by distance and the slot by absolute tick, so a
+    // timer's slot always turns up (and cascades it) no later than it is due
+    uint64_t expiry = std::max(nodes_[node].expiry, earliest);
+    expiry = std::min(expiry, now_tick_ + SPAN - 1);
+    uint64_t delta = expiry - now_tick_;
+    int level = 0;
+    while (level < LEVELS - 1 && delta >= (uint64_t{1} << (SLOT_BITS * (level + 1)))) ++level;
+    
+    uint32_t list = head(level, static_cast<uint32_t>((expiry >> (SLOT_BITS * level)) & SLOT_MASK));
+    Node& n = nodes_[node];
+    n.prev = nodes_[list].prev;
+    n.next = list;
+    nodes_[n.prev].next = node;
+    nodes_[list].prev = node;
+}
+
+void TimerWheel::unlink(uint32_t node) {
+    Node& n = nodes_[node];
+    nodes_[n.prev].next = n.next;
+    nodes_[n.next].prev = n.prev;
+    n.prev = n.next = node;
+}
+
+void TimerWheel::release(uint32_t node) {
+    nodes_[node].armed = false;
+    ++nodes_[node].generation;
+    free_.push_back(node);
+    --armed_;
+}
+
+void TimerWheel::cascade(int level, uint32_t slot) {
+    uint32_t list = head(level, slot);
+    // Detach the whole slot first: re-filed timers may land back in it. The
+    // detached chain still ends in a link to the head.
+    uint32_t node = nodes_[list].next;
+    nodes_[list].prev = nodes_[list].next = list;
+    while (node != list) {
+        uint32_t next = nodes_[node].next;
+        insert(node, now_tick_);
+        node = next;
+    }
+}
\ No newline at end of file
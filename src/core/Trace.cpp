@@ -0,0 +1,114 @@
+#include "core/Trace.h"
+#include <algorithm>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace {
+
+struct Event {
+    const char* name;
+    int64_t startNanos;
+    int64_t durationNanos;
+};
+
+// The owning thread appends under its own, normally uncontended, lock so
+// that stop() can drain buffers of threads that are still running
+struct ThreadBuffer {
+    std::mutex mutex;
+    std::vector<Event> events;
+    uint64_t dropped = 0;
+    int tid = 0;
+};
+
+struct Registry {
+    std::mutex mutex;
+    std::vector<std::shared_ptr<ThreadBuffer>> buffers;
+    Trace::Clock::time_point epoch;
+    int nextTid = 1;
+};
+
+Registry& registry() {
+    static Registry* instance = new Registry();
+    return *instance;
+}
+
+// Buffers stay registered after their thread exits so its spans survive
+ThreadBuffer& localBuffer() {
+    thread_local std::shared_ptr<ThreadBuffer> buffer = []() {
+        auto created = std::make_shared<ThreadBuffer>();
+        Registry& reg = registry();
+        std::lock_guard<std::mutex> lock(reg.mutex);
+        created->tid = reg.nextTid++;
+        reg.buffers.push_back(created);
+        return created;
+    }();
+    return *buffer;
+}
+
+}
+
+namespace Trace {
+
+namespace detail {
+std::atomic<bool> active{false};
+}
+
+void start() {
+    Registry& reg = registry();
+    {
+        std::lock_guard<std::mutex> lock(reg.mutex);
+        for (auto& buffer : reg.buffers) {
+            std::lock_guard<std::mutex> bufferLock(buffer->mutex);
+            buffer->events.clear();
+            buffer->dropped = 0;
+        }
+        reg.epoch = Clock::now();
+    }
+    detail::active.store(true, std::memory_order_release);
+}
+
+void record(const char* name, Clock::time_point start, Clock::duration duration) {
+    ThreadBuffer& buffer = localBuffer();
+    int64_t startNanos = std::chrono::duration_cast<std::chrono::nanoseconds>(start - registry().epoch).count();
+    std::lock_guard<std::mutex> lock(buffer.mutex);
+    if (buffer.events.size() >= MAX_SPANS_PER_THREAD) {
+        ++buffer.dropped;
+        return;
+    }
+    buffer.events.push_back({name, startNanos,
+                             std::chrono::duration_cast<std::chrono::nanoseconds>(duration).count()});
+}
+
+bool stop(const std::string& path, uint64_t* droppedSpans) {
+    detail::active.store(false, std::memory_order_relaxed);
+    
+    std::FILE* file = std::fopen(path.c_str(), "w");
+    if (!file) return false;
+    
+    uint64_t dropped = 0;
+    bool first = true;
+    std::fputs("{\"displayTimeUnit\":\"ns\",\"traceEvents\":[", file);
+    Registry& reg = registry();
+    std::lock_guard<std::mutex> lock(reg.mutex);
+    for (auto& buffer : reg.buffers) {
+        std::lock_guard<std::mutex> bufferLock(buffer->mutex);
+        dropped += buffer->dropped;
+        for (const Event& event : buffer->events) {
+            // Complete events; timestamps are microseconds with ns precision
+            std::fprintf(file, "%s\n{\"name\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":%d,\"ts\":%.3f,\"dur\":%.3f}",
+                         first ? "" : ",", event.name, buffer->tid,
+                         event.startNanos / 1000.0, event.durationNanos / 1000.0);
+            first = false;
+        }
+        buffer->events.clear();
+        buffer->events.shrink_to_fit();
+    }
+    std::fputs("\n]}\n", file);
+    
+    if (droppedSpans) *droppedSpans = dropped;
+    return std::fclose(file) == 0;
+}
+
+}
\ No newline at end of file
@@ -0,0 +1,162 @@
+#include "core/TrainingData.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace {
+
+constexpr char MAGIC[4] = {'R', 'C', 'T', 'D'};
+constexpr uint32_t VERSION = 1;
+
+}
+
+std::optional<PackedPosition> PackedPosition::pack(const PositionSnapshot& position, int result, int pliesToEnd) {
+    PackedPosition packed{};
+    int count = 0;
+    for (int sq = 0; sq < 64; ++sq) {
+        uint8_t code = position.squares[sq] & 0x0F;
+        if (!code) continue;
+        if (count == 32) return std::nullopt;
+        packed.occupancy |= uint64_t{1} << sq;
+        packed.pieces[count / 2] |= static_cast<uint8_t>(code << (4 * (count % 2)));
+        ++count;
+    }
+    packed.flags = static_cast<uint8_t>((position.sideToMove ? BLACK_TO_MOVE : 0) | (position.castlingRights() << 1));
+    packed.enPassant = position.enPassant;
+    packed.halfmoveClock = static_cast<uint8_t>(std::min<int>(position.halfmoveClock, 255));
+    packed.result = static_cast<int8_t>(result);
+    packed.fullmoveNumber = position.fullmoveNumber;
+    packed.pliesToEnd = static_cast<uint16_t>(std::clamp(pliesToEnd, 0, 65535));
+    return packed;
+}
+
+PositionSnapshot PackedPosition::unpack() const {
+    PositionSnapshot position{};
+    int index = 0;
+    for (uint64_t bits = occupancy; bits; bits &= bits - 1, ++index) {
+        int sq = __builtin_ctzll(bits);
+        uint8_t code = (pieces[index / 2] >> (4 * (index % 2))) & 0x0F;
+        bool black = code & PositionSnapshot::BLACK_BIT;
+        int homeRow = black ? 1 : 6;
+        if (PositionSnapshot::isType(code, PieceType::PAWN) && sq / 8 != homeRow) code |= PositionSnapshot::MOVED_BIT;
+        position.squares[sq] = code;
+    }
+
+    uint8_t rights = flags >> 1;
+    auto markMoved = [&position](int sq, PieceType type, bool unmoved) {
+        if (!unmoved && PositionSnapshot::isType(position.squares[sq], type)) {
+            position.squares[sq] |= PositionSnapshot::MOVED_BIT;
+        }
+    };
+    markMoved(60, PieceType::KING, rights & (PositionSnapshot::WHITE_KINGSIDE | PositionSnapshot::WHITE_QUEENSIDE));
+    markMoved(4, PieceType::KING, rights & (PositionSnapshot::BLACK_KINGSIDE | PositionSnapshot::BLACK_QUEENSIDE));
+    markMoved(63, PieceType::ROOK, rights & PositionSnapshot::WHITE_KINGSIDE);
+    markMoved(56, PieceType::ROOK, rights & PositionSnapshot::WHITE_QUEENSIDE);
+    markMoved(7, PieceType::ROOK, rights & PositionSnapshot::BLACK_KINGSIDE);
+    markMoved(0, PieceType::ROOK, rights & PositionSnapshot::BLACK_QUEENSIDE);
+
+    position.sideToMove = (flags & BLACK_TO_MOVE) ? 1 : 0;
+    position.enPassant = enPassant;
+    position.halfmoveClock = halfmoveClock;
+    position.fullmoveNumber = fullmoveNumber;
+    return position;
+}
+
+TrainingDataWriter::Buffer::Buffer(TrainingDataWriter& writer, size_t records)
+    : writer_(writer), capacity_(std::max<size_t>(records, 1)) {
+    records_.reserve(capacity_);
+}
+
+TrainingDataWriter::Buffer::~Buffer() {
+    flush();
+}
+
+void TrainingDataWriter::Buffer::add(const PackedPosition& position) {
+    records_.push_back(position);
+    if (records_.size() == capacity_) flush();
+}
+
+bool TrainingDataWriter::Buffer::flush() {
+    if (records_.empty()) return true;
+    bool written = writer_.append(records_.data(), records_.size() * sizeof(PackedPosition));
+    records_.clear();
+    return written;
+}
+
+TrainingDataWriter::~TrainingDataWriter() {
+    close();
+}
+
+bool TrainingDataWriter::open(const std::string& path) {
+    close();
+    fd_ = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (fd_ < 0) return false;
+
+    unsigned char header[HEADER_SIZE] = {};
+    uint32_t recordSize = sizeof(PackedPosition);
+    std::memcpy(header, MAGIC, sizeof(MAGIC));
+    std::memcpy(header + 4, &VERSION, sizeof(VERSION));
+    std::memcpy(header + 8, &recordSize, sizeof(recordSize));
+    end_ = HEADER_SIZE;
+    failed_ = false;
+    if (::pwrite(fd_, header, sizeof(header), 0) != static_cast<ssize_t>(sizeof(header))) {
+        ::close(fd_);
+        fd_ = -1;
+        return false;
+    }
+    return true;
+}
+
+bool TrainingDataWriter::close() {
+    if (fd_ < 0) return !failed_;
+    bool ok = ::close(fd_) == 0 && !failed_;
+    fd_ = -1;
+    return ok;
+}
+
+bool TrainingDataWriter::append(const void* data, size_t bytes) {
+    if (fd_ < 0) return false;
+    // The range is this thread's alone once reserved
+    uint64_t offset = end_.fetch_add(bytes);
+    const char* source = static_cast<const char*>(data);
+    while (bytes > 0) {
+        ssize_t written = ::pwrite(fd_, source, bytes, static_cast<off_t>(offset));
+        if (written < 0 && errno == EINTR) continue;
+        if (written <= 0) {
+            failed_ = true;
+            return false;
+        }
+        source += written;
+        offset += static_cast<uint64_t>(written);
+        bytes -= static_cast<size_t>(written);
+    }
+    return true;
+}
+
+TrainingDataReader::TrainingDataReader(const std::string& path) {
+    open(path);
+}
+
+bool TrainingDataReader::open(const std::string& path) {
+    file_.close();
+    records_ = nullptr;
+    count_ = 0;
+
+    MappedFile file;
+    if (!file.open(path) || file.size() < TrainingDataWriter::HEADER_SIZE) return false;
+    uint32_t version, recordSize;
+    std::memcpy(&version, file.data() + 4, sizeof(version));
+    std::memcpy(&recordSize, file.data() + 8, sizeof(recordSize));
+    if (std::memcmp(file.data(), MAGIC, sizeof(MAGIC)) != 0 || version != VERSION ||
+        recordSize != sizeof(PackedPosition)) {
+        return false;
+    }
+
+    file_ = std::move(file);
+    // A torn tail from an interrupted run is left out
+    count_ = (file_.size() - TrainingDataWriter::HEADER_SIZE) / sizeof(PackedPosition);
+    records_ = reinterpret_cast<const PackedPosition*>(file_.data() + TrainingDataWriter::HEADER_SIZE);
+    return true;
+}
\ No newline at end of file
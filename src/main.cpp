@@ -1,12 +1,124 @@
 #include "core/Game.h"
+#include "core/Notation.h"
 #include "core/Player.h"
+#include "core/Stats.h"
+#include "core/Trace.h"
 #include "ui/Display.h"
 #include "ui/InputParser.h"
+#include "utils/LineReader.h"
 #include "utils/Utils.h"
 #include <iostream>
 #include <memory>
+#include <string>
 
-int main() {
+namespace {
+
+void printUsage() {
+    std::cout << "Usage: chess [--script FILE] [--stats] [--trace FILE]\n"
+              << "  --script FILE  Play moves and commands from FILE ('-' for stdin) without\n"
+              << "                 prompts or board drawing, then print the final position\n"
+              << "  --stats        Print hot-path counters and latencies to stderr on exit\n"
+              << "  --trace FILE   Write timed spans as Chrome trace JSON on exit\n";
+}
+
+// Prints the hot-path counters and writes the trace however main returns
+struct StatsReport {
+    bool enabled = false;
+    std::string tracePath;
+    
+    ~StatsReport() {
+        if (!tracePath.empty() && !Trace::stop(tracePath)) {
+            std::cerr << "Error: cannot write " << tracePath << "\n";
+        }
+        if (enabled) Stats::print(std::cerr, Stats::snapshot());
+    }
+};
+
+// Batch mode for scripted games: one move (e2e4 or SAN) or command per line,
+// blank lines and lines starting with '#' are skipped, and the first bad
+// line stops the run with a non-zero exit code
+int runScript(const std::string& path) {
+    LineReader reader;
+    if (!reader.open(path)) {
+        std::cerr << "Error: cannot open " << path << "\n";
+        return 1;
+    }
+    
+    InputParser parser;
+    Game game;
+    std::string_view line;
+    bool stopped = false;
+    
+    while (!stopped && !game.isGameOver() && reader.nextLine(line)) {
+        size_t first = line.find_first_not_of(" \t");
+        if (first != std::string_view::npos && line[first] == '#') continue;
+        
+        ParsedInput input = parser.classify(line);
+        switch (input.command) {
+            case InputCommand::EMPTY:
+            case InputCommand::HELP:
+                break;
+            case InputCommand::QUIT:
+                stopped = true;
+                break;
+            case InputCommand::UNDO:
+                game.undoLastMove();
+                break;
+            case InputCommand::DRAW:
+                if (!game.acceptDraw()) game.offerDraw();
+                break;
+            case InputCommand::RESIGN:
+                game.resignGame(game.getCurrentPlayer());
+                break;
+            case InputCommand::MOVE: {
+                bool legal = input.promotion ? game.makeMove(Move(input.from, input.to, *input.promotion))
+                                             : game.makeMove(input.from, input.to);
+                if (!legal) {
+                    std::cerr << path << ":" << reader.lineNumber() << ": illegal move '" << line << "'\n";
+                    return 1;
+                }
+                break;
+            }
+            case InputCommand::INVALID: {
+                // Anything else may be a SAN move such as Nf3 or exd8=Q+
+                std::string_view san = line.substr(first, line.find_last_not_of(" \t") + 1 - first);
+                auto move = Notation::fromSAN(game.getBoard(), game.getCurrentPlayer(), san);
+                if (move && game.makeMove(*move)) break;
+                std::cerr << path << ":" << reader.lineNumber() << ": unrecognised input '" << line << "'\n";
+                return 1;
+            }
+        }
+    }
+    
+    std::cout << "Moves: " << game.getMoveHistory().size() << "\n";
+    std::cout << "Status: " << game.getGameStatusString() << "\n";
+    std::cout << "FEN: " << game.toFEN() << "\n";
+    return 0;
+}
+
+}
+
+int main(int argc, char* argv[]) {
+    StatsReport statsReport;
+    std::string scriptPath;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--script" && i + 1 < argc) {
+            scriptPath = argv[++i];
+        } else if (arg == "--stats") {
+            statsReport.enabled = true;
+        } else if (arg == "--trace" && i + 1 < argc) {
+            statsReport.tracePath = argv[++i];
+            Trace::start();
+        } else {
+            printUsage();
+            return arg == "--help" ? 0 : 1;
+        }
+    }
+    if (!scriptPath.empty()) {
+        return runScript(scriptPath);
+    }
+    
     Display display;
     InputParser parser;
     Game game;
@@ -41,34 +153,36 @@ int main() {
         std::string input = parser.getUserInput();
         
         // Handle commands
-        if (parser.isQuitCommand(input)) {
+        ParsedInput parsed = parser.classify(input);
+        if (parsed.command == InputCommand::QUIT) {
             display.displayMessage("Thanks for playing!");
             break;
-        } else if (parser.isHelpCommand(input)) {
+        } else if (parsed.command == InputCommand::HELP) {
             display.showHelpMessage();
             continue;
-        } else if (parser.isUndoCommand(input)) {
+        } else if (parsed.command == InputCommand::UNDO) {
             game.undoLastMove();
             display.displayMessage("Move undone.");
             continue;
-        } else if (parser.isDrawCommand(input)) {
+        } else if (parsed.command == InputCommand::DRAW) {
             if (game.offerDraw()) {
                 display.displayMessage("Draw offered. Opponent, type 'draw' to accept.");
             }
             continue;
-        } else if (parser.isResignCommand(input)) {
+        } else if (parsed.command == InputCommand::RESIGN) {
             game.resignGame(game.getCurrentPlayer());
             display.displayMessage(currentPlayer->getName() + " resigned.");
             break;
         }
         
-        // Parse and execute move
-        auto movePositions = parser.parseMove(input);
-        if (movePositions) {
-            Position from = movePositions->first;
-            Position to = movePositions->second;
+        // Execute move
+        if (parsed.command == InputCommand::MOVE) {
+            Position from = parsed.from;
+            Position to = parsed.to;
+            bool moved = parsed.promotion ? game.makeMove(Move(from, to, *parsed.promotion))
+                                          : game.makeMove(from, to);
             
-            if (game.makeMove(from, to)) {
+            if (moved) {
                 display.displayMessage("Move executed: " + 
                                      Utils::positionToSquare(from) + " to " + 
                                      Utils::positionToSquare(to));
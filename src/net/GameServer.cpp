@@ -0,0 +1,878 @@
+#include "net/GameServer.h"
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <deque>
+#include <sstream>
+
+namespace {
+
+constexpr size_t MAX_LINE = 4096;
+constexpr int MAX_EVENTS = 256;
+constexpr int SPECTATOR_TICK_MS = 10;
+// A spectator with more unsent output than this skips events and resyncs
+// once its socket drains
+constexpr size_t MAX_SPECTATOR_BACKLOG = 64 * 1024;
+
+}
+
+struct GameServer::Connection : std::enable_shared_from_this<Connection> {
+    uint64_t id;
+    int fd;
+    Worker* worker;
+    std::string input;
+    std::vector<uint32_t> created;
+    std::vector<uint32_t> joined;      // Sessions it plays black in
+    
+    std::mutex output_mutex;
+    std::string output;
+    // Output waiting for the log, in order: each entry with the LSN it waits
+    // for, or NO_LSN when it only queues behind an earlier one
+    std::deque<std::pair<uint64_t, std::string>> held;
+    bool holding = false;   // Listed in holding_
+    bool write_armed = false;
+    bool closed = false;
+};
+
+struct GameServer::WatchGroup {
+    struct Spectator {
+        std::weak_ptr<Connection> connection;
+        uint64_t next;          // Sequence number of the next event to send
+        bool resync = false;
+    };
+    
+    // Held by WATCH and UNWATCH on a worker and by a fan-out pass
+    std::mutex mutex;
+    std::shared_ptr<Session> session;
+    std::vector<Spectator> spectators;
+    // Set by the fan-out thread when it drops the group; a later WATCH
+    // starts a new one
+    bool finished = false;
+};
+
+struct GameServer::Worker {
+    size_t index = 0;
+    int epoll_fd = -1;
+    int wake_fd = -1;
+    std::thread thread;
+    std::unordered_map<int, std::shared_ptr<Connection>> connections;
+};
+
+GameServer::GameServer(const ServerConfig& config)
+    : config_(config),
+      listen_fd_(-1),
+      port_(config.port),
+      running_(false),
+      next_session_id_(1),
+      next_connection_id_(1),
+      connection_count_(0) {}
+
+GameServer::~GameServer() {
+    stop();
+    wait();
+    if (listen_fd_ >= 0) ::close(listen_fd_);
+    if (!config_.unixPath.empty()) ::unlink(config_.unixPath.c_str());
+}
+
+bool GameServer::start() {
+    if (!openListener()) return false;
+    if (!config_.logDirectory.empty() && !openLog()) return false;
+    
+    unsigned threads = config_.threads ? config_.threads : std::max(1u, std::thread::hardware_concurrency());
+    running_ = true;
+    
+    for (unsigned i = 0; i < threads; ++i) {
+        auto worker = std::make_unique<Worker>();
+        worker->index = i;
+        worker->epoll_fd = ::epoll_create1(EPOLL_CLOEXEC);
+        worker->wake_fd = ::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+        
+        epoll_event listenEvent{};
+        listenEvent.events = EPOLLIN | EPOLLEXCLUSIVE;
+        listenEvent.data.fd = listen_fd_;
+        epoll_event wakeEvent{};
+        wakeEvent.events = EPOLLIN;
+        wakeEvent.data.fd = worker->wake_fd;
+        if (worker->epoll_fd < 0 || worker->wake_fd < 0 ||
+            ::epoll_ctl(worker->epoll_fd, EPOLL_CTL_ADD, listen_fd_, &listenEvent) != 0 ||
+            ::epoll_ctl(worker->epoll_fd, EPOLL_CTL_ADD, worker->wake_fd, &wakeEvent) != 0) {
+            stop();
+            return false;
+        }
+        
+        workers_.push_back(std::move(worker));
+    }
+    
+    for (auto& worker : workers_) {
+        Worker* w = worker.get();
+        worker->thread = std::thread([this, w] { workerLoop(*w); });
+    }
+    spectator_thread_ = std::thread([this] { spectatorLoop(); });
+    if (log_) checkpoint_thread_ = std::thread([this] { checkpointLoop(); });
+    return true;
+}
+
+void GameServer::stop() {
+    {
+        // Under the locks, so the background threads cannot miss the wakeup
+        std::scoped_lock lock(watch_mutex_, checkpoint_mutex_);
+        running_ = false;
+    }
+    watch_cv_.notify_all();
+    checkpoint_cv_.notify_all();
+    for (auto& worker : workers_) {
+        uint64_t one = 1;
+        if (worker->wake_fd >= 0) {
+            [[maybe_unused]] ssize_t written = ::write(worker->wake_fd, &one, sizeof(one));
+        }
+    }
+}
+
+void GameServer::wait() {
+    if (spectator_thread_.joinable()) spectator_thread_.join();
+    if (checkpoint_thread_.joinable()) checkpoint_thread_.join();
+    watching_.clear();
+    for (auto& worker : workers_) {
+        if (worker->thread.joinable()) worker->thread.join();
+    }
+    // Sessions are left open in the log, so a restart resumes them. Closed
+    // before the connections, as its last sync still releases held replies.
+    if (log_) log_->close();
+    for (auto& worker : workers_) {
+        for (auto& entry : worker->connections) ::close(entry.first);
+        worker->connections.clear();
+        if (worker->epoll_fd >= 0) ::close(worker->epoll_fd);
+        if (worker->wake_fd >= 0) ::close(worker->wake_fd);
+        worker->epoll_fd = worker->wake_fd = -1;
+    }
+    workers_.clear();
+}
+
+size_t GameServer::sessionCount() const {
+    size_t count = 0;
+    for (auto& shard : sessions_) {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        count += shard.items.size();
+    }
+    return count;
+}
+
+bool GameServer::openListener() {
+    if (!config_.unixPath.empty()) {
+        listen_fd_ = ::socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+        if (listen_fd_ < 0) return false;
+        
+        sockaddr_un addr{};
+        addr.sun_family = AF_UNIX;
+        if (config_.unixPath.size() >= sizeof(addr.sun_path)) return false;
+        std::strcpy(addr.sun_path, config_.unixPath.c_str());
+        ::unlink(config_.unixPath.c_str());
+        if (::bind(listen_fd_, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0) return false;
+    } else {
+        listen_fd_ = ::socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+        if (listen_fd_ < 0) return false;
+        
+        int reuse = 1;
+        ::setsockopt(listen_fd_, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+        
+        sockaddr_in addr{};
+        addr.sin_family = AF_INET;
+        addr.sin_port = htons(static_cast<uint16_t>(config_.port));
+        if (::inet_pton(AF_INET, config_.host.c_str(), &addr.sin_addr) != 1) return false;
+        if (::bind(listen_fd_, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0) return false;
+        
+        socklen_t length = sizeof(addr);
+        ::getsockname(listen_fd_, reinterpret_cast<sockaddr*>(&addr), &length);
+        port_ = ntohs(addr.sin_port);
+    }
+    return ::listen(listen_fd_, SOMAXCONN) == 0;
+}
+
+bool GameServer::openLog() {
+    MoveLogConfig logConfig;
+    logConfig.directory = config_.logDirectory;
+    logConfig.commitInterval = std::chrono::microseconds(config_.commitMicros);
+    logConfig.checkpointRecords = config_.checkpointRecords;
+    logConfig.onDurable = [this](uint64_t durable) { releaseHeld(durable); };
+    log_ = std::make_unique<MoveLog>(logConfig);
+    
+    std::vector<RecoveredSession> recovered;
+    if (!log_->open(recovered)) return false;
+    uint32_t last = 0;
+    for (const auto& entry : recovered) {
+        sessions_[entry.id % SHARD_COUNT].items[entry.id] = std::make_shared<Session>(entry, log_.get());
+        last = std::max(last, entry.id);
+    }
+    next_session_id_ = last + 1;
+    
+    // Start from a checkpoint, so the segments just replayed go away
+    checkpoint();
+    return !log_->failed();
+}
+
+void GameServer::checkpoint() {
+    if (!log_->beginCheckpoint()) return;
+    
+    std::vector<CheckpointEntry> entries;
+    for (auto& shard : sessions_) {
+        std::vector<std::shared_ptr<Session>> sessions;
+        {
+            std::lock_guard<std::mutex> lock(shard.mutex);
+            for (const auto& entry : shard.items) sessions.push_back(entry.second);
+        }
+        for (const auto& session : sessions) entries.push_back(session->checkpoint());
+    }
+    log_->writeCheckpoint(entries);
+}
+
+void GameServer::checkpointLoop() {
+    // Polls like the parking sweep; the checkpoint itself runs here, so no
+    // worker's connections wait on it
+    std::unique_lock<std::mutex> lock(checkpoint_mutex_);
+    while (running_) {
+        checkpoint_cv_.wait_for(lock, std::chrono::seconds(1), [this] { return !running_; });
+        if (!running_) break;
+        lock.unlock();
+        if (log_->checkpointDue()) checkpoint();
+        lock.lock();
+    }
+}
+
+void GameServer::workerLoop(Worker& worker) {
+    epoll_event events[MAX_EVENTS];
+    int sweepTimeout = config_.parkAfterSeconds ? 1000 : -1;
+    auto lastSweep = std::chrono::steady_clock::now();
+    
+    while (running_) {
+        int timeout = clockTimeout(worker);
+        if (sweepTimeout >= 0 && (timeout < 0 || timeout > sweepTimeout)) timeout = sweepTimeout;
+        int ready = ::epoll_wait(worker.epoll_fd, events, MAX_EVENTS, timeout);
+        if (ready < 0) {
+            if (errno == EINTR) continue;
+            break;
+        }
+        
+        fireClockTimers(worker);
+        
+        if (config_.parkAfterSeconds && std::chrono::steady_clock::now() - lastSweep >= std::chrono::seconds(1)) {
+            parkIdleSessions(worker);
+            lastSweep = std::chrono::steady_clock::now();
+        }
+        
+        for (int i = 0; i < ready; ++i) {
+            int fd = events[i].data.fd;
+            if (fd == worker.wake_fd) continue;
+            if (fd == listen_fd_) {
+                acceptConnections(worker);
+                continue;
+            }
+            
+            auto it = worker.connections.find(fd);
+            if (it == worker.connections.end()) continue;
+            auto connection = it->second;
+            
+            if (events[i].events & (EPOLLHUP | EPOLLERR)) {
+                closeConnection(worker, fd);
+                continue;
+            }
+            if (events[i].events & EPOLLOUT) {
+                handleWritable(*connection);
+            }
+            if (events[i].events & EPOLLIN) {
+                handleReadable(worker, connection);
+            }
+        }
+    }
+}
+
+void GameServer::acceptConnections(Worker& worker) {
+    while (true) {
+        int fd = ::accept4(listen_fd_, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (fd < 0) return;
+        
+        if (config_.unixPath.empty()) {
+            int noDelay = 1;
+            ::setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &noDelay, sizeof(noDelay));
+        }
+        
+        auto connection = std::make_shared<Connection>();
+        connection->id = next_connection_id_++;
+        connection->fd = fd;
+        connection->worker = &worker;
+        
+        epoll_event event{};
+        event.events = EPOLLIN | EPOLLRDHUP;
+        event.data.fd = fd;
+        if (::epoll_ctl(worker.epoll_fd, EPOLL_CTL_ADD, fd, &event) != 0) {
+            ::close(fd);
+            continue;
+        }
+        
+        worker.connections[fd] = connection;
+        auto& shard = connections_[connection->id % SHARD_COUNT];
+        {
+            std::lock_guard<std::mutex> lock(shard.mutex);
+            shard.items[connection->id] = connection;
+        }
+        ++connection_count_;
+    }
+}
+
+void GameServer::handleReadable(Worker& worker, const std::shared_ptr<Connection>& connection) {
+    char buffer[16384];
+    std::string replies;
+    
+    while (true) {
+        ssize_t received = ::recv(connection->fd, buffer, sizeof(buffer), 0);
+        if (received == 0) {
+            closeConnection(worker, connection->fd);
+            return;
+        }
+        if (received < 0) {
+            if (errno == EAGAIN || errno == EWOULDBLOCK) break;
+            if (errno == EINTR) continue;
+            closeConnection(worker, connection->fd);
+            return;
+        }
+        
+        connection->input.append(buffer, static_cast<size_t>(received));
+        
+        // Answer every complete line; replies for a batch go out in one write
+        size_t start = 0;
+        size_t newline;
+        while ((newline = connection->input.find('\n', start)) != std::string::npos) {
+            size_t end = newline;
+            if (end > start && connection->input[end - 1] == '\r') --end;
+            uint64_t lsn = MoveLog::NO_LSN;
+            std::string reply = handleLine(*connection, connection->input.substr(start, end - start), lsn);
+            if (lsn != MoveLog::NO_LSN) {
+                // Held until the move is durable; later replies queue behind it
+                if (!replies.empty()) deliver(*connection, replies);
+                replies.clear();
+                deliver(*connection, reply + '\n', lsn);
+            } else {
+                replies += reply;
+                replies += '\n';
+            }
+            start = newline + 1;
+        }
+        connection->input.erase(0, start);
+        
+        if (connection->input.size() > MAX_LINE) {
+            closeConnection(worker, connection->fd);
+            return;
+        }
+    }
+    
+    if (!replies.empty()) deliver(*connection, replies);
+}
+
+void GameServer::handleWritable(Connection& connection) {
+    std::lock_guard<std::mutex> lock(connection.output_mutex);
+    if (connection.closed) return;
+    
+    while (!connection.output.empty()) {
+        ssize_t sent = ::send(connection.fd, connection.output.data(), connection.output.size(), MSG_NOSIGNAL);
+        if (sent < 0) {
+            if (errno == EINTR) continue;
+            return;
+        }
+        connection.output.erase(0, static_cast<size_t>(sent));
+    }
+    
+    epoll_event event{};
+    event.events = EPOLLIN | EPOLLRDHUP;
+    event.data.fd = connection.fd;
+    ::epoll_ctl(connection.worker->epoll_fd, EPOLL_CTL_MOD, connection.fd, &event);
+    connection.write_armed = false;
+}
+
+void GameServer::deliver(Connection& connection, const std::string& data, uint64_t lsn) {
+    std::lock_guard<std::mutex> lock(connection.output_mutex);
+    if (connection.closed) return;
+    if (lsn == MoveLog::NO_LSN && connection.held.empty()) {
+        send(connection, data);
+        return;
+    }
+    
+    // Listed before durableLsn() is read, so a sync that this check misses
+    // finds the connection
+    connection.held.emplace_back(lsn, data);
+    if (!connection.holding) {
+        connection.holding = true;
+        std::lock_guard<std::mutex> holdingLock(holding_mutex_);
+        holding_.push_back(connection.shared_from_this());
+    }
+    release(connection, log_->durableLsn(), log_->failed());
+}
+
+void GameServer::send(Connection& connection, const std::string& data) {
+    size_t offset = 0;
+    if (connection.output.empty()) {
+        while (offset < data.size()) {
+            ssize_t sent = ::send(connection.fd, data.data() + offset, data.size() - offset,
+                                  MSG_NOSIGNAL | MSG_DONTWAIT);
+            if (sent < 0) {
+                if (errno == EINTR) continue;
+                break;
+            }
+            offset += static_cast<size_t>(sent);
+        }
+    }
+    if (offset == data.size()) return;
+    
+    // Socket is full: keep the rest and wait for EPOLLOUT
+    connection.output.append(data, offset, std::string::npos);
+    if (!connection.write_armed) {
+        epoll_event event{};
+        event.events = EPOLLIN | EPOLLOUT | EPOLLRDHUP;
+        event.data.fd = connection.fd;
+        ::epoll_ctl(connection.worker->epoll_fd, EPOLL_CTL_MOD, connection.fd, &event);
+        connection.write_armed = true;
+    }
+}
+
+void GameServer::release(Connection& connection, uint64_t durable, bool failed) {
+    std::string ready;
+    auto& held = connection.held;
+    while (!held.empty() && (held.front().first == MoveLog::NO_LSN || held.front().first < durable)) {
+        ready += held.front().second;
+        held.pop_front();
+    }
+    if (!ready.empty()) send(connection, ready);
+    if (!failed || held.empty()) return;
+    
+    // Nothing more will sync: rather than acknowledge moves a crash would
+    // lose, drop the connection; its worker closes it on the hangup
+    held.clear();
+    ::shutdown(connection.fd, SHUT_RDWR);
+}
+
+void GameServer::releaseHeld(uint64_t durable) {
+    bool failed = durable == MoveLog::NO_LSN;
+    if (failed) durable = log_->durableLsn();
+    std::vector<std::weak_ptr<Connection>> holding;
+    {
+        std::lock_guard<std::mutex> lock(holding_mutex_);
+        holding.swap(holding_);
+    }
+    for (const auto& weak : holding) {
+        auto connection = weak.lock();
+        if (!connection) continue;
+        std::lock_guard<std::mutex> lock(connection->output_mutex);
+        connection->holding = false;
+        if (connection->closed) continue;
+        release(*connection, durable, failed);
+        if (!connection->held.empty()) {
+            connection->holding = true;
+            std::lock_guard<std::mutex> holdingLock(holding_mutex_);
+            holding_.push_back(connection);
+        }
+    }
+}
+
+void GameServer::notify(uint64_t connectionId, const std::string& line, uint64_t lsn) {
+    std::shared_ptr<Connection> target;
+    auto& shard = connections_[connectionId % SHARD_COUNT];
+    {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        auto it = shard.items.find(connectionId);
+        if (it == shard.items.end()) return;
+        target = it->second;
+    }
+    deliver(*target, line + "\n", lsn);
+}
+
+void GameServer::closeConnection(Worker& worker, int fd) {
+    auto it = worker.connections.find(fd);
+    if (it == worker.connections.end()) return;
+    auto connection = it->second;
+    worker.connections.erase(it);
+    
+    {
+        auto& shard = connections_[connection->id % SHARD_COUNT];
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        shard.items.erase(connection->id);
+    }
+    // A game in progress is forfeited to the opponent, and the session stays
+    // until they have left as well
+    auto leave = [&](uint32_t id) {
+        auto session = findSession(id);
+        if (!session) return;
+        SessionReply reply = session->leave(connection->id);
+        if (reply.notifyConnection != 0) notify(reply.notifyConnection, reply.notification);
+        if (reply.vacated) {
+            eraseSession(id);
+        } else if (session->isTimed()) {
+            syncClockTimer(*session);
+        }
+    };
+    for (uint32_t id : connection->created) leave(id);
+    for (uint32_t id : connection->joined) leave(id);
+    
+    {
+        std::lock_guard<std::mutex> lock(connection->output_mutex);
+        connection->closed = true;
+        ::epoll_ctl(worker.epoll_fd, EPOLL_CTL_DEL, fd, nullptr);
+        ::close(fd);
+    }
+    --connection_count_;
+}
+
+void GameServer::parkIdleSessions(const Worker& worker) {
+    auto idleSince = Session::Clock::now() - std::chrono::seconds(config_.parkAfterSeconds);
+    
+    // Each worker sweeps its own slice of the shards
+    for (size_t s = worker.index; s < SHARD_COUNT; s += workers_.size()) {
+        std::vector<std::shared_ptr<Session>> candidates;
+        {
+            std::lock_guard<std::mutex> lock(sessions_[s].mutex);
+            candidates.reserve(sessions_[s].items.size());
+            for (const auto& entry : sessions_[s].items) candidates.push_back(entry.second);
+        }
+        for (const auto& session : candidates) {
+            session->park(idleSince);
+        }
+    }
+}
+
+void GameServer::syncClockTimer(const Session& session) {
+    size_t s = session.getId() % SHARD_COUNT;
+    auto& shard = clocks_[s];
+    {
+        // The deadline is read under the shard lock, so the last sync of
+        // racing updates always arms the session's current deadline
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        auto deadline = session.flagTime();
+        auto it = shard.timers.find(session.getId());
+        if (it != shard.timers.end()) {
+            shard.wheel.cancel(it->second);
+            if (!deadline) shard.timers.erase(it);
+        }
+        if (!deadline) return;
+        shard.timers[session.getId()] = shard.wheel.arm(session.getId(), *deadline);
+    }
+    
+    uint64_t one = 1;
+    const Worker& owner = *workers_[s % workers_.size()];
+    [[maybe_unused]] ssize_t written = ::write(owner.wake_fd, &one, sizeof(one));
+}
+
+void GameServer::fireClockTimers(const Worker& worker) {
+    auto now = Session::Clock::now();
+    std::vector<uint64_t> fired;
+    for (size_t s = worker.index; s < SHARD_COUNT; s += workers_.size()) {
+        std::lock_guard<std::mutex> lock(clocks_[s].mutex);
+        size_t from = fired.size();
+        clocks_[s].wheel.advance(now, fired);
+        for (size_t i = from; i < fired.size(); ++i) {
+            clocks_[s].timers.erase(static_cast<uint32_t>(fired[i]));
+        }
+    }
+    
+    for (uint64_t id : fired) {
+        auto session = findSession(static_cast<uint32_t>(id));
+        if (!session) continue;
+        auto flag = session->checkFlag(now);
+        if (!flag) {
+            // Fired within a tick of the deadline or the clock moved on
+            syncClockTimer(*session);
+            continue;
+        }
+        for (uint64_t connection : session->participants()) notify(connection, *flag);
+    }
+}
+
+int GameServer::clockTimeout(const Worker& worker) {
+    std::optional<Session::Clock::time_point> wakeup;
+    for (size_t s = worker.index; s < SHARD_COUNT; s += workers_.size()) {
+        std::lock_guard<std::mutex> lock(clocks_[s].mutex);
+        auto next = clocks_[s].wheel.nextWakeup();
+        if (next && (!wakeup || *next < *wakeup)) wakeup = next;
+    }
+    if (!wakeup) return -1;
+    
+    auto wait = std::chrono::ceil<std::chrono::milliseconds>(*wakeup - Session::Clock::now());
+    return static_cast<int>(std::max<int64_t>(0, wait.count()));
+}
+
+std::string GameServer::handleLine(Connection& connection, const std::string& line, uint64_t& lsn) {
+    using Protocol::CommandType;
+    Protocol::Command command = Protocol::parseCommand(line);
+    std::string id = std::to_string(command.gameId);
+    
+    if (command.type == CommandType::PING) return "PONG";
+    if (command.type == CommandType::UNKNOWN) return "ERR 0 unknown-command";
+    
+    if (command.type == CommandType::NEW) {
+        bool solo = false;
+        std::optional<TimeControl> control;
+        std::istringstream options(command.argument);
+        std::string option;
+        while (options >> option) {
+            if (option == "solo") {
+                solo = true;
+            } else if (!(control = Protocol::parseTimeControl(option))) {
+                return "ERR 0 bad-option";
+            }
+        }
+        
+        uint32_t sessionId = next_session_id_++;
+        auto session = std::make_shared<Session>(sessionId, connection.id, solo, control, log_.get());
+        if (session->isTimed()) syncClockTimer(*session);
+        auto& shard = sessions_[sessionId % SHARD_COUNT];
+        {
+            std::lock_guard<std::mutex> lock(shard.mutex);
+            shard.items[sessionId] = std::move(session);
+        }
+        connection.created.push_back(sessionId);
+        return "GAME " + std::to_string(sessionId) + (solo ? " both" : " white");
+    }
+    
+    if (command.type == CommandType::UNWATCH) return unwatch(connection, command.gameId);
+    
+    auto session = findSession(command.gameId);
+    if (!session) return "ERR " + id + " no-such-game";
+    
+    SessionReply reply;
+    switch (command.type) {
+        case CommandType::JOIN:
+            reply = session->join(connection.id);
+            if (reply.claimed) {
+                connection.created.push_back(command.gameId);
+            } else if (reply.text.rfind("JOINED ", 0) == 0) {
+                connection.joined.push_back(command.gameId);
+            }
+            break;
+        case CommandType::MOVE: {
+            auto move = Protocol::parseMove(command.argument);
+            if (!move) return "ERR " + id + " bad-move";
+            reply = session->move(connection.id, *move);
+            if (config_.durableReplies && log_) {
+                // Once the log has failed a move cannot be made durable; hold
+                // it on an LSN that never syncs, so the connection is dropped
+                lsn = (reply.lsn == MoveLog::NO_LSN && log_->failed()) ? log_->durableLsn() : reply.lsn;
+            }
+            break;
+        }
+        case CommandType::STATE:
+            reply = session->state();
+            break;
+        case CommandType::UNDO:
+            reply = session->undo(connection.id);
+            break;
+        case CommandType::RESIGN:
+            reply = session->resign(connection.id);
+            break;
+        case CommandType::CLOCK:
+            reply = session->clock();
+            break;
+        case CommandType::WATCH:
+            return watch(connection, session);
+        case CommandType::UNWATCH:
+            return unwatch(connection, command.gameId);
+        case CommandType::CLOSE: {
+            auto it = std::find(connection.created.begin(), connection.created.end(), command.gameId);
+            if (it == connection.created.end()) return "ERR " + id + " not-owner";
+            connection.created.erase(it);
+            eraseSession(command.gameId);
+            return "CLOSED " + id;
+        }
+        default:
+            return "ERR " + id + " unknown-command";
+    }
+    
+    if (session->isTimed() && command.type != CommandType::STATE && command.type != CommandType::CLOCK) {
+        syncClockTimer(*session);
+    }
+    if (reply.notifyConnection != 0) {
+        notify(reply.notifyConnection, reply.notification, lsn);
+    }
+    return reply.text;
+}
+
+std::string GameServer::watch(Connection& connection, const std::shared_ptr<Session>& session) {
+    SpectatorSnapshot snapshot = session->spectate();
+    while (true) {
+        std::shared_ptr<WatchGroup> group;
+        {
+            std::lock_guard<std::mutex> lock(watch_mutex_);
+            auto& slot = watching_[session->getId()];
+            if (!slot || slot->finished || slot->session != session) {
+                slot = std::make_shared<WatchGroup>();
+                slot->session = session;
+            }
+            group = slot;
+        }
+        watch_cv_.notify_all();
+        
+        std::lock_guard<std::mutex> lock(group->mutex);
+        // Dropped by the fan-out thread in between: start a new one
+        if (group->finished) continue;
+        auto it = std::find_if(group->spectators.begin(), group->spectators.end(),
+                               [&](const WatchGroup::Spectator& s) { return s.connection.lock().get() == &connection; });
+        if (it == group->spectators.end()) {
+            group->spectators.push_back({connection.worker->connections.at(connection.fd), snapshot.sequence});
+        } else {
+            it->next = snapshot.sequence;
+            it->resync = false;
+        }
+        return "WATCHING " + std::to_string(session->getId()) + " " + std::to_string(snapshot.sequence) + " " +
+               snapshot.text;
+    }
+}
+
+std::string GameServer::unwatch(Connection& connection, uint32_t id) {
+    std::shared_ptr<WatchGroup> group;
+    {
+        std::lock_guard<std::mutex> lock(watch_mutex_);
+        auto it = watching_.find(id);
+        if (it != watching_.end()) group = it->second;
+    }
+    if (!group) return "ERR " + std::to_string(id) + " not-watching";
+    
+    // An emptied group is dropped by the next fan-out pass
+    std::lock_guard<std::mutex> lock(group->mutex);
+    auto& spectators = group->spectators;
+    auto it = std::find_if(spectators.begin(), spectators.end(), [&](const WatchGroup::Spectator& s) {
+        return s.connection.lock().get() == &connection;
+    });
+    if (group->finished || it == spectators.end()) return "ERR " + std::to_string(id) + " not-watching";
+    spectators.erase(it);
+    return "UNWATCHED " + std::to_string(id);
+}
+
+void GameServer::spectatorLoop() {
+    std::unique_lock<std::mutex> lock(watch_mutex_);
+    while (running_) {
+        if (watching_.empty()) {
+            watch_cv_.wait(lock, [this] { return !running_ || !watching_.empty(); });
+            continue;
+        }
+        watch_cv_.wait_for(lock, std::chrono::milliseconds(SPECTATOR_TICK_MS), [this] { return !running_; });
+        
+        // Fan out without the map lock, so WATCH and UNWATCH on the workers
+        // only ever wait for one group
+        std::vector<std::pair<uint32_t, std::shared_ptr<WatchGroup>>> groups(watching_.begin(), watching_.end());
+        lock.unlock();
+        std::vector<uint32_t> finished;
+        for (const auto& [id, group] : groups) {
+            std::lock_guard<std::mutex> groupLock(group->mutex);
+            if (!fanOut(id, *group)) {
+                group->finished = true;
+                finished.push_back(id);
+            }
+        }
+        lock.lock();
+        for (uint32_t id : finished) {
+            auto it = watching_.find(id);
+            if (it != watching_.end() && it->second->finished) watching_.erase(it);
+        }
+    }
+}
+
+bool GameServer::fanOut(uint32_t id, WatchGroup& group) {
+    auto& spectators = group.spectators;
+    spectators.erase(std::remove_if(spectators.begin(), spectators.end(),
+                                    [](const WatchGroup::Spectator& s) { return s.connection.expired(); }),
+                     spectators.end());
+    if (spectators.empty()) return false;
+    
+    // Read before head, so that head covers the CLOSED event
+    bool closed = group.session->isClosed();
+    const auto& ring = group.session->events();
+    uint64_t head = ring.head();
+    uint64_t from = head;
+    for (const auto& spectator : spectators) {
+        if (!spectator.resync) from = std::min(from, spectator.next);
+    }
+    
+    // Read and format the events once for everyone; offsets[i] is where the
+    // line of event from + i starts, and events up to lostBefore are gone
+    std::string lines;
+    std::vector<size_t> offsets;
+    uint64_t lostBefore = 0;
+    for (uint64_t sequence = from; sequence < head; ++sequence) {
+        offsets.push_back(lines.size());
+        SpectatorEvent event;
+        if (ring.read(sequence, event) != EventRing<SpectatorEvent>::Read::OK) {
+            lostBefore = sequence + 1;
+            continue;
+        }
+        lines += Session::formatEvent(id, sequence, event);
+        lines += '\n';
+    }
+    offsets.push_back(lines.size());
+    
+    for (auto& spectator : spectators) {
+        auto connection = spectator.connection.lock();
+        if (spectator.next < lostBefore || pendingOutput(*connection) > MAX_SPECTATOR_BACKLOG) {
+            spectator.resync = true;
+        }
+        if (spectator.resync) {
+            if (closed) {
+                SpectatorEvent last{};
+                last.kind = SpectatorEvent::CLOSED;
+                deliver(*connection, Session::formatEvent(id, head - 1, last) + "\n");
+            } else if (pendingOutput(*connection) == 0) {
+                // Caught up on the socket: start again from a fresh position
+                SpectatorSnapshot snapshot = group.session->spectate();
+                deliver(*connection, "SYNC " + std::to_string(id) + " " + std::to_string(snapshot.sequence) + " " +
+                                     snapshot.text + "\n");
+                spectator.next = snapshot.sequence;
+                spectator.resync = false;
+            }
+            continue;
+        }
+        if (spectator.next < head) {
+            deliver(*connection, lines.substr(offsets[spectator.next - from]));
+            spectator.next = head;
+        }
+    }
+    return !closed;
+}
+
+size_t GameServer::pendingOutput(Connection& connection) {
+    std::lock_guard<std::mutex> lock(connection.output_mutex);
+    return connection.output.size();
+}
+
+std::shared_ptr<Session> GameServer::findSession(uint32_t id) {
+    auto& shard = sessions_[id % SHARD_COUNT];
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    auto it = shard.items.find(id);
+    return it == shard.items.end() ? nullptr : it->second;
+}
+
+void GameServer::eraseSession(uint32_t id) {
+    {
+        auto& clocks = clocks_[id % SHARD_COUNT];
+        std::lock_guard<std::mutex> lock(clocks.mutex);
+        auto it = clocks.timers.find(id);
+        if (it != clocks.timers.end()) {
+            clocks.wheel.cancel(it->second);
+            clocks.timers.erase(it);
+        }
+    }
+    std::shared_ptr<Session> session;
+    {
+        auto& shard = sessions_[id % SHARD_COUNT];
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        auto it = shard.items.find(id);
+        if (it == shard.items.end()) return;
+        session = std::move(it->second);
+        shard.items.erase(it);
+    }
+    // Spectators still hold it and learn from the ring that it is gone
+    session->close();
+}
\ No newline at end of file
@@ -0,0 +1,490 @@
+#include "net/MoveLog.h"
+#include "core/Game.h"
+#include "utils/MappedFile.h"
+#include <fcntl.h>
+#include <unistd.h>
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <map>
+#include <memory>
+
+namespace {
+
+constexpr char SEGMENT_MAGIC[4] = {'R', 'C', 'W', 'L'};
+constexpr char CHECKPOINT_MAGIC[4] = {'R', 'C', 'C', 'P'};
+constexpr uint32_t VERSION = 1;
+// Version 1 checkpoints have no clocks
+constexpr uint32_t CHECKPOINT_VERSION = 2;
+// Magic, version, segment, first LSN
+constexpr size_t SEGMENT_HEADER = 4 + 4 + 4 + 8;
+// Magic, version, segment, first LSN, session count
+constexpr size_t CHECKPOINT_HEADER = 4 + 4 + 4 + 8 + 4;
+
+uint32_t crc32(const void* data, size_t size) {
+    static const std::array<uint32_t, 256> table = [] {
+        std::array<uint32_t, 256> entries{};
+        for (uint32_t i = 0; i < 256; ++i) {
+            uint32_t crc = i;
+            for (int bit = 0; bit < 8; ++bit) crc = (crc >> 1) ^ ((crc & 1) ? 0xEDB88320u : 0);
+            entries[i] = crc;
+        }
+        return entries;
+    }();
+    uint32_t crc = 0xFFFFFFFFu;
+    const uint8_t* bytes = static_cast<const uint8_t*>(data);
+    for (size_t i = 0; i < size; ++i) crc = table[(crc ^ bytes[i]) & 0xFF] ^ (crc >> 8);
+    return ~crc;
+}
+
+uint32_t checksumOf(const MoveRecord& record) {
+    return crc32(&record, offsetof(MoveRecord, checksum));
+}
+
+bool writeAll(int fd, const void* data, size_t size) {
+    const char* bytes = static_cast<const char*>(data);
+    while (size > 0) {
+        ssize_t written = ::write(fd, bytes, size);
+        if (written < 0 && errno == EINTR) continue;
+        if (written <= 0) return false;
+        bytes += written;
+        size -= static_cast<size_t>(written);
+    }
+    return true;
+}
+
+template <typename T>
+void put(std::vector<uint8_t>& out, const T& value) {
+    const uint8_t* bytes = reinterpret_cast<const uint8_t*>(&value);
+    out.insert(out.end(), bytes, bytes + sizeof(T));
+}
+
+template <typename T>
+bool take(const unsigned char*& cursor, const unsigned char* end, T& value) {
+    if (static_cast<size_t>(end - cursor) < sizeof(T)) return false;
+    std::memcpy(&value, cursor, sizeof(T));
+    cursor += sizeof(T);
+    return true;
+}
+
+// Segment number from "wal-<n>.log", or -1
+int64_t segmentNumber(const std::string& name) {
+    if (name.size() < 9 || name.compare(0, 4, "wal-") != 0 || name.compare(name.size() - 4, 4, ".log") != 0) {
+        return -1;
+    }
+    std::string digits = name.substr(4, name.size() - 8);
+    if (digits.empty() || digits.find_first_not_of("0123456789") != std::string::npos) return -1;
+    return static_cast<int64_t>(std::stoull(digits));
+}
+
+std::vector<uint32_t> listSegments(const std::string& directory) {
+    std::vector<uint32_t> segments;
+    std::error_code ec;
+    for (const auto& entry : std::filesystem::directory_iterator(directory, ec)) {
+        int64_t number = segmentNumber(entry.path().filename().string());
+        if (number >= 0) segments.push_back(static_cast<uint32_t>(number));
+    }
+    std::sort(segments.begin(), segments.end());
+    return segments;
+}
+
+struct Replay {
+    bool solo;
+    uint64_t lastLsn;       // Records up to here are already in the game
+    std::unique_ptr<Game> game;
+    std::optional<LoggedClock> clock{};
+};
+
+int sideIndex(PieceColor side) {
+    return side == PieceColor::WHITE ? 0 : 1;
+}
+
+void putClock(std::vector<uint8_t>& out, const std::optional<LoggedClock>& clock) {
+    put(out, static_cast<uint8_t>(clock ? 1 : 0));
+    if (!clock) return;
+    for (auto millis : {clock->control.base, clock->control.increment, clock->control.delay,
+                        clock->remaining[0], clock->remaining[1]}) {
+        put(out, static_cast<uint32_t>(millis.count()));
+    }
+}
+
+bool takeClock(const unsigned char*& cursor, const unsigned char* end, std::optional<LoggedClock>& clock) {
+    uint8_t timed = 0;
+    if (!take(cursor, end, timed)) return false;
+    if (!timed) return true;
+    uint32_t millis[5];
+    for (auto& value : millis) {
+        if (!take(cursor, end, value)) return false;
+    }
+    LoggedClock loaded;
+    loaded.control.base = std::chrono::milliseconds(millis[0]);
+    loaded.control.increment = std::chrono::milliseconds(millis[1]);
+    loaded.control.delay = std::chrono::milliseconds(millis[2]);
+    loaded.remaining[0] = std::chrono::milliseconds(millis[3]);
+    loaded.remaining[1] = std::chrono::milliseconds(millis[4]);
+    clock = loaded;
+    return true;
+}
+
+void apply(std::map<uint32_t, Replay>& sessions, const MoveRecord& record, uint64_t lsn) {
+    auto it = sessions.find(record.session);
+    if (it != sessions.end() && it->second.lastLsn != MoveLog::NO_LSN && lsn <= it->second.lastLsn) return;
+    
+    if (record.type == MoveRecord::NEW) {
+        Replay& replay = sessions[record.session] = {(record.detail & 1) != 0, MoveLog::NO_LSN,
+                                                     std::make_unique<Game>()};
+        if (record.clock) {
+            LoggedClock clock;
+            clock.control.base = std::chrono::seconds(record.clock);
+            auto extra = std::chrono::seconds(record.from + 256 * record.to);
+            ((record.detail & 2) ? clock.control.delay : clock.control.increment) = extra;
+            clock.remaining[0] = clock.remaining[1] = clock.control.base;
+            replay.clock = clock;
+        }
+        return;
+    }
+    if (it == sessions.end()) return;
+    Game& game = *it->second.game;
+    auto& clock = it->second.clock;
+    PieceColor toMove = game.getCurrentPlayer();
+    Position from(record.from / 8, record.from % 8);
+    Position to(record.to / 8, record.to % 8);
+    switch (record.type) {
+        case MoveRecord::MOVE:
+            // The same call Session made, so an omitted promotion queens again
+            if (game.makeMove(record.detail ? Move(from, to, static_cast<PieceType>(record.detail - 1))
+                                            : Move(from, to)) &&
+                clock) {
+                clock->remaining[sideIndex(toMove)] = std::chrono::milliseconds(record.clock);
+            }
+            break;
+        case MoveRecord::UNDO:
+            // The side that was to move is charged as the undone mover takes over
+            if (!game.getMoveHistory().empty() && clock) {
+                clock->remaining[sideIndex(toMove)] = std::chrono::milliseconds(record.clock);
+            }
+            game.undoLastMove();
+            break;
+        case MoveRecord::RESIGN:
+            game.resignGame(static_cast<PieceColor>(record.detail));
+            break;
+        case MoveRecord::FLAG:
+            // The flag fell with its side to move, so the bare-king rule
+            // sees the same material
+            game.forfeitOnTime();
+            break;
+        case MoveRecord::CLOSE:
+            sessions.erase(it);
+            break;
+        default:
+            break;
+    }
+}
+
+}
+
+MoveLog::MoveLog(const MoveLogConfig& config) : config_(config) {}
+
+MoveLog::~MoveLog() {
+    close();
+}
+
+bool MoveLog::open(std::vector<RecoveredSession>& recovered) {
+    std::error_code ec;
+    std::filesystem::create_directories(config_.directory, ec);
+    if (ec || !recover(recovered)) return false;
+    
+    fd_ = createSegment(segment_, next_lsn_);
+    if (fd_ < 0) return false;
+    durable_lsn_ = next_lsn_;
+    open_ = true;
+    stopping_ = exited_ = failed_ = false;
+    flusher_ = std::thread([this] { flushLoop(); });
+    return true;
+}
+
+void MoveLog::close() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!open_) return;
+        open_ = false;
+        stopping_ = true;
+    }
+    work_.notify_all();
+    if (flusher_.joinable()) flusher_.join();
+    ::close(fd_);
+    fd_ = -1;
+}
+
+uint64_t MoveLog::append(const MoveRecord& record) {
+    MoveRecord sealed = record;
+    sealed.checksum = checksumOf(sealed);
+    
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!open_ || failed_) return NO_LSN;
+    bool wake = pending_.empty();
+    pending_.push_back(sealed);
+    ++since_checkpoint_;
+    if (wake) work_.notify_one();
+    return next_lsn_++;
+}
+
+uint64_t MoveLog::durableLsn() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return durable_lsn_;
+}
+
+bool MoveLog::waitDurable(uint64_t lsn) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    durable_.wait(lock, [&] { return durable_lsn_ > lsn || failed_ || exited_; });
+    return durable_lsn_ > lsn;
+}
+
+bool MoveLog::failed() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return failed_;
+}
+
+bool MoveLog::checkpointDue() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return open_ && since_checkpoint_ >= config_.checkpointRecords;
+}
+
+bool MoveLog::beginCheckpoint() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    if (!open_ || failed_) return false;
+    rotate_ = true;
+    since_checkpoint_ = 0;
+    work_.notify_one();
+    durable_.wait(lock, [&] { return !rotate_ || failed_ || exited_; });
+    return !rotate_ && !failed_;
+}
+
+bool MoveLog::writeCheckpoint(const std::vector<CheckpointEntry>& sessions) {
+    uint32_t segment;
+    uint64_t firstLsn;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        segment = checkpoint_segment_;
+        firstLsn = checkpoint_lsn_;
+    }
+    
+    std::vector<uint8_t> data;
+    data.insert(data.end(), CHECKPOINT_MAGIC, CHECKPOINT_MAGIC + sizeof(CHECKPOINT_MAGIC));
+    put(data, CHECKPOINT_VERSION);
+    put(data, segment);
+    put(data, firstLsn);
+    put(data, static_cast<uint32_t>(sessions.size()));
+    for (const auto& entry : sessions) {
+        put(data, entry.id);
+        put(data, static_cast<uint8_t>(entry.solo ? 1 : 0));
+        put(data, entry.lastLsn);
+        putClock(data, entry.clock);
+        put(data, static_cast<uint32_t>(entry.state.size()));
+        data.insert(data.end(), entry.state.begin(), entry.state.end());
+    }
+    put(data, crc32(data.data(), data.size()));
+    
+    std::string tempPath = checkpointPath() + ".tmp";
+    int fd = ::open(tempPath.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (fd < 0) return false;
+    bool written = writeAll(fd, data.data(), data.size()) && ::fsync(fd) == 0;
+    ::close(fd);
+    if (!written || std::rename(tempPath.c_str(), checkpointPath().c_str()) != 0 || !syncDirectory()) {
+        std::remove(tempPath.c_str());
+        return false;
+    }
+    
+    for (uint32_t old : listSegments(config_.directory)) {
+        if (old < segment) std::remove(segmentPath(old).c_str());
+    }
+    return true;
+}
+
+MoveRecord MoveLog::makeRecord(uint32_t session, MoveRecord::Type type, uint8_t from, uint8_t to, uint8_t detail,
+                               uint32_t clock) {
+    MoveRecord record{};
+    record.session = session;
+    record.type = type;
+    record.from = from;
+    record.to = to;
+    record.detail = detail;
+    record.clock = clock;
+    return record;
+}
+
+MoveRecord MoveLog::makeNewRecord(uint32_t session, bool solo, const std::optional<TimeControl>& control) {
+    if (!control) return makeRecord(session, MoveRecord::NEW, 0, 0, solo ? 1 : 0);
+    // Protocol clocks are whole seconds, up to six digits of base and three
+    // of increment or delay
+    bool delay = control->delay.count() > 0;
+    auto extra = std::chrono::duration_cast<std::chrono::seconds>(delay ? control->delay : control->increment).count();
+    auto base = std::chrono::duration_cast<std::chrono::seconds>(control->base).count();
+    return makeRecord(session, MoveRecord::NEW, static_cast<uint8_t>(extra & 0xFF), static_cast<uint8_t>(extra >> 8),
+                      static_cast<uint8_t>((solo ? 1 : 0) | (delay ? 2 : 0)), static_cast<uint32_t>(base));
+}
+
+uint32_t MoveLog::clockMillis(std::chrono::steady_clock::duration left) {
+    auto millis = std::chrono::duration_cast<std::chrono::milliseconds>(left).count();
+    return static_cast<uint32_t>(std::clamp<int64_t>(millis, 0, UINT32_MAX));
+}
+
+std::string MoveLog::segmentPath(uint32_t segment) const {
+    char name[32];
+    std::snprintf(name, sizeof(name), "wal-%08u.log", segment);
+    return (std::filesystem::path(config_.directory) / name).string();
+}
+
+std::string MoveLog::checkpointPath() const {
+    return (std::filesystem::path(config_.directory) / "checkpoint").string();
+}
+
+int MoveLog::createSegment(uint32_t segment, uint64_t firstLsn) {
+    int fd = ::open(segmentPath(segment).c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_APPEND | O_CLOEXEC, 0644);
+    if (fd < 0) return -1;
+    
+    std::vector<uint8_t> header(SEGMENT_MAGIC, SEGMENT_MAGIC + sizeof(SEGMENT_MAGIC));
+    put(header, VERSION);
+    put(header, segment);
+    put(header, firstLsn);
+    // The file has to exist after a crash for its records to count
+    if (!writeAll(fd, header.data(), header.size()) || ::fdatasync(fd) != 0 || !syncDirectory()) {
+        ::close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+bool MoveLog::syncDirectory() const {
+    int fd = ::open(config_.directory.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if (fd < 0) return false;
+    bool synced = ::fsync(fd) == 0;
+    ::close(fd);
+    return synced;
+}
+
+void MoveLog::flushLoop() {
+    std::vector<MoveRecord> batch;
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (true) {
+        work_.wait(lock, [&] { return stopping_ || rotate_ || !pending_.empty(); });
+        if (!stopping_ && !rotate_ && config_.commitInterval.count() > 0) {
+            // Let the rest of the window's appends join this batch
+            work_.wait_for(lock, config_.commitInterval, [&] { return stopping_ || rotate_; });
+        }
+        
+        batch.swap(pending_);
+        uint64_t end = next_lsn_;
+        int fd = fd_;
+        bool rotate = rotate_;
+        bool stop = stopping_;
+        uint32_t nextSegment = segment_ + 1;
+        lock.unlock();
+        
+        bool ok = batch.empty() ||
+                  (writeAll(fd, batch.data(), batch.size() * sizeof(MoveRecord)) && ::fdatasync(fd) == 0);
+        batch.clear();
+        int next = (ok && rotate) ? createSegment(nextSegment, end) : -1;
+        
+        lock.lock();
+        if (ok) durable_lsn_ = end;
+        if (!ok || (rotate && next < 0)) failed_ = true;
+        if (next >= 0) {
+            ::close(fd_);
+            fd_ = next;
+            segment_ = nextSegment;
+            checkpoint_segment_ = nextSegment;
+            checkpoint_lsn_ = end;
+        }
+        rotate_ = false;
+        bool broken = failed_;
+        if (!stop && !broken) durable_.notify_all();
+        if (config_.onDurable && (ok || broken)) {
+            lock.unlock();
+            config_.onDurable(broken ? NO_LSN : end);
+            lock.lock();
+        }
+        if (stop || broken) break;
+    }
+    exited_ = true;
+    durable_.notify_all();
+}
+
+bool MoveLog::recover(std::vector<RecoveredSession>& recovered) {
+    std::map<uint32_t, Replay> sessions;
+    uint32_t firstSegment = 0;
+    next_lsn_ = 0;
+    
+    MappedFile checkpoint;
+    if (std::filesystem::exists(checkpointPath())) {
+        if (!checkpoint.open(checkpointPath()) || checkpoint.size() < CHECKPOINT_HEADER + sizeof(uint32_t)) {
+            return false;
+        }
+        const unsigned char* cursor = checkpoint.data();
+        const unsigned char* end = cursor + checkpoint.size() - sizeof(uint32_t);
+        uint32_t version = 0, count = 0, checksum = 0;
+        std::memcpy(&checksum, end, sizeof(checksum));
+        if (std::memcmp(cursor, CHECKPOINT_MAGIC, sizeof(CHECKPOINT_MAGIC)) != 0 ||
+            checksum != crc32(cursor, static_cast<size_t>(end - cursor))) {
+            return false;
+        }
+        cursor += sizeof(CHECKPOINT_MAGIC);
+        if (!take(cursor, end, version) || !take(cursor, end, firstSegment) || !take(cursor, end, next_lsn_) ||
+            !take(cursor, end, count) || (version != 1 && version != CHECKPOINT_VERSION)) {
+            return false;
+        }
+        
+        for (uint32_t i = 0; i < count; ++i) {
+            uint32_t id = 0, size = 0;
+            uint8_t solo = 0;
+            uint64_t lastLsn = 0;
+            std::optional<LoggedClock> clock;
+            if (!take(cursor, end, id) || !take(cursor, end, solo) || !take(cursor, end, lastLsn) ||
+                (version > 1 && !takeClock(cursor, end, clock)) || !take(cursor, end, size) ||
+                static_cast<size_t>(end - cursor) < size) {
+                return false;
+            }
+            auto state = GameState::deserialize(cursor, size);
+            cursor += size;
+            auto game = std::make_unique<Game>();
+            if (!state || !game->restoreState(*state)) return false;
+            sessions[id] = {solo != 0, lastLsn, std::move(game), clock};
+        }
+    }
+    
+    std::vector<uint32_t> segments = listSegments(config_.directory);
+    segment_ = segments.empty() ? firstSegment : std::max(firstSegment, segments.back() + 1);
+    for (uint32_t segment : segments) {
+        if (segment < firstSegment) continue;
+        MappedFile file;
+        if (!file.open(segmentPath(segment)) || file.size() < SEGMENT_HEADER) continue;
+        const unsigned char* cursor = file.data();
+        const unsigned char* end = cursor + file.size();
+        uint32_t version = 0, number = 0;
+        uint64_t lsn = 0;
+        if (std::memcmp(cursor, SEGMENT_MAGIC, sizeof(SEGMENT_MAGIC)) != 0) continue;
+        cursor += sizeof(SEGMENT_MAGIC);
+        if (!take(cursor, end, version) || !take(cursor, end, number) || !take(cursor, end, lsn) ||
+            version != VERSION || number != segment) {
+            continue;
+        }
+        
+        MoveRecord record{};
+        for (; take(cursor, end, record); ++lsn) {
+            if (record.checksum != checksumOf(record)) break;
+            apply(sessions, record, lsn);
+        }
+        next_lsn_ = std::max(next_lsn_, lsn);
+    }
+    
+    for (const auto& [id, replay] : sessions) {
+        recovered.push_back({id, replay.solo, replay.game->saveState(), replay.clock});
+    }
+    checkpoint_segment_ = firstSegment;
+    checkpoint_lsn_ = next_lsn_;
+    return true;
+}
\ No newline at end of file
@@ -0,0 +1,100 @@
+#include "net/Protocol.h"
+#include "utils/Utils.h"
+#include <sstream>
+
+namespace Protocol {
+
+Command parseCommand(const std::string& line) {
+    std::istringstream in(line);
+    std::string verb;
+    in >> verb;
+    
+    Command command;
+    if (verb == "NEW") command.type = CommandType::NEW;
+    else if (verb == "JOIN") command.type = CommandType::JOIN;
+    else if (verb == "MOVE") command.type = CommandType::MOVE;
+    else if (verb == "STATE") command.type = CommandType::STATE;
+    else if (verb == "UNDO") command.type = CommandType::UNDO;
+    else if (verb == "RESIGN") command.type = CommandType::RESIGN;
+    else if (verb == "CLOSE") command.type = CommandType::CLOSE;
+    else if (verb == "CLOCK") command.type = CommandType::CLOCK;
+    else if (verb == "WATCH") command.type = CommandType::WATCH;
+    else if (verb == "UNWATCH") command.type = CommandType::UNWATCH;
+    else if (verb == "PING") command.type = CommandType::PING;
+    
+    if (command.type == CommandType::NEW) {
+        // Options in any order, space-separated
+        std::string option;
+        while (in >> option) {
+            if (!command.argument.empty()) command.argument += ' ';
+            command.argument += option;
+        }
+    } else if (command.type != CommandType::PING && command.type != CommandType::UNKNOWN) {
+        unsigned long id = 0;
+        if (!(in >> id)) {
+            command.type = CommandType::UNKNOWN;
+            return command;
+        }
+        command.gameId = static_cast<uint32_t>(id);
+        in >> command.argument;
+    }
+    return command;
+}
+
+std::optional<MoveText> parseMove(const std::string& text) {
+    if (text.size() != 4 && text.size() != 5) return std::nullopt;
+    
+    Position from = Utils::squareToPosition(text.substr(0, 2));
+    Position to = Utils::squareToPosition(text.substr(2, 2));
+    if (!from.isValid() || !to.isValid()) return std::nullopt;
+    
+    MoveText move{from, to, std::nullopt};
+    if (text.size() == 5) {
+        switch (text[4]) {
+            case 'q': move.promotion = PieceType::QUEEN; break;
+            case 'r': move.promotion = PieceType::ROOK; break;
+            case 'b': move.promotion = PieceType::BISHOP; break;
+            case 'n': move.promotion = PieceType::KNIGHT; break;
+            default: return std::nullopt;
+        }
+    }
+    return move;
+}
+
+std::optional<TimeControl> parseTimeControl(const std::string& text) {
+    size_t split = text.find_first_of("+d");
+    if (split == std::string::npos || split == 0 || split + 1 == text.size()) return std::nullopt;
+    if (text.find_first_not_of("0123456789", split + 1) != std::string::npos ||
+        text.find_first_not_of("0123456789") != split || split > 6 || text.size() - split > 4) {
+        return std::nullopt;
+    }
+    
+    TimeControl control;
+    control.base = std::chrono::seconds(std::stoi(text.substr(0, split)));
+    auto extra = std::chrono::seconds(std::stoi(text.substr(split + 1)));
+    (text[split] == '+' ? control.increment : control.delay) = extra;
+    if (control.base.count() == 0) return std::nullopt;
+    return control;
+}
+
+std::string formatMove(const Position& from, const Position& to, std::optional<PieceType> promotion) {
+    std::string text = Utils::positionToSquare(from) + Utils::positionToSquare(to);
+    if (promotion) {
+        text += Utils::pieceToChar(*promotion, PieceColor::BLACK);
+    }
+    return text;
+}
+
+const char* statusToken(GameStatus status) {
+    switch (status) {
+        case GameStatus::ONGOING: return "ONGOING";
+        case GameStatus::CHECK: return "CHECK";
+        case GameStatus::CHECKMATE: return "CHECKMATE";
+        case GameStatus::STALEMATE: return "STALEMATE";
+        case GameStatus::DRAW: return "DRAW";
+        case GameStatus::TIME_FORFEIT: return "TIME_FORFEIT";
+    }
+    return "UNKNOWN";
+}
+
+}
\ No newline at end of file
@@ -0,0 +1,369 @@
+#include "net/Session.h"
+
+Session::Session(uint32_t id, uint64_t creator, bool solo, std::optional<TimeControl> control, MoveLog* log)
+    : id_(id),
+      white_(creator),
+      black_(solo ? creator : 0),
+      state_(solo ? SessionState::PLAYING : SessionState::WAITING),
+      timed_(control.has_value()),
+      solo_(solo),
+      game_(std::make_unique<Game>()),
+      last_active_(Clock::now()),
+      log_(log) {
+    if (control) {
+        game_->setTimeControl(*control);
+        if (solo) game_->startClock(last_active_);
+    }
+    append(MoveLog::makeNewRecord(id_, solo, control));
+}
+
+Session::Session(const RecoveredSession& recovered, MoveLog* log)
+    : id_(recovered.id),
+      white_(0),
+      black_(0),
+      state_(SessionState::WAITING),
+      timed_(recovered.clock.has_value()),
+      solo_(recovered.solo),
+      parked_(recovered.state),
+      last_active_(Clock::now()),
+      log_(log) {
+    auto status = static_cast<GameStatus>(recovered.state.status);
+    if (status != GameStatus::ONGOING && status != GameStatus::CHECK) state_ = SessionState::FINISHED;
+    if (timed_) {
+        // Timed sessions never park; the clock is set before it runs again
+        game().setTimeControl(recovered.clock->control);
+        game_->setRemainingTime(PieceColor::WHITE, recovered.clock->remaining[0]);
+        game_->setRemainingTime(PieceColor::BLACK, recovered.clock->remaining[1]);
+    }
+}
+
+SessionState Session::getState() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return state_;
+}
+
+bool Session::isParticipant(uint64_t connection) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return connection == white_ || connection == black_;
+}
+
+SessionReply Session::join(uint64_t connection) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (white_ == 0) {
+        // Recovered: nobody holds the session until now. A finished one can
+        // still be claimed, so that it can be closed
+        white_ = connection;
+        if (solo_) {
+            black_ = connection;
+            if (state_ == SessionState::WAITING) state_ = SessionState::PLAYING;
+            if (timed_) game().startClock();
+        }
+        SessionReply reply{"JOINED " + std::to_string(id_) + (solo_ ? " both" : " white")};
+        reply.claimed = true;
+        return reply;
+    }
+    
+    if (state_ != SessionState::WAITING) return {error("not-waiting")};
+    if (connection == white_) return {error("already-joined")};
+    
+    black_ = connection;
+    state_ = SessionState::PLAYING;
+    if (timed_) game().startClock();
+    publish(SpectatorEvent::JOIN);
+    return {"JOINED " + std::to_string(id_) + " black", white_, "JOINED " + std::to_string(id_) + " black"};
+}
+
+SessionReply Session::move(uint64_t connection, const Protocol::MoveText& text) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (state_ == SessionState::WAITING) return {error("waiting")};
+    if (state_ == SessionState::FINISHED) return {error("finished")};
+    if (ownerOf(game().getCurrentPlayer()) != connection) return {error("not-your-turn")};
+    
+    PieceColor mover = game().getCurrentPlayer();
+    Move move = text.promotion ? Move(text.from, text.to, *text.promotion) : Move(text.from, text.to);
+    if (!game().makeMove(move)) {
+        if (!game().isGameOver()) return {error("illegal")};
+        
+        // The mover's flag had fallen
+        state_ = SessionState::FINISHED;
+        publish(SpectatorEvent::FLAG, game().getCurrentPlayer());
+        uint64_t lsn = record(MoveRecord::FLAG, 0, 0, static_cast<uint8_t>(game().getCurrentPlayer()));
+        uint64_t opponent = opponentOf(connection);
+        return {flagLine(), opponent, opponent ? flagLine() : std::string(), false, lsn};
+    }
+    
+    if (game().isGameOver()) {
+        state_ = SessionState::FINISHED;
+    }
+    publishMove(text);
+    uint64_t lsn = record(MoveRecord::MOVE, static_cast<uint8_t>(text.from.row * 8 + text.from.col),
+                          static_cast<uint8_t>(text.to.row * 8 + text.to.col),
+                          text.promotion ? static_cast<uint8_t>(static_cast<int>(*text.promotion) + 1) : 0,
+                          clockMillis(mover));
+    
+    SessionReply reply{ok()};
+    reply.lsn = lsn;
+    uint64_t opponent = opponentOf(connection);
+    if (opponent != 0) {
+        reply.notifyConnection = opponent;
+        reply.notification = "MOVED " + std::to_string(id_) + " " +
+                             Protocol::formatMove(text.from, text.to, text.promotion) + " " +
+                             Protocol::statusToken(game().getGameStatus());
+    }
+    return reply;
+}
+
+SessionReply Session::undo(uint64_t connection) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (state_ != SessionState::PLAYING) return {error("not-playing")};
+    if (connection != white_ && connection != black_) return {error("not-a-player")};
+    // Taking a move back needs the opponent's consent, so only solo games allow it
+    if (!solo_) return {error("solo-only")};
+    if (game().getMoveHistory().empty()) return {error("no-moves")};
+    
+    PieceColor toMove = game().getCurrentPlayer();
+    game().undoLastMove();
+    publish(SpectatorEvent::UNDO);
+    record(MoveRecord::UNDO, 0, 0, 0, clockMillis(toMove));
+    return {ok()};
+}
+
+SessionReply Session::resign(uint64_t connection) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (state_ != SessionState::PLAYING) return {error("not-playing")};
+    if (connection != white_ && connection != black_) return {error("not-a-player")};
+    
+    // In solo mode the side to move resigns
+    PieceColor color = (white_ == black_) ? game().getCurrentPlayer()
+                     : (connection == white_ ? PieceColor::WHITE : PieceColor::BLACK);
+    game().resignGame(color);
+    state_ = SessionState::FINISHED;
+    publish(SpectatorEvent::RESIGN, color);
+    record(MoveRecord::RESIGN, 0, 0, static_cast<uint8_t>(color));
+    
+    SessionReply reply{ok()};
+    uint64_t opponent = opponentOf(connection);
+    if (opponent != 0) {
+        reply.notifyConnection = opponent;
+        reply.notification = "RESIGNED " + std::to_string(id_);
+    }
+    return reply;
+}
+
+SessionReply Session::leave(uint64_t connection) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (connection == 0 || (connection != white_ && connection != black_)) return {};
+    if (connection == white_) white_left_ = true;
+    if (connection == black_) black_left_ = true;
+    
+    SessionReply reply;
+    uint64_t opponent = opponentOf(connection);
+    if (state_ == SessionState::PLAYING && opponent != 0 && !(white_left_ && black_left_)) {
+        PieceColor color = connection == white_ ? PieceColor::WHITE : PieceColor::BLACK;
+        game().resignGame(color);
+        state_ = SessionState::FINISHED;
+        publish(SpectatorEvent::RESIGN, color);
+        record(MoveRecord::RESIGN, 0, 0, static_cast<uint8_t>(color));
+        reply.notifyConnection = opponent;
+        reply.notification = "ABANDONED " + std::to_string(id_);
+    }
+    reply.vacated = (white_ == 0 || white_left_) && (black_ == 0 || black_left_);
+    return reply;
+}
+
+SessionReply Session::state() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return {"STATE " + std::to_string(id_) + " " + sessionStateToken(state_) + " " +
+            Protocol::statusToken(game().getGameStatus()) + " " + game().toFEN()};
+}
+
+SessionReply Session::clock() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    const GameClock* clock = game().getClock();
+    if (!clock) return {error("untimed")};
+    
+    auto now = Clock::now();
+    auto millis = [&](PieceColor side) {
+        return std::to_string(std::chrono::duration_cast<std::chrono::milliseconds>(clock->remaining(side, now)).count());
+    };
+    const char* running = !clock->isRunning() ? "none"
+                        : (clock->getRunningSide() == PieceColor::WHITE ? "white" : "black");
+    return {"CLOCK " + std::to_string(id_) + " " + millis(PieceColor::WHITE) + " " + millis(PieceColor::BLACK) + " " + running};
+}
+
+std::optional<Session::Clock::time_point> Session::flagTime() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!game_ || !game_->getClock() || !game_->getClock()->isRunning()) return std::nullopt;
+    return game_->getClock()->flagTime();
+}
+
+std::optional<std::string> Session::checkFlag(Clock::time_point now) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!game_ || state_ != SessionState::PLAYING || !game_->checkFlag(now)) return std::nullopt;
+    state_ = SessionState::FINISHED;
+    publish(SpectatorEvent::FLAG, game_->getCurrentPlayer());
+    record(MoveRecord::FLAG, 0, 0, static_cast<uint8_t>(game_->getCurrentPlayer()));
+    return flagLine();
+}
+
+std::vector<uint64_t> Session::participants() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::vector<uint64_t> connections;
+    if (white_) connections.push_back(white_);
+    if (black_ && black_ != white_) connections.push_back(black_);
+    return connections;
+}
+
+SpectatorSnapshot Session::spectate() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    // A parked game is read where it lies: watching neither restores it nor
+    // counts as activity
+    GameStatus status = game_ ? game_->getGameStatus() : static_cast<GameStatus>(parked_.status);
+    char fen[96];
+    size_t length = game_ ? game_->writeFEN(fen, sizeof(fen)) : parked_.position().writeFEN(fen, sizeof(fen));
+    return {events_.head(), std::string(sessionStateToken(state_)) + " " + Protocol::statusToken(status) + " " +
+                                std::string(fen, length)};
+}
+
+std::string Session::formatEvent(uint32_t id, uint64_t sequence, const SpectatorEvent& event) {
+    static const char* const KINDS[] = {"JOIN", "MOVE", "UNDO", "RESIGN", "FLAG", "CLOSED"};
+    std::string line = "EVENT " + std::to_string(id) + " " + std::to_string(sequence) + " " + KINDS[event.kind];
+    if (event.kind == SpectatorEvent::CLOSED) return line;
+    
+    if (event.kind == SpectatorEvent::MOVE) {
+        std::optional<PieceType> promotion;
+        if (event.promotion) promotion = static_cast<PieceType>(event.promotion - 1);
+        line += " " + Protocol::formatMove(Position(event.from / 8, event.from % 8),
+                                           Position(event.to / 8, event.to % 8), promotion);
+    } else if (event.kind == SpectatorEvent::RESIGN || event.kind == SpectatorEvent::FLAG) {
+        line += static_cast<PieceColor>(event.color) == PieceColor::WHITE ? " white" : " black";
+    }
+    return line + " " + std::to_string(event.ply) + " " +
+           Protocol::statusToken(static_cast<GameStatus>(event.status));
+}
+
+void Session::close() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    state_ = SessionState::FINISHED;
+    publish(SpectatorEvent::CLOSED);
+    record(MoveRecord::CLOSE);
+    closed_.store(true, std::memory_order_release);
+}
+
+bool Session::park(Clock::time_point idleSince) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!game_ || last_active_ > idleSince) return false;
+    // GameState has no clock
+    if (timed_) return false;
+    
+    parked_ = game_->saveState();
+    game_.reset();
+    return true;
+}
+
+bool Session::isParked() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return !game_;
+}
+
+std::vector<uint8_t> Session::snapshot() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return game_ ? game_->saveState().serialize() : parked_.serialize();
+}
+
+CheckpointEntry Session::checkpoint() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    CheckpointEntry entry{id_, solo_, last_lsn_, game_ ? game_->saveState().serialize() : parked_.serialize()};
+    if (timed_ && game_ && game_->getClock()) {
+        const GameClock& clock = *game_->getClock();
+        auto now = Clock::now();
+        LoggedClock logged{clock.getTimeControl(), {}};
+        logged.remaining[0] = std::chrono::milliseconds(MoveLog::clockMillis(clock.remaining(PieceColor::WHITE, now)));
+        logged.remaining[1] = std::chrono::milliseconds(MoveLog::clockMillis(clock.remaining(PieceColor::BLACK, now)));
+        entry.clock = logged;
+    }
+    return entry;
+}
+
+Game& Session::game() {
+    last_active_ = Clock::now();
+    if (!game_) {
+        game_ = std::make_unique<Game>();
+        game_->restoreState(parked_);
+        parked_ = GameState();
+    }
+    return *game_;
+}
+
+std::string Session::ok() const {
+    // Only called after game() has restored a parked session
+    return "OK " + std::to_string(id_) + " " + std::to_string(game_->getMoveHistory().size()) + " " +
+           Protocol::statusToken(game_->getGameStatus());
+}
+
+std::string Session::error(const char* reason) const {
+    return "ERR " + std::to_string(id_) + " " + reason;
+}
+
+std::string Session::flagLine() const {
+    PieceColor loser = game_->getCurrentPlayer();
+    return "FLAG " + std::to_string(id_) + " " + (loser == PieceColor::WHITE ? "white " : "black ") +
+           Protocol::statusToken(game_->getGameStatus());
+}
+
+uint64_t Session::ownerOf(PieceColor color) const {
+    return color == PieceColor::WHITE ? white_ : black_;
+}
+
+uint64_t Session::opponentOf(uint64_t connection) const {
+    if (white_ == black_) return 0;
+    return connection == white_ ? black_ : white_;
+}
+
+void Session::publish(SpectatorEvent::Kind kind, PieceColor color) {
+    SpectatorEvent event{};
+    event.kind = kind;
+    event.color = static_cast<uint8_t>(color);
+    // A parked game has nothing new to report beyond the kind
+    if (game_) {
+        event.status = static_cast<uint8_t>(game_->getGameStatus());
+        event.ply = static_cast<uint16_t>(game_->getMoveHistory().size());
+    }
+    events_.publish(event);
+}
+
+void Session::publishMove(const Protocol::MoveText& move) {
+    SpectatorEvent event{};
+    event.kind = SpectatorEvent::MOVE;
+    event.from = static_cast<uint8_t>(move.from.row * 8 + move.from.col);
+    event.to = static_cast<uint8_t>(move.to.row * 8 + move.to.col);
+    event.promotion = move.promotion ? static_cast<uint8_t>(static_cast<int>(*move.promotion) + 1) : 0;
+    event.status = static_cast<uint8_t>(game_->getGameStatus());
+    event.ply = static_cast<uint16_t>(game_->getMoveHistory().size());
+    events_.publish(event);
+}
+
+uint64_t Session::record(MoveRecord::Type type, uint8_t from, uint8_t to, uint8_t detail, uint32_t clock) {
+    return append(MoveLog::makeRecord(id_, type, from, to, detail, clock));
+}
+
+uint64_t Session::append(const MoveRecord& record) {
+    if (!log_) return MoveLog::NO_LSN;
+    uint64_t lsn = log_->append(record);
+    if (lsn != MoveLog::NO_LSN) last_lsn_ = lsn;
+    return lsn;
+}
+
+uint32_t Session::clockMillis(PieceColor side) const {
+    const GameClock* clock = game_ ? game_->getClock() : nullptr;
+    return clock ? MoveLog::clockMillis(clock->remaining(side, Clock::now())) : 0;
+}
+
+const char* sessionStateToken(SessionState state) {
+    switch (state) {
+        case SessionState::WAITING: return "WAITING";
+        case SessionState::PLAYING: return "PLAYING";
+        case SessionState::FINISHED: return "FINISHED";
+    }
+    return "UNKNOWN";
+}
\ No newline at end of file
@@ -0,0 +1,65 @@
+#include "core/Bitbase.h"
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+void printUsage() {
+    std::cout << "Usage: bitbase_gen [--threads N] [--out DIR] MATERIAL...\n";
+    std::cout << "Builds win/draw bitbases for a king and up to two pieces against a\n";
+    std::cout << "lone king, e.g. bitbase_gen KPK KRK KQK KBNK\n";
+}
+
+}
+
+int main(int argc, char* argv[]) {
+    unsigned threads = std::thread::hardware_concurrency();
+    std::string outDir = ".";
+    std::vector<std::string> materials;
+    
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--threads" && i + 1 < argc) {
+            threads = static_cast<unsigned>(std::stoul(argv[++i]));
+        } else if (arg == "--out" && i + 1 < argc) {
+            outDir = argv[++i];
+        } else if (arg == "--help" || arg == "-h") {
+            printUsage();
+            return 0;
+        } else {
+            materials.push_back(arg);
+        }
+    }
+    
+    if (materials.empty()) {
+        printUsage();
+        return 1;
+    }
+    
+    BitbaseStore store;
+    for (const auto& material : materials) {
+        auto start = std::chrono::steady_clock::now();
+        if (!store.generate(material, threads)) {
+            std::cerr << "Error: unsupported material " << material << "\n";
+            return 1;
+        }
+        auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::steady_clock::now() - start).count();
+        
+        const Bitbase* table = store.find(Bitbase::canonicalMaterial(material));
+        size_t wins = 0;
+        for (size_t i = 0; i < table->size(); ++i) wins += table->isWin(i);
+        std::cout << table->getMaterial() << ": " << table->size() << " positions, "
+                  << wins << " wins, " << elapsed << " ms\n";
+    }
+    
+    if (!store.saveAll(outDir)) {
+        std::cerr << "Error: cannot write bitbases to " << outDir << "\n";
+        return 1;
+    }
+    std::cout << "Wrote " << store.size() << " bitbases to " << outDir << "\n";
+    return 0;
+}
\ No newline at end of file
@@ -0,0 +1,89 @@
+#include "core/Game.h"
+#include "core/PolyglotBook.h"
+#include "core/Zobrist.h"
+#include "ui/InputParser.h"
+#include "utils/Utils.h"
+#include <chrono>
+#include <cstdio>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace {
+
+void printUsage() {
+    std::cout << "Usage: book_query <book.bin> [--randoms <random64.bin>] [move ...]\n";
+    std::cout << "Plays the given moves (e.g. e2e4 e7e5) from the initial position\n";
+    std::cout << "and lists the book entries for the resulting position.\n";
+}
+
+}
+
+int main(int argc, char* argv[]) {
+    if (argc < 2) {
+        printUsage();
+        return 1;
+    }
+    
+    std::string bookPath = argv[1];
+    std::vector<std::string> moves;
+    for (int i = 2; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--randoms" && i + 1 < argc) {
+            if (!Zobrist::loadRandomTable(argv[++i])) {
+                std::cerr << "Error: cannot read random table " << argv[i] << "\n";
+                return 1;
+            }
+        } else {
+            moves.push_back(arg);
+        }
+    }
+    
+    auto start = std::chrono::steady_clock::now();
+    PolyglotBook book;
+    if (!book.open(bookPath)) {
+        std::cerr << "Error: cannot open book " << bookPath << "\n";
+        return 1;
+    }
+    auto opened = std::chrono::steady_clock::now();
+    
+    Game game;
+    InputParser parser;
+    for (const auto& text : moves) {
+        auto move = parser.parseMove(text);
+        if (!move || !game.makeMove(move->first, move->second)) {
+            std::cerr << "Error: illegal move " << text << "\n";
+            return 1;
+        }
+    }
+    
+    uint64_t key = Zobrist::hash(game.getBoard(), game.getCurrentPlayer());
+    auto entries = book.lookup(game.getBoard(), game.getCurrentPlayer());
+    auto done = std::chrono::steady_clock::now();
+    
+    char keyText[19];
+    std::snprintf(keyText, sizeof(keyText), "%016llx", static_cast<unsigned long long>(key));
+    std::cout << "Book: " << bookPath << " (" << book.size() << " entries)\n";
+    std::cout << "Key:  " << keyText << "\n";
+    
+    uint32_t total = 0;
+    for (const auto& entry : entries) total += entry.weight;
+    
+    if (entries.empty()) {
+        std::cout << "No book moves.\n";
+    }
+    for (const auto& entry : entries) {
+        std::string text = Utils::positionToSquare(entry.from) + Utils::positionToSquare(entry.to);
+        if (entry.isPromotion) {
+            text += Utils::pieceToChar(entry.promotion, PieceColor::BLACK);
+        }
+        double share = total ? 100.0 * entry.weight / total : 0.0;
+        std::printf("  %-6s weight %5u  %5.1f%%\n", text.c_str(), entry.weight, share);
+    }
+    
+    auto micros = [](auto from, auto to) {
+        return std::chrono::duration_cast<std::chrono::microseconds>(to - from).count();
+    };
+    std::cout << "Open " << micros(start, opened) << "us, lookup " << micros(opened, done) << "us\n";
+    return 0;
+}
\ No newline at end of file
@@ -0,0 +1,109 @@
+#include "core/Stats.h"
+#include "core/Trace.h"
+#include "net/GameServer.h"
+#include <csignal>
+#include <iostream>
+#include <string>
+#include <sys/resource.h>
+
+namespace {
+
+void printUsage() {
+    std::cout << "Usage: chess_server [--host ADDR] [--port N] [--unix PATH] [--threads N]\n";
+    std::cout << "                    [--park-after SECONDS] [--log DIR] [--commit-us N]\n";
+    std::cout << "                    [--checkpoint-records N] [--no-durable-replies]\n";
+    std::cout << "                    [--stats] [--trace FILE]\n";
+    std::cout << "--log keeps a write-ahead log of every session in DIR and resumes them on\n";
+    std::cout << "restart; --commit-us sets its group commit window (default 2000). MOVE\n";
+    std::cout << "replies wait for the window's sync unless --no-durable-replies is given.\n";
+    std::cout << "--stats prints hot-path counters and latency percentiles on shutdown;\n";
+    std::cout << "--trace writes the spans of the whole run as Chrome trace JSON.\n";
+}
+
+void raiseFileLimit() {
+    rlimit limit;
+    if (getrlimit(RLIMIT_NOFILE, &limit) == 0 && limit.rlim_cur < limit.rlim_max) {
+        limit.rlim_cur = limit.rlim_max;
+        setrlimit(RLIMIT_NOFILE, &limit);
+    }
+}
+
+}
+
+int main(int argc, char* argv[]) {
+    ServerConfig config;
+    bool stats = false;
+    std::string tracePath;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--host" && i + 1 < argc) {
+            config.host = argv[++i];
+        } else if (arg == "--port" && i + 1 < argc) {
+            config.port = std::stoi(argv[++i]);
+        } else if (arg == "--unix" && i + 1 < argc) {
+            config.unixPath = argv[++i];
+        } else if (arg == "--threads" && i + 1 < argc) {
+            config.threads = static_cast<unsigned>(std::stoul(argv[++i]));
+        } else if (arg == "--park-after" && i + 1 < argc) {
+            config.parkAfterSeconds = static_cast<unsigned>(std::stoul(argv[++i]));
+        } else if (arg == "--log" && i + 1 < argc) {
+            config.logDirectory = argv[++i];
+        } else if (arg == "--commit-us" && i + 1 < argc) {
+            config.commitMicros = static_cast<unsigned>(std::stoul(argv[++i]));
+        } else if (arg == "--checkpoint-records" && i + 1 < argc) {
+            config.checkpointRecords = std::stoul(argv[++i]);
+        } else if (arg == "--no-durable-replies") {
+            config.durableReplies = false;
+        } else if (arg == "--stats") {
+            stats = true;
+        } else if (arg == "--trace" && i + 1 < argc) {
+            tracePath = argv[++i];
+        } else {
+            printUsage();
+            return arg == "--help" ? 0 : 1;
+        }
+    }
+    
+    raiseFileLimit();
+    
+    // Workers inherit the blocked mask; the main thread waits for shutdown
+    sigset_t signals;
+    sigemptyset(&signals);
+    sigaddset(&signals, SIGINT);
+    sigaddset(&signals, SIGTERM);
+    pthread_sigmask(SIG_BLOCK, &signals, nullptr);
+    
+    GameServer server(config);
+    if (!server.start()) {
+        std::cerr << "Error: cannot listen on "
+                  << (config.unixPath.empty() ? config.host + ":" + std::to_string(config.port) : config.unixPath)
+                  << (config.logDirectory.empty() ? "" : " or recover " + config.logDirectory) << "\n";
+        return 1;
+    }
+    if (!config.logDirectory.empty()) {
+        std::cout << "Resumed " << server.sessionCount() << " sessions from " << config.logDirectory << std::endl;
+    }
+    std::cout << "Listening on "
+              << (config.unixPath.empty() ? config.host + ":" + std::to_string(server.getPort()) : config.unixPath)
+              << std::endl;
+    
+    if (!tracePath.empty()) {
+        Trace::start();
+    }
+    
+    int signal = 0;
+    sigwait(&signals, &signal);
+    
+    std::cout << "Shutting down (" << server.connectionCount() << " connections, "
+              << server.sessionCount() << " sessions)" << std::endl;
+    server.stop();
+    server.wait();
+    
+    if (!tracePath.empty() && !Trace::stop(tracePath)) {
+        std::cerr << "Error: cannot write " << tracePath << "\n";
+    }
+    if (stats) {
+        Stats::print(std::cout, Stats::snapshot());
+    }
+    return 0;
+}
\ No newline at end of file
@@ -0,0 +1,289 @@
+#include "core/Game.h"
+#include "core/Material.h"
+#include "core/Notation.h"
+#include "core/Stats.h"
+#include "core/Trace.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <new>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Allocation counting: every operator new in this binary bumps a per-thread
+// counter, which each worker folds into its result when it finishes
+namespace {
+thread_local uint64_t t_allocations = 0;
+thread_local uint64_t t_allocated_bytes = 0;
+}
+
+void* operator new(std::size_t size) {
+    ++t_allocations;
+    t_allocated_bytes += size;
+    if (void* p = std::malloc(size ? size : 1)) return p;
+    throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size) {
+    return operator new(size);
+}
+
+void operator delete(void* p) noexcept {
+    std::free(p);
+}
+
+void operator delete[](void* p) noexcept {
+    std::free(p);
+}
+
+void operator delete(void* p, std::size_t) noexcept {
+    std::free(p);
+}
+
+void operator delete[](void* p, std::size_t) noexcept {
+    std::free(p);
+}
+
+namespace {
+
+enum EndReason {
+    CHECKMATE,
+    STALEMATE,
+    FIFTY_MOVE_RULE,
+    REPETITION,
+    INSUFFICIENT_MATERIAL,
+    PLY_LIMIT,
+    END_REASON_COUNT
+};
+
+const char* const END_REASON_NAMES[] = {
+    "checkmate", "stalemate", "fifty-move rule", "threefold repetition", "insufficient material", "ply limit"
+};
+
+struct Options {
+    size_t games = 1000;
+    unsigned threads = std::max(1u, std::thread::hardware_concurrency());
+    uint64_t seed = 1;
+    int maxPlies = 600;
+    bool weighted = false;
+    bool verify = false;
+    bool stats = false;
+    std::string tracePath;
+};
+
+struct Totals {
+    uint64_t games = 0;
+    uint64_t plies = 0;
+    uint64_t allocations = 0;
+    uint64_t allocatedBytes = 0;
+    uint64_t violations = 0;
+    uint64_t endings[END_REASON_COUNT] = {};
+    
+    void add(const Totals& other) {
+        games += other.games;
+        plies += other.plies;
+        allocations += other.allocations;
+        allocatedBytes += other.allocatedBytes;
+        violations += other.violations;
+        for (int r = 0; r < END_REASON_COUNT; ++r) endings[r] += other.endings[r];
+    }
+};
+
+struct Candidate {
+    Position from;
+    Position to;
+    int weight;
+};
+
+void printUsage() {
+    std::cout << "Usage: chess_sim [--games N] [--threads N] [--seed N] [--max-plies N]\n"
+              << "                 [--weighted] [--verify] [--stats] [--trace FILE]\n"
+              << "Plays complete games of random legal moves through Game::makeMove and\n"
+              << "reports throughput, how the games ended and allocation counts.\n"
+              << "  --weighted  prefer captures (by value) and promotions\n"
+              << "  --verify    cross-check every ply: one king each, mover not left\n"
+              << "              in check, SAN and FEN round trips\n"
+              << "  --stats     print hot-path counters per ply and latency percentiles\n"
+              << "  --trace F   write timed spans to F as Chrome trace JSON\n";
+}
+
+void collectMoves(const Game& game, bool weighted, std::vector<Candidate>& out) {
+    out.clear();
+    const Board& board = game.getBoard();
+    for (const auto& from : board.getAllPiecesPositions(game.getCurrentPlayer())) {
+        const Piece* piece = board.getPiece(from);
+        for (const auto& to : game.getValidMoves(from)) {
+            int weight = 1;
+            if (weighted) {
+                if (const Piece* victim = board.getPiece(to)) weight += 4 * Material::pieceValue(victim->getType());
+                if (piece->getType() == PieceType::PAWN && (to.row == 0 || to.row == 7)) weight += 20;
+            }
+            out.push_back({from, to, weight});
+        }
+    }
+}
+
+// Rule cross-checks that must hold after every move
+uint64_t verifyPly(const Game& game, const Board& before, const Candidate& move) {
+    uint64_t violations = 0;
+    const Board& board = game.getBoard();
+    PieceColor mover = (game.getCurrentPlayer() == PieceColor::WHITE) ? PieceColor::BLACK : PieceColor::WHITE;
+    
+    int kings[2] = {0, 0};
+    for (int sq = 0; sq < 64; ++sq) {
+        const Piece* piece = board.getPiece(Position(sq / 8, sq % 8));
+        if (piece && piece->getType() == PieceType::KING) ++kings[piece->getColor() == PieceColor::WHITE ? 0 : 1];
+    }
+    if (kings[0] != 1 || kings[1] != 1) ++violations;
+    if (board.isInCheck(mover)) ++violations;
+    
+    std::string san = Notation::toSAN(before, move.from, move.to);
+    auto decoded = Notation::fromSAN(before, mover, san);
+    if (!decoded || decoded->getFrom() != move.from || decoded->getTo() != move.to) ++violations;
+    
+    Game reloaded;
+    if (!reloaded.loadFEN(game.toFEN()) || reloaded.toFEN() != game.toFEN()) ++violations;
+    return violations;
+}
+
+EndReason endReason(const Game& game) {
+    switch (game.getGameStatus()) {
+        case GameStatus::CHECKMATE: return CHECKMATE;
+        case GameStatus::STALEMATE: return STALEMATE;
+        case GameStatus::DRAW:
+            switch (game.getDrawReason()) {
+                case DrawReason::FIFTY_MOVE_RULE: return FIFTY_MOVE_RULE;
+                case DrawReason::THREEFOLD_REPETITION: return REPETITION;
+                case DrawReason::INSUFFICIENT_MATERIAL: return INSUFFICIENT_MATERIAL;
+                default: return PLY_LIMIT;
+            }
+        default: return PLY_LIMIT;
+    }
+}
+
+// Game g always uses seed + g, so results do not depend on the thread count
+Totals simulate(const Options& options, std::atomic<size_t>& nextGame) {
+    Totals totals;
+    uint64_t allocationsAtStart = t_allocations;
+    uint64_t bytesAtStart = t_allocated_bytes;
+    std::vector<Candidate> moves;
+    
+    for (size_t g = nextGame++; g < options.games; g = nextGame++) {
+        std::mt19937_64 rng(options.seed + g);
+        Game game;
+        int ply = 0;
+        
+        while (!game.isGameOver() && ply < options.maxPlies) {
+            collectMoves(game, options.weighted, moves);
+            if (moves.empty()) break;
+            
+            int total = 0;
+            for (const auto& move : moves) total += move.weight;
+            int pick = static_cast<int>(rng() % static_cast<uint64_t>(total));
+            size_t index = 0;
+            while (pick >= moves[index].weight) pick -= moves[index++].weight;
+            const Candidate& move = moves[index];
+            
+            if (options.verify) {
+                Board before(game.getBoard());
+                if (!game.makeMove(move.from, move.to)) {
+                    ++totals.violations;
+                    break;
+                }
+                totals.violations += verifyPly(game, before, move);
+            } else if (!game.makeMove(move.from, move.to)) {
+                ++totals.violations;
+                break;
+            }
+            ++ply;
+        }
+        
+        ++totals.games;
+        totals.plies += static_cast<uint64_t>(ply);
+        ++totals.endings[endReason(game)];
+    }
+    
+    totals.allocations = t_allocations - allocationsAtStart;
+    totals.allocatedBytes = t_allocated_bytes - bytesAtStart;
+    return totals;
+}
+
+}
+
+int main(int argc, char* argv[]) {
+    Options options;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        auto next = [&]() { return i + 1 < argc ? std::string(argv[++i]) : std::string("0"); };
+        if (arg == "--games") options.games = std::stoul(next());
+        else if (arg == "--threads") options.threads = std::max(1u, static_cast<unsigned>(std::stoul(next())));
+        else if (arg == "--seed") options.seed = std::stoull(next());
+        else if (arg == "--max-plies") options.maxPlies = std::stoi(next());
+        else if (arg == "--weighted") options.weighted = true;
+        else if (arg == "--verify") options.verify = true;
+        else if (arg == "--stats") options.stats = true;
+        else if (arg == "--trace") options.tracePath = next();
+        else {
+            printUsage();
+            return arg == "--help" ? 0 : 1;
+        }
+    }
+    
+    std::atomic<size_t> nextGame{0};
+    std::vector<Totals> results(options.threads);
+    std::vector<std::thread> workers;
+    
+    if (!options.tracePath.empty()) Trace::start();
+    auto start = std::chrono::steady_clock::now();
+    for (unsigned t = 0; t < options.threads; ++t) {
+        workers.emplace_back([&, t]() { results[t] = simulate(options, nextGame); });
+    }
+    for (auto& worker : workers) worker.join();
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    
+    uint64_t droppedSpans = 0;
+    if (!options.tracePath.empty() && !Trace::stop(options.tracePath, &droppedSpans)) {
+        std::cerr << "Error: cannot write " << options.tracePath << "\n";
+    }
+    if (droppedSpans) {
+        std::cerr << "Warning: trace buffers full, " << droppedSpans << " spans dropped\n";
+    }
+    
+    Totals totals;
+    for (const auto& result : results) totals.add(result);
+    double plies = static_cast<double>(std::max<uint64_t>(totals.plies, 1));
+    
+    std::printf("Games: %llu, plies: %llu, threads: %u, elapsed: %.3f s\n",
+                static_cast<unsigned long long>(totals.games), static_cast<unsigned long long>(totals.plies),
+                options.threads, seconds);
+    std::printf("Throughput: %.1f games/s, %.0f plies/s, %.1f plies/game\n",
+                totals.games / seconds, totals.plies / seconds,
+                totals.games ? static_cast<double>(totals.plies) / totals.games : 0.0);
+    std::printf("Allocations: %llu (%.1f per ply, %.0f bytes per ply)\n",
+                static_cast<unsigned long long>(totals.allocations), totals.allocations / plies,
+                totals.allocatedBytes / plies);
+    std::printf("Endings:\n");
+    for (int r = 0; r < END_REASON_COUNT; ++r) {
+        double share = totals.games ? 100.0 * totals.endings[r] / totals.games : 0.0;
+        std::printf("  %-22s %8llu  %5.1f%%\n", END_REASON_NAMES[r],
+                    static_cast<unsigned long long>(totals.endings[r]), share);
+    }
+    if (options.stats) {
+        Stats::Snapshot stats = Stats::snapshot();
+        Stats::print(std::cout, stats);
+        if (Stats::ENABLED) {
+            std::printf("Per ply: %.1f board copies, %.1f clones, %.1f check probes\n",
+                        stats[Stats::Counter::BOARD_COPIES] / plies, stats[Stats::Counter::PIECE_CLONES] / plies,
+                        stats[Stats::Counter::CHECK_PROBES] / plies);
+        }
+    }
+    if (options.verify || totals.violations) {
+        std::printf("Rule violations: %llu\n", static_cast<unsigned long long>(totals.violations));
+    }
+    return totals.violations == 0 ? 0 : 1;
+}
\ No newline at end of file
@@ -0,0 +1,250 @@
+#include "core/Game.h"
+#include "core/Material.h"
+#include "core/TrainingData.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <iostream>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+struct Options {
+    size_t games = 1000;
+    unsigned threads = std::max(1u, std::thread::hardware_concurrency());
+    uint64_t seed = 1;
+    int randomPlies = 8;
+    double sample = 0.25;
+    int maxPlies = 400;
+    std::string outPath = "training.bin";
+    std::string inspectPath;
+};
+
+struct Totals {
+    uint64_t games = 0;
+    uint64_t plies = 0;
+    uint64_t written = 0;
+    uint64_t skippedCheck = 0;
+    uint64_t skippedCapture = 0;
+    uint64_t results[3] = {};       // Black won, drawn, White won
+    
+    void add(const Totals& other) {
+        games += other.games;
+        plies += other.plies;
+        written += other.written;
+        skippedCheck += other.skippedCheck;
+        skippedCapture += other.skippedCapture;
+        for (int r = 0; r < 3; ++r) results[r] += other.results[r];
+    }
+};
+
+struct Candidate {
+    Position from;
+    Position to;
+    int score;      // Best capture first, then promotions; 0 for quiet moves
+};
+
+void printUsage() {
+    std::cout << "Usage: datagen [--games N] [--threads N] [--seed N] [--out FILE]\n"
+              << "               [--random-plies N] [--sample P] [--max-plies N]\n"
+              << "       datagen --inspect FILE\n"
+              << "Plays games from randomised openings through Game and writes a share\n"
+              << "of their quiet positions with the game result as 32-byte records.\n"
+              << "  --random-plies N  uniformly random moves before the greedy policy\n"
+              << "  --sample P        probability of keeping each quiet position\n"
+              << "  --inspect F       print the record count and result split of F\n";
+}
+
+int valueOf(uint8_t code) {
+    return Material::pieceValue(GameState::pieceType(code));
+}
+
+// A capture is pending when the side to move can take an undefended piece
+// or a piece worth more than the capturer: the position's label would hinge
+// on that exchange rather than on the position itself
+bool capturePending(const Game& game, const PositionSnapshot& position) {
+    PieceColor mover = position.side();
+    PieceColor other = (mover == PieceColor::WHITE) ? PieceColor::BLACK : PieceColor::WHITE;
+    for (int from = 0; from < 64; ++from) {
+        uint8_t attacker = position.squares[from];
+        if (!PositionSnapshot::isColor(attacker, mover)) continue;
+        uint64_t targets = game.getLegalTargets(Position(from / 8, from % 8));
+        for (; targets; targets &= targets - 1) {
+            int to = __builtin_ctzll(targets);
+            uint8_t victim = position.squares[to];
+            if (!PositionSnapshot::isColor(victim, other)) continue;
+            if (valueOf(victim) > valueOf(attacker) || !position.isAttacked(to, other)) return true;
+        }
+    }
+    return false;
+}
+
+// Captures by most valuable victim, least valuable attacker, then
+// promotions; a random quiet move when there are neither
+void collectMoves(const Game& game, std::vector<Candidate>& out) {
+    out.clear();
+    const Board& board = game.getBoard();
+    for (const auto& from : board.getAllPiecesPositions(game.getCurrentPlayer())) {
+        const Piece* piece = board.getPiece(from);
+        int attacker = Material::pieceValue(piece->getType());
+        uint64_t targets = game.getLegalTargets(from);
+        for (; targets; targets &= targets - 1) {
+            int sq = __builtin_ctzll(targets);
+            Position to(sq / 8, sq % 8);
+            const Piece* victim = board.getPiece(to);
+            int score = victim ? 10 * Material::pieceValue(victim->getType()) - attacker + 10 : 0;
+            if (piece->getType() == PieceType::PAWN && (to.row == 0 || to.row == 7)) score += 80;
+            out.push_back({from, to, score});
+        }
+    }
+}
+
+// 1 White won, 0 drawn, -1 Black won; games still running at the ply limit
+// count as drawn unless the material alone decides them
+int gameResult(const Game& game) {
+    if (game.getGameStatus() == GameStatus::CHECKMATE) {
+        return game.getCurrentPlayer() == PieceColor::WHITE ? -1 : 1;
+    }
+    if (game.isGameOver()) return 0;
+    switch (Material::classify(game.getBoard().getMaterialKey())) {
+        case Material::Outcome::WHITE_WINS: return 1;
+        case Material::Outcome::BLACK_WINS: return -1;
+        default: return 0;
+    }
+}
+
+// Game g always uses seed + g, so the records do not depend on the thread
+// count (their order in the file does)
+Totals generate(const Options& options, TrainingDataWriter& writer, std::atomic<size_t>& nextGame) {
+    Totals totals;
+    TrainingDataWriter::Buffer buffer(writer);
+    std::vector<Candidate> moves;
+    std::vector<std::pair<PositionSnapshot, int>> sampled;
+    std::bernoulli_distribution keep(options.sample);
+    
+    for (size_t g = nextGame++; g < options.games; g = nextGame++) {
+        std::mt19937_64 rng(options.seed + g);
+        Game game;
+        sampled.clear();
+        int ply = 0;
+        
+        while (!game.isGameOver() && ply < options.maxPlies) {
+            Material::Outcome known = Material::classify(game.getBoard().getMaterialKey());
+            if (known == Material::Outcome::WHITE_WINS || known == Material::Outcome::BLACK_WINS) break;
+            
+            collectMoves(game, moves);
+            if (moves.empty()) break;
+            
+            if (ply >= options.randomPlies && keep(rng)) {
+                PositionSnapshot position = game.snapshot();
+                if (position.isInCheck(position.side())) ++totals.skippedCheck;
+                else if (capturePending(game, position)) ++totals.skippedCapture;
+                else sampled.emplace_back(position, ply);
+            }
+            
+            size_t index = rng() % moves.size();
+            if (ply >= options.randomPlies) {
+                auto best = std::max_element(moves.begin(), moves.end(),
+                                             [](const Candidate& a, const Candidate& b) { return a.score < b.score; });
+                if (best->score > 0) index = static_cast<size_t>(best - moves.begin());
+            }
+            if (!game.makeMove(moves[index].from, moves[index].to)) break;
+            ++ply;
+        }
+        
+        int result = gameResult(game);
+        for (const auto& [position, at] : sampled) {
+            if (auto packed = PackedPosition::pack(position, result, ply - at)) {
+                buffer.add(*packed);
+                ++totals.written;
+            }
+        }
+        ++totals.games;
+        totals.plies += static_cast<uint64_t>(ply);
+        ++totals.results[result + 1];
+    }
+    return totals;
+}
+
+int inspect(const std::string& path) {
+    TrainingDataReader reader;
+    if (!reader.open(path)) {
+        std::cerr << "Error: " << path << " is not a training data file\n";
+        return 1;
+    }
+    uint64_t results[3] = {};
+    uint64_t pieces = 0;
+    for (const PackedPosition& record : reader) {
+        ++results[std::clamp<int>(record.result, -1, 1) + 1];
+        pieces += static_cast<uint64_t>(__builtin_popcountll(record.occupancy));
+    }
+    size_t count = std::max<size_t>(reader.size(), 1);
+    std::printf("Records: %zu (%zu bytes each)\n", reader.size(), sizeof(PackedPosition));
+    std::printf("Results: %.1f%% white wins, %.1f%% draws, %.1f%% black wins\n",
+                100.0 * results[2] / count, 100.0 * results[1] / count, 100.0 * results[0] / count);
+    std::printf("Pieces per position: %.1f\n", static_cast<double>(pieces) / count);
+    return 0;
+}
+
+}
+
+int main(int argc, char* argv[]) {
+    Options options;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        auto next = [&]() { return i + 1 < argc ? std::string(argv[++i]) : std::string("0"); };
+        if (arg == "--games") options.games = std::stoul(next());
+        else if (arg == "--threads") options.threads = std::max(1u, static_cast<unsigned>(std::stoul(next())));
+        else if (arg == "--seed") options.seed = std::stoull(next());
+        else if (arg == "--out") options.outPath = next();
+        else if (arg == "--random-plies") options.randomPlies = std::stoi(next());
+        else if (arg == "--sample") options.sample = std::clamp(std::stod(next()), 0.0, 1.0);
+        else if (arg == "--max-plies") options.maxPlies = std::stoi(next());
+        else if (arg == "--inspect") options.inspectPath = next();
+        else {
+            printUsage();
+            return arg == "--help" ? 0 : 1;
+        }
+    }
+    if (!options.inspectPath.empty()) return inspect(options.inspectPath);
+    
+    TrainingDataWriter writer;
+    if (!writer.open(options.outPath)) {
+        std::cerr << "Error: cannot create " << options.outPath << "\n";
+        return 1;
+    }
+    
+    std::atomic<size_t> nextGame{0};
+    std::vector<Totals> results(options.threads);
+    std::vector<std::thread> workers;
+    auto start = std::chrono::steady_clock::now();
+    for (unsigned t = 0; t < options.threads; ++t) {
+        workers.emplace_back([&, t]() { results[t] = generate(options, writer, nextGame); });
+    }
+    for (auto& worker : workers) worker.join();
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    
+    if (!writer.close()) {
+        std::cerr << "Error: writing " << options.outPath << " failed\n";
+        return 1;
+    }
+    
+    Totals totals;
+    for (const auto& result : results) totals.add(result);
+    uint64_t games = std::max<uint64_t>(totals.games, 1);
+    std::printf("Games: %llu, plies: %llu, threads: %u, elapsed: %.3f s\n",
+                static_cast<unsigned long long>(totals.games), static_cast<unsigned long long>(totals.plies),
+                options.threads, seconds);
+    std::printf("Positions: %llu written (%.0f/s), %llu in check and %llu with a capture pending skipped\n",
+                static_cast<unsigned long long>(totals.written), totals.written / seconds,
+                static_cast<unsigned long long>(totals.skippedCheck),
+                static_cast<unsigned long long>(totals.skippedCapture));
+    std::printf("Results: %.1f%% white wins, %.1f%% draws, %.1f%% black wins\n",
+                100.0 * totals.results[2] / games, 100.0 * totals.results[1] / games,
+                100.0 * totals.results[0] / games);
+    return 0;
+}
\ No newline at end of file
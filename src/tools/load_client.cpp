@@ -0,0 +1,270 @@
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/epoll.h>
+#include <sys/resource.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <deque>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+// Knights out and back, then one pawn step per side, keeps every game legal
+// and clear of repetition and the fifty-move rule. Pawns on seven files can
+// advance twice each before meeting head-on, which allows 14 such cycles.
+const char* const SHUFFLE[] = {"g1f3", "g8f6", "f3g1", "f6g8"};
+const char PAWN_FILES[] = "abcdegh";
+constexpr int CYCLE = 6;
+constexpr int MAX_PLIES = 14 * CYCLE + 4;
+
+std::string scriptedMove(int ply) {
+    int cycle = ply / CYCLE;
+    int step = ply % CYCLE;
+    if (step < 4 || cycle >= 14) return SHUFFLE[step % 4];
+    
+    char file = PAWN_FILES[cycle % 7];
+    bool second = cycle >= 7;
+    if (step == 4) return {file, second ? '3' : '2', file, second ? '4' : '3'};
+    return {file, second ? '6' : '7', file, second ? '5' : '6'};
+}
+
+struct Options {
+    std::string host = "127.0.0.1";
+    int port = 7878;
+    std::string unixPath;
+    int connections = 100;
+    int gamesPerConnection = 10;
+    int concurrentGames = 1;
+    int plies = 40;
+};
+
+struct GameSlot {
+    unsigned long id = 0;
+    int ply = 0;
+    int remaining = 0;
+};
+
+struct Request {
+    Clock::time_point sent;
+    size_t slot;
+    bool isMove;
+};
+
+struct Client {
+    int fd = -1;
+    std::string input;
+    std::string output;
+    std::vector<GameSlot> games;
+    std::deque<Request> pending;
+    bool done = false;
+};
+
+void printUsage() {
+    std::cout << "Usage: load_client [--host ADDR] [--port N] [--unix PATH] [--connections N]\n"
+              << "                   [--games N] [--concurrent N] [--plies N]\n"
+              << "Each connection plays --games solo games, --concurrent of them at a\n"
+              << "time, and reports move acknowledgement latency.\n";
+}
+
+int connectTo(const Options& options) {
+    int fd;
+    if (!options.unixPath.empty()) {
+        fd = ::socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        sockaddr_un addr{};
+        addr.sun_family = AF_UNIX;
+        std::strncpy(addr.sun_path, options.unixPath.c_str(), sizeof(addr.sun_path) - 1);
+        if (fd < 0 || ::connect(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0) return -1;
+    } else {
+        fd = ::socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        sockaddr_in addr{};
+        addr.sin_family = AF_INET;
+        addr.sin_port = htons(static_cast<uint16_t>(options.port));
+        ::inet_pton(AF_INET, options.host.c_str(), &addr.sin_addr);
+        if (fd < 0 || ::connect(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0) return -1;
+        int noDelay = 1;
+        ::setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &noDelay, sizeof(noDelay));
+    }
+    return fd;
+}
+
+void queue(Client& client, size_t slot, const std::string& line, bool isMove) {
+    client.output += line;
+    client.output += '\n';
+    client.pending.push_back({Clock::now(), slot, isMove});
+}
+
+void sendMove(Client& client, size_t slot) {
+    GameSlot& game = client.games[slot];
+    queue(client, slot, "MOVE " + std::to_string(game.id) + " " + scriptedMove(game.ply), true);
+}
+
+void flush(Client& client) {
+    while (!client.output.empty()) {
+        ssize_t sent = ::send(client.fd, client.output.data(), client.output.size(), MSG_NOSIGNAL | MSG_DONTWAIT);
+        if (sent <= 0) return;
+        client.output.erase(0, static_cast<size_t>(sent));
+    }
+}
+
+double percentile(std::vector<double>& sorted, double p) {
+    if (sorted.empty()) return 0.0;
+    size_t index = std::min(sorted.size() - 1, static_cast<size_t>(p * sorted.size()));
+    return sorted[index];
+}
+
+}
+
+int main(int argc, char* argv[]) {
+    Options options;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        auto next = [&]() { return i + 1 < argc ? std::string(argv[++i]) : std::string(); };
+        if (arg == "--host") options.host = next();
+        else if (arg == "--port") options.port = std::stoi(next());
+        else if (arg == "--unix") options.unixPath = next();
+        else if (arg == "--connections") options.connections = std::stoi(next());
+        else if (arg == "--games") options.gamesPerConnection = std::stoi(next());
+        else if (arg == "--concurrent") options.concurrentGames = std::stoi(next());
+        else if (arg == "--plies") options.plies = std::min(MAX_PLIES, std::stoi(next()));
+        else {
+            printUsage();
+            return arg == "--help" ? 0 : 1;
+        }
+    }
+    
+    rlimit limit;
+    if (getrlimit(RLIMIT_NOFILE, &limit) == 0) {
+        limit.rlim_cur = limit.rlim_max;
+        setrlimit(RLIMIT_NOFILE, &limit);
+    }
+    
+    int epollFd = ::epoll_create1(EPOLL_CLOEXEC);
+    std::vector<Client> clients(static_cast<size_t>(options.connections));
+    for (size_t c = 0; c < clients.size(); ++c) {
+        Client& client = clients[c];
+        client.fd = connectTo(options);
+        if (client.fd < 0) {
+            std::cerr << "Error: connection " << c << " failed: " << std::strerror(errno) << "\n";
+            return 1;
+        }
+        
+        epoll_event event{};
+        event.events = EPOLLIN;
+        event.data.u64 = c;
+        ::epoll_ctl(epollFd, EPOLL_CTL_ADD, client.fd, &event);
+        
+        int concurrent = std::min(options.concurrentGames, options.gamesPerConnection);
+        client.games.resize(static_cast<size_t>(concurrent));
+        for (int g = 0; g < concurrent; ++g) {
+            client.games[g].remaining = options.gamesPerConnection / concurrent +
+                                        (g < options.gamesPerConnection % concurrent ? 1 : 0);
+        }
+    }
+    
+    auto start = Clock::now();
+    for (auto& client : clients) {
+        for (size_t slot = 0; slot < client.games.size(); ++slot) {
+            queue(client, slot, "NEW solo", false);
+        }
+        flush(client);
+    }
+    
+    std::vector<double> latencies;
+    latencies.reserve(static_cast<size_t>(options.connections) * options.gamesPerConnection * options.plies);
+    size_t errors = 0;
+    size_t gamesDone = 0;
+    size_t active = clients.size();
+    epoll_event events[256];
+    char buffer[65536];
+    
+    while (active > 0) {
+        int ready = ::epoll_wait(epollFd, events, 256, 10000);
+        if (ready <= 0) {
+            std::cerr << "Error: timed out waiting for the server\n";
+            return 1;
+        }
+        
+        for (int e = 0; e < ready; ++e) {
+            Client& client = clients[events[e].data.u64];
+            ssize_t received = ::recv(client.fd, buffer, sizeof(buffer), MSG_DONTWAIT);
+            if (received <= 0) {
+                std::cerr << "Error: server closed connection\n";
+                return 1;
+            }
+            client.input.append(buffer, static_cast<size_t>(received));
+            
+            size_t start = 0;
+            size_t newline;
+            while ((newline = client.input.find('\n', start)) != std::string::npos) {
+                std::istringstream line(client.input.substr(start, newline - start));
+                start = newline + 1;
+                
+                std::string verb;
+                line >> verb;
+                if (verb == "MOVED" || verb == "JOINED") continue;
+                if (client.pending.empty()) continue;
+                
+                Request request = client.pending.front();
+                client.pending.pop_front();
+                GameSlot& game = client.games[request.slot];
+                if (request.isMove) {
+                    latencies.push_back(std::chrono::duration<double, std::micro>(Clock::now() - request.sent).count());
+                }
+                
+                if (verb == "GAME") {
+                    line >> game.id;
+                    game.ply = 0;
+                    sendMove(client, request.slot);
+                } else if (verb == "OK") {
+                    if (++game.ply < options.plies) {
+                        sendMove(client, request.slot);
+                    } else {
+                        queue(client, request.slot, "CLOSE " + std::to_string(game.id), false);
+                    }
+                } else if (verb == "CLOSED") {
+                    ++gamesDone;
+                    if (--game.remaining > 0) {
+                        queue(client, request.slot, "NEW solo", false);
+                    }
+                } else {
+                    ++errors;
+                    queue(client, request.slot, "CLOSE " + std::to_string(game.id), false);
+                }
+            }
+            client.input.erase(0, start);
+            flush(client);
+            
+            if (!client.done && client.pending.empty()) {
+                client.done = true;
+                --active;
+            }
+        }
+    }
+    
+    double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+    std::sort(latencies.begin(), latencies.end());
+    
+    std::printf("Connections: %d, games: %zu, moves: %zu, errors: %zu\n",
+                options.connections, gamesDone, latencies.size(), errors);
+    std::printf("Elapsed: %.3f s, %.0f moves/s, %.0f games/s\n",
+                seconds, latencies.size() / seconds, gamesDone / seconds);
+    std::printf("Move ack latency (us): p50 %.1f  p99 %.1f  p99.9 %.1f  max %.1f\n",
+                percentile(latencies, 0.50), percentile(latencies, 0.99),
+                percentile(latencies, 0.999), latencies.empty() ? 0.0 : latencies.back());
+    
+    for (auto& client : clients) ::close(client.fd);
+    ::close(epollFd);
+    return errors == 0 ? 0 : 1;
+}
\ No newline at end of file
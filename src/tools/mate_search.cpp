@@ -0,0 +1,126 @@
+#include "core/Game.h"
+#include "core/MateSolver.h"
+#include "core/Notation.h"
+#include "utils/LineReader.h"
+#include <chrono>
+#include <cstdio>
+#include <iostream>
+#include <string>
+
+namespace {
+
+struct Options {
+    int maxMoves = 3;
+    size_t tableMb = 64;
+    uint64_t maxNodes = 2'000'000;
+    std::string path = "-";
+};
+
+void printUsage() {
+    std::cout << "Usage: mate_search [--mate N] [--tt-mb MB] [--nodes N] [file]\n"
+              << "Reads one FEN per line (from file or standard input; trailing EPD\n"
+              << "fields are ignored) and reports the shortest forced mate for the side\n"
+              << "to move in at most N of its moves, a proof that none exists, or\n"
+              << "'unknown' when --nodes expansions per position run out.\n";
+}
+
+// FEN fields only: EPD lines carry opcodes after the first four or six
+std::string fenOf(std::string_view line) {
+    std::string fen;
+    size_t fields = 0;
+    size_t pos = 0;
+    while (fields < 6 && pos < line.size()) {
+        size_t start = line.find_first_not_of(' ', pos);
+        if (start == std::string_view::npos) break;
+        size_t end = line.find(' ', start);
+        if (end == std::string_view::npos) end = line.size();
+        std::string_view field = line.substr(start, end - start);
+        // Clocks are numeric; anything else after the en passant field is EPD
+        if (fields >= 4 && field.find_first_not_of("0123456789") != std::string_view::npos) break;
+        if (!fen.empty()) fen += ' ';
+        fen.append(field);
+        ++fields;
+        pos = end;
+    }
+    if (fields == 4) fen += " 0 1";
+    return fen;
+}
+
+std::string lineToSAN(const std::string& fen, const std::vector<Move>& line) {
+    Game replay;
+    replay.loadFEN(fen);
+    std::string text;
+    for (const auto& move : line) {
+        if (!text.empty()) text += ' ';
+        Notation::appendSAN(text, replay.getBoard(), move.getFrom(), move.getTo(), move.getPromotionPiece());
+        replay.makeMove(move);
+    }
+    return text;
+}
+
+}
+
+int main(int argc, char* argv[]) {
+    Options options;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        auto next = [&]() { return i + 1 < argc ? std::string(argv[++i]) : std::string("0"); };
+        if (arg == "--mate") options.maxMoves = std::stoi(next());
+        else if (arg == "--tt-mb") options.tableMb = std::stoul(next());
+        else if (arg == "--nodes") options.maxNodes = std::stoull(next());
+        else if (arg == "--help" || (arg.size() > 1 && arg[0] == '-')) {
+            printUsage();
+            return arg == "--help" ? 0 : 1;
+        } else {
+            options.path = arg;
+        }
+    }
+    
+    LineReader reader;
+    if (!reader.open(options.path)) {
+        std::cerr << "Error: cannot read " << options.path << "\n";
+        return 1;
+    }
+    
+    MateSolverConfig config;
+    config.tableBytes = options.tableMb << 20;
+    config.maxNodes = options.maxNodes;
+    MateSolver solver(config);
+    
+    size_t positions = 0;
+    size_t counts[3] = {0, 0, 0};
+    auto start = std::chrono::steady_clock::now();
+    std::string_view text;
+    while (reader.nextLine(text)) {
+        std::string fen = fenOf(text);
+        if (fen.empty() || fen[0] == '#') continue;
+        Game game;
+        if (!game.loadFEN(fen)) {
+            std::cerr << "Line " << reader.lineNumber() << ": bad FEN\n";
+            continue;
+        }
+        
+        MateSolution solution = solver.solve(game.snapshot(), options.maxMoves);
+        ++positions;
+        ++counts[static_cast<int>(solution.result)];
+        switch (solution.result) {
+            case MateResult::MATE:
+                std::printf("%s\tmate in %d: %s (%llu nodes)\n", fen.c_str(), solution.mateIn,
+                            lineToSAN(fen, solution.line).c_str(), static_cast<unsigned long long>(solution.nodes));
+                break;
+            case MateResult::NO_MATE:
+                std::printf("%s\tno mate in %d (%llu nodes)\n", fen.c_str(), options.maxMoves,
+                            static_cast<unsigned long long>(solution.nodes));
+                break;
+            case MateResult::UNKNOWN:
+                std::printf("%s\tunknown (%llu nodes)\n", fen.c_str(), static_cast<unsigned long long>(solution.nodes));
+                break;
+        }
+        std::fflush(stdout);
+    }
+    
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::fprintf(stderr, "%zu positions: %zu mates, %zu proved mate-free, %zu unknown in %.2f s\n",
+                 positions, counts[0], counts[1], counts[2], seconds);
+    return 0;
+}
\ No newline at end of file
@@ -0,0 +1,114 @@
+#include "core/Game.h"
+#include "core/MCTSPlayer.h"
+#include "core/Material.h"
+#include <cstdio>
+#include <iostream>
+#include <memory>
+#include <string>
+
+namespace {
+
+struct Options {
+    int games = 10;
+    unsigned threads = 2;
+    unsigned opponentThreads = 1;
+    int budgetMs = 1000;
+    int maxPlies = 200;
+    unsigned seed = 1;
+};
+
+struct SideTotals {
+    double score = 0.0;
+    uint64_t iterations = 0;
+    uint64_t moves = 0;
+};
+
+void printUsage() {
+    std::cout << "Usage: mcts_match [--games N] [--threads N] [--vs N] [--budget MS]\n"
+              << "                  [--max-plies N] [--seed N]\n"
+              << "Plays MCTS with --threads search threads against MCTS with --vs threads,\n"
+              << "both with the same time per move, alternating colours. Games still\n"
+              << "running at --max-plies are scored by material (3 points decides).\n";
+}
+
+// White's score: 1, 0.5 or 0
+double playGame(MCTSPlayer& white, MCTSPlayer& black, int maxPlies, SideTotals& whiteTotals, SideTotals& blackTotals) {
+    Game game;
+    for (int ply = 0; ply < maxPlies && !game.isGameOver(); ++ply) {
+        bool whiteToMove = game.getCurrentPlayer() == PieceColor::WHITE;
+        MCTSPlayer& player = whiteToMove ? white : black;
+        SideTotals& totals = whiteToMove ? whiteTotals : blackTotals;
+        
+        Move move = player.getMove(game.getBoard());
+        totals.iterations += player.getLastSearchStats().iterations;
+        ++totals.moves;
+        if (!game.makeMove(move)) {
+            return whiteToMove ? 0.0 : 1.0;
+        }
+    }
+    
+    switch (game.getGameStatus()) {
+        case GameStatus::CHECKMATE:
+            return game.getCurrentPlayer() == PieceColor::WHITE ? 0.0 : 1.0;
+        case GameStatus::STALEMATE:
+        case GameStatus::DRAW:
+            return 0.5;
+        default: {
+            int balance = Material::balance(game.getBoard().getMaterialKey());
+            return balance >= 3 ? 1.0 : (balance <= -3 ? 0.0 : 0.5);
+        }
+    }
+}
+
+}
+
+int main(int argc, char* argv[]) {
+    Options options;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        auto next = [&]() { return i + 1 < argc ? std::string(argv[++i]) : std::string("0"); };
+        if (arg == "--games") options.games = std::stoi(next());
+        else if (arg == "--threads") options.threads = static_cast<unsigned>(std::stoul(next()));
+        else if (arg == "--vs") options.opponentThreads = static_cast<unsigned>(std::stoul(next()));
+        else if (arg == "--budget") options.budgetMs = std::stoi(next());
+        else if (arg == "--max-plies") options.maxPlies = std::stoi(next());
+        else if (arg == "--seed") options.seed = static_cast<unsigned>(std::stoul(next()));
+        else {
+            printUsage();
+            return arg == "--help" ? 0 : 1;
+        }
+    }
+    
+    MCTSConfig config;
+    config.budget = std::chrono::milliseconds(options.budgetMs);
+    MCTSConfig opponentConfig = config;
+    config.threads = options.threads;
+    opponentConfig.threads = options.opponentThreads;
+    
+    SideTotals candidate;
+    SideTotals opponent;
+    for (int g = 0; g < options.games; ++g) {
+        bool candidateWhite = g % 2 == 0;
+        PieceColor candidateColor = candidateWhite ? PieceColor::WHITE : PieceColor::BLACK;
+        PieceColor opponentColor = candidateWhite ? PieceColor::BLACK : PieceColor::WHITE;
+        MCTSPlayer a("candidate", candidateColor, config, options.seed + 2 * g);
+        MCTSPlayer b("opponent", opponentColor, opponentConfig, options.seed + 2 * g + 1);
+        
+        double whiteScore = candidateWhite ? playGame(a, b, options.maxPlies, candidate, opponent)
+                                           : playGame(b, a, options.maxPlies, opponent, candidate);
+        double score = candidateWhite ? whiteScore : 1.0 - whiteScore;
+        candidate.score += score;
+        opponent.score += 1.0 - score;
+        std::printf("Game %d: %s, candidate %s\n", g + 1, candidateWhite ? "white" : "black",
+                    score == 1.0 ? "won" : (score == 0.0 ? "lost" : "drew"));
+    }
+    
+    auto rate = [&](const SideTotals& side) {
+        return side.moves ? side.iterations / (side.moves * options.budgetMs / 1000.0) : 0.0;
+    };
+    std::printf("%u threads vs %u threads, %d ms per move\n", options.threads, options.opponentThreads, options.budgetMs);
+    std::printf("Score: %.1f - %.1f (%.1f%%)\n", candidate.score, opponent.score,
+                options.games ? 100.0 * candidate.score / options.games : 0.0);
+    std::printf("Playouts per second: %.0f vs %.0f\n", rate(candidate), rate(opponent));
+    return 0;
+}
\ No newline at end of file
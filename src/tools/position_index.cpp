@@ -0,0 +1,133 @@
+#include "core/Game.h"
+#include "core/Notation.h"
+#include "core/PositionIndex.h"
+#include "core/Stats.h"
+#include "core/Zobrist.h"
+#include "utils/LineReader.h"
+#include <chrono>
+#include <cstdio>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+void printUsage() {
+    std::cout << "Usage: position_index build <index> <games.txt> [--threads N]\n";
+    std::cout << "       position_index add <index> <games.txt> [--threads N]\n";
+    std::cout << "       position_index query <index> [SAN move ...]\n";
+    std::cout << "games.txt holds one game per line as SAN move text (move numbers,\n";
+    std::cout << "{comments} and results are skipped). Games are numbered in file\n";
+    std::cout << "order; 'add' continues the numbering of an existing index.\n";
+    std::cout << "--stats prints hot-path counters to stderr when done.\n";
+}
+
+bool readGames(const std::string& path, std::vector<std::string>& games) {
+    LineReader reader;
+    if (!reader.open(path)) return false;
+    std::string_view line;
+    while (reader.nextLine(line)) games.emplace_back(line);
+    return true;
+}
+
+int buildIndex(const std::string& indexPath, const std::string& gamesPath, bool incremental, unsigned threads) {
+    auto start = std::chrono::steady_clock::now();
+    std::vector<std::string> games;
+    if (!readGames(gamesPath, games)) {
+        std::cerr << "Error: cannot read " << gamesPath << "\n";
+        return 1;
+    }
+    
+    PositionIndex base;
+    if (incremental && !base.open(indexPath)) {
+        std::cerr << "Error: cannot open index " << indexPath << "\n";
+        return 1;
+    }
+    
+    size_t failed = 0;
+    if (!PositionIndex::build(games, incremental ? &base : nullptr, indexPath, threads, &failed)) {
+        std::cerr << "Error: cannot write index " << indexPath << "\n";
+        return 1;
+    }
+    base.close();
+    
+    PositionIndex index(indexPath);
+    auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - start).count();
+    std::cout << "Indexed " << games.size() << " games (" << failed << " with illegal moves) in "
+              << elapsed << " ms\n";
+    std::cout << "Index: " << index.gameCount() << " games, " << index.size() << " positions\n";
+    return 0;
+}
+
+int query(const std::string& indexPath, const std::vector<std::string>& moves) {
+    PositionIndex index;
+    if (!index.open(indexPath)) {
+        std::cerr << "Error: cannot open index " << indexPath << "\n";
+        return 1;
+    }
+    
+    Game game;
+    for (const auto& text : moves) {
+        auto move = Notation::fromSAN(game.getBoard(), game.getCurrentPlayer(), text);
+        if (!move || !game.makeMove(*move)) {
+            std::cerr << "Error: illegal move " << text << "\n";
+            return 1;
+        }
+    }
+    
+    auto start = std::chrono::steady_clock::now();
+    uint64_t key = Zobrist::hash(game.getBoard(), game.getCurrentPlayer());
+    auto range = index.find(key);
+    auto micros = std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - start).count();
+    
+    char keyText[19];
+    std::snprintf(keyText, sizeof(keyText), "%016llx", static_cast<unsigned long long>(key));
+    std::cout << "Key:  " << keyText << "\n";
+    std::cout << (range.second - range.first) << " occurrences (" << micros << "us)\n";
+    for (auto it = range.first; it != range.second; ++it) {
+        std::cout << "  game " << it->gameId << " ply " << it->ply << "\n";
+    }
+    return 0;
+}
+
+}
+
+int main(int argc, char* argv[]) {
+    if (argc < 3) {
+        printUsage();
+        return 1;
+    }
+    
+    std::string command = argv[1];
+    std::string indexPath = argv[2];
+    std::vector<std::string> args;
+    unsigned threads = std::thread::hardware_concurrency();
+    bool stats = false;
+    for (int i = 3; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--threads" && i + 1 < argc) {
+            threads = static_cast<unsigned>(std::stoul(argv[++i]));
+        } else if (arg == "--stats") {
+            stats = true;
+        } else {
+            args.push_back(arg);
+        }
+    }
+    
+    int result;
+    if ((command == "build" || command == "add") && args.size() == 1) {
+        result = buildIndex(indexPath, args[0], command == "add", threads);
+    } else if (command == "query") {
+        result = query(indexPath, args);
+    } else {
+        printUsage();
+        return 1;
+    }
+    if (stats) {
+        Stats::print(std::cerr, Stats::snapshot());
+    }
+    return result;
+}
\ No newline at end of file
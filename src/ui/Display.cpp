@@ -1,4 +1,6 @@
 #include "ui/Display.h"
+#include "core/Notation.h"
+#include "utils/LineReader.h"
 #include "utils/Utils.h"
 #include <iostream>
 #include <iomanip>
@@ -8,33 +10,69 @@ Display::Display() {
 }
 
 void Display::showBoard(const Board& board) const {
-    clearScreen();
+    const std::string& frame = renderBoard(board);
+    std::cout.write(frame.data(), static_cast<std::streamsize>(frame.size()));
+    std::cout.flush();
+}
+
+const std::string& Display::renderBoard(const Board& board) const {
+    frame_.clear();
+    frame_.reserve(2048);
     
-    std::cout << "\n";
-    printBoardHeader();
+    if (!frame_valid_) {
+        // Home, clear screen, then the full frame
+        frame_ += "\033[H\033[2J\n";
+        frame_ += "     a b c d e f g h\n";
+        frame_ += "   ┌─────────────────┐\n";
+        for (int row = 0; row < 8; ++row) {
+            frame_ += "  ";
+            frame_ += static_cast<char>('8' - row);
+            frame_ += ' ';
+            for (int col = 0; col < 8; ++col) {
+                appendSquare(frame_, board.getPiece(Position(row, col)), row, col);
+            }
+            frame_ += "\033[0m ";
+            frame_ += static_cast<char>('8' - row);
+            frame_ += '\n';
+        }
+        frame_ += "   └─────────────────┘\n";
+        frame_ += "     a b c d e f g h\n\n";
+        frame_valid_ = true;
+        return frame_;
+    }
     
     for (int row = 0; row < 8; ++row) {
-        std::cout << "  " << (8 - row) << " ";
-        
         for (int col = 0; col < 8; ++col) {
             const Piece* piece = board.getPiece(Position(row, col));
+            char code = piece ? Utils::pieceToChar(piece->getType(), piece->getColor()) : ' ';
+            if (code == shown_[row * 8 + col]) continue;
             
-            std::cout << getSquareColor(row, col);
-            
-            if (piece) {
-                std::cout << pieceToUnicode(piece);
-            } else {
-                std::cout << " ";
-            }
-            
-            std::cout << " ";
+            frame_ += "\033[";
+            frame_ += std::to_string(BOARD_TOP_LINE + row);
+            frame_ += ';';
+            frame_ += std::to_string(BOARD_LEFT_COLUMN + 2 * col);
+            frame_ += 'H';
+            appendSquare(frame_, piece, row, col);
+            frame_ += "\033[0m";
         }
-        
-        std::cout << "\033[0m " << (8 - row) << "\n";
     }
     
-    printBoardFooter();
-    std::cout << "\n";
+    // Park the cursor under the board and drop whatever was printed there
+    frame_ += "\033[";
+    frame_ += std::to_string(BOARD_BOTTOM_LINE);
+    frame_ += ";1H\033[J";
+    return frame_;
+}
+
+void Display::appendSquare(std::string& out, const Piece* piece, int row, int col) const {
+    out += getSquareColor(row, col);
+    if (piece) {
+        out += pieceToUnicode(piece);
+    } else {
+        out += ' ';
+    }
+    out += ' ';
+    shown_[row * 8 + col] = piece ? Utils::pieceToChar(piece->getType(), piece->getColor()) : ' ';
 }
 
 void Display::showGameStatus(const Game& game) const {
@@ -50,6 +88,9 @@ void Display::showGameStatus(const Game& game) const {
 }
 
 void Display::showMoveHistory(const Game& game) const {
+    // Long output can scroll the board away from where the next diff expects it
+    frame_valid_ = false;
+    
     const auto& history = game.getMoveHistory();
     if (history.empty()) {
         std::cout << "No moves played yet.\n";
@@ -57,15 +98,16 @@ void Display::showMoveHistory(const Game& game) const {
     }
     
     std::cout << "Move History:\n";
-    for (size_t i = 0; i < history.size(); i += 2) {
+    std::vector<std::string> san = Notation::historyToSAN(game);
+    for (size_t i = 0; i < san.size(); i += 2) {
         std::cout << std::setw(3) << (i / 2 + 1) << ". ";
         
         // White move
-        std::cout << std::setw(8) << history[i].toAlgebraicNotation(game.getBoard());
+        std::cout << std::setw(8) << san[i];
         
         // Black move (if exists)
-        if (i + 1 < history.size()) {
-            std::cout << std::setw(8) << history[i + 1].toAlgebraicNotation(game.getBoard());
+        if (i + 1 < san.size()) {
+            std::cout << std::setw(8) << san[i + 1];
         }
         
         std::cout << "\n";
@@ -91,8 +133,9 @@ void Display::clearScreen() const {
 #ifdef _WIN32
     system("cls");
 #else
-    system("clear");
+    std::cout << "\033[H\033[2J" << std::flush;
 #endif
+    frame_valid_ = false;
 }
 
 void Display::showWelcomeMessage() const {
@@ -109,10 +152,12 @@ void Display::showWelcomeMessage() const {
     std::cout << "  Draw: draw or d\n";
     std::cout << "  Resign: resign or r\n";
     std::cout << "\nPress Enter to start...\n";
-    std::cin.get();
+    std::string_view line;
+    LineReader::console().nextLine(line);
 }
 
 void Display::showHelpMessage() const {
+    frame_valid_ = false;
     std::cout << "\n=== CHESS GAME HELP ===\n";
     std::cout << "Move format: [from][to] (e.g., e2e4, a7a8)\n";
     std::cout << "Squares are named a1-h8 (files a-h, ranks 1-8)\n";
@@ -162,21 +207,11 @@ std::string Display::pieceToUnicode(const Piece* piece) const {
     return Utils::pieceToUnicode(piece->getType(), piece->getColor());
 }
 
-std::string Display::getSquareColor(int row, int col) const {
+const char* Display::getSquareColor(int row, int col) const {
     bool isLightSquare = (row + col) % 2 == 0;
     if (isLightSquare) {
         return "\033[47m\033[30m";  // Light background, dark text
     } else {
         return "\033[40m\033[37m";  // Dark background, light text
     }
-}
-
-void Display::printBoardHeader() const {
-    std::cout << "     a b c d e f g h\n";
-    std::cout << "   ┌─────────────────┐\n";
-}
-
-void Display::printBoardFooter() const {
-    std::cout << "   └─────────────────┘\n";
-    std::cout << "     a b c d e f g h\n";
 }
\ No newline at end of file
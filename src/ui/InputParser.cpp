@@ -1,37 +1,61 @@
 #include "ui/InputParser.h"
+#include "utils/LineReader.h"
 #include "utils/Utils.h"
 #include <iostream>
-#include <algorithm>
 #include <cctype>
 
-std::optional<std::pair<Position, Position>> InputParser::parseMove(const std::string& input) const {
-    std::string trimmedInput = trim(input);
+ParsedInput InputParser::classify(std::string_view input) const {
+    ParsedInput parsed;
+    std::string_view text = trim(input);
+    if (text.empty()) return parsed;
     
-    if (trimmedInput.length() == 4) {
-        std::string fromSquare = trimmedInput.substr(0, 2);
-        std::string toSquare = trimmedInput.substr(2, 2);
-        
-        if (isValidSquare(fromSquare) && isValidSquare(toSquare)) {
-            Position from = squareToPosition(fromSquare);
-            Position to = squareToPosition(toSquare);
-            return std::make_pair(from, to);
+    // Moves: e2e4, e2-e4, optionally followed by a promotion letter
+    size_t toStart = (text.size() >= 5 && text[2] == '-') ? 3 : 2;
+    size_t moveLength = toStart + 2;
+    if ((text.size() == moveLength || text.size() == moveLength + 1) &&
+        isValidSquare(text.substr(0, 2)) && isValidSquare(text.substr(toStart, 2))) {
+        if (text.size() == moveLength + 1) {
+            parsed.promotion = parsePromotionPiece(text.substr(moveLength));
+            if (!parsed.promotion) {
+                parsed.command = InputCommand::INVALID;
+                return parsed;
+            }
         }
-    } else if (trimmedInput.length() == 5 && trimmedInput[2] == '-') {
-        std::string fromSquare = trimmedInput.substr(0, 2);
-        std::string toSquare = trimmedInput.substr(3, 2);
-        
-        if (isValidSquare(fromSquare) && isValidSquare(toSquare)) {
-            Position from = squareToPosition(fromSquare);
-            Position to = squareToPosition(toSquare);
-            return std::make_pair(from, to);
+        parsed.command = InputCommand::MOVE;
+        parsed.from = squareToPosition(text.substr(0, 2));
+        parsed.to = squareToPosition(text.substr(toStart, 2));
+        return parsed;
+    }
+    
+    // Commands are matched on their first letter, then compared once
+    struct Keyword { std::string_view word; InputCommand command; };
+    static constexpr Keyword KEYWORDS[] = {
+        {"q", InputCommand::QUIT}, {"quit", InputCommand::QUIT}, {"exit", InputCommand::QUIT},
+        {"h", InputCommand::HELP}, {"help", InputCommand::HELP}, {"?", InputCommand::HELP},
+        {"u", InputCommand::UNDO}, {"undo", InputCommand::UNDO},
+        {"d", InputCommand::DRAW}, {"draw", InputCommand::DRAW},
+        {"r", InputCommand::RESIGN}, {"resign", InputCommand::RESIGN},
+    };
+    char first = static_cast<char>(std::tolower(static_cast<unsigned char>(text[0])));
+    for (const auto& keyword : KEYWORDS) {
+        if (keyword.word[0] == first && equalsIgnoreCase(text, keyword.word)) {
+            parsed.command = keyword.command;
+            return parsed;
         }
     }
     
-    return std::nullopt;
+    parsed.command = InputCommand::INVALID;
+    return parsed;
 }
 
-std::optional<Position> InputParser::parsePosition(const std::string& input) const {
-    std::string trimmedInput = trim(input);
+std::optional<std::pair<Position, Position>> InputParser::parseMove(std::string_view input) const {
+    ParsedInput parsed = classify(input);
+    if (parsed.command != InputCommand::MOVE || parsed.promotion) return std::nullopt;
+    return std::make_pair(parsed.from, parsed.to);
+}
+
+std::optional<Position> InputParser::parsePosition(std::string_view input) const {
+    std::string_view trimmedInput = trim(input);
     
     if (isValidSquare(trimmedInput)) {
         return squareToPosition(trimmedInput);
@@ -40,59 +64,53 @@ std::optional<Position> InputParser::parsePosition(const std::string& input) con
     return std::nullopt;
 }
 
-std::optional<PieceType> InputParser::parsePromotionPiece(const std::string& input) const {
-    std::string lowerInput = toLower(trim(input));
+std::optional<PieceType> InputParser::parsePromotionPiece(std::string_view input) const {
+    std::string_view text = trim(input);
     
-    if (lowerInput == "q" || lowerInput == "queen") {
+    if (equalsIgnoreCase(text, "q") || equalsIgnoreCase(text, "queen")) {
         return PieceType::QUEEN;
-    } else if (lowerInput == "r" || lowerInput == "rook") {
+    } else if (equalsIgnoreCase(text, "r") || equalsIgnoreCase(text, "rook")) {
         return PieceType::ROOK;
-    } else if (lowerInput == "b" || lowerInput == "bishop") {
+    } else if (equalsIgnoreCase(text, "b") || equalsIgnoreCase(text, "bishop")) {
         return PieceType::BISHOP;
-    } else if (lowerInput == "n" || lowerInput == "knight") {
+    } else if (equalsIgnoreCase(text, "n") || equalsIgnoreCase(text, "knight")) {
         return PieceType::KNIGHT;
     }
     
     return std::nullopt;
 }
 
-bool InputParser::isQuitCommand(const std::string& input) const {
-    std::string lowerInput = toLower(trim(input));
-    return lowerInput == "quit" || lowerInput == "q" || lowerInput == "exit";
+bool InputParser::isQuitCommand(std::string_view input) const {
+    return classify(input).command == InputCommand::QUIT;
 }
 
-bool InputParser::isHelpCommand(const std::string& input) const {
-    std::string lowerInput = toLower(trim(input));
-    return lowerInput == "help" || lowerInput == "h" || lowerInput == "?";
+bool InputParser::isHelpCommand(std::string_view input) const {
+    return classify(input).command == InputCommand::HELP;
 }
 
-bool InputParser::isUndoCommand(const std::string& input) const {
-    std::string lowerInput = toLower(trim(input));
-    return lowerInput == "undo" || lowerInput == "u";
+bool InputParser::isUndoCommand(std::string_view input) const {
+    return classify(input).command == InputCommand::UNDO;
 }
 
-bool InputParser::isDrawCommand(const std::string& input) const {
-    std::string lowerInput = toLower(trim(input));
-    return lowerInput == "draw" || lowerInput == "d";
+bool InputParser::isDrawCommand(std::string_view input) const {
+    return classify(input).command == InputCommand::DRAW;
 }
 
-bool InputParser::isResignCommand(const std::string& input) const {
-    std::string lowerInput = toLower(trim(input));
-    return lowerInput == "resign" || lowerInput == "r";
+bool InputParser::isResignCommand(std::string_view input) const {
+    return classify(input).command == InputCommand::RESIGN;
 }
 
 std::string InputParser::getUserInput() const {
-    std::string input;
-    std::getline(std::cin, input);
-    return input;
+    std::string_view input;
+    if (!LineReader::console().nextLine(input)) return {};
+    return std::string(input);
 }
 
 std::string InputParser::getPlayerName(PieceColor color) const {
     std::string colorName = Utils::colorToString(color);
     std::cout << "Enter name for " << colorName << " player: ";
     
-    std::string name;
-    std::getline(std::cin, name);
+    std::string name = getUserInput();
     
     if (name.empty()) {
         name = colorName + " Player";
@@ -101,7 +119,7 @@ std::string InputParser::getPlayerName(PieceColor color) const {
     return name;
 }
 
-bool InputParser::isValidSquare(const std::string& square) const {
+bool InputParser::isValidSquare(std::string_view square) const {
     if (square.length() != 2) return false;
     
     char file = square[0];
@@ -110,7 +128,7 @@ bool InputParser::isValidSquare(const std::string& square) const {
     return (file >= 'a' && file <= 'h') && (rank >= '1' && rank <= '8');
 }
 
-Position InputParser::squareToPosition(const std::string& square) const {
+Position InputParser::squareToPosition(std::string_view square) const {
     if (!isValidSquare(square)) return Position(-1, -1);
     
     int col = square[0] - 'a';
@@ -119,16 +137,18 @@ Position InputParser::squareToPosition(const std::string& square) const {
     return Position(row, col);
 }
 
-std::string InputParser::trim(const std::string& str) const {
+std::string_view InputParser::trim(std::string_view str) const {
     size_t start = str.find_first_not_of(" \t\n\r\f\v");
-    if (start == std::string::npos) return "";
+    if (start == std::string_view::npos) return {};
     
     size_t end = str.find_last_not_of(" \t\n\r\f\v");
     return str.substr(start, end - start + 1);
 }
 
-std::string InputParser::toLower(const std::string& str) const {
-    std::string result = str;
-    std::transform(result.begin(), result.end(), result.begin(), ::tolower);
-    return result;
+bool InputParser::equalsIgnoreCase(std::string_view str, std::string_view lower) const {
+    if (str.size() != lower.size()) return false;
+    for (size_t i = 0; i < str.size(); ++i) {
+        if (std::tolower(static_cast<unsigned char>(str[i])) != lower[i]) return false;
+    }
+    return true;
 }
\ No newline at end of file
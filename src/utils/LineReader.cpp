@@ -0,0 +1,97 @@
+#include "utils/LineReader.h"
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+
+LineReader::~LineReader() {
+    close();
+}
+
+LineReader& LineReader::console() {
+    static LineReader reader;
+    if (!reader.isOpen()) reader.open("-");
+    return reader;
+}
+
+bool LineReader::open(const std::string& path) {
+    close();
+    
+    if (path == "-") {
+        fd_ = STDIN_FILENO;
+        owns_fd_ = false;
+    } else {
+        fd_ = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd_ < 0) return false;
+        owns_fd_ = true;
+    }
+    
+    buffer_.resize(BUFFER_SIZE);
+    begin_ = end_ = 0;
+    line_number_ = 0;
+    eof_ = false;
+    return true;
+}
+
+void LineReader::close() {
+    if (owns_fd_ && fd_ >= 0) ::close(fd_);
+    fd_ = -1;
+    owns_fd_ = false;
+}
+
+bool LineReader::nextLine(std::string_view& line) {
+    if (fd_ < 0) return false;
+    
+    size_t scanned = begin_;
+    while (true) {
+        const char* start = buffer_.data() + begin_;
+        const void* newline = std::memchr(buffer_.data() + scanned, '\n', end_ - scanned);
+        
+        size_t length;
+        if (newline) {
+            length = static_cast<size_t>(static_cast<const char*>(newline) - start);
+            begin_ += length + 1;
+        } else if (eof_) {
+            if (begin_ == end_) return false;
+            length = end_ - begin_;
+            begin_ = end_;
+        } else {
+            scanned = end_ - begin_;
+            if (!fill()) return false;
+            scanned += begin_;
+            continue;
+        }
+        
+        if (length > 0 && start[length - 1] == '\r') --length;
+        line = std::string_view(start, length);
+        ++line_number_;
+        return true;
+    }
+}
+
+bool LineReader::hasLine() const {
+    return eof_ || std::memchr(buffer_.data() + begin_, '\n', end_ - begin_) != nullptr;
+}
+
+bool LineReader::fill() {
+    // Move the partial line to the front, growing only for very long lines
+    if (begin_ > 0) {
+        std::memmove(buffer_.data(), buffer_.data() + begin_, end_ - begin_);
+        end_ -= begin_;
+        begin_ = 0;
+    }
+    if (end_ == buffer_.size()) buffer_.resize(buffer_.size() * 2);
+    
+    while (true) {
+        ssize_t received = ::read(fd_, buffer_.data() + end_, buffer_.size() - end_);
+        if (received > 0) {
+            end_ += static_cast<size_t>(received);
+            return true;
+        }
+        if (received == 0) {
+            eof_ = true;
+            return true;
+        }
+        if (errno != EINTR) return false;
+    }
+}
\ No newline at end of file
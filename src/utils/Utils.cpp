@@ -29,6 +29,7 @@ std::string gameStatusToString(GameStatus status) {
         case GameStatus::CHECKMATE: return "Checkmate";
         case GameStatus::STALEMATE: return "Stalemate";
         case GameStatus::DRAW: return "Draw";
+        case GameStatus::TIME_FORFEIT: return "Time forfeit";
         default: return "Unknown";
     }
 }
@@ -0,0 +1,103 @@
+#include <gtest/gtest.h>
+#include "core/Bitbase.h"
+#include "core/Board.h"
+#include <cstdio>
+
+class BitbaseTest : public ::testing::Test {
+protected:
+    static void SetUpTestSuite() {
+        store = new BitbaseStore();
+        store->generate("KPK", 2);
+    }
+    
+    static void TearDownTestSuite() {
+        delete store;
+        store = nullptr;
+    }
+    
+    void SetUp() override {
+        board.clearBoard();
+    }
+    
+    void place(PieceType type, PieceColor color, int row, int col) {
+        std::unique_ptr<Piece> piece;
+        switch (type) {
+            case PieceType::KING: piece = std::make_unique<King>(color); break;
+            case PieceType::PAWN: piece = std::make_unique<Pawn>(color); break;
+            case PieceType::ROOK: piece = std::make_unique<Rook>(color); break;
+            default: piece = std::make_unique<Queen>(color); break;
+        }
+        board.placePiece(std::move(piece), Position(row, col));
+    }
+    
+    static BitbaseStore* store;
+    Board board;
+};
+
+BitbaseStore* BitbaseTest::store = nullptr;
+
+TEST_F(BitbaseTest, GeneratesDependencies) {
+    EXPECT_NE(store->find("KPK"), nullptr);
+    EXPECT_NE(store->find("KQK"), nullptr);
+    EXPECT_NE(store->find("KRK"), nullptr);
+    EXPECT_EQ(Bitbase::canonicalMaterial("KNBK"), "KBNK");
+    EXPECT_EQ(Bitbase::canonicalMaterial("KQRBK"), "");
+}
+
+TEST_F(BitbaseTest, KingOnSixthWinsEitherSideToMove) {
+    place(PieceType::KING, PieceColor::WHITE, 2, 4);  // Ke6
+    place(PieceType::PAWN, PieceColor::WHITE, 3, 4);  // e5
+    place(PieceType::KING, PieceColor::BLACK, 0, 4);  // Ke8
+    
+    EXPECT_EQ(store->probe(board, PieceColor::WHITE), BitbaseResult::WIN);
+    EXPECT_EQ(store->probe(board, PieceColor::BLACK), BitbaseResult::LOSS);
+}
+
+TEST_F(BitbaseTest, BlackPawnIsMirrored) {
+    place(PieceType::KING, PieceColor::BLACK, 5, 4);  // Ke3
+    place(PieceType::PAWN, PieceColor::BLACK, 4, 4);  // e4
+    place(PieceType::KING, PieceColor::WHITE, 7, 4);  // Ke1
+    
+    EXPECT_EQ(store->probe(board, PieceColor::BLACK), BitbaseResult::WIN);
+    EXPECT_EQ(store->probe(board, PieceColor::WHITE), BitbaseResult::LOSS);
+}
+
+TEST_F(BitbaseTest, RookPawnWithDefenderInCornerIsDrawn) {
+    place(PieceType::KING, PieceColor::WHITE, 7, 7);  // Kh1
+    place(PieceType::PAWN, PieceColor::WHITE, 4, 0);  // a4
+    place(PieceType::KING, PieceColor::BLACK, 0, 0);  // Ka8
+    
+    EXPECT_EQ(store->probe(board, PieceColor::WHITE), BitbaseResult::DRAW);
+    EXPECT_EQ(store->probe(board, PieceColor::BLACK), BitbaseResult::DRAW);
+}
+
+TEST_F(BitbaseTest, MateAndHangingRook) {
+    place(PieceType::KING, PieceColor::BLACK, 0, 0);  // Ka8
+    place(PieceType::KING, PieceColor::WHITE, 2, 1);  // Kb6
+    place(PieceType::ROOK, PieceColor::WHITE, 0, 7);  // Rh8
+    EXPECT_EQ(store->probe(board, PieceColor::BLACK), BitbaseResult::LOSS);
+    
+    board.clearBoard();
+    place(PieceType::KING, PieceColor::BLACK, 0, 0);  // Ka8
+    place(PieceType::ROOK, PieceColor::WHITE, 1, 1);  // Rb7, undefended
+    place(PieceType::KING, PieceColor::WHITE, 7, 7);  // Kh1
+    EXPECT_EQ(store->probe(board, PieceColor::BLACK), BitbaseResult::DRAW);
+    EXPECT_EQ(store->probe(board, PieceColor::WHITE), BitbaseResult::WIN);
+}
+
+TEST_F(BitbaseTest, SaveAndLoadRoundTrip) {
+    std::string path = ::testing::TempDir() + "KRK.bb";
+    ASSERT_TRUE(store->find("KRK")->save(path));
+    
+    BitbaseStore loaded;
+    ASSERT_TRUE(loaded.load(path));
+    
+    place(PieceType::KING, PieceColor::BLACK, 0, 0);
+    place(PieceType::KING, PieceColor::WHITE, 2, 1);
+    place(PieceType::ROOK, PieceColor::WHITE, 0, 7);
+    EXPECT_EQ(loaded.probe(board, PieceColor::BLACK), BitbaseResult::LOSS);
+    std::remove(path.c_str());
+    
+    Board initial;
+    EXPECT_FALSE(loaded.probe(initial, PieceColor::WHITE).has_value());
+}
\ No newline at end of file
@@ -1,5 +1,6 @@
 #include <gtest/gtest.h>
 #include "core/Board.h"
+#include <cstring>
 
 class BoardTest : public ::testing::Test {
 protected:
@@ -46,4 +47,57 @@ TEST_F(BoardTest, CheckDetection) {
     // Initially no check
     EXPECT_FALSE(board.isInCheck(PieceColor::WHITE));
     EXPECT_FALSE(board.isInCheck(PieceColor::BLACK));
+}
+
+TEST_F(BoardTest, SnapshotRoundTripsThroughMemcpy) {
+    board.movePiece(Position(6, 4), Position(4, 4));
+    board.setEnPassantTarget(Position(5, 4));
+    PositionSnapshot original = board.snapshot(PieceColor::BLACK);
+    
+    PositionSnapshot copy;
+    std::memcpy(&copy, &original, sizeof(copy));
+    EXPECT_EQ(copy.side(), PieceColor::BLACK);
+    EXPECT_EQ(copy.enPassant, 5 * 8 + 4);
+    EXPECT_EQ(copy.castlingRights(), 0x0F);
+    
+    Board restored;
+    restored.clearBoard();
+    restored.restore(copy);
+    PositionSnapshot again = restored.snapshot(PieceColor::BLACK);
+    EXPECT_EQ(std::memcmp(&again, &original, sizeof(original)), 0);
+    ASSERT_NE(restored.getPiece(Position(4, 4)), nullptr);
+    EXPECT_TRUE(restored.getPiece(Position(4, 4))->hasMoved());
+    EXPECT_EQ(restored.getEnPassantTarget(), Position(5, 4));
+    
+    board.movePiece(Position(7, 7), Position(5, 7));
+    EXPECT_EQ(board.snapshot().castlingRights(), PositionSnapshot::WHITE_QUEENSIDE | PositionSnapshot::BLACK_KINGSIDE |
+                                                 PositionSnapshot::BLACK_QUEENSIDE);
+}
+
+TEST_F(BoardTest, SnapshotCheckProbesMatchBoardCopies) {
+    // A scrambled middlegame with pins, open lines and both kings exposed
+    board.clearBoard();
+    board.placePiece(std::make_unique<King>(PieceColor::WHITE), Position(7, 4));
+    board.placePiece(std::make_unique<King>(PieceColor::BLACK), Position(0, 4));
+    board.placePiece(std::make_unique<Rook>(PieceColor::BLACK), Position(3, 4));
+    board.placePiece(std::make_unique<Bishop>(PieceColor::BLACK), Position(4, 1));
+    board.placePiece(std::make_unique<Knight>(PieceColor::BLACK), Position(5, 2));
+    board.placePiece(std::make_unique<Pawn>(PieceColor::BLACK), Position(6, 6));
+    board.placePiece(std::make_unique<Queen>(PieceColor::WHITE), Position(6, 4));
+    board.placePiece(std::make_unique<Knight>(PieceColor::WHITE), Position(6, 3));
+    board.placePiece(std::make_unique<Bishop>(PieceColor::WHITE), Position(7, 5));
+    board.placePiece(std::make_unique<Rook>(PieceColor::WHITE), Position(2, 0));
+    board.placePiece(std::make_unique<Queen>(PieceColor::BLACK), Position(2, 7));
+    
+    for (PieceColor color : {PieceColor::WHITE, PieceColor::BLACK}) {
+        for (const auto& from : board.getAllPiecesPositions(color)) {
+            for (const auto& to : board.getPiece(from)->getPossibleMoves(from, board)) {
+                Board copy(board);
+                copy.placePiece(copy.removePiece(from), to);
+                EXPECT_EQ(board.wouldBeInCheck(from, to, color), copy.isInCheck(color))
+                    << from.row << from.col << "-" << to.row << to.col;
+            }
+        }
+        EXPECT_EQ(board.snapshot().isInCheck(color), board.isInCheck(color));
+    }
 }
\ No newline at end of file
@@ -0,0 +1,130 @@
+#include <gtest/gtest.h>
+#include "capi/chesscore.h"
+#include <memory>
+#include <string>
+
+namespace {
+
+struct PositionDeleter {
+    void operator()(chess_position* position) const { chess_position_destroy(position); }
+};
+
+using PositionHandle = std::unique_ptr<chess_position, PositionDeleter>;
+
+PositionHandle create() {
+    return PositionHandle(chess_position_create());
+}
+
+int square(const char* name) {
+    return (name[0] - 'a') + 8 * (name[1] - '1');
+}
+
+chess_move move(const char* from, const char* to, chess_promotion promotion = CHESS_PROMOTE_NONE) {
+    return chess_make_move(square(from), square(to), promotion);
+}
+
+std::string fenOf(const chess_position* position) {
+    char buffer[CHESS_MAX_FEN];
+    EXPECT_EQ(chess_position_fen(position, buffer, sizeof(buffer), nullptr), CHESS_OK);
+    return buffer;
+}
+
+uint64_t perft(chess_position* position, int depth) {
+    chess_move moves[CHESS_MAX_MOVES];
+    size_t count = 0;
+    EXPECT_EQ(chess_position_legal_moves(position, moves, CHESS_MAX_MOVES, &count), CHESS_OK);
+    if (depth == 1) return count;
+    uint64_t nodes = 0;
+    for (size_t i = 0; i < count; ++i) {
+        EXPECT_EQ(chess_position_make_move(position, moves[i]), CHESS_OK);
+        nodes += perft(position, depth - 1);
+        EXPECT_EQ(chess_position_unmake_move(position), CHESS_OK);
+    }
+    return nodes;
+}
+
+}
+
+TEST(ChessCoreApiTest, PerftRestoresThePositionThroughMakeAndUnmake) {
+    EXPECT_EQ(chess_abi_version(), static_cast<uint32_t>(CHESSCORE_ABI_VERSION));
+    PositionHandle position = create();
+    ASSERT_TRUE(position);
+    uint64_t hash = chess_position_hash(position.get());
+    std::string fen = fenOf(position.get());
+    
+    EXPECT_EQ(perft(position.get(), 3), 8902u);
+    EXPECT_EQ(chess_position_hash(position.get()), hash);
+    EXPECT_EQ(fenOf(position.get()), fen);
+    EXPECT_EQ(chess_position_ply(position.get()), 0u);
+    EXPECT_EQ(chess_position_unmake_move(position.get()), CHESS_NO_MOVE_TO_UNMAKE);
+}
+
+TEST(ChessCoreApiTest, HashesTranspositionsAlikeAndDetectsMate) {
+    PositionHandle a = create();
+    PositionHandle b = create();
+    for (chess_move m : {move("g1", "f3"), move("g8", "f6"), move("b1", "c3")}) {
+        ASSERT_EQ(chess_position_make_move(a.get(), m), CHESS_OK);
+    }
+    for (chess_move m : {move("b1", "c3"), move("g8", "f6"), move("g1", "f3")}) {
+        ASSERT_EQ(chess_position_make_move(b.get(), m), CHESS_OK);
+    }
+    EXPECT_EQ(chess_position_hash(a.get()), chess_position_hash(b.get()));
+    EXPECT_EQ(chess_position_side_to_move(a.get()), CHESS_BLACK);
+    
+    PositionHandle mate = create();
+    for (chess_move m : {move("f2", "f3"), move("e7", "e5"), move("g2", "g4")}) {
+        ASSERT_EQ(chess_position_make_move(mate.get(), m), CHESS_OK);
+    }
+    EXPECT_FALSE(chess_position_is_legal(mate.get(), move("e1", "e2")));
+    EXPECT_EQ(chess_position_make_move(mate.get(), move("e1", "e2")), CHESS_ILLEGAL_MOVE);
+    ASSERT_EQ(chess_position_make_move(mate.get(), move("d8", "h4")), CHESS_OK);
+    EXPECT_EQ(chess_position_state(mate.get()), CHESS_CHECKMATE);
+    
+    size_t count = 99;
+    EXPECT_EQ(chess_position_legal_moves(mate.get(), nullptr, 0, &count), CHESS_OK);
+    EXPECT_EQ(count, 0u);
+}
+
+TEST(ChessCoreApiTest, PromotionsBuffersAndBadInput) {
+    PositionHandle position = create();
+    const char* fen = "8/2P5/8/8/8/8/4k1p1/K7 b - - 0 1";
+    ASSERT_EQ(chess_position_load_fen(position.get(), fen), CHESS_OK);
+    EXPECT_EQ(chess_position_load_fen(position.get(), "not a fen"), CHESS_INVALID_FEN);
+    EXPECT_EQ(fenOf(position.get()), fen);
+    
+    // Four promotions on g1 and the king's moves; a short buffer still
+    // reports the full count
+    chess_move moves[CHESS_MAX_MOVES];
+    size_t count = 0;
+    ASSERT_EQ(chess_position_legal_moves(position.get(), moves, CHESS_MAX_MOVES, &count), CHESS_OK);
+    size_t promotions = 0;
+    for (size_t i = 0; i < count; ++i) {
+        if (chess_move_promotion(moves[i]) != CHESS_PROMOTE_NONE) ++promotions;
+    }
+    EXPECT_EQ(promotions, 4u);
+    size_t needed = 0;
+    EXPECT_EQ(chess_position_legal_moves(position.get(), moves, 2, &needed), CHESS_BUFFER_TOO_SMALL);
+    EXPECT_EQ(needed, count);
+    
+    ASSERT_EQ(chess_position_make_move(position.get(), move("g2", "g1", CHESS_PROMOTE_KNIGHT)), CHESS_OK);
+    EXPECT_EQ(fenOf(position.get()), "8/2P5/8/8/8/8/4k3/K5n1 w - - 0 2");
+    ASSERT_EQ(chess_position_make_move(position.get(), move("c7", "c8")), CHESS_OK);
+    EXPECT_EQ(fenOf(position.get()), "2Q5/8/8/8/8/8/4k3/K5n1 b - - 0 2");
+    ASSERT_EQ(chess_position_unmake_move(position.get()), CHESS_OK);
+    ASSERT_EQ(chess_position_unmake_move(position.get()), CHESS_OK);
+    EXPECT_EQ(fenOf(position.get()), fen);
+    
+    char tiny[8];
+    size_t length = 0;
+    EXPECT_EQ(chess_position_fen(position.get(), tiny, sizeof(tiny), &length), CHESS_BUFFER_TOO_SMALL);
+    EXPECT_EQ(length, std::string(fen).size());
+    EXPECT_EQ(std::string(tiny), std::string(fen).substr(0, sizeof(tiny) - 1));
+    EXPECT_EQ(chess_position_fen(position.get(), nullptr, 0, &length), CHESS_BUFFER_TOO_SMALL);
+    EXPECT_EQ(length, std::string(fen).size());
+    
+    EXPECT_EQ(chess_position_make_move(nullptr, 0), CHESS_INVALID_ARGUMENT);
+    EXPECT_EQ(chess_position_legal_moves(position.get(), nullptr, 4, &count), CHESS_INVALID_ARGUMENT);
+    EXPECT_EQ(chess_position_make_move(position.get(), static_cast<chess_move>(move("g2", "g1") | (7 << 12))),
+              CHESS_INVALID_ARGUMENT);
+    EXPECT_STREQ(chess_status_string(CHESS_ILLEGAL_MOVE), "illegal move");
+}
\ No newline at end of file
@@ -0,0 +1,158 @@
+#include <gtest/gtest.h>
+#include "core/Game.h"
+#include "core/GameClock.h"
+#include "core/TimerWheel.h"
+#include <random>
+#include <unordered_map>
+
+using namespace std::chrono_literals;
+using Clock = std::chrono::steady_clock;
+
+TEST(GameClockTest, ChargesTurnsAndAddsIncrement) {
+    GameClock clock({60s, 2s, 0s});
+    auto t0 = Clock::time_point() + 1h;
+    clock.start(PieceColor::WHITE, t0);
+    
+    EXPECT_TRUE(clock.press(t0 + 5s));
+    EXPECT_EQ(clock.remaining(PieceColor::WHITE, t0 + 6s), 57s);
+    EXPECT_EQ(clock.remaining(PieceColor::BLACK, t0 + 6s), 59s);
+    EXPECT_EQ(clock.getRunningSide(), PieceColor::BLACK);
+    
+    EXPECT_TRUE(clock.press(t0 + 5s + 1234ms));
+    EXPECT_EQ(clock.remaining(PieceColor::BLACK, t0 + 10s), 60s + 766ms);
+    
+    clock.stop(t0 + 7s);
+    EXPECT_FALSE(clock.isRunning());
+    EXPECT_EQ(clock.remaining(PieceColor::WHITE, t0 + 1h), 57s - 7s + 5s + 1234ms);
+}
+
+TEST(GameClockTest, DelayIsFreeTimeEachTurn) {
+    GameClock clock({10s, 0s, 3s});
+    auto t0 = Clock::time_point() + 1h;
+    clock.start(PieceColor::WHITE, t0);
+    
+    EXPECT_TRUE(clock.press(t0 + 2s));
+    EXPECT_EQ(clock.remaining(PieceColor::WHITE, t0 + 2s), 10s);
+    EXPECT_TRUE(clock.press(t0 + 7s));
+    EXPECT_EQ(clock.remaining(PieceColor::BLACK, t0 + 7s), 8s);
+    EXPECT_EQ(clock.flagTime(), t0 + 7s + 3s + 10s);
+}
+
+TEST(GameClockTest, FlagFallsAtTheDeadlineAndRefusesLatePresses) {
+    GameClock clock({1s, 1s, 0s});
+    auto t0 = Clock::time_point() + 1h;
+    clock.start(PieceColor::WHITE, t0);
+    
+    EXPECT_FALSE(clock.hasFlagged(t0 + 1s - 1ns));
+    EXPECT_TRUE(clock.hasFlagged(t0 + 1s));
+    EXPECT_FALSE(clock.press(t0 + 1s));
+    EXPECT_EQ(clock.getRunningSide(), PieceColor::WHITE);
+    EXPECT_EQ(clock.remaining(PieceColor::WHITE, t0 + 2s), 0s);
+}
+
+TEST(GameClockTest, GameEndsOnTimeAndTakebacksSwitchTheClock) {
+    Game game;
+    game.setTimeControl({60s, 0s, 0s});
+    auto start = Clock::now();
+    game.startClock(start);
+    ASSERT_TRUE(game.makeMove(Position(6, 4), Position(4, 4)));
+    EXPECT_EQ(game.getClock()->getRunningSide(), PieceColor::BLACK);
+    game.undoLastMove();
+    EXPECT_EQ(game.getClock()->getRunningSide(), PieceColor::WHITE);
+    
+    EXPECT_FALSE(game.checkFlag(start + 59s));
+    EXPECT_TRUE(game.checkFlag(start + 61s));
+    EXPECT_EQ(game.getGameStatus(), GameStatus::TIME_FORFEIT);
+    EXPECT_EQ(game.getGameStatusString(), "White lost on time. Black wins!");
+    EXPECT_FALSE(game.getClock()->isRunning());
+    
+    // A move stamped after the flag fell is refused
+    Game late;
+    late.setTimeControl({1s, 0s, 0s});
+    late.startClock(Clock::now() - 2s);
+    EXPECT_FALSE(late.makeMove(Position(6, 4), Position(4, 4)));
+    EXPECT_EQ(late.getGameStatus(), GameStatus::TIME_FORFEIT);
+    EXPECT_TRUE(late.isGameOver());
+}
+
+TEST(GameClockTest, FlagAgainstABareKingIsADraw) {
+    Game game;
+    ASSERT_TRUE(game.loadFEN("4k3/8/8/8/8/8/P7/R3K3 w - - 0 1"));
+    game.setTimeControl({1s, 0s, 0s});
+    game.startClock(Clock::now() - 2s);
+    EXPECT_TRUE(game.checkFlag());
+    EXPECT_EQ(game.getGameStatus(), GameStatus::DRAW);
+    EXPECT_EQ(game.getDrawReason(), DrawReason::TIMEOUT_VS_INSUFFICIENT_MATERIAL);
+}
+
+TEST(TimerWheelTest, FiresWithinOneTickAfterTheDeadline) {
+    auto start = Clock::time_point() + 1h;
+    TimerWheel wheel(start);
+    std::mt19937 rng(7);
+    std::unordered_map<uint64_t, Clock::time_point> deadlines;
+    
+    // Spread over the first three levels, with sub-tick offsets
+    for (uint64_t tag = 0; tag < 2000; ++tag) {
+        auto deadline = start + std::chrono::microseconds(rng() % 300'000'000);
+        deadlines[tag] = deadline;
+        wheel.arm(tag, deadline);
+    }
+    EXPECT_EQ(wheel.size(), 2000u);
+    
+    std::vector<uint64_t> fired;
+    size_t total = 0;
+    for (auto now = start; total < deadlines.size(); now += 1ms) {
+        auto wakeup = wheel.nextWakeup();
+        ASSERT_TRUE(wakeup.has_value());
+        fired.clear();
+        total += wheel.advance(now, fired);
+        for (uint64_t tag : fired) {
+            EXPECT_GE(now, deadlines[tag]) << tag;
+            EXPECT_LT(now - deadlines[tag], 1ms) << tag;
+            EXPECT_LE(*wakeup, now) << tag;
+        }
+    }
+    EXPECT_EQ(wheel.size(), 0u);
+    EXPECT_FALSE(wheel.nextWakeup().has_value());
+}
+
+TEST(TimerWheelTest, CancelledAndStaleHandlesDoNotFire) {
+    auto start = Clock::time_point() + 1h;
+    TimerWheel wheel(start);
+    auto first = wheel.arm(1, start + 10ms);
+    auto second = wheel.arm(2, start + 5s);
+    EXPECT_TRUE(wheel.cancel(first));
+    EXPECT_FALSE(wheel.cancel(first));
+    EXPECT_FALSE(wheel.cancel(TimerWheel::NO_TIMER));
+    
+    // The recycled node gets a new handle; the old one stays dead
+    auto third = wheel.arm(3, start + 10ms);
+    EXPECT_NE(third, first);
+    EXPECT_FALSE(wheel.cancel(first));
+    
+    std::vector<uint64_t> fired;
+    wheel.advance(start + 1s, fired);
+    EXPECT_EQ(fired, std::vector<uint64_t>{3});
+    EXPECT_FALSE(wheel.cancel(third));
+    EXPECT_TRUE(wheel.cancel(second));
+    
+    // Past deadlines fire on the next advance
+    wheel.arm(4, start);
+    fired.clear();
+    wheel.advance(start + 1s + 1ms, fired);
+    EXPECT_EQ(fired, std::vector<uint64_t>{4});
+}
+
+TEST(TimerWheelTest, DeadlinesBeyondTheTopLevelAreRefiled) {
+    auto start = Clock::time_point() + 1h;
+    TimerWheel wheel(start, 1s);
+    // The top level spans 64^4 ticks, about 194 days at 1 s
+    auto far = start + std::chrono::hours(24 * 400);
+    wheel.arm(9, far);
+    
+    std::vector<uint64_t> fired;
+    wheel.advance(far - 1s, fired);
+    EXPECT_TRUE(fired.empty());
+    wheel.advance(far, fired);
+    EXPECT_EQ(fired, std::vector<uint64_t>{9});
+}
\ No newline at end of file
@@ -0,0 +1,57 @@
+#include <gtest/gtest.h>
+#include "core/Game.h"
+#include "ui/Display.h"
+#include <string>
+
+namespace {
+
+size_t countOf(const std::string& text, const std::string& needle) {
+    size_t count = 0;
+    for (size_t pos = text.find(needle); pos != std::string::npos; pos = text.find(needle, pos + 1)) ++count;
+    return count;
+}
+
+}
+
+TEST(DisplayTest, FirstFrameRepaintsWholeBoard) {
+    Display display;
+    Game game;
+    std::string frame = display.renderBoard(game.getBoard());
+    
+    EXPECT_EQ(frame.rfind("\033[H\033[2J", 0), 0u);
+    EXPECT_EQ(countOf(frame, "♙"), 8u);
+    EXPECT_EQ(countOf(frame, "♚"), 1u);
+}
+
+TEST(DisplayTest, UnchangedBoardSendsAlmostNothing) {
+    Display display;
+    Game game;
+    size_t full = display.renderBoard(game.getBoard()).size();
+    std::string frame = display.renderBoard(game.getBoard());
+    
+    EXPECT_EQ(frame, "\033[15;1H\033[J");
+    EXPECT_LT(frame.size() * 20, full);
+}
+
+TEST(DisplayTest, MoveRewritesOnlyChangedSquares) {
+    Display display;
+    Game game;
+    display.renderBoard(game.getBoard());
+    
+    ASSERT_TRUE(game.makeMove(Position(6, 4), Position(4, 4)));  // e2-e4
+    std::string frame = display.renderBoard(game.getBoard());
+    
+    EXPECT_EQ(countOf(frame, "H"), 3u);  // e2, e4 and the cursor park below the board
+    EXPECT_NE(frame.find("\033[10;13H"), std::string::npos);  // e2 emptied
+    EXPECT_NE(frame.find("\033[8;13H"), std::string::npos);   // pawn on e4
+    EXPECT_EQ(countOf(frame, "♙"), 1u);
+}
+
+TEST(DisplayTest, InvalidateForcesFullRepaint) {
+    Display display;
+    Game game;
+    display.renderBoard(game.getBoard());
+    display.invalidate();
+    
+    EXPECT_EQ(display.renderBoard(game.getBoard()).rfind("\033[H\033[2J", 0), 0u);
+}
\ No newline at end of file
@@ -0,0 +1,71 @@
+#include <gtest/gtest.h>
+#include "core/EventRing.h"
+#include <atomic>
+#include <thread>
+#include <vector>
+
+namespace {
+
+// Three words that must always agree, so a torn read shows
+struct Triple {
+    uint64_t a;
+    uint64_t b;
+    uint64_t c;
+};
+
+}
+
+TEST(EventRingTest, ReadsInOrderAndReportsLag) {
+    EventRing<uint64_t> ring(6);
+    EXPECT_EQ(ring.capacity(), 8u);
+    
+    uint64_t value = 0;
+    EXPECT_EQ(ring.read(0, value), EventRing<uint64_t>::Read::EMPTY);
+    for (uint64_t i = 0; i < 5; ++i) EXPECT_EQ(ring.publish(i * 10), i);
+    EXPECT_EQ(ring.head(), 5u);
+    EXPECT_EQ(ring.tail(), 0u);
+    ASSERT_EQ(ring.read(3, value), EventRing<uint64_t>::Read::OK);
+    EXPECT_EQ(value, 30u);
+    
+    for (uint64_t i = 5; i < 20; ++i) ring.publish(i * 10);
+    EXPECT_EQ(ring.tail(), 12u);
+    EXPECT_EQ(ring.read(3, value), EventRing<uint64_t>::Read::LAGGED);
+    EXPECT_EQ(ring.read(11, value), EventRing<uint64_t>::Read::LAGGED);
+    ASSERT_EQ(ring.read(12, value), EventRing<uint64_t>::Read::OK);
+    EXPECT_EQ(value, 120u);
+    EXPECT_EQ(ring.read(20, value), EventRing<uint64_t>::Read::EMPTY);
+}
+
+TEST(EventRingTest, ReadersNeverSeeTornOrMisnumberedEvents) {
+    constexpr uint64_t EVENTS = 200000;
+    EventRing<Triple> ring(64);
+    std::atomic<bool> done{false};
+    
+    std::vector<std::thread> readers;
+    for (int r = 0; r < 3; ++r) {
+        readers.emplace_back([&]() {
+            uint64_t next = 0;
+            while (true) {
+                bool finished = done.load();
+                Triple event;
+                auto result = ring.read(next, event);
+                if (result == EventRing<Triple>::Read::OK) {
+                    ASSERT_EQ(event.a, next);
+                    ASSERT_EQ(event.b, next * 3);
+                    ASSERT_EQ(event.c, ~next);
+                    ++next;
+                } else if (result == EventRing<Triple>::Read::LAGGED) {
+                    next = ring.tail();
+                } else if (finished) {
+                    break;
+                }
+            }
+            EXPECT_EQ(next, EVENTS);
+        });
+    }
+    
+    for (uint64_t i = 0; i < EVENTS; ++i) ring.publish({i, i * 3, ~i});
+    done = true;
+    for (auto& reader : readers) reader.join();
+    EXPECT_EQ(ring.head(), EVENTS);
+}
\ No newline at end of file
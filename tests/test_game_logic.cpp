@@ -61,4 +61,170 @@ TEST_F(GameTest, UndoMove) {
     // Check that piece is back in original position
     EXPECT_EQ(game.getBoard().getPiece(Position(6, 4))->getType(), PieceType::PAWN);
     EXPECT_TRUE(game.getBoard().isSquareEmpty(Position(4, 4)));
+}
+
+TEST_F(GameTest, UndoRestoresTheExactPosition) {
+    // Captures, an en passant capture, castling and clock changes, each
+    // undone back to the FEN it was played from
+    const std::pair<Position, Position> line[] = {
+        {Position(6, 4), Position(4, 4)},  // e4
+        {Position(1, 3), Position(3, 3)},  // d5
+        {Position(4, 4), Position(3, 3)},  // exd5
+        {Position(1, 2), Position(3, 2)},  // c5
+        {Position(3, 3), Position(2, 2)},  // dxc6 e.p.
+        {Position(0, 1), Position(2, 2)},  // Nxc6
+        {Position(7, 6), Position(5, 5)},  // Nf3
+        {Position(0, 2), Position(4, 6)},  // Bg4
+        {Position(7, 5), Position(5, 3)},  // Bd3
+        {Position(0, 3), Position(1, 2)},  // Qc7
+        {Position(7, 4), Position(7, 6)},  // O-O
+        {Position(0, 4), Position(0, 2)},  // O-O-O
+    };
+    std::vector<std::string> fens;
+    for (const auto& move : line) {
+        fens.push_back(game.toFEN());
+        ASSERT_TRUE(game.makeMove(move.first, move.second)) << fens.back();
+    }
+    std::string end = game.toFEN();
+    
+    for (size_t ply = fens.size(); ply-- > 0;) {
+        game.undoLastMove();
+        EXPECT_EQ(game.toFEN(), fens[ply]);
+        EXPECT_EQ(game.getCurrentPly(), ply);
+    }
+    EXPECT_EQ(game.getBoard().getPiece(Position(6, 4))->hasMoved(), false);
+    
+    ASSERT_TRUE(game.seekToPly(game.getLastPly()));
+    EXPECT_EQ(game.toFEN(), end);
+    EXPECT_EQ(game.getMoveHistory().back().getType(), MoveType::CASTLING_QUEENSIDE);
+    EXPECT_NE(game.getMoveHistory()[4].getCapturedPiece(), nullptr);
+}
+
+TEST_F(GameTest, SeekToPlyKeepsTheLineUntilItBranches) {
+    ASSERT_TRUE(game.makeMove(Position(6, 4), Position(4, 4)));  // e4
+    ASSERT_TRUE(game.makeMove(Position(1, 4), Position(3, 4)));  // e5
+    ASSERT_TRUE(game.makeMove(Position(7, 6), Position(5, 5)));  // Nf3
+    std::string afterE5 = "rnbqkbnr/pppp1ppp/8/4p3/4P3/8/PPPP1PPP/RNBQKBNR w KQkq e6 0 2";
+    
+    ASSERT_TRUE(game.seekToPly(0));
+    EXPECT_EQ(game.toFEN(), "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1");
+    EXPECT_EQ(game.getLastPly(), 3u);
+    ASSERT_TRUE(game.seekToPly(2));
+    EXPECT_EQ(game.toFEN(), afterE5);
+    EXPECT_EQ(game.getMoveHistory().size(), 2u);
+    EXPECT_FALSE(game.seekToPly(4));
+    
+    // Replaying the recorded move steps forward without losing the line
+    ASSERT_TRUE(game.seekToPly(1));
+    ASSERT_TRUE(game.makeMove(Position(1, 4), Position(3, 4)));
+    EXPECT_EQ(game.getLastPly(), 3u);
+    
+    // A different move starts a new line from here
+    ASSERT_TRUE(game.makeMove(Position(7, 1), Position(5, 2)));  // Nc3
+    EXPECT_EQ(game.getLastPly(), 3u);
+    ASSERT_TRUE(game.seekToPly(2));
+    ASSERT_TRUE(game.seekToPly(3));
+    EXPECT_NE(game.getBoard().getPiece(Position(5, 2)), nullptr);
+    EXPECT_TRUE(game.getBoard().isSquareEmpty(Position(5, 5)));
+    
+    ASSERT_TRUE(game.seekToPly(1));
+    ASSERT_TRUE(game.makeMove(Position(1, 3), Position(3, 3)));  // d5
+    EXPECT_EQ(game.getLastPly(), 2u);
+}
+
+TEST_F(GameTest, ExportsFEN) {
+    EXPECT_EQ(game.toFEN(), "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1");
+    
+    game.makeMove(Position(6, 4), Position(4, 4));  // e2-e4
+    EXPECT_EQ(game.toFEN(), "rnbqkbnr/pppppppp/8/8/4P3/8/PPPP1PPP/RNBQKBNR b KQkq e3 0 1");
+}
+
+TEST_F(GameTest, ThreefoldRepetitionIsDraw) {
+    // Knights out and back twice: the start position occurs for the third time
+    for (int cycle = 0; cycle < 2; ++cycle) {
+        EXPECT_NE(game.getGameStatus(), GameStatus::DRAW);
+        game.makeMove(Position(7, 6), Position(5, 5));  // Ng1-f3
+        game.makeMove(Position(0, 6), Position(2, 5));  // Ng8-f6
+        game.makeMove(Position(5, 5), Position(7, 6));  // Nf3-g1
+        game.makeMove(Position(2, 5), Position(0, 6));  // Nf6-g8
+    }
+    EXPECT_EQ(game.getGameStatus(), GameStatus::DRAW);
+    EXPECT_EQ(game.getDrawReason(), DrawReason::THREEFOLD_REPETITION);
+    EXPECT_FALSE(game.makeMove(Position(6, 4), Position(4, 4)));
+    
+    game.undoLastMove();
+    EXPECT_EQ(game.getDrawReason(), DrawReason::NONE);
+    EXPECT_FALSE(game.isGameOver());
+}
+
+TEST_F(GameTest, PawnMoveResetsRepetitionWindow) {
+    game.makeMove(Position(7, 6), Position(5, 5));  // Ng1-f3
+    game.makeMove(Position(0, 6), Position(2, 5));  // Ng8-f6
+    game.makeMove(Position(5, 5), Position(7, 6));  // Nf3-g1
+    game.makeMove(Position(2, 5), Position(0, 6));  // Nf6-g8
+    game.makeMove(Position(6, 0), Position(5, 0));  // a2-a3
+    game.makeMove(Position(1, 0), Position(2, 0));  // a7-a6
+    for (int i = 0; i < 2; ++i) {
+        EXPECT_NE(game.getGameStatus(), GameStatus::DRAW);
+        game.makeMove(Position(7, 6), Position(5, 5));
+        game.makeMove(Position(0, 6), Position(2, 5));
+        game.makeMove(Position(5, 5), Position(7, 6));
+        game.makeMove(Position(2, 5), Position(0, 6));
+    }
+    EXPECT_EQ(game.getDrawReason(), DrawReason::THREEFOLD_REPETITION);
+    
+    Game fresh;
+    ASSERT_TRUE(fresh.loadFEN("4k3/8/8/8/8/8/4P3/4K2R w K - 99 80"));
+    ASSERT_TRUE(fresh.makeMove(Position(7, 7), Position(6, 7)));  // Rh1-h2
+    EXPECT_EQ(fresh.getDrawReason(), DrawReason::FIFTY_MOVE_RULE);
+    EXPECT_EQ(fresh.getGameStatusString(), "Draw by the fifty-move rule");
+}
+
+TEST_F(GameTest, LegalMoveTableMatchesBoardGeneration) {
+    const char* positions[] = {
+        "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1",
+        "rnbqkbnr/ppp1p1pp/8/3pPp2/8/8/PPPP1PPP/RNBQKBNR w KQkq f6 0 3",
+        "4k3/8/8/8/8/8/4r3/4K3 w - - 0 1"
+    };
+    for (const char* fen : positions) {
+        ASSERT_TRUE(game.loadFEN(fen));
+        const Board& board = game.getBoard();
+        size_t total = 0;
+        for (const auto& from : board.getAllPiecesPositions(game.getCurrentPlayer())) {
+            std::vector<Position> expected;
+            for (const auto& to : board.getPiece(from)->getPossibleMoves(from, board)) {
+                if (!board.wouldBeInCheck(from, to, game.getCurrentPlayer())) expected.push_back(to);
+            }
+            auto valid = game.getValidMoves(from);
+            EXPECT_EQ(valid.size(), expected.size()) << fen;
+            for (const auto& to : expected) {
+                EXPECT_TRUE(game.isValidMove(from, to)) << fen;
+            }
+            total += valid.size();
+        }
+        EXPECT_EQ(total, board.getAllValidMoves(game.getCurrentPlayer()).size()) << fen;
+        EXPECT_TRUE(game.getValidMoves(Position(4, 4)).empty() || board.getPiece(Position(4, 4)));
+        EXPECT_FALSE(game.isValidMove(Position(-1, 0), Position(0, 0)));
+    }
+}
+
+TEST_F(GameTest, LegalMoveTableFollowsThePosition) {
+    EXPECT_EQ(game.getValidMoves(Position(6, 4)).size(), 2u);
+    EXPECT_TRUE(game.getValidMoves(Position(1, 4)).empty());  // Not black's turn
+    
+    ASSERT_TRUE(game.makeMove(Position(6, 4), Position(4, 4)));
+    EXPECT_TRUE(game.getValidMoves(Position(4, 4)).empty());
+    EXPECT_EQ(game.getValidMoves(Position(1, 4)).size(), 2u);
+    EXPECT_EQ(game.getLegalTargets(Position(0, 6)), (uint64_t{1} << 21) | (uint64_t{1} << 23));  // Ng8-f6, h6
+    
+    game.undoLastMove();
+    EXPECT_EQ(game.getValidMoves(Position(6, 4)).size(), 2u);
+    EXPECT_TRUE(game.getValidMoves(Position(1, 4)).empty());
+    
+    Game other;
+    ASSERT_TRUE(other.makeMove(Position(6, 3), Position(4, 3)));
+    ASSERT_TRUE(game.restoreState(other.saveState()));
+    EXPECT_TRUE(game.isValidMove(Position(1, 3), Position(3, 3)));
+    EXPECT_FALSE(game.isValidMove(Position(6, 4), Position(4, 4)));
+    EXPECT_TRUE(game.hasLegalMoves());
 }
\ No newline at end of file
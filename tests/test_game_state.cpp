@@ -0,0 +1,167 @@
+#include <gtest/gtest.h>
+#include "core/Game.h"
+#include "core/GameState.h"
+#include "net/Session.h"
+
+class GameStateTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        game.makeMove(Position(6, 4), Position(4, 4));  // e2-e4
+        game.makeMove(Position(1, 3), Position(3, 3));  // d7-d5
+        game.makeMove(Position(4, 4), Position(3, 3));  // exd5
+        game.makeMove(Position(0, 3), Position(3, 3));  // Qxd5
+    }
+    
+    Game game;
+};
+
+TEST_F(GameStateTest, RoundTripPreservesPosition) {
+    GameState state = game.saveState();
+    std::vector<uint8_t> bytes = state.serialize();
+    auto decoded = GameState::deserialize(bytes.data(), bytes.size());
+    ASSERT_TRUE(decoded.has_value());
+    
+    Game restored;
+    ASSERT_TRUE(restored.restoreState(*decoded));
+    EXPECT_EQ(restored.toFEN(), game.toFEN());
+    EXPECT_EQ(restored.getMoveHistory().size(), 4u);
+    EXPECT_EQ(restored.getCurrentPlayer(), PieceColor::WHITE);
+}
+
+TEST_F(GameStateTest, RestoredGameKeepsPlayingAndUndoing) {
+    Game restored;
+    ASSERT_TRUE(restored.restoreState(game.saveState()));
+    
+    const Piece* captured = restored.getMoveHistory().back().getCapturedPiece();
+    ASSERT_NE(captured, nullptr);
+    EXPECT_EQ(captured->getType(), PieceType::PAWN);
+    EXPECT_EQ(captured->getColor(), PieceColor::WHITE);
+    
+    EXPECT_TRUE(restored.makeMove(Position(7, 1), Position(5, 2)));  // Nb1-c3 attacks the queen
+    restored.undoLastMove();
+    EXPECT_EQ(restored.toFEN(), game.toFEN());
+    
+    // The start position travels with the state, so the whole line is reachable
+    EXPECT_EQ(restored.getFirstPly(), 0u);
+    ASSERT_TRUE(restored.seekToPly(2));
+    EXPECT_EQ(restored.toFEN(), "rnbqkbnr/ppp1pppp/8/3p4/4P3/8/PPPP1PPP/RNBQKBNR w KQkq d6 0 2");
+    EXPECT_EQ(restored.getStartFEN(), "");
+}
+
+TEST_F(GameStateTest, StateWithoutStartPositionResumesAtItsLastPly) {
+    GameState state = game.saveState();
+    state.start.reset();
+    std::vector<uint8_t> bytes = state.serialize();
+    auto decoded = GameState::deserialize(bytes.data(), bytes.size());
+    ASSERT_TRUE(decoded.has_value());
+    EXPECT_FALSE(decoded->start.has_value());
+    
+    Game restored;
+    ASSERT_TRUE(restored.restoreState(*decoded));
+    EXPECT_EQ(restored.toFEN(), game.toFEN());
+    EXPECT_EQ(restored.getFirstPly(), 4u);
+    EXPECT_FALSE(restored.seekToPly(3));
+}
+
+TEST_F(GameStateTest, CustomStartPositionRoundTrips) {
+    Game fromFen;
+    ASSERT_TRUE(fromFen.loadFEN("4k3/4p3/8/8/8/8/4P3/4K3 w - - 0 40"));
+    ASSERT_TRUE(fromFen.makeMove(Position(6, 4), Position(4, 4)));
+    std::vector<uint8_t> bytes = fromFen.saveState().serialize();
+    auto decoded = GameState::deserialize(bytes.data(), bytes.size());
+    ASSERT_TRUE(decoded.has_value());
+    
+    Game restored;
+    ASSERT_TRUE(restored.restoreState(*decoded));
+    EXPECT_EQ(restored.toFEN(), fromFen.toFEN());
+    restored.undoLastMove();
+    EXPECT_EQ(restored.toFEN(), "4k3/4p3/8/8/8/8/4P3/4K3 w - - 0 40");
+}
+
+TEST_F(GameStateTest, SnapshotIsCompact) {
+    std::vector<uint8_t> bytes = game.saveState().serialize();
+    EXPECT_LT(bytes.size(), 128u);
+}
+
+TEST_F(GameStateTest, RejectsCorruptInput) {
+    std::vector<uint8_t> bytes = game.saveState().serialize();
+    EXPECT_FALSE(GameState::deserialize(bytes.data(), bytes.size() - 1).has_value());
+    
+    bytes[0] ^= 0xFF;
+    EXPECT_FALSE(GameState::deserialize(bytes.data(), bytes.size()).has_value());
+    
+    GameState noKings = game.saveState();
+    noKings.squares.fill(0);
+    Game target;
+    EXPECT_FALSE(target.restoreState(noKings));
+}
+
+TEST(SessionParkingTest, ParkedSessionResumesOnNextRequest) {
+    Session session(1, 7, true);
+    ASSERT_FALSE(session.move(7, {Position(6, 4), Position(4, 4), std::nullopt}).text.empty());
+    
+    EXPECT_FALSE(session.park(Session::Clock::now() - std::chrono::hours(1)));
+    EXPECT_TRUE(session.park(Session::Clock::now() + std::chrono::seconds(1)));
+    EXPECT_TRUE(session.isParked());
+    
+    SessionReply reply = session.move(7, {Position(1, 4), Position(3, 4), std::nullopt});
+    EXPECT_EQ(reply.text.rfind("OK 1 2", 0), 0u) << reply.text;
+    EXPECT_FALSE(session.isParked());
+}
+TEST(GameFENTest, LoadsAndExportsSamePosition) {
+    const char* positions[] = {
+        "r1bqkbnr/pppp1ppp/2n5/4p3/4P3/5N2/PPPP1PPP/RNBQKB1R w KQkq - 2 3",
+        "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1",
+        "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1",
+        "rnbqkbnr/ppp1p1pp/8/3pPp2/8/8/PPPP1PPP/RNBQKBNR w KQkq f6 0 3",
+    };
+    for (const char* fen : positions) {
+        Game game;
+        ASSERT_TRUE(game.loadFEN(fen)) << fen;
+        EXPECT_EQ(game.toFEN(), fen);
+        EXPECT_TRUE(game.getMoveHistory().empty());
+    }
+}
+
+TEST(GameFENTest, LoadedPositionPlaysOn) {
+    Game game;
+    ASSERT_TRUE(game.loadFEN("rnbqkbnr/ppp1p1pp/8/3pPp2/8/8/PPPP1PPP/RNBQKBNR w KQkq f6 0 3"));
+    EXPECT_TRUE(game.makeMove(Position(3, 4), Position(2, 5)));  // exf6 en passant
+    EXPECT_EQ(game.getBoard().getPiece(Position(3, 5)), nullptr);
+    
+    Game castling;
+    ASSERT_TRUE(castling.loadFEN("r3k2r/8/8/8/8/8/8/R3K2R w KQkq - 0 1"));
+    EXPECT_TRUE(castling.makeMove(Position(7, 4), Position(7, 6)));  // O-O
+}
+
+TEST(GameFENTest, RejectsMalformedFEN) {
+    Game game;
+    EXPECT_FALSE(game.loadFEN(""));
+    EXPECT_FALSE(game.loadFEN("8/8/8/8/8/8/8/8 w - - 0 1"));  // no kings
+    EXPECT_FALSE(game.loadFEN("rnbqkbnr/pppppppp/9/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1"));
+    EXPECT_FALSE(game.loadFEN("rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR x KQkq - 0 1"));
+}
+
+TEST(PositionSnapshotTest, GameRestoresFromSnapshot) {
+    Game game;
+    ASSERT_TRUE(game.loadFEN("r3k2r/8/8/3pP3/8/8/8/R3K2R w Kq d6 4 30"));
+    PositionSnapshot position = game.snapshot();
+    EXPECT_EQ(position.castlingRights(), PositionSnapshot::WHITE_KINGSIDE | PositionSnapshot::BLACK_QUEENSIDE);
+    EXPECT_EQ(position.halfmoveClock, 4);
+    EXPECT_EQ(position.fullmoveNumber, 30);
+    
+    // Thousands of branch points cost 72 bytes each
+    std::vector<PositionSnapshot> branches(4096, position);
+    Game branch;
+    ASSERT_TRUE(branch.makeMove(Position(6, 4), Position(4, 4)));
+    ASSERT_TRUE(branch.restoreSnapshot(branches.back()));
+    EXPECT_EQ(branch.toFEN(), game.toFEN());
+    EXPECT_EQ(branch.getStartFEN(), game.toFEN());
+    EXPECT_TRUE(branch.getMoveHistory().empty());
+    EXPECT_TRUE(branch.isValidMove(Position(3, 4), Position(2, 3)));  // exd6 en passant
+    
+    PositionSnapshot kingless = position;
+    kingless.squares[60] = 0;
+    EXPECT_FALSE(branch.restoreSnapshot(kingless));
+    EXPECT_EQ(branch.toFEN(), game.toFEN());
+}
\ No newline at end of file
@@ -0,0 +1,83 @@
+#include <gtest/gtest.h>
+#include "ui/InputParser.h"
+#include "utils/LineReader.h"
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <vector>
+
+TEST(InputParserTest, ClassifiesCommandsIgnoringCaseAndSpace) {
+    InputParser parser;
+    EXPECT_EQ(parser.classify("  QUIT \r\n").command, InputCommand::QUIT);
+    EXPECT_EQ(parser.classify("q").command, InputCommand::QUIT);
+    EXPECT_EQ(parser.classify("Help").command, InputCommand::HELP);
+    EXPECT_EQ(parser.classify("?").command, InputCommand::HELP);
+    EXPECT_EQ(parser.classify("u").command, InputCommand::UNDO);
+    EXPECT_EQ(parser.classify("Draw").command, InputCommand::DRAW);
+    EXPECT_EQ(parser.classify("resign").command, InputCommand::RESIGN);
+    EXPECT_EQ(parser.classify("   ").command, InputCommand::EMPTY);
+    EXPECT_EQ(parser.classify("quitt").command, InputCommand::INVALID);
+    EXPECT_EQ(parser.classify("hello").command, InputCommand::INVALID);
+}
+
+TEST(InputParserTest, ParsesMovesInOnePass) {
+    InputParser parser;
+    ParsedInput move = parser.classify(" e2e4 ");
+    ASSERT_EQ(move.command, InputCommand::MOVE);
+    EXPECT_EQ(move.from, Position(6, 4));
+    EXPECT_EQ(move.to, Position(4, 4));
+    EXPECT_FALSE(move.promotion.has_value());
+    
+    EXPECT_EQ(parser.classify("g1-f3").command, InputCommand::MOVE);
+    
+    ParsedInput promotion = parser.classify("e7e8n");
+    ASSERT_EQ(promotion.command, InputCommand::MOVE);
+    EXPECT_EQ(promotion.promotion, PieceType::KNIGHT);
+    
+    EXPECT_EQ(parser.classify("e7e8k").command, InputCommand::INVALID);
+    EXPECT_EQ(parser.classify("e2e9").command, InputCommand::INVALID);
+    EXPECT_EQ(parser.classify("E2E4").command, InputCommand::INVALID);
+}
+
+TEST(InputParserTest, LegacyHelpersAgreeWithClassify) {
+    InputParser parser;
+    EXPECT_TRUE(parser.isQuitCommand("exit"));
+    EXPECT_FALSE(parser.isQuitCommand("e2e4"));
+    EXPECT_TRUE(parser.parseMove("a7-a8").has_value());
+    EXPECT_FALSE(parser.parseMove("undo").has_value());
+    EXPECT_EQ(parser.parsePromotionPiece(" Queen "), PieceType::QUEEN);
+    EXPECT_EQ(parser.parsePosition("h1"), Position(7, 7));
+}
+
+TEST(LineReaderTest, SplitsLinesAcrossBufferBoundaries) {
+    std::string path = ::testing::TempDir() + "line_reader_test.txt";
+    std::string longLine(LineReader::BUFFER_SIZE + 100, 'x');
+    {
+        std::ofstream out(path, std::ios::binary);
+        out << "e2e4\r\n\n" << longLine << "\n";
+        for (int i = 0; i < 20000; ++i) out << "g1f3\n";
+        out << "last";
+    }
+    
+    LineReader reader;
+    ASSERT_TRUE(reader.open(path));
+    std::vector<std::string> lines;
+    std::string_view line;
+    while (reader.nextLine(line)) lines.emplace_back(line);
+    std::remove(path.c_str());
+    
+    ASSERT_EQ(lines.size(), 20004u);
+    EXPECT_EQ(lines[0], "e2e4");
+    EXPECT_EQ(lines[1], "");
+    EXPECT_EQ(lines[2], longLine);
+    EXPECT_EQ(lines[3], "g1f3");
+    EXPECT_EQ(lines.back(), "last");
+    EXPECT_EQ(reader.lineNumber(), 20004u);
+}
+
+TEST(LineReaderTest, MissingFileFailsToOpen) {
+    LineReader reader;
+    EXPECT_FALSE(reader.open(::testing::TempDir() + "does_not_exist.txt"));
+    std::string_view line;
+    EXPECT_FALSE(reader.nextLine(line));
+}
\ No newline at end of file
@@ -0,0 +1,107 @@
+#include <gtest/gtest.h>
+#include "core/Game.h"
+#include "core/MateSolver.h"
+
+namespace {
+
+PositionSnapshot positionOf(const std::string& fen) {
+    Game game;
+    EXPECT_TRUE(game.loadFEN(fen)) << fen;
+    return game.snapshot();
+}
+
+// Plain minimax over every legal move: does the side to move mate within
+// plies (odd, counted from its own move)?
+bool bruteForceMate(Game& game, PieceColor attacker, int plies) {
+    if (game.isGameOver()) {
+        return game.getGameStatus() == GameStatus::CHECKMATE && game.getCurrentPlayer() != attacker;
+    }
+    if (plies == 0) return false;
+    bool attacking = game.getCurrentPlayer() == attacker;
+    for (const auto& from : game.getBoard().getAllPiecesPositions(game.getCurrentPlayer())) {
+        bool pawn = game.getBoard().getPiece(from)->getType() == PieceType::PAWN;
+        for (const auto& to : game.getValidMoves(from)) {
+            bool promotes = pawn && (to.row == 0 || to.row == 7);
+            for (PieceType promotion : {PieceType::QUEEN, PieceType::KNIGHT, PieceType::ROOK, PieceType::BISHOP}) {
+                game.makeMove(promotes ? Move(from, to, promotion) : Move(from, to));
+                bool mates = bruteForceMate(game, attacker, plies - 1);
+                game.undoLastMove();
+                if (mates == attacking) return attacking;
+                if (!promotes) break;
+            }
+        }
+    }
+    return !attacking;
+}
+
+int bruteForceMateIn(const std::string& fen, int maxMoves) {
+    Game game;
+    game.loadFEN(fen);
+    for (int moves = 1; moves <= maxMoves; ++moves) {
+        if (bruteForceMate(game, game.getCurrentPlayer(), 2 * moves - 1)) return moves;
+    }
+    return 0;
+}
+
+// Plays the line and checks that it ends in mate by the side to move
+void expectMatingLine(const std::string& fen, const MateSolution& solution) {
+    Game game;
+    game.loadFEN(fen);
+    PieceColor attacker = game.getCurrentPlayer();
+    ASSERT_EQ(solution.line.size(), static_cast<size_t>(2 * solution.mateIn - 1)) << fen;
+    for (const auto& move : solution.line) {
+        ASSERT_TRUE(game.makeMove(move.isPromotion() ? Move(move.getFrom(), move.getTo(), move.getPromotionPiece())
+                                                     : Move(move.getFrom(), move.getTo()))) << fen;
+    }
+    EXPECT_EQ(game.getGameStatus(), GameStatus::CHECKMATE) << fen;
+    EXPECT_NE(game.getCurrentPlayer(), attacker) << fen;
+}
+
+}
+
+TEST(MateSolverTest, FindsShortestMatesLikeBruteForce) {
+    const char* positions[] = {
+        "6k1/5ppp/8/8/8/8/8/R5K1 w - - 0 1",        // Back rank, mate in 1
+        "7k/8/5K2/8/8/8/8/6R1 w - - 0 1",           // Quiet king move first
+        "k7/8/2K5/8/8/8/P7/1R6 w - - 0 1",          // Mate in 3, none in 2
+        "6r1/p7/8/8/8/5k2/8/7K b - - 0 1",          // Black mates
+        "2k5/8/2K5/8/8/8/P7/7R w - - 0 1",
+    };
+    MateSolver solver;
+    for (const char* fen : positions) {
+        int expected = bruteForceMateIn(fen, 2);
+        MateSolution solution = solver.solve(positionOf(fen), 2);
+        if (expected == 0) {
+            EXPECT_EQ(solution.result, MateResult::NO_MATE) << fen;
+            continue;
+        }
+        ASSERT_EQ(solution.result, MateResult::MATE) << fen;
+        EXPECT_EQ(solution.mateIn, expected) << fen;
+        expectMatingLine(fen, solution);
+    }
+}
+
+TEST(MateSolverTest, ProvesThatNoMateExists) {
+    MateSolver solver;
+    MateSolution solution = solver.solve(positionOf("rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1"), 2);
+    EXPECT_EQ(solution.result, MateResult::NO_MATE);
+    EXPECT_TRUE(solution.line.empty());
+    EXPECT_GT(solution.nodes, 0u);
+}
+
+TEST(MateSolverTest, SolvesWithinATinyTableAndReportsExhaustedBudgets) {
+    const std::string fen = "k7/8/2K5/8/8/8/P7/1R6 w - - 0 1";
+    MateSolverConfig small;
+    small.tableBytes = 1024;
+    MateSolver tiny(small);
+    EXPECT_LE(tiny.tableEntries() * 32, 1024u);
+    MateSolution solution = tiny.solve(positionOf(fen), 3);
+    ASSERT_EQ(solution.result, MateResult::MATE);
+    EXPECT_EQ(solution.mateIn, 3);
+    expectMatingLine(fen, solution);
+    
+    MateSolverConfig starved;
+    starved.maxNodes = 1;
+    MateSolver hurried(starved);
+    EXPECT_EQ(hurried.solve(positionOf(fen), 3).result, MateResult::UNKNOWN);
+}
\ No newline at end of file
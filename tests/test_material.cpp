@@ -0,0 +1,104 @@
+#include <gtest/gtest.h>
+#include "core/Game.h"
+#include "core/Material.h"
+#include <random>
+
+namespace {
+
+Material::Outcome outcomeOf(const std::string& fen) {
+    Game game;
+    EXPECT_TRUE(game.loadFEN(fen)) << fen;
+    return Material::classify(game.getBoard().getMaterialKey());
+}
+
+bool isDrawnByMaterial(const std::string& fen) {
+    Game game;
+    EXPECT_TRUE(game.loadFEN(fen)) << fen;
+    return game.getGameStatus() == GameStatus::DRAW && game.getDrawReason() == DrawReason::INSUFFICIENT_MATERIAL;
+}
+
+}
+
+TEST(MaterialTest, CountsPiecesAndBishopSquareColours) {
+    Board board;
+    Material::Key key = board.getMaterialKey();
+    EXPECT_EQ(key, Material::key(board));
+    EXPECT_EQ(Material::count(key, Material::PAWN, PieceColor::WHITE), 8);
+    EXPECT_EQ(Material::count(key, Material::ROOK, PieceColor::BLACK), 2);
+    EXPECT_EQ(Material::count(key, Material::LIGHT_BISHOP, PieceColor::WHITE), 1);
+    EXPECT_EQ(Material::count(key, Material::DARK_BISHOP, PieceColor::WHITE), 1);
+    EXPECT_EQ(Material::count(key, Material::KING, PieceColor::BLACK), 1);
+    EXPECT_EQ(Material::classify(key), Material::Outcome::UNKNOWN);
+    EXPECT_EQ(Material::balance(key), 0);
+    
+    // c1 is dark and f1 light
+    EXPECT_EQ(Material::slotOf(PieceType::BISHOP, Position(7, 2)), Material::DARK_BISHOP);
+    EXPECT_EQ(Material::slotOf(PieceType::BISHOP, Position(7, 5)), Material::LIGHT_BISHOP);
+    
+    board.clearBoard();
+    EXPECT_EQ(board.getMaterialKey(), 0u);
+}
+
+TEST(MaterialTest, KeyFollowsMovesCapturesPromotionsAndUndo) {
+    Game game;
+    std::mt19937 rng(7);
+    for (int ply = 0; ply < 400 && !game.isGameOver(); ++ply) {
+        std::vector<std::pair<Position, Position>> moves;
+        for (const auto& from : game.getBoard().getAllPiecesPositions(game.getCurrentPlayer())) {
+            for (const auto& to : game.getValidMoves(from)) moves.emplace_back(from, to);
+        }
+        ASSERT_FALSE(moves.empty());
+        const auto& [from, to] = moves[rng() % moves.size()];
+        ASSERT_TRUE(game.makeMove(from, to));
+        ASSERT_EQ(game.getBoard().getMaterialKey(), Material::key(game.getBoard())) << game.toFEN();
+        if (ply % 5 == 4) {
+            game.undoLastMove();
+            ASSERT_EQ(game.getBoard().getMaterialKey(), Material::key(game.getBoard())) << game.toFEN();
+        }
+    }
+    
+    ASSERT_TRUE(game.loadFEN("4k3/1P6/8/8/8/8/8/4K3 w - - 0 1"));
+    ASSERT_TRUE(game.makeMove(Move(Position(1, 1), Position(0, 1), PieceType::KNIGHT)));
+    EXPECT_EQ(game.getBoard().getMaterialKey(), Material::key(game.getBoard()));
+    EXPECT_EQ(Material::count(game.getBoard().getMaterialKey(), Material::KNIGHT, PieceColor::WHITE), 1);
+    EXPECT_EQ(Material::count(game.getBoard().getMaterialKey(), Material::PAWN, PieceColor::WHITE), 0);
+}
+
+TEST(MaterialTest, WeighsMaterialInPawns) {
+    EXPECT_EQ(Material::pieceValue(PieceType::PAWN), 1);
+    EXPECT_EQ(Material::pieceValue(PieceType::BISHOP), 3);
+    EXPECT_EQ(Material::pieceValue(PieceType::QUEEN), 9);
+    EXPECT_EQ(Material::pieceValue(PieceType::KING), 0);
+    
+    Game game;
+    ASSERT_TRUE(game.loadFEN("r3k3/pp6/8/8/8/8/PPP5/1NBQK3 w - - 0 1"));
+    EXPECT_EQ(Material::balance(game.getBoard().getMaterialKey()), 3 + 3 + 3 + 9 - 5 - 2);
+}
+
+TEST(MaterialTest, RecognizesDeadDrawsOnly) {
+    EXPECT_TRUE(isDrawnByMaterial("4k3/8/8/8/8/8/8/4K3 w - - 0 1"));
+    EXPECT_TRUE(isDrawnByMaterial("4k3/8/8/8/8/8/8/2B1K3 w - - 0 1"));
+    EXPECT_TRUE(isDrawnByMaterial("4k3/8/8/8/8/8/8/1N2K3 b - - 0 1"));
+    // Bishops on squares of one colour, however many
+    EXPECT_TRUE(isDrawnByMaterial("4kb2/8/8/8/8/8/8/2B1K3 w - - 0 1"));
+    EXPECT_TRUE(isDrawnByMaterial("4k3/8/8/8/8/8/8/B1B1K3 w - - 0 1"));
+    
+    EXPECT_FALSE(isDrawnByMaterial("4k3/8/8/8/8/8/8/R3K3 w - - 0 1"));
+    EXPECT_FALSE(isDrawnByMaterial("4k3/8/8/8/8/8/8/3QK3 b - - 0 1"));
+    EXPECT_FALSE(isDrawnByMaterial("4k3/8/8/8/8/8/4P3/4K3 w - - 0 1"));
+    // Opposite-coloured bishops can still mate with help
+    EXPECT_FALSE(isDrawnByMaterial("2b1k3/8/8/8/8/8/8/2B1K3 w - - 0 1"));
+    EXPECT_FALSE(isDrawnByMaterial("2n1k3/8/8/8/8/8/8/2B1K3 w - - 0 1"));
+}
+
+TEST(MaterialTest, KnowsTheResultsOfSimpleEndings) {
+    EXPECT_EQ(outcomeOf("4k3/8/8/8/8/8/8/R3K3 w - - 0 1"), Material::Outcome::WHITE_WINS);
+    EXPECT_EQ(outcomeOf("4k3/8/8/8/8/8/8/3qK3 w - - 0 1"), Material::Outcome::BLACK_WINS);
+    EXPECT_EQ(outcomeOf("4k3/8/8/8/8/8/8/1NB1K3 w - - 0 1"), Material::Outcome::WHITE_WINS);
+    EXPECT_EQ(outcomeOf("4k3/8/8/8/8/8/8/1BB1K3 w - - 0 1"), Material::Outcome::WHITE_WINS);
+    EXPECT_EQ(outcomeOf("1r2k3/8/8/8/8/8/8/3QK3 w - - 0 1"), Material::Outcome::WHITE_WINS);
+    EXPECT_EQ(outcomeOf("4k3/8/8/8/8/8/8/NN2K3 w - - 0 1"), Material::Outcome::DRAWN);
+    EXPECT_EQ(outcomeOf("1r2k3/8/8/8/8/8/8/R3K3 w - - 0 1"), Material::Outcome::DRAWN);
+    EXPECT_EQ(outcomeOf("1b2k3/8/8/8/8/8/8/R3K3 w - - 0 1"), Material::Outcome::DRAWN);
+    EXPECT_EQ(outcomeOf("4k3/8/8/8/8/8/4P3/4K3 w - - 0 1"), Material::Outcome::UNKNOWN);
+}
\ No newline at end of file
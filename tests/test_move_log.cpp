@@ -0,0 +1,406 @@
+#include <gtest/gtest.h>
+#include "core/Game.h"
+#include "net/GameServer.h"
+#include "net/MoveLog.h"
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+class MoveLogTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        // One directory per test, as ctest may run them in parallel
+        config.directory = ::testing::TempDir() + "move_log_" +
+                           ::testing::UnitTest::GetInstance()->current_test_info()->name();
+        std::filesystem::remove_all(config.directory);
+    }
+    
+    void TearDown() override {
+        std::filesystem::remove_all(config.directory);
+    }
+    
+    static uint8_t square(const char* name) {
+        return static_cast<uint8_t>((8 - (name[1] - '0')) * 8 + (name[0] - 'a'));
+    }
+    
+    static MoveRecord move(uint32_t session, const char* from, const char* to) {
+        return MoveLog::makeRecord(session, MoveRecord::MOVE, square(from), square(to));
+    }
+    
+    static std::string fenAfter(const std::vector<const char*>& moves) {
+        Game game;
+        for (size_t i = 0; i + 1 < moves.size(); i += 2) {
+            EXPECT_TRUE(game.makeMove(Position(8 - (moves[i][1] - '0'), moves[i][0] - 'a'),
+                                      Position(8 - (moves[i + 1][1] - '0'), moves[i + 1][0] - 'a')));
+        }
+        return game.toFEN();
+    }
+    
+    static std::string fenOf(const RecoveredSession& session) {
+        Game game;
+        EXPECT_TRUE(game.restoreState(session.state));
+        return game.toFEN();
+    }
+    
+    std::vector<std::string> segments() const {
+        std::vector<std::string> names;
+        for (const auto& entry : std::filesystem::directory_iterator(config.directory)) {
+            std::string name = entry.path().filename().string();
+            if (name.rfind("wal-", 0) == 0) names.push_back(name);
+        }
+        std::sort(names.begin(), names.end());
+        return names;
+    }
+    
+    MoveLogConfig config;
+};
+
+TEST_F(MoveLogTest, ReplaysOpenSessionsThroughGame) {
+    std::vector<RecoveredSession> recovered;
+    {
+        MoveLog log(config);
+        ASSERT_TRUE(log.open(recovered));
+        EXPECT_TRUE(recovered.empty());
+        
+        log.append(MoveLog::makeRecord(1, MoveRecord::NEW, 0, 0, 1));
+        log.append(MoveLog::makeRecord(2, MoveRecord::NEW));
+        log.append(move(1, "f2", "f3"));
+        log.append(move(2, "d2", "d4"));
+        log.append(move(1, "e7", "e5"));
+        log.append(move(2, "d7", "d5"));
+        log.append(move(1, "g2", "g4"));
+        log.append(MoveLog::makeRecord(2, MoveRecord::UNDO));
+        log.append(move(1, "d8", "h4"));
+        log.append(MoveLog::makeRecord(3, MoveRecord::NEW));
+        log.append(move(3, "e2", "e4"));
+        uint64_t last = log.append(MoveLog::makeRecord(3, MoveRecord::CLOSE));
+        EXPECT_EQ(last, 11u);
+        EXPECT_TRUE(log.waitDurable(last));
+        EXPECT_GT(log.durableLsn(), last);
+    }
+    
+    MoveLog log(config);
+    ASSERT_TRUE(log.open(recovered));
+    ASSERT_EQ(recovered.size(), 2u);
+    EXPECT_EQ(recovered[0].id, 1u);
+    EXPECT_TRUE(recovered[0].solo);
+    EXPECT_EQ(static_cast<GameStatus>(recovered[0].state.status), GameStatus::CHECKMATE);
+    EXPECT_EQ(fenOf(recovered[0]), fenAfter({"f2", "f3", "e7", "e5", "g2", "g4", "d8", "h4"}));
+    EXPECT_EQ(recovered[1].id, 2u);
+    EXPECT_FALSE(recovered[1].solo);
+    EXPECT_EQ(recovered[1].state.moves.size(), 1u);
+    EXPECT_EQ(fenOf(recovered[1]), fenAfter({"d2", "d4"}));
+    // Numbering carries on after the recovered records
+    EXPECT_EQ(log.append(move(2, "d7", "d5")), 12u);
+}
+
+TEST_F(MoveLogTest, StopsAtATornOrCorruptTail) {
+    std::vector<RecoveredSession> recovered;
+    {
+        MoveLog log(config);
+        ASSERT_TRUE(log.open(recovered));
+        log.append(MoveLog::makeRecord(1, MoveRecord::NEW));
+        log.append(move(1, "e2", "e4"));
+    }
+    ASSERT_EQ(segments().size(), 1u);
+    {
+        // A record with a bad checksum, then half of one
+        MoveRecord bad = move(1, "e7", "e5");
+        bad.checksum = 12345;
+        std::ofstream out(config.directory + "/" + segments().back(), std::ios::binary | std::ios::app);
+        out.write(reinterpret_cast<const char*>(&bad), sizeof(bad));
+        out.write(reinterpret_cast<const char*>(&bad), sizeof(bad) / 2);
+    }
+    {
+        MoveLog log(config);
+        ASSERT_TRUE(log.open(recovered));
+        ASSERT_EQ(recovered.size(), 1u);
+        EXPECT_EQ(fenOf(recovered[0]), fenAfter({"e2", "e4"}));
+        // Later records land in a new segment, past the damage
+        log.append(move(1, "c7", "c5"));
+    }
+    
+    recovered.clear();
+    MoveLog log(config);
+    ASSERT_TRUE(log.open(recovered));
+    ASSERT_EQ(recovered.size(), 1u);
+    EXPECT_EQ(fenOf(recovered[0]), fenAfter({"e2", "e4", "c7", "c5"}));
+}
+
+TEST_F(MoveLogTest, CheckpointsReplaceOlderSegments) {
+    config.checkpointRecords = 4;
+    std::vector<RecoveredSession> recovered;
+    {
+        MoveLog log(config);
+        ASSERT_TRUE(log.open(recovered));
+        Game game;
+        log.append(MoveLog::makeRecord(7, MoveRecord::NEW));
+        log.append(move(7, "e2", "e4"));
+        game.makeMove(Position(6, 4), Position(4, 4));
+        EXPECT_FALSE(log.checkpointDue());
+        log.append(move(7, "e7", "e5"));
+        log.append(MoveLog::makeRecord(8, MoveRecord::NEW));
+        game.makeMove(Position(1, 4), Position(3, 4));
+        EXPECT_TRUE(log.checkpointDue());
+        
+        ASSERT_TRUE(log.beginCheckpoint());
+        EXPECT_FALSE(log.checkpointDue());
+        // A move after the rotation that the collected state already has
+        uint64_t lsn = log.append(move(7, "g1", "f3"));
+        game.makeMove(Position(7, 6), Position(5, 5));
+        Game empty;
+        ASSERT_TRUE(log.writeCheckpoint({{7, false, lsn, game.saveState().serialize()},
+                                         {8, true, MoveLog::NO_LSN, empty.saveState().serialize()}}));
+        EXPECT_EQ(segments().size(), 1u);
+        
+        log.append(move(7, "b8", "c6"));
+        log.append(move(8, "d2", "d4"));
+    }
+    
+    MoveLog log(config);
+    ASSERT_TRUE(log.open(recovered));
+    ASSERT_EQ(recovered.size(), 2u);
+    EXPECT_EQ(fenOf(recovered[0]), fenAfter({"e2", "e4", "e7", "e5", "g1", "f3", "b8", "c6"}));
+    EXPECT_TRUE(recovered[1].solo);
+    EXPECT_EQ(fenOf(recovered[1]), fenAfter({"d2", "d4"}));
+}
+
+TEST_F(MoveLogTest, ReplaysFlagFallAgainstABareKingAsADraw) {
+    std::vector<RecoveredSession> recovered;
+    {
+        MoveLog log(config);
+        ASSERT_TRUE(log.open(recovered));
+        Game bare;
+        ASSERT_TRUE(bare.loadFEN("4k3/8/8/8/8/8/8/3QK3 w - - 0 1"));
+        ASSERT_TRUE(log.beginCheckpoint());
+        ASSERT_TRUE(log.writeCheckpoint({{1, false, MoveLog::NO_LSN, bare.saveState().serialize()}}));
+        log.append(MoveLog::makeRecord(1, MoveRecord::FLAG, 0, 0, static_cast<uint8_t>(PieceColor::WHITE)));
+        log.append(MoveLog::makeRecord(2, MoveRecord::NEW));
+        log.append(move(2, "e2", "e4"));
+        log.append(MoveLog::makeRecord(2, MoveRecord::FLAG, 0, 0, static_cast<uint8_t>(PieceColor::BLACK)));
+    }
+    
+    MoveLog log(config);
+    ASSERT_TRUE(log.open(recovered));
+    ASSERT_EQ(recovered.size(), 2u);
+    EXPECT_EQ(static_cast<GameStatus>(recovered[0].state.status), GameStatus::DRAW);
+    EXPECT_EQ(static_cast<GameStatus>(recovered[1].state.status), GameStatus::TIME_FORFEIT);
+}
+
+TEST_F(MoveLogTest, RecoversTimedSessionsWithTheirClocks) {
+    using std::chrono::milliseconds;
+    using std::chrono::seconds;
+    std::vector<RecoveredSession> recovered;
+    {
+        MoveLog log(config);
+        ASSERT_TRUE(log.open(recovered));
+        Session timed(1, 11, false, Protocol::parseTimeControl("300+2"), &log);
+        timed.join(12);
+        EXPECT_EQ(timed.move(11, *Protocol::parseMove("e2e4")).text, "OK 1 1 ONGOING");
+        EXPECT_EQ(timed.move(12, *Protocol::parseMove("e7e5")).text, "OK 1 2 ONGOING");
+        // The checkpoint carries the clocks; the move after it its own record
+        ASSERT_TRUE(log.beginCheckpoint());
+        ASSERT_TRUE(log.writeCheckpoint({timed.checkpoint()}));
+        EXPECT_EQ(timed.move(11, *Protocol::parseMove("g1f3")).text, "OK 1 3 ONGOING");
+        Session delayed(2, 21, true, Protocol::parseTimeControl("600d300"), &log);
+    }
+    
+    MoveLog log(config);
+    ASSERT_TRUE(log.open(recovered));
+    ASSERT_EQ(recovered.size(), 2u);
+    ASSERT_TRUE(recovered[0].clock);
+    const LoggedClock& clock = *recovered[0].clock;
+    EXPECT_EQ(clock.control.base, seconds(300));
+    EXPECT_EQ(clock.control.increment, seconds(2));
+    EXPECT_GT(clock.remaining[0], milliseconds(303000));
+    EXPECT_LE(clock.remaining[0], milliseconds(304000));
+    EXPECT_GT(clock.remaining[1], milliseconds(301000));
+    EXPECT_LE(clock.remaining[1], milliseconds(302000));
+    ASSERT_TRUE(recovered[1].clock);
+    EXPECT_TRUE(recovered[1].solo);
+    EXPECT_EQ(recovered[1].clock->control.base, seconds(600));
+    EXPECT_EQ(recovered[1].clock->control.delay, seconds(300));
+    EXPECT_EQ(recovered[1].clock->control.increment, seconds(0));
+    
+    // Back in play once both sides are, with black's clock running again
+    Session restored(recovered[0], &log);
+    EXPECT_TRUE(restored.isTimed());
+    restored.join(31);
+    EXPECT_FALSE(restored.flagTime());
+    restored.join(32);
+    EXPECT_TRUE(restored.flagTime());
+    std::string line = restored.clock().text;
+    EXPECT_EQ(line.substr(line.size() - 6), " black");
+    EXPECT_EQ(restored.move(32, *Protocol::parseMove("b8c6")).text, "OK 1 4 ONGOING");
+}
+
+namespace {
+
+int connectTo(int port) {
+    int fd = ::socket(AF_INET, SOCK_STREAM, 0);
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(static_cast<uint16_t>(port));
+    ::inet_pton(AF_INET, "127.0.0.1", &addr.sin_addr);
+    if (::connect(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0) {
+        ::close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+std::string exchange(int fd, const std::string& request, size_t lines) {
+    EXPECT_EQ(::send(fd, request.data(), request.size(), 0), static_cast<ssize_t>(request.size()));
+    std::string received;
+    char buffer[512];
+    while (static_cast<size_t>(std::count(received.begin(), received.end(), '\n')) < lines) {
+        ssize_t n = ::recv(fd, buffer, sizeof(buffer), 0);
+        if (n <= 0) break;
+        received.append(buffer, static_cast<size_t>(n));
+    }
+    return received;
+}
+
+}
+
+TEST_F(MoveLogTest, ServerResumesSessionsAfterRestart) {
+    ServerConfig server;
+    server.host = "127.0.0.1";
+    server.port = 0;
+    server.threads = 1;
+    server.logDirectory = config.directory;
+    {
+        GameServer first(server);
+        ASSERT_TRUE(first.start());
+        int fd = connectTo(first.getPort());
+        ASSERT_GE(fd, 0);
+        EXPECT_EQ(exchange(fd, "NEW solo\nMOVE 1 e2e4\nMOVE 1 e7e5\nNEW\n", 4),
+                  "GAME 1 both\nOK 1 1 ONGOING\nOK 1 2 ONGOING\nGAME 2 white\n");
+        // Shut down with the connection open, as a crash would
+        first.stop();
+        first.wait();
+        ::close(fd);
+    }
+    
+    GameServer second(server);
+    ASSERT_TRUE(second.start());
+    EXPECT_EQ(second.sessionCount(), 2u);
+    int fd = connectTo(second.getPort());
+    ASSERT_GE(fd, 0);
+    std::string fen = fenAfter({"e2", "e4", "e7", "e5"});
+    EXPECT_EQ(exchange(fd, "STATE 1\nJOIN 1\nMOVE 1 g1f3\nJOIN 2\nNEW\n", 5),
+              "STATE 1 WAITING ONGOING " + fen + "\nJOINED 1 both\nOK 1 3 ONGOING\nJOINED 2 white\nGAME 3 white\n");
+    EXPECT_EQ(exchange(fd, "CLOSE 1\n", 1), "CLOSED 1\n");
+    second.stop();
+    second.wait();
+    ::close(fd);
+    
+    std::vector<RecoveredSession> recovered;
+    MoveLog log(config);
+    ASSERT_TRUE(log.open(recovered));
+    ASSERT_EQ(recovered.size(), 2u);
+    EXPECT_EQ(recovered[0].id, 2u);
+    EXPECT_EQ(recovered[1].id, 3u);
+}
+
+TEST_F(MoveLogTest, ServerCheckpointsInTheBackground) {
+    ServerConfig server;
+    server.host = "127.0.0.1";
+    server.port = 0;
+    server.threads = 1;
+    server.logDirectory = config.directory;
+    server.checkpointRecords = 3;
+    GameServer running(server);
+    ASSERT_TRUE(running.start());
+    std::vector<std::string> before = segments();
+    int fd = connectTo(running.getPort());
+    ASSERT_GE(fd, 0);
+    EXPECT_EQ(exchange(fd, "NEW solo\nMOVE 1 e2e4\nMOVE 1 e7e5\n", 3),
+              "GAME 1 both\nOK 1 1 ONGOING\nOK 1 2 ONGOING\n");
+    // The checkpoint rotates to a fresh segment and drops the old one
+    for (int i = 0; i < 50 && (segments() == before || segments().size() != 1); ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    }
+    EXPECT_NE(segments(), before);
+    EXPECT_EQ(segments().size(), 1u);
+    running.stop();
+    running.wait();
+    ::close(fd);
+    
+    std::vector<RecoveredSession> recovered;
+    MoveLog log(config);
+    ASSERT_TRUE(log.open(recovered));
+    ASSERT_EQ(recovered.size(), 1u);
+    EXPECT_EQ(fenOf(recovered[0]), fenAfter({"e2", "e4", "e7", "e5"}));
+}
+
+TEST_F(MoveLogTest, ServerHoldsMoveRepliesUntilDurable) {
+    ServerConfig server;
+    server.host = "127.0.0.1";
+    server.port = 0;
+    server.threads = 1;
+    server.logDirectory = config.directory;
+    server.commitMicros = 300000;
+    for (bool durable : {true, false}) {
+        std::filesystem::remove_all(config.directory);
+        server.durableReplies = durable;
+        GameServer running(server);
+        ASSERT_TRUE(running.start());
+        int white = connectTo(running.getPort());
+        int black = connectTo(running.getPort());
+        ASSERT_GE(white, 0);
+        ASSERT_GE(black, 0);
+        EXPECT_EQ(exchange(white, "NEW\n", 1), "GAME 1 white\n");
+        EXPECT_EQ(exchange(black, "JOIN 1\n", 1), "JOINED 1 black\n");
+        EXPECT_EQ(exchange(white, "", 1), "JOINED 1 black\n");
+        // Past the commit window of those records, so the move opens its own
+        std::this_thread::sleep_for(std::chrono::milliseconds(400));
+        
+        // The PING behind the move must not overtake its reply
+        auto sent = std::chrono::steady_clock::now();
+        EXPECT_EQ(exchange(white, "MOVE 1 e2e4\nPING\n", 2), "OK 1 1 ONGOING\nPONG\n");
+        auto waited = std::chrono::steady_clock::now() - sent;
+        EXPECT_EQ(exchange(black, "", 1), "MOVED 1 e2e4 ONGOING\n");
+        if (durable) {
+            EXPECT_GE(waited, std::chrono::milliseconds(250));
+        } else {
+            EXPECT_LT(waited, std::chrono::milliseconds(250));
+        }
+        running.stop();
+        running.wait();
+        ::close(white);
+        ::close(black);
+    }
+}
+
+TEST_F(MoveLogTest, ServerDropsMovesOnceTheLogFails) {
+    ServerConfig server;
+    server.host = "127.0.0.1";
+    server.port = 0;
+    server.threads = 1;
+    server.logDirectory = config.directory;
+    server.checkpointRecords = 3;
+    GameServer running(server);
+    ASSERT_TRUE(running.start());
+    int fd = connectTo(running.getPort());
+    ASSERT_GE(fd, 0);
+    
+    // Without its directory the next checkpoint cannot rotate, which fails the log
+    std::filesystem::remove_all(config.directory);
+    EXPECT_EQ(exchange(fd, "NEW solo\nMOVE 1 e2e4\nMOVE 1 e7e5\n", 3),
+              "GAME 1 both\nOK 1 1 ONGOING\nOK 1 2 ONGOING\n");
+    std::this_thread::sleep_for(std::chrono::milliseconds(2500));
+    EXPECT_EQ(exchange(fd, "PING\n", 1), "PONG\n");
+    EXPECT_EQ(exchange(fd, "MOVE 1 g1f3\n", 1), "");
+    running.stop();
+    running.wait();
+    ::close(fd);
+}
\ No newline at end of file
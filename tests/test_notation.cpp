@@ -0,0 +1,133 @@
+#include <gtest/gtest.h>
+#include "core/Game.h"
+#include "core/Notation.h"
+#include <string>
+#include <vector>
+
+namespace {
+
+std::string sanOf(const char* fen, const char* from, const char* to, PieceType promotion = PieceType::QUEEN) {
+    Game game;
+    EXPECT_TRUE(game.loadFEN(fen)) << fen;
+    auto square = [](const char* s) { return Position('8' - s[1], s[0] - 'a'); };
+    return Notation::toSAN(game.getBoard(), square(from), square(to), promotion);
+}
+
+}
+
+TEST(NotationTest, EncodesPieceMovesCapturesAndCastling) {
+    const char* start = "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1";
+    EXPECT_EQ(sanOf(start, "e2", "e4"), "e4");
+    EXPECT_EQ(sanOf(start, "g1", "f3"), "Nf3");
+    EXPECT_EQ(sanOf("rnbqkbnr/ppp1pppp/8/3p4/4P3/8/PPPP1PPP/RNBQKBNR w KQkq d6 0 2", "e4", "d5"), "exd5");
+    EXPECT_EQ(sanOf("rnbqkbnr/ppp1p1pp/8/3pPp2/8/8/PPPP1PPP/RNBQKBNR w KQkq f6 0 3", "e5", "f6"), "exf6");
+    EXPECT_EQ(sanOf("r3k2r/8/8/8/8/8/8/R3K2R w KQkq - 0 1", "e1", "g1"), "O-O");
+    EXPECT_EQ(sanOf("r3k2r/8/8/8/8/8/8/R3K2R w KQkq - 0 1", "e1", "c1"), "O-O-O");
+}
+
+TEST(NotationTest, DisambiguatesByFileThenRankThenSquare) {
+    EXPECT_EQ(sanOf("4k3/8/8/8/8/8/8/R4RK1 w - - 0 1", "a1", "d1"), "Rad1");
+    EXPECT_EQ(sanOf("4k3/8/8/8/8/8/8/R4RK1 w - - 0 1", "f1", "d1"), "Rfd1");
+    EXPECT_EQ(sanOf("4k3/8/8/R7/8/8/8/R3K3 w - - 0 1", "a1", "a3"), "R1a3");
+    EXPECT_EQ(sanOf("8/7k/8/8/8/Q7/8/Q1Q3K1 w - - 0 1", "a1", "b2"), "Qa1b2");
+    // A pinned knight cannot reach the square, so no disambiguation
+    EXPECT_EQ(sanOf("4k3/4r3/8/8/8/8/4N3/2N1K3 w - - 0 1", "c1", "d3"), "Nd3");
+}
+
+TEST(NotationTest, MarksPromotionCheckAndMate) {
+    EXPECT_EQ(sanOf("8/4P3/8/8/8/8/k7/4K3 w - - 0 1", "e7", "e8"), "e8=Q");
+    EXPECT_EQ(sanOf("3r4/4P3/8/8/8/8/k7/4K3 w - - 0 1", "e7", "d8", PieceType::KNIGHT), "exd8=N");
+    EXPECT_EQ(sanOf("4k3/8/8/8/8/8/8/R3K3 w - - 0 1", "a1", "a8"), "Ra8+");
+    EXPECT_EQ(sanOf("rnbqkbnr/pppp1ppp/8/4p3/6P1/5P2/PPPPP2P/RNBQKBNR b KQkq - 0 2", "d8", "h4"), "Qh4#");
+    // En passant uncovers the rook; the castled rook checks, or mates
+    EXPECT_EQ(sanOf("4k3/8/8/3pP3/8/8/8/4R1K1 w - d6 0 1", "e5", "d6"), "exd6+");
+    EXPECT_EQ(sanOf("5k2/8/8/8/8/8/8/4K2R w K - 0 1", "e1", "g1"), "O-O+");
+    EXPECT_EQ(sanOf("4rkr1/4p1p1/8/8/8/8/8/4K2R w K - 0 1", "e1", "g1"), "O-O#");
+}
+
+TEST(NotationTest, DecodesEveryLegalMoveBack) {
+    const char* positions[] = {
+        "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1",
+        "8/7k/8/8/8/Q7/8/Q1Q3K1 w - - 0 1",
+        "3r4/4P3/8/8/8/8/k7/4K3 w - - 0 1",
+        "rnbqkbnr/ppp1p1pp/8/3pPp2/8/8/PPPP1PPP/RNBQKBNR w KQkq f6 0 3",
+    };
+    for (const char* fen : positions) {
+        Game game;
+        ASSERT_TRUE(game.loadFEN(fen));
+        const Board& board = game.getBoard();
+        for (int sq = 0; sq < 64; ++sq) {
+            Position from(sq / 8, sq % 8);
+            for (const auto& to : game.getValidMoves(from)) {
+                std::string san = Notation::toSAN(board, from, to);
+                auto move = Notation::fromSAN(board, game.getCurrentPlayer(), san);
+                ASSERT_TRUE(move.has_value()) << fen << " " << san;
+                EXPECT_EQ(move->getFrom(), from) << san;
+                EXPECT_EQ(move->getTo(), to) << san;
+            }
+        }
+    }
+}
+
+TEST(NotationTest, RejectsAmbiguousAndIllegalSAN) {
+    Game game;
+    ASSERT_TRUE(game.loadFEN("4k3/8/8/8/8/8/8/R4RK1 w - - 0 1"));
+    const Board& board = game.getBoard();
+    EXPECT_FALSE(Notation::fromSAN(board, PieceColor::WHITE, "Rd1").has_value());
+    EXPECT_TRUE(Notation::fromSAN(board, PieceColor::WHITE, "Rfd1").has_value());
+    EXPECT_FALSE(Notation::fromSAN(board, PieceColor::WHITE, "Rxd1").has_value());
+    EXPECT_FALSE(Notation::fromSAN(board, PieceColor::WHITE, "Nf3").has_value());
+    EXPECT_FALSE(Notation::fromSAN(board, PieceColor::WHITE, "O-O").has_value());
+    EXPECT_FALSE(Notation::fromSAN(board, PieceColor::WHITE, "Rz9").has_value());
+    EXPECT_FALSE(Notation::fromSAN(board, PieceColor::WHITE, "").has_value());
+}
+
+TEST(NotationTest, PlaysAndExportsWholeGames) {
+    Game game;
+    size_t played = Notation::playSAN(game, "1. e4 e5 2. Bc4 {Italian} Nc6 3.Qh5 Nf6?? 4. Qxf7# 1-0");
+    EXPECT_EQ(played, 7u);
+    EXPECT_EQ(game.getGameStatus(), GameStatus::CHECKMATE);
+    
+    std::vector<std::string> expected = {"e4", "e5", "Bc4", "Nc6", "Qh5", "Nf6", "Qxf7#"};
+    EXPECT_EQ(Notation::historyToSAN(game), expected);
+    
+    Game partial;
+    EXPECT_EQ(Notation::playSAN(partial, "1. e4 e5 2. Ke3"), 2u);
+}
+
+TEST(NotationTest, ExportsGamesStartedFromFEN) {
+    Game game;
+    ASSERT_TRUE(game.loadFEN("r3k2r/8/8/8/8/8/8/R3K2R b KQkq - 0 1"));
+    EXPECT_EQ(Notation::playSAN(game, "1... O-O-O 2. O-O Rh7"), 3u);
+    
+    std::vector<std::string> expected = {"O-O-O", "O-O", "Rh7"};
+    EXPECT_EQ(Notation::historyToSAN(game), expected);
+}
+
+TEST(NotationTest, ExportsGamesRestoredWithoutTheirStart) {
+    Game game;
+    const char* line = "1. e4 d5 2. e5 f5 3. exf6 Nxf6 4. Nf3 e6 5. Bb5+ c6 6. O-O Bd6 7. Nc3 O-O 8. Re1 Nbd7";
+    ASSERT_EQ(Notation::playSAN(game, line), 16u);
+    std::vector<std::string> expected = {"e4", "d5", "e5", "f5", "exf6", "Nxf6", "Nf3", "e6",
+                                         "Bb5+", "c6", "O-O", "Bd6", "Nc3", "O-O", "Re1", "Nbd7"};
+    ASSERT_EQ(Notation::historyToSAN(game), expected);
+    
+    GameState state = game.saveState();
+    state.start.reset();
+    Game restored;
+    ASSERT_TRUE(restored.restoreState(state));
+    ASSERT_EQ(restored.getFirstPly(), 16u);
+    EXPECT_EQ(Notation::historyToSAN(restored), expected);
+    
+    EXPECT_EQ(Notation::playSAN(restored, "9. d4"), 1u);
+    expected.push_back("d4");
+    EXPECT_EQ(Notation::historyToSAN(restored), expected);
+    
+    Game promotion;
+    ASSERT_TRUE(promotion.loadFEN("2r1k3/1P6/8/8/8/8/8/4K3 w - - 0 1"));
+    EXPECT_EQ(Notation::playSAN(promotion, "1. bxc8=Q+ Ke7"), 2u);
+    state = promotion.saveState();
+    state.start.reset();
+    ASSERT_TRUE(restored.restoreState(state));
+    EXPECT_EQ(Notation::historyToSAN(restored), (std::vector<std::string>{"bxc8=Q+", "Ke7"}));
+}
\ No newline at end of file
@@ -0,0 +1,161 @@
+#include <gtest/gtest.h>
+#include "core/Game.h"
+#include "core/MCTSPlayer.h"
+#include "core/Player.h"
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <unistd.h>
+
+using namespace std::chrono_literals;
+
+namespace {
+
+// Thinks until the request is cancelled, then answers anyway
+class StallingPlayer : public ComputerPlayer {
+public:
+    StallingPlayer() : ComputerPlayer("Staller", PieceColor::WHITE, 1) {}
+    ~StallingPlayer() override { stopWorker(); }
+    
+    std::atomic<bool> sawCancel{false};
+    
+protected:
+    Move chooseMove(const Board& board, const MoveRequest& request) override {
+        while (!request.isCancelled()) {
+            std::this_thread::sleep_for(1ms);
+        }
+        sawCancel = true;
+        return ComputerPlayer::chooseMove(board, request);
+    }
+};
+
+}
+
+TEST(PlayerTest, RequestMoveResolvesWithLegalMove) {
+    Game game;
+    ComputerPlayer player("Random", PieceColor::WHITE, 3);
+    
+    auto request = player.requestMove(game.getBoard());
+    auto move = request->wait();
+    ASSERT_TRUE(move.has_value());
+    EXPECT_TRUE(request->isDone());
+    EXPECT_TRUE(game.makeMove(*move));
+}
+
+TEST(PlayerTest, GetMoveWrapsRequest) {
+    Game game;
+    ComputerPlayer player("Random", PieceColor::WHITE, 3);
+    EXPECT_TRUE(game.makeMove(player.getMove(game.getBoard())));
+}
+
+TEST(PlayerTest, CancelResolvesEmpty) {
+    Game game;
+    StallingPlayer player;
+    
+    auto request = player.requestMove(game.getBoard());
+    EXPECT_FALSE(request->waitUntil(MoveRequest::Clock::now() + 5ms).has_value());
+    EXPECT_FALSE(request->isDone());
+    
+    request->cancel();
+    EXPECT_TRUE(request->isDone());
+    EXPECT_FALSE(request->wait().has_value());
+}
+
+TEST(PlayerTest, DeadlineResolvesEmptyAndStopsSearch) {
+    Game game;
+    StallingPlayer player;
+    
+    auto start = MoveRequest::Clock::now();
+    auto request = player.requestMove(game.getBoard(), start + 20ms);
+    EXPECT_FALSE(request->wait().has_value());
+    EXPECT_GE(MoveRequest::Clock::now() - start, 20ms);
+    
+    // A new request retires the old worker, which has seen the deadline
+    auto next = player.requestMove(game.getBoard(), MoveRequest::Clock::now() + 1ms);
+    EXPECT_TRUE(player.sawCancel);
+    EXPECT_FALSE(next->wait().has_value());
+}
+
+TEST(PlayerTest, NewRequestCancelsPrevious) {
+    Game game;
+    StallingPlayer player;
+    
+    auto first = player.requestMove(game.getBoard());
+    auto second = player.requestMove(game.getBoard());
+    EXPECT_TRUE(first->isCancelled());
+    EXPECT_FALSE(first->wait().has_value());
+    EXPECT_FALSE(second->isDone());
+    second->cancel();
+}
+
+TEST(PlayerTest, HumanReadsEveryPipedLine) {
+    // Both moves arrive in one read, so the second is already buffered when
+    // the second request starts and poll would see nothing left on the pipe
+    int fds[2];
+    ASSERT_EQ(::pipe(fds), 0);
+    int savedStdin = ::dup(STDIN_FILENO);
+    ASSERT_EQ(::dup2(fds[0], STDIN_FILENO), STDIN_FILENO);
+    ::close(fds[0]);
+    const char input[] = "e2e4\nd2d4\n";
+    ASSERT_EQ(::write(fds[1], input, sizeof(input) - 1), static_cast<ssize_t>(sizeof(input) - 1));
+    
+    Game game;
+    HumanPlayer player("Human", PieceColor::WHITE);
+    auto first = player.requestMove(game.getBoard(), MoveRequest::Clock::now() + 2s)->wait();
+    auto second = player.requestMove(game.getBoard(), MoveRequest::Clock::now() + 2s)->wait();
+    
+    ::close(fds[1]);
+    ::dup2(savedStdin, STDIN_FILENO);
+    ::close(savedStdin);
+    ASSERT_TRUE(first.has_value());
+    EXPECT_EQ(first->getTo(), Position(4, 4));
+    ASSERT_TRUE(second.has_value());
+    EXPECT_EQ(second->getTo(), Position(4, 3));
+}
+
+TEST(MCTSPlayerTest, FindsBackRankMate) {
+    Game game;
+    ASSERT_TRUE(game.loadFEN("6k1/5ppp/8/8/8/8/8/R5K1 w - - 0 1"));
+    MCTSConfig config;
+    config.threads = 2;
+    config.budget = 300ms;
+    MCTSPlayer player("MCTS", PieceColor::WHITE, config, 5);
+    
+    Move move = player.getMove(game.getBoard());
+    EXPECT_EQ(move.getFrom(), Position(7, 0));
+    EXPECT_EQ(move.getTo(), Position(0, 0));
+    ASSERT_TRUE(game.makeMove(move));
+    EXPECT_EQ(game.getGameStatus(), GameStatus::CHECKMATE);
+    
+    MCTSStats stats = player.getLastSearchStats();
+    EXPECT_GT(stats.iterations, 0u);
+    EXPECT_GT(stats.nodes, 1u);
+    EXPECT_LT(stats.seconds, 1.0);
+}
+
+TEST(MCTSPlayerTest, KeepsSearchingWhenArenaIsFull) {
+    Game game;
+    MCTSConfig config;
+    config.budget = 50ms;
+    config.maxNodes = 8;  // Too small even for the root's 20 children
+    MCTSPlayer player("MCTS", PieceColor::WHITE, config, 5);
+    
+    EXPECT_TRUE(game.makeMove(player.getMove(game.getBoard())));
+    EXPECT_EQ(player.getLastSearchStats().nodes, 8u);
+    EXPECT_GT(player.getLastSearchStats().iterations, 0u);
+}
+
+TEST(MCTSPlayerTest, StopsAtRequestDeadline) {
+    Game game;
+    MCTSConfig config;
+    config.threads = 2;
+    config.budget = 10s;
+    MCTSPlayer player("MCTS", PieceColor::WHITE, config, 5);
+    
+    auto start = MoveRequest::Clock::now();
+    auto request = player.requestMove(game.getBoard(), start + 100ms);
+    auto move = request->wait();
+    ASSERT_TRUE(move.has_value());
+    EXPECT_TRUE(game.makeMove(*move));
+    EXPECT_LT(MoveRequest::Clock::now() - start, 1s);
+}
\ No newline at end of file
@@ -0,0 +1,174 @@
+#include <gtest/gtest.h>
+#include "core/Game.h"
+#include "core/PolyglotBook.h"
+#include "core/Zobrist.h"
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <vector>
+
+class PolyglotBookTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        path = ::testing::TempDir() + "polyglot_test.bin";
+        tablePath = ::testing::TempDir() + "polyglot_random64.bin";
+        startKey = Zobrist::hash(game.getBoard(), PieceColor::WHITE);
+    }
+    
+    void TearDown() override {
+        std::remove(path.c_str());
+        std::remove(tablePath.c_str());
+    }
+    
+    void writeBook(std::vector<BookEntry> entries) {
+        std::sort(entries.begin(), entries.end(), [](const BookEntry& a, const BookEntry& b) {
+            return a.key < b.key;
+        });
+        std::ofstream out(path, std::ios::binary);
+        for (const auto& entry : entries) {
+            unsigned char bytes[PolyglotBook::ENTRY_SIZE];
+            PolyglotBook::writeEntry(bytes, entry);
+            out.write(reinterpret_cast<const char*>(bytes), sizeof(bytes));
+        }
+    }
+    
+    // The keys in use, read back in Random64 file order
+    static std::vector<uint64_t> currentTable() {
+        const PieceType types[6] = {PieceType::PAWN, PieceType::KNIGHT, PieceType::BISHOP,
+                                    PieceType::ROOK, PieceType::QUEEN, PieceType::KING};
+        std::vector<uint64_t> table;
+        for (int kind = 0; kind < 12; ++kind) {
+            PieceColor color = (kind % 2) ? PieceColor::WHITE : PieceColor::BLACK;
+            for (int square = 0; square < 64; ++square) {
+                table.push_back(Zobrist::pieceKey(types[kind / 2], color, Position(7 - square / 8, square % 8)));
+            }
+        }
+        for (int i = 0; i < 4; ++i) table.push_back(Zobrist::castleKey(i));
+        for (int file = 0; file < 8; ++file) table.push_back(Zobrist::enPassantKey(file));
+        table.push_back(Zobrist::turnKey());
+        return table;
+    }
+    
+    void writeTable(const std::vector<uint64_t>& table) {
+        std::ofstream out(tablePath, std::ios::binary);
+        for (uint64_t value : table) {
+            for (int shift = 56; shift >= 0; shift -= 8) out.put(static_cast<char>(value >> shift));
+        }
+    }
+    
+    Game game;
+    std::string path;
+    std::string tablePath;
+    uint64_t startKey = 0;
+};
+
+TEST_F(PolyglotBookTest, KeysFollowRandom64Layout) {
+    std::vector<uint64_t> saved = currentTable();
+    ASSERT_EQ(saved.size(), static_cast<size_t>(Zobrist::RANDOM_COUNT));
+    std::vector<uint64_t> table(Zobrist::RANDOM_COUNT);
+    for (size_t i = 0; i < table.size(); ++i) table[i] = 0x9E3779B97F4A7C15ULL * (i + 1);
+    writeTable(table);
+    ASSERT_TRUE(Zobrist::loadRandomTable(tablePath));
+    
+    // Squares count from a1; kinds run black pawn, white pawn, black knight...
+    const int backRank[8] = {6, 2, 4, 8, 10, 4, 2, 6};
+    uint64_t expected = table[768] ^ table[769] ^ table[770] ^ table[771] ^ table[780];
+    for (int file = 0; file < 8; ++file) {
+        expected ^= table[64 * (backRank[file] + 1) + file];
+        expected ^= table[64 + 8 + file];
+        expected ^= table[48 + file];
+        expected ^= table[64 * backRank[file] + 56 + file];
+    }
+    uint64_t start = Zobrist::hash(game.getBoard(), PieceColor::WHITE);
+    game.makeMove(Position(6, 4), Position(4, 4));
+    uint64_t afterE4 = Zobrist::hash(game.getBoard(), PieceColor::BLACK);
+    
+    writeTable(saved);
+    ASSERT_TRUE(Zobrist::loadRandomTable(tablePath));
+    EXPECT_EQ(start, expected);
+    EXPECT_EQ(afterE4, expected ^ table[780] ^ table[64 + 12] ^ table[64 + 28]);
+}
+
+// The keys published with the Polyglot book format
+TEST_F(PolyglotBookTest, StandardTableGivesPublishedStartKey) {
+    EXPECT_EQ(startKey, 0x463B96181691FC9CULL);
+    
+    const struct {
+        Position from, to;
+        uint64_t key;
+    } line[] = {
+        {Position(6, 4), Position(4, 4), 0x823C9B50FD114196ULL},   // e2-e4
+        {Position(1, 3), Position(3, 3), 0x0756B94461C50FB0ULL},   // d7-d5
+        {Position(4, 4), Position(3, 4), 0x662FAFB965DB29D4ULL},   // e4-e5
+        {Position(1, 5), Position(3, 5), 0x22A48B5A8E47FF78ULL},   // f7-f5, en passant on
+        {Position(7, 4), Position(6, 4), 0x652A607CA3F242C1ULL},   // Ke1-e2
+        {Position(0, 4), Position(1, 5), 0x00FDD303C946BDD9ULL},   // Ke8-f7
+    };
+    for (const auto& step : line) {
+        ASSERT_TRUE(game.makeMove(step.from, step.to));
+        EXPECT_EQ(Zobrist::hash(game.getBoard(), game.getCurrentPlayer()), step.key);
+    }
+}
+
+TEST_F(PolyglotBookTest, TranspositionsShareKey) {
+    game.makeMove(Position(7, 6), Position(5, 5));  // Ng1-f3
+    game.makeMove(Position(0, 6), Position(2, 5));  // Ng8-f6
+    EXPECT_NE(Zobrist::hash(game.getBoard(), game.getCurrentPlayer()), startKey);
+    
+    game.makeMove(Position(5, 5), Position(7, 6));
+    game.makeMove(Position(2, 5), Position(0, 6));
+    EXPECT_EQ(Zobrist::hash(game.getBoard(), game.getCurrentPlayer()), startKey);
+}
+
+TEST_F(PolyglotBookTest, EnPassantOnlyHashedWhenCapturable) {
+    game.makeMove(Position(6, 4), Position(4, 4));  // e2-e4, no black pawn next to e4
+    Board withoutTarget(game.getBoard());
+    withoutTarget.clearEnPassantTarget();
+    EXPECT_EQ(Zobrist::hash(game.getBoard(), PieceColor::BLACK), Zobrist::hash(withoutTarget, PieceColor::BLACK));
+}
+
+TEST_F(PolyglotBookTest, LookupFindsAllEntriesForKey) {
+    uint16_t e2e4 = PolyglotBook::encodeMove(Position(6, 4), Position(4, 4), std::nullopt);
+    uint16_t d2d4 = PolyglotBook::encodeMove(Position(6, 3), Position(4, 3), std::nullopt);
+    writeBook({{startKey, e2e4, 10, 0}, {startKey, d2d4, 5, 0},
+               {startKey - 1, e2e4, 1, 0}, {startKey + 1, d2d4, 1, 0}});
+    
+    PolyglotBook book(path);
+    ASSERT_TRUE(book.isOpen());
+    EXPECT_EQ(book.size(), 4u);
+    
+    auto moves = book.lookup(game.getBoard(), PieceColor::WHITE);
+    ASSERT_EQ(moves.size(), 2u);
+    
+    std::mt19937 rng(1);
+    auto best = book.pickMove(game.getBoard(), PieceColor::WHITE, BookSelection::BEST, rng);
+    ASSERT_TRUE(best);
+    EXPECT_EQ(best->from, Position(6, 4));
+    EXPECT_EQ(best->to, Position(4, 4));
+    
+    EXPECT_TRUE(book.lookup(game.getBoard(), PieceColor::BLACK).empty());
+}
+
+TEST_F(PolyglotBookTest, CastlingDecodedAsKingMove) {
+    Board board;
+    board.removePiece(Position(7, 5));
+    board.removePiece(Position(7, 6));
+    
+    uint16_t e1h1 = PolyglotBook::encodeMove(Position(7, 4), Position(7, 7), std::nullopt);
+    BookMove move = PolyglotBook::decodeMove(e1h1, 1, board);
+    EXPECT_EQ(move.to, Position(7, 6));
+    EXPECT_FALSE(move.isPromotion);
+}
+
+TEST_F(PolyglotBookTest, ComputerPlayerUsesBook) {
+    uint16_t d2d4 = PolyglotBook::encodeMove(Position(6, 3), Position(4, 3), std::nullopt);
+    writeBook({{startKey, d2d4, 1, 0}});
+    
+    ComputerPlayer player("Book", PieceColor::WHITE, 7);
+    player.setOpeningBook(std::make_shared<PolyglotBook>(path));
+    
+    Move move = player.getMove(game.getBoard());
+    EXPECT_EQ(move.getFrom(), Position(6, 3));
+    EXPECT_EQ(move.getTo(), Position(4, 3));
+    EXPECT_TRUE(game.makeMove(move));
+}
\ No newline at end of file
@@ -0,0 +1,149 @@
+#include <gtest/gtest.h>
+#include "core/Game.h"
+#include "core/PositionBatch.h"
+#include <random>
+
+namespace {
+
+// Positions from seeded random games plus hand-picked ones for the corner
+// cases of move legality
+std::vector<PositionSnapshot> samplePositions() {
+    std::vector<PositionSnapshot> positions;
+    std::mt19937 rng(2024);
+    for (int g = 0; g < 12; ++g) {
+        Game game;
+        positions.push_back(game.snapshot());
+        for (int ply = 0; ply < 160 && !game.isGameOver(); ++ply) {
+            std::vector<std::pair<Position, Position>> moves;
+            for (const auto& from : game.getBoard().getAllPiecesPositions(game.getCurrentPlayer())) {
+                for (const auto& to : game.getValidMoves(from)) moves.emplace_back(from, to);
+            }
+            const auto& [from, to] = moves[rng() % moves.size()];
+            game.makeMove(from, to);
+            positions.push_back(game.snapshot());
+        }
+    }
+    
+    const char* fens[] = {
+        "r3k2r/8/8/8/8/8/8/R3K2R w KQkq - 0 1",
+        "r3k2r/8/8/8/8/8/4p3/R3K2R w KQkq - 0 1",       // Pawn on e2 "attacks" f1 only by Board's rules
+        "r3k2r/8/8/8/8/8/5p2/R3K2R w KQkq - 0 1",       // Pawn advance onto f1 blocks castling
+        "r3k2r/8/8/8/8/5n2/8/R3K2R w KQkq - 0 1",       // Check from a knight
+        "r3k2r/8/8/8/1b6/8/8/R3K2R w KQkq - 0 1",       // Check from a bishop
+        "4k3/8/8/KPp4r/8/8/8/8 w - c6 0 1",             // En passant along a pinned rank
+        "4k3/8/8/3pP3/4K3/8/8/8 w - d6 0 1",            // En passant against a checking pawn
+        "8/2P5/8/8/8/8/4k1p1/K7 b - - 0 1",             // Promotions count once
+        "4k3/8/8/8/8/8/4r3/r3K3 w - - 0 1",             // Double check
+        "4k3/4r3/8/8/8/8/4B3/4K3 w - - 0 1",            // Pinned bishop
+        "4k3/8/8/8/8/2q5/3N4/4K3 w - - 0 1",            // Pinned knight
+    };
+    for (const char* fen : fens) {
+        Game game;
+        EXPECT_TRUE(game.loadFEN(fen)) << fen;
+        positions.push_back(game.snapshot());
+    }
+    return positions;
+}
+
+std::vector<PositionBatch::Kernel> kernels() {
+    std::vector<PositionBatch::Kernel> available = {PositionBatch::Kernel::SCALAR};
+    if (PositionBatch::hasAvx2()) available.push_back(PositionBatch::Kernel::AVX2);
+    return available;
+}
+
+}
+
+TEST(PositionBatchTest, MatchesSnapshotsAndGameOnEveryPosition) {
+    std::vector<PositionSnapshot> positions = samplePositions();
+    // Not a multiple of the group size, so the padding lanes are exercised
+    if (positions.size() % PositionBatch::GROUP == 0) positions.pop_back();
+    ASSERT_NE(positions.size() % PositionBatch::GROUP, 0u);
+    
+    std::vector<uint64_t> whiteAttacks, blackAttacks;
+    std::vector<uint16_t> moveCounts;
+    std::vector<uint8_t> checks;
+    std::vector<int16_t> balances;
+    for (const auto& position : positions) {
+        uint64_t white = 0, black = 0;
+        int balance = 0;
+        for (int sq = 0; sq < 64; ++sq) {
+            if (position.isAttacked(sq, PieceColor::WHITE)) white |= uint64_t{1} << sq;
+            if (position.isAttacked(sq, PieceColor::BLACK)) black |= uint64_t{1} << sq;
+            static const int values[7] = {0, 1, 5, 3, 3, 9, 0};
+            uint8_t code = position.squares[sq];
+            balance += PositionSnapshot::isColor(code, PieceColor::WHITE) ? values[code & 7] : -values[code & 7];
+        }
+        whiteAttacks.push_back(white);
+        blackAttacks.push_back(black);
+        balances.push_back(static_cast<int16_t>(balance));
+        checks.push_back(position.isInCheck(position.side()) ? 1 : 0);
+        
+        Game game;
+        game.restoreSnapshot(position);
+        int count = 0;
+        for (int sq = 0; sq < 64; ++sq) count += __builtin_popcountll(game.getLegalTargets(Position(sq / 8, sq % 8)));
+        moveCounts.push_back(static_cast<uint16_t>(count));
+    }
+    
+    PositionBatch batch;
+    batch.reserve(positions.size());
+    for (const auto& position : positions) batch.add(position);
+    ASSERT_EQ(batch.size(), positions.size());
+    
+    for (PositionBatch::Kernel kernel : kernels()) {
+        ASSERT_TRUE(batch.setKernel(kernel));
+        std::vector<uint64_t> attacks;
+        batch.attackMaps(PieceColor::WHITE, attacks);
+        EXPECT_EQ(attacks, whiteAttacks);
+        batch.attackMaps(PieceColor::BLACK, attacks);
+        EXPECT_EQ(attacks, blackAttacks);
+        
+        std::vector<uint8_t> inCheck;
+        batch.inCheck(inCheck);
+        EXPECT_EQ(inCheck, checks);
+        
+        std::vector<int16_t> material;
+        batch.materialBalance(material);
+        EXPECT_EQ(material, balances);
+        
+        std::vector<uint16_t> counts;
+        batch.legalMoveCounts(counts);
+        ASSERT_EQ(counts.size(), moveCounts.size());
+        for (size_t i = 0; i < counts.size(); ++i) {
+            EXPECT_EQ(counts[i], moveCounts[i]) << "position " << i << " kernel " << static_cast<int>(kernel);
+        }
+    }
+}
+
+TEST(PositionBatchTest, SnapshotLegalTargetsMatchGame) {
+    for (const auto& position : samplePositions()) {
+        Game game;
+        ASSERT_TRUE(game.restoreSnapshot(position));
+        PieceColor side = position.side();
+        for (int sq = 0; sq < 64; ++sq) {
+            if (!PositionSnapshot::isColor(position.squares[sq], side)) continue;
+            EXPECT_EQ(position.legalTargets(sq), game.getLegalTargets(Position(sq / 8, sq % 8)))
+                << game.toFEN() << " square " << sq;
+        }
+        EXPECT_EQ(position.hasLegalMove(side), game.hasLegalMoves()) << game.toFEN();
+    }
+}
+
+TEST(PositionBatchTest, ClearsAndRefillsWithoutStaleLanes) {
+    PositionBatch batch;
+    for (int i = 0; i < 5; ++i) batch.add(PositionSnapshot::initial());
+    batch.clear();
+    EXPECT_EQ(batch.size(), 0u);
+    
+    Game game;
+    ASSERT_TRUE(game.loadFEN("4k3/8/8/8/8/8/8/4K3 w - - 0 1"));
+    batch.add(game.snapshot());
+    std::vector<uint16_t> counts;
+    batch.legalMoveCounts(counts);
+    ASSERT_EQ(counts.size(), 1u);
+    EXPECT_EQ(counts[0], 5);
+    
+    std::vector<int16_t> material;
+    batch.materialBalance(material);
+    EXPECT_EQ(material, std::vector<int16_t>{0});
+}
\ No newline at end of file
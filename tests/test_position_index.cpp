@@ -0,0 +1,107 @@
+#include <gtest/gtest.h>
+#include "core/Game.h"
+#include "core/Notation.h"
+#include "core/PositionIndex.h"
+#include "core/Zobrist.h"
+#include <cstdio>
+#include <string>
+#include <vector>
+
+class PositionIndexTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        path = ::testing::TempDir() + "position_index_test.pidx";
+    }
+    
+    void TearDown() override {
+        std::remove(path.c_str());
+    }
+    
+    static uint64_t keyAfter(const char* moves) {
+        Game game;
+        EXPECT_EQ(Notation::playSAN(game, moves) > 0, moves[0] != '\0');
+        return Zobrist::hash(game.getBoard(), game.getCurrentPlayer());
+    }
+    
+    std::string path;
+};
+
+TEST_F(PositionIndexTest, FindsEveryGameThroughTransposition) {
+    std::vector<std::string> games = {
+        "1. e4 e5 2. Nf3 Nc6 3. Bb5 a6 1-0",
+        "1. Nf3 Nc6 2. e4 e5 3. Bc4 1/2-1/2",
+        "1. d4 d5 2. c4 0-1",
+    };
+    ASSERT_TRUE(PositionIndex::build(games, nullptr, path, 2));
+    
+    PositionIndex index(path);
+    ASSERT_TRUE(index.isOpen());
+    EXPECT_EQ(index.gameCount(), 3u);
+    EXPECT_EQ(index.size(), 7u + 6u + 4u);
+    
+    auto range = index.find(keyAfter("e4 e5 Nf3 Nc6"));
+    ASSERT_EQ(range.second - range.first, 2);
+    EXPECT_EQ(range.first[0].gameId, 0u);
+    EXPECT_EQ(range.first[0].ply, 4u);
+    EXPECT_EQ(range.first[1].gameId, 1u);
+    EXPECT_EQ(range.first[1].ply, 4u);
+    
+    EXPECT_EQ(index.find(keyAfter("")).second - index.find(keyAfter("")).first, 3);
+    EXPECT_EQ(index.find(keyAfter("h4")).first, index.find(keyAfter("h4")).second);
+}
+
+TEST_F(PositionIndexTest, AddsGamesIncrementally) {
+    ASSERT_TRUE(PositionIndex::build({"1. d4 d5"}, nullptr, path, 1));
+    
+    {
+        PositionIndex base(path);
+        ASSERT_TRUE(base.isOpen());
+        size_t failed = 0;
+        ASSERT_TRUE(PositionIndex::build({"1. d4 Nf6", "1. d4 d5 2. Qxx9"}, &base, path, 2, &failed));
+        EXPECT_EQ(failed, 1u);
+    }
+    
+    PositionIndex index(path);
+    ASSERT_TRUE(index.isOpen());
+    EXPECT_EQ(index.gameCount(), 3u);
+    
+    auto range = index.find(keyAfter("d4 d5"));
+    ASSERT_EQ(range.second - range.first, 2);
+    EXPECT_EQ(range.first[0].gameId, 0u);
+    EXPECT_EQ(range.first[1].gameId, 2u);
+    
+    range = index.find(keyAfter("d4 Nf6"));
+    ASSERT_EQ(range.second - range.first, 1);
+    EXPECT_EQ(range.first->gameId, 1u);
+}
+
+TEST_F(PositionIndexTest, ParallelBuildMatchesSerialBuild) {
+    std::vector<std::string> games;
+    const char* openings[] = {"e4 e5 Nf3", "d4 Nf6 c4 e6", "c4 e5 Nc3 Nf6 g3", "Nf3 d5 g3 c5 Bg2"};
+    for (int i = 0; i < 500; ++i) games.push_back(openings[i % 4]);
+    
+    std::string serialPath = path + ".serial";
+    ASSERT_TRUE(PositionIndex::build(games, nullptr, serialPath, 1));
+    ASSERT_TRUE(PositionIndex::build(games, nullptr, path, 4));
+    
+    PositionIndex serial(serialPath), parallel(path);
+    ASSERT_EQ(serial.size(), parallel.size());
+    auto a = serial.find(keyAfter("d4 Nf6 c4"));
+    auto b = parallel.find(keyAfter("d4 Nf6 c4"));
+    ASSERT_EQ(a.second - a.first, 125);
+    ASSERT_EQ(b.second - b.first, 125);
+    for (int i = 0; i < 125; ++i) {
+        EXPECT_EQ(a.first[i].gameId, b.first[i].gameId);
+    }
+    std::remove(serialPath.c_str());
+}
+
+TEST_F(PositionIndexTest, RejectsForeignFiles) {
+    std::FILE* file = std::fopen(path.c_str(), "wb");
+    std::fputs("not an index", file);
+    std::fclose(file);
+    
+    PositionIndex index;
+    EXPECT_FALSE(index.open(path));
+    EXPECT_EQ(index.find(0).first, index.find(0).second);
+}
\ No newline at end of file
@@ -0,0 +1,299 @@
+#include <gtest/gtest.h>
+#include "net/GameServer.h"
+#include "net/Protocol.h"
+#include "net/Session.h"
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <thread>
+
+TEST(ProtocolTest, ParsesCommands) {
+    auto move = Protocol::parseCommand("MOVE 42 e7e8q");
+    EXPECT_EQ(move.type, Protocol::CommandType::MOVE);
+    EXPECT_EQ(move.gameId, 42u);
+    
+    auto text = Protocol::parseMove(move.argument);
+    ASSERT_TRUE(text);
+    EXPECT_EQ(text->from, Position(1, 4));
+    EXPECT_EQ(text->to, Position(0, 4));
+    EXPECT_EQ(text->promotion, PieceType::QUEEN);
+    
+    EXPECT_EQ(Protocol::parseCommand("MOVE e2e4").type, Protocol::CommandType::UNKNOWN);
+    EXPECT_EQ(Protocol::parseCommand("NEW solo").argument, "solo");
+    EXPECT_FALSE(Protocol::parseMove("e2e9"));
+}
+
+TEST(SessionTest, StateMachine) {
+    Session session(1, 10, false);
+    auto e2e4 = *Protocol::parseMove("e2e4");
+    
+    EXPECT_EQ(session.getState(), SessionState::WAITING);
+    EXPECT_EQ(session.move(10, e2e4).text, "ERR 1 waiting");
+    
+    auto joined = session.join(20);
+    EXPECT_EQ(session.getState(), SessionState::PLAYING);
+    EXPECT_EQ(joined.notifyConnection, 10u);
+    
+    EXPECT_EQ(session.move(20, e2e4).text, "ERR 1 not-your-turn");
+    auto moved = session.move(10, e2e4);
+    EXPECT_EQ(moved.text, "OK 1 1 ONGOING");
+    EXPECT_EQ(moved.notifyConnection, 20u);
+    EXPECT_EQ(moved.notification, "MOVED 1 e2e4 ONGOING");
+    EXPECT_EQ(session.undo(10).text, "ERR 1 solo-only");
+    EXPECT_EQ(session.undo(20).text, "ERR 1 solo-only");
+    EXPECT_NE(session.state().text.find("/4P3/"), std::string::npos);
+    
+    session.resign(20);
+    EXPECT_EQ(session.getState(), SessionState::FINISHED);
+    EXPECT_EQ(session.move(20, *Protocol::parseMove("e7e5")).text, "ERR 1 finished");
+}
+
+TEST(GameServerTest, ServesSoloGameOverTcp) {
+    ServerConfig config;
+    config.host = "127.0.0.1";
+    config.port = 0;
+    config.threads = 2;
+    GameServer server(config);
+    ASSERT_TRUE(server.start());
+    
+    int fd = ::socket(AF_INET, SOCK_STREAM, 0);
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(static_cast<uint16_t>(server.getPort()));
+    ::inet_pton(AF_INET, "127.0.0.1", &addr.sin_addr);
+    ASSERT_EQ(::connect(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)), 0);
+    
+    std::string request = "NEW solo\nMOVE 1 f2f3\nMOVE 1 e7e5\nMOVE 1 g2g4\nMOVE 1 d8h4\nMOVE 1 a2a3\n";
+    ASSERT_EQ(::send(fd, request.data(), request.size(), 0), static_cast<ssize_t>(request.size()));
+    
+    std::string expected = "GAME 1 both\nOK 1 1 ONGOING\nOK 1 2 ONGOING\nOK 1 3 ONGOING\n"
+                           "OK 1 4 CHECKMATE\nERR 1 finished\n";
+    std::string received;
+    char buffer[512];
+    while (received.size() < expected.size()) {
+        ssize_t n = ::recv(fd, buffer, sizeof(buffer), 0);
+        ASSERT_GT(n, 0);
+        received.append(buffer, static_cast<size_t>(n));
+    }
+    EXPECT_EQ(received, expected);
+    EXPECT_EQ(server.sessionCount(), 1u);
+    
+    ::close(fd);
+    server.stop();
+    server.wait();
+}
+
+TEST(SessionTest, LeavingMidGameForfeits) {
+    Session session(2, 10, false);
+    session.join(20);
+    session.move(10, *Protocol::parseMove("e2e4"));
+    
+    auto left = session.leave(10);
+    EXPECT_EQ(left.notifyConnection, 20u);
+    EXPECT_EQ(left.notification, "ABANDONED 2");
+    EXPECT_FALSE(left.vacated);
+    EXPECT_EQ(session.getState(), SessionState::FINISHED);
+    EXPECT_EQ(session.state().text.substr(0, 27), "STATE 2 FINISHED CHECKMATE ");
+    
+    EXPECT_EQ(session.leave(30).text, "");
+    EXPECT_FALSE(session.leave(30).vacated);
+    auto last = session.leave(20);
+    EXPECT_EQ(last.notifyConnection, 0u);
+    EXPECT_TRUE(last.vacated);
+}
+
+TEST(SessionTest, TimedSessionReportsAndFlags) {
+    Session session(3, 10, true, Protocol::parseTimeControl("60+1"));
+    EXPECT_TRUE(session.isTimed());
+    ASSERT_TRUE(session.flagTime().has_value());
+    EXPECT_EQ(session.move(10, *Protocol::parseMove("e2e4")).text, "OK 3 1 ONGOING");
+    EXPECT_EQ(session.clock().text.rfind("CLOCK 3 ", 0), 0u);
+    EXPECT_NE(session.clock().text.find(" black"), std::string::npos);
+    
+    EXPECT_FALSE(session.checkFlag(Session::Clock::now()));
+    auto flag = session.checkFlag(*session.flagTime());
+    ASSERT_TRUE(flag.has_value());
+    EXPECT_EQ(*flag, "FLAG 3 black TIME_FORFEIT");
+    EXPECT_EQ(session.getState(), SessionState::FINISHED);
+    EXPECT_FALSE(session.flagTime().has_value());
+    
+    EXPECT_FALSE(Protocol::parseTimeControl("0+5"));
+    EXPECT_FALSE(Protocol::parseTimeControl("5+"));
+    EXPECT_EQ(Protocol::parseTimeControl("300d5")->delay, std::chrono::seconds(5));
+    EXPECT_EQ(Protocol::parseCommand("NEW solo 300+2").argument, "solo 300+2");
+}
+
+TEST(GameServerTest, PushesFlagFallOfTimedGame) {
+    ServerConfig config;
+    config.host = "127.0.0.1";
+    config.port = 0;
+    config.threads = 2;
+    GameServer server(config);
+    ASSERT_TRUE(server.start());
+    
+    int fd = ::socket(AF_INET, SOCK_STREAM, 0);
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(static_cast<uint16_t>(server.getPort()));
+    ::inet_pton(AF_INET, "127.0.0.1", &addr.sin_addr);
+    ASSERT_EQ(::connect(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)), 0);
+    
+    auto sent = Session::Clock::now();
+    std::string request = "NEW solo 1+0\nMOVE 1 e2e4\n";
+    ASSERT_EQ(::send(fd, request.data(), request.size(), 0), static_cast<ssize_t>(request.size()));
+    
+    std::string expected = "GAME 1 both\nOK 1 1 ONGOING\nFLAG 1 black TIME_FORFEIT\n";
+    std::string received;
+    char buffer[512];
+    while (received.size() < expected.size()) {
+        ssize_t n = ::recv(fd, buffer, sizeof(buffer), 0);
+        ASSERT_GT(n, 0);
+        received.append(buffer, static_cast<size_t>(n));
+    }
+    EXPECT_EQ(received, expected);
+    EXPECT_GE(Session::Clock::now() - sent, std::chrono::seconds(1));
+    
+    ::close(fd);
+    server.stop();
+    server.wait();
+}
+
+TEST(SessionTest, PublishesEventsForSpectators) {
+    Session session(4, 10, true);
+    SpectatorSnapshot start = session.spectate();
+    EXPECT_EQ(start.sequence, 0u);
+    EXPECT_EQ(start.text, "PLAYING ONGOING rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1");
+    
+    session.move(10, *Protocol::parseMove("e2e4"));
+    session.undo(10);
+    session.resign(10);
+    session.close();
+    EXPECT_TRUE(session.isClosed());
+    
+    const char* expected[] = {
+        "EVENT 4 0 MOVE e2e4 1 ONGOING",
+        "EVENT 4 1 UNDO 0 ONGOING",
+        "EVENT 4 2 RESIGN white 0 CHECKMATE",
+        "EVENT 4 3 CLOSED",
+    };
+    const auto& events = session.events();
+    ASSERT_EQ(events.head(), 4u);
+    for (uint64_t sequence = 0; sequence < 4; ++sequence) {
+        SpectatorEvent event;
+        ASSERT_EQ(events.read(sequence, event), EventRing<SpectatorEvent>::Read::OK);
+        EXPECT_EQ(Session::formatEvent(4, sequence, event), expected[sequence]);
+    }
+    EXPECT_EQ(session.spectate().sequence, 4u);
+}
+
+TEST(SessionTest, SpectatingLeavesAParkedGameParked) {
+    Session session(5, 10, true);
+    session.move(10, *Protocol::parseMove("e2e4"));
+    std::string live = session.spectate().text;
+    ASSERT_TRUE(session.park(Session::Clock::now()));
+    
+    EXPECT_EQ(session.spectate().text, live);
+    EXPECT_TRUE(session.isParked());
+    EXPECT_EQ(session.state().text, "STATE 5 " + live);
+    EXPECT_FALSE(session.isParked());
+}
+
+TEST(GameServerTest, StreamsEventsToSpectators) {
+    ServerConfig config;
+    config.host = "127.0.0.1";
+    config.port = 0;
+    config.threads = 2;
+    GameServer server(config);
+    ASSERT_TRUE(server.start());
+    
+    auto connect = [&]() {
+        int fd = ::socket(AF_INET, SOCK_STREAM, 0);
+        sockaddr_in addr{};
+        addr.sin_family = AF_INET;
+        addr.sin_port = htons(static_cast<uint16_t>(server.getPort()));
+        ::inet_pton(AF_INET, "127.0.0.1", &addr.sin_addr);
+        EXPECT_EQ(::connect(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)), 0);
+        return fd;
+    };
+    auto exchange = [](int fd, const std::string& request, const std::string& expected) {
+        if (!request.empty()) ::send(fd, request.data(), request.size(), 0);
+        std::string received;
+        char buffer[512];
+        while (received.size() < expected.size()) {
+            ssize_t n = ::recv(fd, buffer, sizeof(buffer), 0);
+            if (n <= 0) break;
+            received.append(buffer, static_cast<size_t>(n));
+        }
+        EXPECT_EQ(received, expected);
+    };
+    
+    int player = connect();
+    int spectator = connect();
+    exchange(player, "NEW solo\n", "GAME 1 both\n");
+    exchange(spectator, "WATCH 1\n",
+             "WATCHING 1 0 PLAYING ONGOING rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1\n");
+    exchange(player, "MOVE 1 e2e4\nMOVE 1 e7e5\nCLOSE 1\n", "OK 1 1 ONGOING\nOK 1 2 ONGOING\nCLOSED 1\n");
+    exchange(spectator, "", "EVENT 1 0 MOVE e2e4 1 ONGOING\nEVENT 1 1 MOVE e7e5 2 ONGOING\nEVENT 1 2 CLOSED\n");
+    exchange(spectator, "WATCH 1\nUNWATCH 1\n", "ERR 1 no-such-game\nERR 1 not-watching\n");
+    
+    ::close(player);
+    ::close(spectator);
+    server.stop();
+    server.wait();
+}
+
+TEST(GameServerTest, KeepsAbandonedGamesForTheOpponent) {
+    ServerConfig config;
+    config.host = "127.0.0.1";
+    config.port = 0;
+    config.threads = 2;
+    GameServer server(config);
+    ASSERT_TRUE(server.start());
+    
+    auto connect = [&]() {
+        int fd = ::socket(AF_INET, SOCK_STREAM, 0);
+        sockaddr_in addr{};
+        addr.sin_family = AF_INET;
+        addr.sin_port = htons(static_cast<uint16_t>(server.getPort()));
+        ::inet_pton(AF_INET, "127.0.0.1", &addr.sin_addr);
+        EXPECT_EQ(::connect(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)), 0);
+        return fd;
+    };
+    auto exchange = [](int fd, const std::string& request, const std::string& expected) {
+        if (!request.empty()) ::send(fd, request.data(), request.size(), 0);
+        std::string received;
+        char buffer[512];
+        while (received.size() < expected.size()) {
+            ssize_t n = ::recv(fd, buffer, sizeof(buffer), 0);
+            if (n <= 0) break;
+            received.append(buffer, static_cast<size_t>(n));
+        }
+        EXPECT_EQ(received, expected);
+    };
+    auto waitForSessions = [&](size_t count) {
+        for (int i = 0; i < 200 && server.sessionCount() != count; ++i) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+        EXPECT_EQ(server.sessionCount(), count);
+    };
+    
+    int white = connect();
+    int black = connect();
+    exchange(white, "NEW\n", "GAME 1 white\n");
+    exchange(black, "JOIN 1\n", "JOINED 1 black\n");
+    exchange(white, "", "JOINED 1 black\n");
+    exchange(white, "MOVE 1 e2e4\n", "OK 1 1 ONGOING\n");
+    exchange(black, "", "MOVED 1 e2e4 ONGOING\n");
+    
+    ::close(white);
+    exchange(black, "", "ABANDONED 1\n");
+    exchange(black, "STATE 1\n",
+             "STATE 1 FINISHED CHECKMATE rnbqkbnr/pppppppp/8/8/4P3/8/PPPP1PPP/RNBQKBNR w KQkq e3 0 1\n");
+    EXPECT_EQ(server.sessionCount(), 1u);
+    
+    ::close(black);
+    waitForSessions(0);
+    server.stop();
+    server.wait();
+}
\ No newline at end of file
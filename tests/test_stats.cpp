@@ -0,0 +1,113 @@
+#include <gtest/gtest.h>
+#include "core/Game.h"
+#include "core/Stats.h"
+#include "core/Trace.h"
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <thread>
+
+TEST(StatsTest, CountsHotPathsOfAMove) {
+    Game game;
+    Stats::Snapshot before = Stats::snapshot();
+    ASSERT_TRUE(game.makeMove(Position(6, 4), Position(4, 4)));
+    auto legal = game.getValidMoves(Position(1, 4));
+    Stats::Snapshot delta = Stats::snapshot() - before;
+    
+    if (!Stats::ENABLED) {
+        for (uint64_t value : delta.values) EXPECT_EQ(value, 0u);
+        GTEST_SKIP() << "built without CHESS_STATS";
+    }
+    
+    EXPECT_EQ(delta[Stats::Counter::STATUS_UPDATES], 1u);
+    EXPECT_GT(delta[Stats::Counter::STATUS_UPDATE_NANOS], 0u);
+    EXPECT_GE(delta[Stats::Counter::LEGAL_MOVES_GENERATED], legal.size());
+    EXPECT_GT(delta[Stats::Counter::CHECK_PROBES], 0u);
+    EXPECT_GT(delta[Stats::Counter::POSSIBLE_MOVES_CALLS], 0u);
+    // Probes run on snapshots, so a move copies no boards at all
+    EXPECT_EQ(delta[Stats::Counter::BOARD_COPIES], 0u);
+    EXPECT_EQ(delta[Stats::Counter::PIECE_CLONES], 0u);
+}
+
+TEST(StatsTest, KeepsCountsOfExitedThreads) {
+    if (!Stats::ENABLED) GTEST_SKIP() << "built without CHESS_STATS";
+    
+    Stats::Snapshot before = Stats::snapshot();
+    std::thread worker([]() {
+        Board board;
+        Board copy(board);
+        (void)copy;
+    });
+    worker.join();
+    Stats::Snapshot delta = Stats::snapshot() - before;
+    EXPECT_EQ(delta[Stats::Counter::BOARD_COPIES], 1u);
+    EXPECT_EQ(delta[Stats::Counter::PIECE_CLONES], 32u);
+}
+
+TEST(StatsTest, HistogramBucketsBoundTheirValues) {
+    for (uint64_t value : {0ull, 1ull, 15ull, 16ull, 17ull, 31ull, 32ull, 1000ull, 123456789ull, ~0ull}) {
+        int index = Stats::Histogram::bucketIndex(value);
+        ASSERT_LT(index, Stats::Histogram::BUCKET_COUNT);
+        EXPECT_GE(Stats::Histogram::bucketUpperBound(index), value);
+        if (index > 0) {
+            EXPECT_LT(Stats::Histogram::bucketUpperBound(index - 1), value);
+        }
+    }
+}
+
+TEST(StatsTest, HistogramPercentilesAreWithinBucketPrecision) {
+    Stats::Histogram histogram;
+    for (uint64_t nanos = 1; nanos <= 10000; ++nanos) histogram.record(nanos * 100);
+    
+    EXPECT_EQ(histogram.count(), 10000u);
+    EXPECT_EQ(histogram.max(), 1000000u);
+    EXPECT_NEAR(histogram.mean(), 500050.0, 0.5);
+    for (double p : {0.5, 0.99, 0.999}) {
+        double exact = p * 1000000.0;
+        EXPECT_GE(static_cast<double>(histogram.percentile(p)), exact);
+        EXPECT_LE(static_cast<double>(histogram.percentile(p)), exact * (1.0 + 1.0 / 16));
+    }
+    EXPECT_EQ(histogram.percentile(1.0), 1000000u);
+    
+    Stats::Histogram doubled = histogram;
+    doubled.merge(histogram);
+    EXPECT_EQ(doubled.count(), 20000u);
+    EXPECT_EQ(doubled.percentile(0.5), histogram.percentile(0.5));
+}
+
+TEST(StatsTest, TimesMoveOperations) {
+    if (!Stats::ENABLED) GTEST_SKIP() << "built without CHESS_STATS";
+    
+    uint64_t before = Stats::latency(Stats::Operation::MAKE_MOVE).count();
+    Game game;
+    ASSERT_TRUE(game.makeMove(Position(6, 4), Position(4, 4)));
+    ASSERT_TRUE(game.makeMove(Position(1, 4), Position(3, 4)));
+    Stats::Histogram makeMove = Stats::latency(Stats::Operation::MAKE_MOVE);
+    EXPECT_EQ(makeMove.count() - before, 2u);
+    EXPECT_GT(makeMove.percentile(0.5), 0u);
+}
+
+TEST(StatsTest, TraceWritesChromeTraceEvents) {
+    std::string path = ::testing::TempDir() + "stats_test_trace.json";
+    Trace::start();
+    EXPECT_TRUE(Trace::isActive());
+    {
+        Trace::Span outer("outer");
+        std::thread([]() { Trace::Span inner("inner"); }).join();
+        // Instrumented operations are traced with or without CHESS_STATS
+        Game game;
+        ASSERT_TRUE(game.makeMove(Position(6, 4), Position(4, 4)));
+    }
+    uint64_t dropped = 1;
+    ASSERT_TRUE(Trace::stop(path, &dropped));
+    EXPECT_FALSE(Trace::isActive());
+    EXPECT_EQ(dropped, 0u);
+    
+    std::ifstream in(path);
+    std::string json((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    EXPECT_EQ(json.rfind("{\"displayTimeUnit\":\"ns\",\"traceEvents\":[", 0), 0u);
+    EXPECT_NE(json.find("\"name\":\"outer\",\"ph\":\"X\""), std::string::npos);
+    EXPECT_NE(json.find("\"name\":\"inner\",\"ph\":\"X\""), std::string::npos);
+    EXPECT_NE(json.find("\"name\":\"Game::makeMove\",\"ph\":\"X\""), std::string::npos);
+    std::remove(path.c_str());
+}
\ No newline at end of file
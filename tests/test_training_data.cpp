@@ -0,0 +1,106 @@
+#include <gtest/gtest.h>
+#include "core/Game.h"
+#include "core/TrainingData.h"
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+class TrainingDataTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        path = ::testing::TempDir() + "training_data_test.bin";
+    }
+    
+    void TearDown() override {
+        std::remove(path.c_str());
+    }
+    
+    std::string path;
+};
+
+TEST_F(TrainingDataTest, PackRoundTripsThroughFEN) {
+    const char* fens[] = {
+        "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1",
+        "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1",
+        "r3k2r/8/8/8/8/8/8/R3K2R b Kq - 3 12",
+        "4k3/8/8/3pP3/8/8/8/4K3 w - d6 0 33",
+        "8/2P5/8/8/8/8/4k1p1/K7 b - - 99 140",
+    };
+    for (const char* fen : fens) {
+        Game game;
+        ASSERT_TRUE(game.loadFEN(fen)) << fen;
+        auto packed = PackedPosition::pack(game.snapshot(), -1, 17);
+        ASSERT_TRUE(packed.has_value()) << fen;
+        EXPECT_EQ(packed->result, -1);
+        EXPECT_EQ(packed->pliesToEnd, 17);
+        EXPECT_EQ(packed->unpack(), game.snapshot()) << fen;
+        
+        Game restored;
+        ASSERT_TRUE(restored.restoreSnapshot(packed->unpack()));
+        EXPECT_EQ(restored.toFEN(), fen);
+    }
+}
+
+TEST_F(TrainingDataTest, ThreadsAppendWholeBuffersTheReaderSees) {
+    constexpr int THREADS = 4;
+    constexpr int PER_THREAD = 1000;
+    TrainingDataWriter writer;
+    ASSERT_TRUE(writer.open(path));
+    
+    // Each thread tags its records through pliesToEnd; small buffers force
+    // many interleaved appends
+    std::vector<std::thread> threads;
+    for (int t = 0; t < THREADS; ++t) {
+        threads.emplace_back([&writer, t]() {
+            TrainingDataWriter::Buffer buffer(writer, 37);
+            auto record = PackedPosition::pack(PositionSnapshot::initial(), t % 3 - 1);
+            for (int i = 0; i < PER_THREAD; ++i) {
+                record->pliesToEnd = static_cast<uint16_t>(t * PER_THREAD + i);
+                buffer.add(*record);
+            }
+        });
+    }
+    for (auto& thread : threads) thread.join();
+    EXPECT_EQ(writer.size(), static_cast<uint64_t>(THREADS * PER_THREAD));
+    ASSERT_TRUE(writer.close());
+    
+    TrainingDataReader reader(path);
+    ASSERT_TRUE(reader.isOpen());
+    ASSERT_EQ(reader.size(), static_cast<size_t>(THREADS * PER_THREAD));
+    std::vector<int> tags;
+    for (const PackedPosition& record : reader) {
+        int t = record.pliesToEnd / PER_THREAD;
+        EXPECT_EQ(record.result, t % 3 - 1);
+        EXPECT_EQ(record.unpack(), PositionSnapshot::initial());
+        tags.push_back(record.pliesToEnd);
+    }
+    std::sort(tags.begin(), tags.end());
+    for (int i = 0; i < THREADS * PER_THREAD; ++i) ASSERT_EQ(tags[i], i);
+}
+
+TEST_F(TrainingDataTest, RejectsForeignFilesAndIgnoresATornTail) {
+    {
+        std::ofstream out(path, std::ios::binary);
+        out << "not a training file at all";
+    }
+    TrainingDataReader reader;
+    EXPECT_FALSE(reader.open(path));
+    EXPECT_FALSE(reader.isOpen());
+    
+    TrainingDataWriter writer;
+    ASSERT_TRUE(writer.open(path));
+    {
+        TrainingDataWriter::Buffer buffer(writer);
+        for (int i = 0; i < 3; ++i) buffer.add(*PackedPosition::pack(PositionSnapshot::initial()));
+    }
+    ASSERT_TRUE(writer.close());
+    {
+        std::ofstream out(path, std::ios::binary | std::ios::app);
+        out << "partial";
+    }
+    ASSERT_TRUE(reader.open(path));
+    EXPECT_EQ(reader.size(), 3u);
+}
\ No newline at end of file